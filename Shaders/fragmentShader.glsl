@@ -0,0 +1,339 @@
+///////////////////////////////////////////////////////////////////////////////
+// fragmentShader.glsl
+// ============
+// shade the scene fragments with Phong lighting from the lights listed for
+// their cluster, or from the light uniform block, with cascaded shadows from
+// the light that casts them
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+// the clustered lights are read from storage buffers where they are
+// supported, otherwise only the light block is used
+#extension GL_ARB_shader_storage_buffer_object : enable
+
+#define MAX_LIGHT_SOURCES 4
+#define MAX_OBJECT_MATERIALS 64
+
+// the clusters across, down and deep, these must match LightClusters
+#define CLUSTER_COUNT_X 16
+#define CLUSTER_COUNT_Y 9
+#define CLUSTER_COUNT_Z 24
+
+// the slices of the view with a shadow map each, this must match ShadowMaps
+#define SHADOW_CASCADE_COUNT 3
+
+struct Material
+{
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+	float ambientStrength;
+	float shininess;
+};
+
+struct LightSource
+{
+	vec4 position;
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+	float focalStrength;
+	float specularIntensity;
+	float range;
+};
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+in vec4 fragmentObjectColor;
+in vec2 fragmentUVscale;
+flat in int fragmentMaterialIndex;
+flat in int fragmentTextureLayer;
+flat in float fragmentLODFade;
+
+layout (location = 0) out vec4 outFragmentColor;
+// how much of the background a translucent fragment lets through, only
+// written while the fragments are accumulated for weighted blending
+layout (location = 1) out vec4 outRevealage;
+
+// per-frame camera data, shared by every shader program
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	vec4 viewPosition;
+};
+
+// scene light sources, only uploaded when they change
+layout (std140) uniform LightBlock
+{
+	LightSource lightSources[MAX_LIGHT_SOURCES];
+	int lightCount;
+};
+
+// object materials, uploaded once when the scene is prepared
+layout (std140) uniform MaterialBlock
+{
+	Material materials[MAX_OBJECT_MATERIALS];
+};
+
+#ifdef GL_ARB_shader_storage_buffer_object
+// every scene light
+layout (std430) readonly buffer LightList
+{
+	LightSource sceneLights[];
+};
+
+// the offset and count of the lights listed for each cluster,
+// filled by the light culling pass every frame
+layout (std430) readonly buffer ClusterGrid
+{
+	uvec2 clusterLights[];
+};
+
+// the light indices of every cluster
+layout (std430) readonly buffer LightIndexList
+{
+	uint lightIndexCount;
+	uint lightIndices[];
+};
+#endif
+
+// set while the depth pre-pass draws, which only writes depth
+uniform bool bDepthOnly = false;
+// every shaded fragment adds a little color instead, to show overdraw
+uniform bool bShowOverdraw = false;
+// set while the translucent objects are accumulated in any order
+uniform bool bWeightedBlend = false;
+// set while the fading objects are drawn again at their next level
+// of detail, which keeps the fragments the first draw dropped
+uniform bool bLODFadeOut = false;
+
+// the fragment's cluster is its window position times the tile
+// scale, and log(view depth) times the slice scale plus the bias
+uniform bool bUseLightClusters = false;
+uniform vec2 clusterTileScale;
+uniform vec2 clusterSliceScaleBias;
+
+// the scene light that casts shadows, shadowed by a map per cascade
+uniform bool bUseShadows = false;
+uniform int shadowLightIndex = -1;
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowMatrices[SHADOW_CASCADE_COUNT];
+// the view depth each cascade reaches out to, and its texel size
+uniform vec4 shadowCascadeEnds;
+uniform vec4 shadowTexelSizes;
+
+uniform bool bUseTexture = false;
+uniform bool bUseLighting = false;
+uniform sampler2D objectTexture;
+
+// the scene textures packed into array pages by size and format,
+// the layer of the object texture comes with the object values
+uniform bool bUseTextureArray = false;
+uniform sampler2DArray objectTextureArray;
+
+// the material of the object being drawn
+Material material;
+
+/***********************************************************
+ *  CalcLightShadow()
+ *
+ *  Calculate how much of a light source reaches the current
+ *  fragment, from 0 in full shadow to 1 when fully lit. Only
+ *  the light that casts shadows is looked up, in the map of
+ *  the cascade the fragment's view depth falls in. The point
+ *  looked up is pushed off the surface by a texel or more,
+ *  the more the surface faces away from the light, so it
+ *  does not shadow itself.
+ ***********************************************************/
+float CalcLightShadow(int lightIndex, LightSource light, vec3 lightNormal, vec3 vertexPosition)
+{
+	if ((bUseShadows == false) || (lightIndex != shadowLightIndex))
+	{
+		return(1.0f);
+	}
+
+	float viewDepth = -(view * vec4(vertexPosition, 1.0f)).z;
+	int cascade = 0;
+	while ((cascade < SHADOW_CASCADE_COUNT) && (viewDepth > shadowCascadeEnds[cascade]))
+	{
+		cascade++;
+	}
+	if (cascade >= SHADOW_CASCADE_COUNT)
+	{
+		return(1.0f);
+	}
+
+	vec3 lightDirection = normalize(light.position.xyz - vertexPosition);
+	float facingAway = 1.0f - max(dot(lightNormal, lightDirection), 0.0f);
+	vec3 offsetPosition = vertexPosition + lightNormal * shadowTexelSizes[cascade] * (1.0f + 2.0f * facingAway);
+
+	vec4 shadowPosition = shadowMatrices[cascade] * vec4(offsetPosition, 1.0f);
+	vec3 shadowCoordinate = shadowPosition.xyz / shadowPosition.w * 0.5f + 0.5f;
+
+	// four lookups half a texel apart, each blending its nearest
+	// texels, soften the shadow edges
+	vec2 texelOffset = 0.5f / vec2(textureSize(shadowMap, 0).xy);
+	float lit = 0.0f;
+	lit += texture(shadowMap, vec4(shadowCoordinate.xy + vec2(-texelOffset.x, -texelOffset.y), cascade, shadowCoordinate.z));
+	lit += texture(shadowMap, vec4(shadowCoordinate.xy + vec2(texelOffset.x, -texelOffset.y), cascade, shadowCoordinate.z));
+	lit += texture(shadowMap, vec4(shadowCoordinate.xy + vec2(-texelOffset.x, texelOffset.y), cascade, shadowCoordinate.z));
+	lit += texture(shadowMap, vec4(shadowCoordinate.xy + vec2(texelOffset.x, texelOffset.y), cascade, shadowCoordinate.z));
+
+	return(lit * 0.25f);
+}
+
+/***********************************************************
+ *  CalcLightSource()
+ *
+ *  Calculate the Phong lighting contributed by a single
+ *  light source to the current fragment. The shadow scales
+ *  the diffuse and specular lighting, the ambient lighting
+ *  reaches into the shadows.
+ ***********************************************************/
+vec3 CalcLightSource(LightSource light, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection, float shadow)
+{
+	// ambient lighting
+	vec3 ambient = light.ambientColor.rgb * material.ambientStrength * material.ambientColor.rgb;
+
+	// diffuse lighting
+	vec3 lightDirection = normalize(light.position.xyz - vertexPosition);
+	float impact = max(dot(lightNormal, lightDirection), 0.0f);
+	vec3 diffuse = impact * light.diffuseColor.rgb * material.diffuseColor.rgb;
+
+	// specular lighting
+	vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+	float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0f), light.focalStrength);
+	vec3 specular = light.specularIntensity * specularComponent * light.specularColor.rgb * material.specularColor.rgb;
+
+	// lights with a range fade out smoothly to nothing at it
+	float attenuation = 1.0f;
+	if (light.range > 0.0f)
+	{
+		float distanceRatio = length(light.position.xyz - vertexPosition) / light.range;
+		attenuation = clamp(1.0f - distanceRatio * distanceRatio, 0.0f, 1.0f);
+		attenuation *= attenuation;
+	}
+
+	return((ambient + (diffuse + specular) * shadow) * attenuation);
+}
+
+/***********************************************************
+ *  CalcDitherThreshold()
+ *
+ *  Calculate the threshold of the current pixel in a 4x4
+ *  ordered dither pattern, spread evenly between 0 and 1.
+ *  The pattern is tied to the window, so the same pixels
+ *  are kept by every draw of the same fade.
+ ***********************************************************/
+float CalcDitherThreshold()
+{
+	const float bayer[16] = float[16](
+		0.0f, 8.0f, 2.0f, 10.0f,
+		12.0f, 4.0f, 14.0f, 6.0f,
+		3.0f, 11.0f, 1.0f, 9.0f,
+		15.0f, 7.0f, 13.0f, 5.0f);
+	ivec2 pixel = ivec2(gl_FragCoord.xy) & 3;
+	return((bayer[pixel.y * 4 + pixel.x] + 0.5f) / 16.0f);
+}
+
+void main()
+{
+	// an object fading to its next level of detail keeps fewer of
+	// its pixels the further it has faded, and the draw of the next
+	// level keeps the rest, before the pre-pass too so both passes
+	// cover the same pixels
+	if ((fragmentLODFade > 0.0f) || (bLODFadeOut == true))
+	{
+		bool bFadedOut = (CalcDitherThreshold() < fragmentLODFade);
+		if (bFadedOut != bLODFadeOut)
+		{
+			discard;
+		}
+	}
+
+	// the depth is all the pre-pass needs, so skip the shading
+	if (bDepthOnly == true)
+	{
+		outFragmentColor = vec4(0.0f);
+		return;
+	}
+	if (bShowOverdraw == true)
+	{
+		outFragmentColor = vec4(0.1f, 0.05f, 0.02f, 1.0f);
+		return;
+	}
+
+	material = materials[fragmentMaterialIndex];
+
+	vec4 baseColor = fragmentObjectColor;
+	if (bUseTexture == true)
+	{
+		vec2 textureCoordinate = fragmentTextureCoordinate * fragmentUVscale;
+		vec4 textureColor;
+		if (bUseTextureArray == true)
+		{
+			textureColor = texture(objectTextureArray, vec3(textureCoordinate, fragmentTextureLayer));
+		}
+		else
+		{
+			textureColor = texture(objectTexture, textureCoordinate);
+		}
+		baseColor = vec4(textureColor.rgb, textureColor.a * fragmentObjectColor.a);
+	}
+
+	if (bUseLighting == true)
+	{
+		vec3 lightNormal = normalize(fragmentVertexNormal);
+		vec3 viewDirection = normalize(viewPosition.xyz - fragmentPosition);
+		vec3 phongResult = vec3(0.0f);
+
+#ifdef GL_ARB_shader_storage_buffer_object
+		if (bUseLightClusters == true)
+		{
+			// only shade the lights listed for the fragment's cluster
+			float viewDepth = max(-(view * vec4(fragmentPosition, 1.0f)).z, 0.0001f);
+			ivec3 cluster;
+			cluster.xy = ivec2(gl_FragCoord.xy * clusterTileScale);
+			cluster.z = int(log(viewDepth) * clusterSliceScaleBias.x + clusterSliceScaleBias.y);
+			cluster = clamp(cluster, ivec3(0), ivec3(CLUSTER_COUNT_X - 1, CLUSTER_COUNT_Y - 1, CLUSTER_COUNT_Z - 1));
+
+			uvec2 clusterList = clusterLights[cluster.x + CLUSTER_COUNT_X * (cluster.y + CLUSTER_COUNT_Y * cluster.z)];
+			for (uint i = 0u; i < clusterList.y; i++)
+			{
+				int lightIndex = int(lightIndices[clusterList.x + i]);
+				LightSource light = sceneLights[lightIndex];
+				float shadow = CalcLightShadow(lightIndex, light, lightNormal, fragmentPosition);
+				phongResult += CalcLightSource(light, lightNormal, fragmentPosition, viewDirection, shadow);
+			}
+		}
+		else
+#endif
+		{
+			for (int i = 0; i < lightCount; i++)
+			{
+				float shadow = CalcLightShadow(i, lightSources[i], lightNormal, fragmentPosition);
+				phongResult += CalcLightSource(lightSources[i], lightNormal, fragmentPosition, viewDirection, shadow);
+			}
+		}
+
+		outFragmentColor = vec4(phongResult * baseColor.rgb, baseColor.a);
+	}
+	else
+	{
+		outFragmentColor = baseColor;
+	}
+
+	if (bWeightedBlend == true)
+	{
+		// nearer and more opaque fragments count for more in the
+		// average, the weight falls off with the window depth
+		float alpha = outFragmentColor.a;
+		float weight = clamp(pow(min(1.0f, alpha * 10.0f) + 0.01f, 3.0f) * 1e8f *
+			pow(1.0f - gl_FragCoord.z * 0.9f, 3.0f), 0.01f, 3000.0f);
+		outFragmentColor = vec4(outFragmentColor.rgb * alpha, alpha) * weight;
+		outRevealage = vec4(alpha);
+	}
+}
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightClusterShader.glsl
+// ============
+// list the scene lights reaching each view space cluster of the frustum
+///////////////////////////////////////////////////////////////////////////////
+
+#version 430 core
+
+// the clusters across, down and deep, these must match LightClusters
+#define CLUSTER_COUNT_X 16
+#define CLUSTER_COUNT_Y 9
+#define CLUSTER_COUNT_Z 24
+#define MAX_LIGHTS_PER_CLUSTER 64
+
+// one work group per depth slice, one invocation per screen tile
+layout (local_size_x = CLUSTER_COUNT_X, local_size_y = CLUSTER_COUNT_Y, local_size_z = 1) in;
+
+struct LightSource
+{
+	vec4 position;
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+	float focalStrength;
+	float specularIntensity;
+	float range;
+};
+
+// the scene lights, in world space
+layout (std430, binding = 0) readonly buffer LightList
+{
+	LightSource sceneLights[];
+};
+
+// the offset and count of the lights listed for each cluster
+layout (std430, binding = 1) writeonly buffer ClusterGrid
+{
+	uvec2 clusterLights[];
+};
+
+// the light indices of every cluster, claimed through the counter
+layout (std430, binding = 2) buffer LightIndexList
+{
+	uint lightIndexCount;
+	uint lightIndices[];
+};
+
+uniform mat4 view;
+uniform mat4 inverseProjection;
+// view depth of the near and far planes
+uniform vec2 depthRange;
+uniform int lightCount;
+
+// the lights are tested in batches shared by the work group, so
+// each one is read and moved into view space only once
+#define LIGHT_BATCH_SIZE (CLUSTER_COUNT_X * CLUSTER_COUNT_Y)
+shared vec4 batchLights[LIGHT_BATCH_SIZE];
+
+/***********************************************************
+ *  PointAtDepth()
+ *
+ *  Find the view space point at a view depth on the line
+ *  through a point of the window, given in normalized device
+ *  coordinates. The line runs between the near and far planes,
+ *  so it works for perspective and orthographic views alike.
+ ***********************************************************/
+vec3 PointAtDepth(vec2 ndcPoint, float depth)
+{
+	vec4 nearPoint = inverseProjection * vec4(ndcPoint, -1.0f, 1.0f);
+	vec4 farPoint = inverseProjection * vec4(ndcPoint, 1.0f, 1.0f);
+	nearPoint /= nearPoint.w;
+	farPoint /= farPoint.w;
+
+	float t = (-depth - nearPoint.z) / (farPoint.z - nearPoint.z);
+	return(mix(nearPoint.xyz, farPoint.xyz, t));
+}
+
+void main()
+{
+	uvec3 cluster = uvec3(gl_LocalInvocationID.xy, gl_WorkGroupID.z);
+	uint clusterIndex = cluster.x + CLUSTER_COUNT_X * (cluster.y + CLUSTER_COUNT_Y * cluster.z);
+
+	// the depth slices are spaced exponentially between the planes
+	float depthRatio = depthRange.y / depthRange.x;
+	float nearDepth = depthRange.x * pow(depthRatio, float(cluster.z) / CLUSTER_COUNT_Z);
+	float farDepth = depthRange.x * pow(depthRatio, float(cluster.z + 1) / CLUSTER_COUNT_Z);
+
+	// view space bounds of the cluster, from its tile corners on
+	// both of its depth planes
+	vec2 tileSize = 2.0f / vec2(CLUSTER_COUNT_X, CLUSTER_COUNT_Y);
+	vec2 tileMin = vec2(-1.0f) + vec2(cluster.xy) * tileSize;
+	vec2 tileMax = tileMin + tileSize;
+	vec3 point0 = PointAtDepth(tileMin, nearDepth);
+	vec3 point1 = PointAtDepth(tileMax, nearDepth);
+	vec3 point2 = PointAtDepth(tileMin, farDepth);
+	vec3 point3 = PointAtDepth(tileMax, farDepth);
+	vec3 boundsMin = min(min(point0, point1), min(point2, point3));
+	vec3 boundsMax = max(max(point0, point1), max(point2, point3));
+
+	uint clusterLightList[MAX_LIGHTS_PER_CLUSTER];
+	uint clusterLightCount = 0;
+
+	for (int batchStart = 0; batchStart < lightCount; batchStart += LIGHT_BATCH_SIZE)
+	{
+		// each invocation moves one light of the batch into view space
+		int loadIndex = batchStart + int(gl_LocalInvocationIndex);
+		if (loadIndex < lightCount)
+		{
+			LightSource light = sceneLights[loadIndex];
+			batchLights[gl_LocalInvocationIndex] = vec4((view * vec4(light.position.xyz, 1.0f)).xyz, light.range);
+		}
+		barrier();
+
+		int batchCount = min(lightCount - batchStart, LIGHT_BATCH_SIZE);
+		for (int i = 0; i < batchCount; i++)
+		{
+			vec4 light = batchLights[i];
+
+			// a light without a range reaches every cluster, the others
+			// only the clusters their sphere touches
+			bool bReaches = (light.w <= 0.0f);
+			if (!bReaches)
+			{
+				vec3 closest = clamp(light.xyz, boundsMin, boundsMax);
+				vec3 toLight = closest - light.xyz;
+				bReaches = (dot(toLight, toLight) <= light.w * light.w);
+			}
+
+			if (bReaches && (clusterLightCount < MAX_LIGHTS_PER_CLUSTER))
+			{
+				clusterLightList[clusterLightCount] = uint(batchStart + i);
+				clusterLightCount++;
+			}
+		}
+		barrier();
+	}
+
+	// claim room for the lights of the cluster and copy them in
+	uint offset = atomicAdd(lightIndexCount, clusterLightCount);
+	for (uint i = 0; i < clusterLightCount; i++)
+	{
+		lightIndices[offset + i] = clusterLightList[i];
+	}
+	clusterLights[clusterIndex] = uvec2(offset, clusterLightCount);
+}
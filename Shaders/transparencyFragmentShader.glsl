@@ -0,0 +1,33 @@
+///////////////////////////////////////////////////////////////////////////////
+// transparencyFragmentShader.glsl
+// ============
+// blend the weighted average of the accumulated translucent fragments over
+// the frame, by how much of the background they cover
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+out vec4 outFragmentColor;
+
+// premultiplied color and alpha summed with their weights
+uniform sampler2D accumulationTexture;
+// product of how much of the background each fragment lets through
+uniform sampler2D revealageTexture;
+
+void main()
+{
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+	float revealage = texelFetch(revealageTexture, texel, 0).r;
+
+	// nothing translucent was drawn over this pixel
+	if (revealage >= 1.0f)
+	{
+		discard;
+	}
+
+	vec4 accumulation = texelFetch(accumulationTexture, texel, 0);
+	vec3 averageColor = accumulation.rgb / clamp(accumulation.a, 0.0001f, 50000.0f);
+
+	// drawn with the usual alpha blending
+	outFragmentColor = vec4(averageColor, 1.0f - revealage);
+}
@@ -0,0 +1,14 @@
+///////////////////////////////////////////////////////////////////////////////
+// transparencyVertexShader.glsl
+// ============
+// cover the window with a single triangle for the transparency composite
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+void main()
+{
+	// the corners (-1,-1), (3,-1) and (-1,3) cover the whole window
+	vec2 position = vec2((gl_VertexID == 1) ? 3.0f : -1.0f, (gl_VertexID == 2) ? 3.0f : -1.0f);
+	gl_Position = vec4(position, 0.0f, 1.0f);
+}
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// vertexShader.glsl
+// ============
+// transform the scene vertices using the shared camera uniform block, with
+// the object values taken from uniforms or from the per-instance attributes
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+// per-instance object values, read when bUseInstancing is set
+layout (location = 3) in mat4 inInstanceModel;
+layout (location = 7) in vec4 inInstanceColor;
+layout (location = 8) in vec2 inInstanceUVscale;
+layout (location = 9) in int inInstanceMaterial;
+layout (location = 10) in int inInstanceTextureLayer;
+// how far the instance has faded to its next level of detail
+layout (location = 11) in float inInstanceLODFade;
+// slot of a dynamic object in the ring of model matrices, or -1
+layout (location = 12) in int inInstanceDynamicSlot;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+out vec4 fragmentObjectColor;
+out vec2 fragmentUVscale;
+flat out int fragmentMaterialIndex;
+flat out int fragmentTextureLayer;
+flat out float fragmentLODFade;
+
+// the opaque objects are drawn twice, into the depth buffer and then
+// shaded where the depth matches, so both must land on the same depth
+invariant gl_Position;
+
+// per-frame camera data, shared by every shader program
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	vec4 viewPosition;
+};
+
+// per-object values, used when bUseInstancing is not set
+uniform bool bUseInstancing = false;
+uniform mat4 model;
+uniform vec4 objectColor = vec4(1.0f);
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+uniform int materialIndex = 0;
+uniform int textureLayer = 0;
+
+// the model matrices of the dynamic objects, written every frame into
+// a region of a ring that starts at the base texel, four per matrix
+uniform bool bUseDynamicModels = false;
+uniform samplerBuffer dynamicModels;
+uniform int dynamicModelBase = 0;
+
+// set while the shadow maps are drawn, from the light of a cascade
+uniform bool bShadowPass = false;
+uniform mat4 shadowViewProjection;
+
+void main()
+{
+	mat4 objectModel = model;
+	fragmentObjectColor = objectColor;
+	fragmentUVscale = UVscale;
+	fragmentMaterialIndex = materialIndex;
+	fragmentTextureLayer = textureLayer;
+	fragmentLODFade = 0.0f;
+	if (bUseInstancing == true)
+	{
+		objectModel = inInstanceModel;
+		fragmentObjectColor = inInstanceColor;
+		fragmentUVscale = inInstanceUVscale;
+		fragmentMaterialIndex = inInstanceMaterial;
+		fragmentTextureLayer = inInstanceTextureLayer;
+		if ((bUseDynamicModels == true) && (inInstanceDynamicSlot >= 0))
+		{
+			int texel = dynamicModelBase + inInstanceDynamicSlot * 4;
+			objectModel = mat4(
+				texelFetch(dynamicModels, texel),
+				texelFetch(dynamicModels, texel + 1),
+				texelFetch(dynamicModels, texel + 2),
+				texelFetch(dynamicModels, texel + 3));
+		}
+		// the shadow maps are drawn at the finest level, unfaded
+		if (bShadowPass == false)
+		{
+			fragmentLODFade = inInstanceLODFade;
+		}
+	}
+
+	// transform the vertex into clip space
+	if (bShadowPass == true)
+	{
+		gl_Position = shadowViewProjection * objectModel * vec4(inVertexPosition, 1.0f);
+	}
+	else
+	{
+		gl_Position = projection * view * objectModel * vec4(inVertexPosition, 1.0f);
+	}
+
+	// world space position and normal for the lighting calculations
+	fragmentPosition = vec3(objectModel * vec4(inVertexPosition, 1.0f));
+	fragmentVertexNormal = mat3(transpose(inverse(objectModel))) * inVertexNormal;
+	fragmentTextureCoordinate = inTextureCoordinate;
+}
@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.cpp
+// ============
+// record and replay timed camera positions for repeatable runs
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+/***********************************************************
+ *  AddKey()
+ *
+ *  This method is used for adding a pose to the end of the
+ *  path. A pose that is not later than the last one is
+ *  dropped, so the keys stay sorted by time.
+ ***********************************************************/
+void CameraPath::AddKey(float time, const glm::vec3& position, const glm::vec3& front)
+{
+	if (!m_keys.empty() && (time <= m_keys.back().time))
+	{
+		return;
+	}
+
+	CAMERA_KEY key;
+	key.time = time;
+	key.position = position;
+	key.front = glm::normalize(front);
+	m_keys.push_back(key);
+}
+
+/***********************************************************
+ *  MakeOrbit()
+ *
+ *  This method is used for replacing the path with a full
+ *  circle of the passed in radius around the center, at the
+ *  passed in height above it and always looking at it. The
+ *  last key is the same as the first, so the path repeats
+ *  without a jump.
+ ***********************************************************/
+void CameraPath::MakeOrbit(
+	const glm::vec3& center,
+	float radius,
+	float height,
+	float duration,
+	int keyCount)
+{
+	Clear();
+
+	if (keyCount < 2)
+	{
+		keyCount = 2;
+	}
+
+	for (int i = 0; i <= keyCount; i++)
+	{
+		float fraction = (float)i / keyCount;
+		float angle = fraction * glm::radians(360.0f);
+
+		// the orbit starts in front of the scene, where the
+		// interactive camera starts
+		glm::vec3 position = center + glm::vec3(
+			radius * std::sin(angle),
+			height,
+			radius * std::cos(angle));
+
+		AddKey(fraction * duration, position, center - position);
+	}
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every pose of the path.
+ ***********************************************************/
+void CameraPath::Clear()
+{
+	m_keys.clear();
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for reading a path from a text file.
+ *  Every line holds the time, position and viewing direction
+ *  of a pose as seven numbers, lines starting with # are
+ *  comments.
+ ***********************************************************/
+bool CameraPath::Load(const std::string& filename)
+{
+	std::ifstream file(filename);
+	if (!file)
+	{
+		return(false);
+	}
+
+	Clear();
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || (line[0] == '#'))
+		{
+			continue;
+		}
+
+		std::istringstream values(line);
+		float time = 0.0f;
+		glm::vec3 position;
+		glm::vec3 front;
+		if (values >> time >> position.x >> position.y >> position.z >> front.x >> front.y >> front.z)
+		{
+			AddKey(time, position, front);
+		}
+	}
+
+	return(!m_keys.empty());
+}
+
+/***********************************************************
+ *  Save()
+ *
+ *  This method is used for writing the path to a text file
+ *  that Load() can read back.
+ ***********************************************************/
+bool CameraPath::Save(const std::string& filename) const
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		return(false);
+	}
+
+	file << "# time position.x position.y position.z front.x front.y front.z\n";
+	for (const CAMERA_KEY& key : m_keys)
+	{
+		file << key.time << " "
+			<< key.position.x << " " << key.position.y << " " << key.position.z << " "
+			<< key.front.x << " " << key.front.y << " " << key.front.z << "\n";
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  Sample()
+ *
+ *  This method is used for getting the pose at the passed in
+ *  time. The position and direction are blended between the
+ *  keys on either side of the time, and the time wraps
+ *  around once it passes the end of the path.
+ ***********************************************************/
+void CameraPath::Sample(float time, glm::vec3& position, glm::vec3& front) const
+{
+	if (m_keys.empty())
+	{
+		return;
+	}
+
+	float duration = GetDuration();
+	if (duration > 0.0f)
+	{
+		time = std::fmod(time, duration);
+	}
+
+	// find the first key after the time
+	int next = (int)(std::upper_bound(m_keys.begin(), m_keys.end(), time,
+		[](float value, const CAMERA_KEY& key)
+		{
+			return(value < key.time);
+		}) - m_keys.begin());
+
+	if (next == 0)
+	{
+		position = m_keys.front().position;
+		front = m_keys.front().front;
+		return;
+	}
+	if (next == (int)m_keys.size())
+	{
+		position = m_keys.back().position;
+		front = m_keys.back().front;
+		return;
+	}
+
+	const CAMERA_KEY& previousKey = m_keys[next - 1];
+	const CAMERA_KEY& nextKey = m_keys[next];
+	float blend = (time - previousKey.time) / (nextKey.time - previousKey.time);
+
+	position = glm::mix(previousKey.position, nextKey.position, blend);
+	front = glm::normalize(glm::mix(previousKey.front, nextKey.front, blend));
+}
+
+/***********************************************************
+ *  GetDuration()
+ *
+ *  This method is used for getting the time of the last pose.
+ ***********************************************************/
+float CameraPath::GetDuration() const
+{
+	if (m_keys.empty())
+	{
+		return(0.0f);
+	}
+	return(m_keys.back().time);
+}
+
+/***********************************************************
+ *  IsEmpty()
+ *
+ *  This method is used for checking whether the path has
+ *  no poses.
+ ***********************************************************/
+bool CameraPath::IsEmpty() const
+{
+	return(m_keys.empty());
+}
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.h
+// ============
+// record and replay timed camera positions for repeatable runs
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  CameraPath
+ *
+ *  This class holds a list of timed camera poses, each a
+ *  position and a viewing direction. A path is recorded from
+ *  the interactive camera or generated as an orbit, saved to
+ *  and loaded from a text file with one pose per line, and
+ *  replayed by sampling it at any time, so the same path can
+ *  be flown again frame for frame.
+ ***********************************************************/
+class CameraPath
+{
+public:
+	// a camera pose at a point in time along the path
+	struct CAMERA_KEY
+	{
+		float time;
+		glm::vec3 position;
+		glm::vec3 front;
+	};
+
+	// add a pose to the end of the path, the times must increase
+	void AddKey(float time, const glm::vec3& position, const glm::vec3& front);
+	// replace the path with a circle around a point, looking at it
+	void MakeOrbit(
+		const glm::vec3& center,
+		float radius,
+		float height,
+		float duration,
+		int keyCount);
+	// remove every pose
+	void Clear();
+
+	// read a path from a text file, false if it has no valid poses
+	bool Load(const std::string& filename);
+	// write the path to a text file
+	bool Save(const std::string& filename) const;
+
+	// get the pose at the passed in time, blended between the two
+	// nearest keys, the path repeats once the time passes its end
+	void Sample(float time, glm::vec3& position, glm::vec3& front) const;
+	// get the time of the last pose
+	float GetDuration() const;
+	// whether the path has no poses
+	bool IsEmpty() const;
+
+private:
+	std::vector<CAMERA_KEY> m_keys;
+};
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+// cullingbenchmark.cpp
+// ============
+// compare linear frustum culling with culling through the scene BVH
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CullingBenchmark.h"
+#include "Frustum.h"
+#include "SceneBVH.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// declaration of the benchmark settings
+namespace
+{
+	// the generated objects are spread over a square area of
+	// this size around the camera, on a band of heights
+	const float SCENE_HALF_WIDTH = 500.0f;
+	const float SCENE_HALF_HEIGHT = 20.0f;
+
+	// number of times each culling method runs per scene size
+	const int CULL_REPEATS = 100;
+
+	// the same view settings ViewManager uses for perspective
+	const float FIELD_OF_VIEW = 80.0f;
+	const float ASPECT_RATIO = 1000.0f / 800.0f;
+
+	typedef std::chrono::high_resolution_clock BenchmarkClock;
+
+	/***********************************************************
+	 *  ElapsedMilliseconds()
+	 *
+	 *  Get the milliseconds passed since the passed in time.
+	 ***********************************************************/
+	double ElapsedMilliseconds(BenchmarkClock::time_point start)
+	{
+		return(std::chrono::duration<double, std::milli>(BenchmarkClock::now() - start).count());
+	}
+
+	/***********************************************************
+	 *  BenchmarkSceneSize()
+	 *
+	 *  Generate a scene of the passed in size, then time the
+	 *  linear culling, the BVH build, the BVH culling and the
+	 *  refit of one percent of the objects.
+	 ***********************************************************/
+	void BenchmarkSceneSize(int objectCount, const Frustum& frustum)
+	{
+		// a fixed seed keeps the scene the same from run to run
+		std::mt19937 generator(330);
+		std::uniform_real_distribution<float> across(-SCENE_HALF_WIDTH, SCENE_HALF_WIDTH);
+		std::uniform_real_distribution<float> height(-SCENE_HALF_HEIGHT, SCENE_HALF_HEIGHT);
+		std::uniform_real_distribution<float> size(0.25f, 4.0f);
+
+		std::vector<BOUNDING_VOLUME> bounds(objectCount);
+		for (int i = 0; i < objectCount; i++)
+		{
+			glm::vec3 center = glm::vec3(across(generator), height(generator), across(generator));
+			glm::vec3 extents = glm::vec3(size(generator), size(generator), size(generator));
+			bounds[i] = Frustum::MakeBounds(center - extents, center + extents);
+		}
+
+		// linear culling tests every object
+		int linearVisible = 0;
+		BenchmarkClock::time_point start = BenchmarkClock::now();
+		for (int repeat = 0; repeat < CULL_REPEATS; repeat++)
+		{
+			linearVisible = 0;
+			for (int i = 0; i < objectCount; i++)
+			{
+				if (frustum.IsVisible(bounds[i]))
+				{
+					linearVisible++;
+				}
+			}
+		}
+		double linearTime = ElapsedMilliseconds(start) / CULL_REPEATS;
+
+		SceneBVH sceneBVH;
+		start = BenchmarkClock::now();
+		sceneBVH.Build(bounds);
+		double buildTime = ElapsedMilliseconds(start);
+
+		// BVH culling skips and accepts whole branches
+		std::vector<int> visibleItems;
+		visibleItems.reserve(objectCount);
+		start = BenchmarkClock::now();
+		for (int repeat = 0; repeat < CULL_REPEATS; repeat++)
+		{
+			visibleItems.clear();
+			sceneBVH.Cull(frustum, visibleItems);
+		}
+		double bvhTime = ElapsedMilliseconds(start) / CULL_REPEATS;
+
+		// move one percent of the objects and refit the tree
+		int refitCount = glm::max(1, objectCount / 100);
+		start = BenchmarkClock::now();
+		for (int i = 0; i < refitCount; i++)
+		{
+			int item = (int)(generator() % objectCount);
+			BOUNDING_VOLUME moved = bounds[item];
+			moved.center += glm::vec3(1.0f, 0.0f, 1.0f);
+			sceneBVH.Refit(item, moved);
+		}
+		double refitTime = ElapsedMilliseconds(start);
+
+		std::cout << objectCount << " objects, " << linearVisible << " visible" << std::endl;
+		std::cout << "  linear cull: " << linearTime << " ms" << std::endl;
+		std::cout << "  BVH cull:    " << bvhTime << " ms (" << visibleItems.size() << " visible)" << std::endl;
+		std::cout << "  BVH build:   " << buildTime << " ms" << std::endl;
+		std::cout << "  BVH refit:   " << refitTime << " ms for " << refitCount << " objects" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  RunCullingBenchmark()
+ *
+ *  This function is used for comparing linear culling with
+ *  BVH culling at 1k, 10k and 100k objects, viewed from the
+ *  default camera of the scene.
+ ***********************************************************/
+void RunCullingBenchmark()
+{
+	const glm::vec3 cameraPosition = glm::vec3(0.0f, 5.0f, 12.0f);
+	const glm::vec3 cameraFront = glm::normalize(glm::vec3(0.0f, -0.5f, -2.0f));
+
+	glm::mat4 projection = glm::perspective(glm::radians(FIELD_OF_VIEW), ASPECT_RATIO, 0.1f, 100.0f);
+	glm::mat4 view = glm::lookAt(cameraPosition, cameraPosition + cameraFront, glm::vec3(0.0f, 1.0f, 0.0f));
+
+	Frustum frustum;
+	frustum.SetViewProjection(projection * view);
+
+	const int objectCounts[3] = { 1000, 10000, 100000 };
+	for (int i = 0; i < 3; i++)
+	{
+		BenchmarkSceneSize(objectCounts[i], frustum);
+	}
+}
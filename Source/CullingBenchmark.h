@@ -0,0 +1,14 @@
+///////////////////////////////////////////////////////////////////////////////
+// cullingbenchmark.h
+// ============
+// compare linear frustum culling with culling through the scene BVH
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// time linear and BVH culling over generated scenes of 1k, 10k and
+// 100k objects and print the results, no OpenGL context is needed
+void RunCullingBenchmark();
@@ -0,0 +1,268 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamictransforms.cpp
+// ============
+// ring of persistently mapped model matrices for the dynamic scene objects
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DynamicTransforms.h"
+
+#include <cstring>
+#include <iostream>
+
+// declaration of the ring settings
+namespace
+{
+	// the ring starts with room for this many slots, and at least
+	// doubles when it grows, so it is rarely made again
+	const int MIN_SLOT_CAPACITY = 64;
+
+	// a model matrix is fetched as four texels of four floats
+	const int TEXELS_PER_MATRIX = 4;
+}
+
+/***********************************************************
+ *  DynamicTransforms()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DynamicTransforms::DynamicTransforms()
+{
+	m_pMappedMatrices = NULL;
+	m_slotCapacity = 0;
+	m_region = 0;
+	m_bFrameOpen = false;
+	for (int region = 0; region < REGION_COUNT; region++)
+	{
+		m_regionFences[region] = 0;
+	}
+}
+
+/***********************************************************
+ *  ~DynamicTransforms()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DynamicTransforms::~DynamicTransforms()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking if the ring can be
+ *  used. A buffer that stays mapped while the GPU draws from
+ *  it needs the buffer storage of OpenGL 4.4.
+ ***********************************************************/
+bool DynamicTransforms::IsSupported()
+{
+	return(GLEW_VERSION_4_4 == GL_TRUE);
+}
+
+/***********************************************************
+ *  Reserve()
+ *
+ *  This method is used for making sure every region has room
+ *  for the passed in number of slots. The buffer's storage
+ *  can't be resized, so a ring that is too small is made
+ *  again once the GPU is done with it. False is returned
+ *  when the ring can't be used, or would be larger than a
+ *  buffer texture can be, and the dynamic objects are then
+ *  uploaded with the other instances instead.
+ ***********************************************************/
+bool DynamicTransforms::Reserve(int slotCount)
+{
+	if (!IsSupported())
+	{
+		return(false);
+	}
+	if (IsReady() && (slotCount <= m_slotCapacity))
+	{
+		return(true);
+	}
+
+	int slotCapacity = glm::max(glm::max(slotCount, m_slotCapacity * 2), MIN_SLOT_CAPACITY);
+
+	GLint maxTexels = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+	if ((GLint64)slotCapacity * TEXELS_PER_MATRIX * REGION_COUNT > (GLint64)maxTexels)
+	{
+		slotCapacity = maxTexels / (TEXELS_PER_MATRIX * REGION_COUNT);
+		if (slotCapacity < slotCount)
+		{
+			std::cout << "Too many dynamic objects for the transform ring, they are uploaded instead" << std::endl;
+			Destroy();
+			return(false);
+		}
+	}
+
+	Destroy();
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	GLsizeiptr size = (GLsizeiptr)slotCapacity * REGION_COUNT * sizeof(glm::mat4);
+
+	m_buffer.Create();
+	glBindBuffer(GL_TEXTURE_BUFFER, m_buffer.Get());
+	glBufferStorage(GL_TEXTURE_BUFFER, size, NULL, flags);
+	m_pMappedMatrices = (glm::mat4*)glMapBufferRange(GL_TEXTURE_BUFFER, 0, size, flags);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	if (m_pMappedMatrices == NULL)
+	{
+		std::cout << "Could not map the dynamic transform ring" << std::endl;
+		m_buffer.Reset();
+		return(false);
+	}
+	m_buffer.SetMemorySize(size);
+
+	m_bufferTexture.Create();
+	glBindTexture(GL_TEXTURE_BUFFER, m_bufferTexture.Get());
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_buffer.Get());
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+	m_slotCapacity = slotCapacity;
+	m_region = 0;
+	return(true);
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking if the ring was created
+ *  and is mapped.
+ ***********************************************************/
+bool DynamicTransforms::IsReady() const
+{
+	return(NULL != m_pMappedMatrices);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for moving on to the next region of
+ *  the ring. The GPU may still be drawing a frame from it,
+ *  so its fence is waited on first, which only blocks when
+ *  the CPU has run more than two frames ahead.
+ ***********************************************************/
+void DynamicTransforms::BeginFrame()
+{
+	if (!IsReady() || m_bFrameOpen)
+	{
+		return;
+	}
+
+	m_region = (m_region + 1) % REGION_COUNT;
+	WaitForRegion(m_region);
+	m_bFrameOpen = true;
+}
+
+/***********************************************************
+ *  SetModelMatrix()
+ *
+ *  This method is used for writing the model matrix of the
+ *  passed in slot into the region of the current frame. The
+ *  mapping is coherent, so the write is seen by the draws
+ *  issued after it without any flush.
+ ***********************************************************/
+void DynamicTransforms::SetModelMatrix(int slot, const glm::mat4& model)
+{
+	if (!m_bFrameOpen || (slot < 0) || (slot >= m_slotCapacity))
+	{
+		return;
+	}
+
+	memcpy(&m_pMappedMatrices[m_region * m_slotCapacity + slot], &model, sizeof(glm::mat4));
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for fencing the region of the current
+ *  frame, after every draw that reads it has been issued.
+ ***********************************************************/
+void DynamicTransforms::EndFrame()
+{
+	if (!m_bFrameOpen)
+	{
+		return;
+	}
+
+	m_regionFences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_bFrameOpen = false;
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the buffer texture to the
+ *  passed in texture unit, and telling the vertex shader the
+ *  first texel of the current region.
+ ***********************************************************/
+void DynamicTransforms::Bind(int unit, const UniformCache* pUniformCache) const
+{
+	if (!IsReady() || (NULL == pUniformCache))
+	{
+		return;
+	}
+
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_BUFFER, m_bufferTexture.Get());
+	glActiveTexture(GL_TEXTURE0);
+
+	pUniformCache->setSampler2DValue(pUniformCache->m_locations.dynamicModels, unit);
+	pUniformCache->setIntValue(pUniformCache->m_locations.dynamicModelBase,
+		m_region * m_slotCapacity * TEXELS_PER_MATRIX);
+}
+
+/***********************************************************
+ *  WaitForRegion()
+ *
+ *  This method is used for blocking until the GPU has
+ *  finished the frame that last drew from the passed in
+ *  region, and dropping its fence.
+ ***********************************************************/
+void DynamicTransforms::WaitForRegion(int region)
+{
+	if (m_regionFences[region] == 0)
+	{
+		return;
+	}
+
+	GLenum result = GL_TIMEOUT_EXPIRED;
+	while ((result != GL_ALREADY_SIGNALED) && (result != GL_CONDITION_SATISFIED) && (result != GL_WAIT_FAILED))
+	{
+		result = glClientWaitSync(m_regionFences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+
+	glDeleteSync(m_regionFences[region]);
+	m_regionFences[region] = 0;
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for unmapping and deleting the ring,
+ *  once every region has been let go of by the GPU.
+ ***********************************************************/
+void DynamicTransforms::Destroy()
+{
+	for (int region = 0; region < REGION_COUNT; region++)
+	{
+		WaitForRegion(region);
+	}
+
+	if (m_buffer.Get() != 0)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, m_buffer.Get());
+		glUnmapBuffer(GL_TEXTURE_BUFFER);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+		m_buffer.Reset();
+	}
+	m_bufferTexture.Reset();
+	m_pMappedMatrices = NULL;
+	m_slotCapacity = 0;
+	m_bFrameOpen = false;
+}
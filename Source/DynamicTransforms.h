@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamictransforms.h
+// ============
+// ring of persistently mapped model matrices for the dynamic scene objects
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLResources.h"
+#include "UniformCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  DynamicTransforms
+ *
+ *  This class holds the model matrices of the dynamic scene
+ *  objects in a ring of three regions of one buffer, which
+ *  stays mapped for as long as it lives. Every frame writes
+ *  each dynamic matrix straight into the next region while
+ *  the GPU may still be drawing from the other two, so
+ *  moving objects never upload the instance buffer again or
+ *  wait for the GPU to let go of it. The draws of each frame
+ *  are fenced, and a region only waits on its fence when the
+ *  ring comes back round to it three frames later. The
+ *  vertex shader reads the matrices through a buffer texture
+ *  by the slot each dynamic instance is given.
+ ***********************************************************/
+class DynamicTransforms
+{
+public:
+	// regions of the ring, one is written while the GPU may still
+	// be reading the others
+	static const int REGION_COUNT = 3;
+
+	// constructor
+	DynamicTransforms();
+	// destructor
+	~DynamicTransforms();
+
+	// check if the GL context can keep a buffer mapped while it is
+	// drawn from, which needs OpenGL 4.4
+	static bool IsSupported();
+
+	// make room for the passed in number of slots in every region,
+	// false if the ring can't hold them
+	bool Reserve(int slotCount);
+	// check if the ring was created
+	bool IsReady() const;
+
+	// move on to the next region, waiting for the GPU to finish the
+	// frame that last drew from it
+	void BeginFrame();
+	// write the model matrix of a slot into the current region
+	void SetModelMatrix(int slot, const glm::mat4& model);
+	// fence the current region once the draws reading it are issued
+	void EndFrame();
+
+	// bind the buffer texture to the passed in unit and point the
+	// vertex shader at the current region
+	void Bind(int unit, const UniformCache* pUniformCache) const;
+
+private:
+	GLBuffer m_buffer;
+	// buffer texture the vertex shader fetches the matrices through
+	GLTexture m_bufferTexture;
+	glm::mat4* m_pMappedMatrices;
+	// number of slots in each region
+	int m_slotCapacity;
+	// region written by the current frame
+	int m_region;
+	bool m_bFrameOpen;
+	// fence set after the last frame that drew from each region
+	GLsync m_regionFences[REGION_COUNT];
+
+	// wait until the GPU has finished drawing from a region
+	void WaitForRegion(int region);
+	// delete the ring once the GPU is done with every region
+	void Destroy();
+};
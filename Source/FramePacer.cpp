@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.cpp
+// ============
+// choose the present mode, cap the frame rate and limit the frames in flight
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FramePacer.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+// declaration of the pacing settings
+namespace
+{
+	// the last stretch of a capped frame is spun out instead of
+	// slept, since a sleep can overshoot by about a millisecond
+	const double SPIN_TIME = 0.002;
+
+	// how long a single wait on a frame fence may take, in nanoseconds
+	const GLuint64 FENCE_TIMEOUT = 100000000;
+}
+
+/***********************************************************
+ *  FramePacer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePacer::FramePacer()
+{
+	m_bSyncSupported = false;
+	m_nextFrameTime = 0.0;
+
+#ifdef _WIN32
+	// wake sleeping threads on a 1 ms timer instead of the
+	// default 15.6 ms one, so capped frames can sleep accurately
+	timeBeginPeriod(1);
+#endif
+}
+
+/***********************************************************
+ *  ~FramePacer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FramePacer::~FramePacer()
+{
+	ClearFences();
+
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+/***********************************************************
+ *  SetSettings()
+ *
+ *  This method is used for applying the passed in settings.
+ *  The swap interval is set for the present mode, and the
+ *  frame cap starts over from the next frame.
+ ***********************************************************/
+void FramePacer::SetSettings(const FRAME_PACING_SETTINGS& settings)
+{
+	m_settings = settings;
+	m_bSyncSupported = (GLEW_VERSION_3_2 == GL_TRUE) || (GLEW_ARB_sync == GL_TRUE);
+	m_nextFrameTime = 0.0;
+	ClearFences();
+
+	int swapInterval = 1;
+	switch (m_settings.presentMode)
+	{
+	case PRESENT_VSYNC_OFF:
+		swapInterval = 0;
+		break;
+	case PRESENT_VSYNC_ADAPTIVE:
+		// a negative interval lets late frames tear instead of
+		// waiting a whole extra refresh
+		if ((glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE) ||
+			(glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE))
+		{
+			swapInterval = -1;
+		}
+		else
+		{
+			std::cout << "Adaptive vsync is not supported, using vsync on" << std::endl;
+			m_settings.presentMode = PRESENT_VSYNC_ON;
+		}
+		break;
+	default:
+		break;
+	}
+	glfwSwapInterval(swapInterval);
+
+	if ((m_settings.maxFramesInFlight > 0) && !m_bSyncSupported)
+	{
+		std::cout << "Fences are not supported, the frames in flight are not limited" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  GetSettings()
+ *
+ *  This method is used for getting the settings in use.
+ ***********************************************************/
+const FRAME_PACING_SETTINGS& FramePacer::GetSettings() const
+{
+	return(m_settings);
+}
+
+/***********************************************************
+ *  WaitForNextFrame()
+ *
+ *  This method is used for holding the loop until the next
+ *  frame may start. The GPU must first finish the oldest
+ *  frame when too many are in flight, then a capped frame
+ *  rate sleeps until the frame's start time. The start times
+ *  are kept on a fixed schedule, so a frame that starts late
+ *  does not push every later frame back, unless it is more
+ *  than a whole frame late.
+ ***********************************************************/
+void FramePacer::WaitForNextFrame()
+{
+	if (m_bSyncSupported && (m_settings.maxFramesInFlight > 0))
+	{
+		while ((int)m_frameFences.size() >= m_settings.maxFramesInFlight)
+		{
+			GLenum result = GL_TIMEOUT_EXPIRED;
+			while (result == GL_TIMEOUT_EXPIRED)
+			{
+				result = glClientWaitSync(m_frameFences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+			}
+			glDeleteSync(m_frameFences.front());
+			m_frameFences.erase(m_frameFences.begin());
+		}
+	}
+
+	if (m_settings.maxFrameRate > 0.0)
+	{
+		double framePeriod = 1.0 / m_settings.maxFrameRate;
+		double currentTime = glfwGetTime();
+
+		if (m_nextFrameTime > currentTime)
+		{
+			SleepUntil(m_nextFrameTime);
+		}
+		else if ((currentTime - m_nextFrameTime) > framePeriod)
+		{
+			// too far behind to catch up, start the schedule over
+			m_nextFrameTime = currentTime;
+		}
+		m_nextFrameTime += framePeriod;
+	}
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for placing a fence after the frame
+ *  that was just swapped, which signals once the GPU has
+ *  finished drawing it.
+ ***********************************************************/
+void FramePacer::EndFrame()
+{
+	if (m_bSyncSupported && (m_settings.maxFramesInFlight > 0))
+	{
+		m_frameFences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	}
+}
+
+/***********************************************************
+ *  ParsePresentMode()
+ *
+ *  This method is used for reading the passed in present mode
+ *  name, one of off, on or adaptive.
+ ***********************************************************/
+bool FramePacer::ParsePresentMode(const char* name, PRESENT_MODE& presentMode)
+{
+	if (strcmp(name, "off") == 0)
+	{
+		presentMode = PRESENT_VSYNC_OFF;
+	}
+	else if (strcmp(name, "on") == 0)
+	{
+		presentMode = PRESENT_VSYNC_ON;
+	}
+	else if (strcmp(name, "adaptive") == 0)
+	{
+		presentMode = PRESENT_VSYNC_ADAPTIVE;
+	}
+	else
+	{
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  SleepUntil()
+ *
+ *  This method is used for sleeping until the passed in time.
+ *  The thread sleeps in 1 ms steps until the time is close,
+ *  then yields until it arrives, trading a little CPU time
+ *  for a wake up that lands within a fraction of a ms.
+ ***********************************************************/
+void FramePacer::SleepUntil(double wakeTime)
+{
+	while ((wakeTime - glfwGetTime()) > SPIN_TIME)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	while (glfwGetTime() < wakeTime)
+	{
+		std::this_thread::yield();
+	}
+}
+
+/***********************************************************
+ *  ClearFences()
+ *
+ *  This method is used for deleting the fences of the frames
+ *  still in flight.
+ ***********************************************************/
+void FramePacer::ClearFences()
+{
+	for (GLsync fence : m_frameFences)
+	{
+		glDeleteSync(fence);
+	}
+	m_frameFences.clear();
+}
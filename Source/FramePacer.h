@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.h
+// ============
+// choose the present mode, cap the frame rate and limit the frames in flight
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include "GLFW/glfw3.h"
+
+#include <vector>
+
+// how swapped frames are lined up with the display refresh
+enum PRESENT_MODE
+{
+	// frames are shown as soon as they are swapped, which can tear
+	PRESENT_VSYNC_OFF,
+	// frames wait for the next refresh
+	PRESENT_VSYNC_ON,
+	// frames wait for the next refresh unless they are late, then
+	// they are shown right away, falls back to vsync on
+	PRESENT_VSYNC_ADAPTIVE
+};
+
+// the frame pacing chosen on the command line
+struct FRAME_PACING_SETTINGS
+{
+	PRESENT_MODE presentMode = PRESENT_VSYNC_ON;
+	// frames per second the loop is held to, 0 for no cap
+	double maxFrameRate = 0.0;
+	// frames the CPU may queue ahead of the GPU, 0 for no limit
+	int maxFramesInFlight = 2;
+};
+
+/***********************************************************
+ *  FramePacer
+ *
+ *  This class paces the main loop. It sets the swap interval
+ *  for the chosen present mode, sleeps out the rest of each
+ *  frame when the frame rate is capped, and places a fence
+ *  after each swap so the CPU never runs more than a set
+ *  number of frames ahead of the GPU. Fewer frames in flight
+ *  cut input latency, and a low cap saves power.
+ ***********************************************************/
+class FramePacer
+{
+public:
+	// constructor
+	FramePacer();
+	// destructor
+	~FramePacer();
+
+	// apply the passed in settings, the GL context must be current
+	void SetSettings(const FRAME_PACING_SETTINGS& settings);
+	// get the settings in use
+	const FRAME_PACING_SETTINGS& GetSettings() const;
+
+	// wait until the next frame may start, called before the
+	// input is read so the frame works from the freshest input
+	void WaitForNextFrame();
+	// mark the end of a frame, called right after the swap
+	void EndFrame();
+
+	// read a present mode name, false if it is not one
+	static bool ParsePresentMode(const char* name, PRESENT_MODE& presentMode);
+
+private:
+	FRAME_PACING_SETTINGS m_settings;
+	// whether fences can be placed, they need OpenGL 3.2 or ARB_sync
+	bool m_bSyncSupported;
+	// fences placed after the frames still in flight, oldest first
+	std::vector<GLsync> m_frameFences;
+	// time the next frame may start at when the rate is capped
+	double m_nextFrameTime;
+
+	// sleep until the passed in time, finishing with a short spin
+	// so the wake up lands close to it
+	static void SleepUntil(double wakeTime);
+	// delete every fence still in flight
+	void ClearFences();
+};
@@ -0,0 +1,708 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.cpp
+// ============
+// time the phases of every frame on the CPU and the GPU
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// declaration of the profiler settings
+namespace
+{
+	// the scope every frame is timed as
+	const char* const FRAME_SCOPE_NAME = "Frame";
+
+	// seconds between updates of the overlay
+	const double OVERLAY_INTERVAL = 0.5;
+}
+
+/***********************************************************
+ *  FrameProfiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameProfiler::FrameProfiler()
+{
+	m_bGpuTimingSupported = false;
+	m_startTime = ProfileClock::now();
+	m_gpuTimeOffset = 0.0;
+	m_frameIndex = 0;
+	m_bFrameOpen = false;
+	m_openDepth = 0;
+	m_lastRenderStats = RENDER_STATS();
+	m_bRecording = false;
+	m_lastOverlayTime = 0.0;
+
+	for (int i = 0; i < PENDING_FRAMES; i++)
+	{
+		m_pendingFrames[i].frameIndex = -1;
+		m_pendingFrames[i].renderStats = RENDER_STATS();
+	}
+}
+
+/***********************************************************
+ *  ~FrameProfiler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameProfiler::~FrameProfiler()
+{
+	for (FRAME_RECORD& frame : m_pendingFrames)
+	{
+		for (SCOPE_EVENT& event : frame.events)
+		{
+			if (event.startQuery != 0)
+			{
+				m_freeQueries.push_back(event.startQuery);
+			}
+			if (event.endQuery != 0)
+			{
+				m_freeQueries.push_back(event.endQuery);
+			}
+		}
+		frame.events.clear();
+	}
+
+	if (!m_freeQueries.empty())
+	{
+		glDeleteQueries((GLsizei)m_freeQueries.size(), m_freeQueries.data());
+		m_freeQueries.clear();
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting to time a frame. The
+ *  slot the frame is timed in last held the frame from a
+ *  few frames back, whose queries are read back first.
+ ***********************************************************/
+void FrameProfiler::BeginFrame()
+{
+	if (m_bFrameOpen)
+	{
+		return;
+	}
+
+	if (m_frameIndex == 0)
+	{
+		// timestamp queries need OpenGL 3.3 or ARB_timer_query
+		m_bGpuTimingSupported = (GLEW_VERSION_3_3 == GL_TRUE) || (GLEW_ARB_timer_query == GL_TRUE);
+		if (m_bGpuTimingSupported)
+		{
+			GLint64 gpuTime = 0;
+			glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+			m_gpuTimeOffset = gpuTime / 1000000.0 - GetCpuTime();
+		}
+	}
+
+	FRAME_RECORD& frame = m_pendingFrames[m_frameIndex % PENDING_FRAMES];
+	if (frame.frameIndex >= 0)
+	{
+		ResolveFrame(frame);
+	}
+	frame.frameIndex = m_frameIndex;
+	frame.events.clear();
+
+	m_bFrameOpen = true;
+	m_openDepth = 0;
+	BeginScope(FRAME_SCOPE_NAME);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for finishing the timing of a frame,
+ *  keeping the passed in draw counters of its scene.
+ ***********************************************************/
+void FrameProfiler::EndFrame(const RENDER_STATS& renderStats)
+{
+	if (!m_bFrameOpen)
+	{
+		return;
+	}
+
+	// the frame itself is always the first scope of the frame
+	EndScope(0);
+
+	FRAME_RECORD& frame = m_pendingFrames[m_frameIndex % PENDING_FRAMES];
+	frame.renderStats = renderStats;
+	m_lastRenderStats = renderStats;
+
+	m_bFrameOpen = false;
+	m_frameIndex++;
+}
+
+/***********************************************************
+ *  BeginScope()
+ *
+ *  This method is used for starting to time a named scope of
+ *  the current frame. A timestamp query is issued, which the
+ *  GPU writes once it has finished every earlier command.
+ ***********************************************************/
+int FrameProfiler::BeginScope(const char* name)
+{
+	if (!m_bFrameOpen)
+	{
+		return(-1);
+	}
+
+	FRAME_RECORD& frame = m_pendingFrames[m_frameIndex % PENDING_FRAMES];
+
+	SCOPE_EVENT event;
+	event.scopeIndex = FindScope(name);
+	event.depth = m_openDepth;
+	event.cpuStart = GetCpuTime();
+	event.cpuEnd = event.cpuStart;
+	event.startQuery = 0;
+	event.endQuery = 0;
+	event.gpuStart = 0.0;
+	event.gpuEnd = 0.0;
+	event.bGpuValid = false;
+
+	if (m_bGpuTimingSupported)
+	{
+		event.startQuery = AcquireQuery();
+		glQueryCounter(event.startQuery, GL_TIMESTAMP);
+	}
+
+	frame.events.push_back(event);
+	m_openDepth++;
+
+	return((int)frame.events.size() - 1);
+}
+
+/***********************************************************
+ *  EndScope()
+ *
+ *  This method is used for finishing the timing of a scope
+ *  of the current frame. Scopes nest, since each timestamp
+ *  stands on its own instead of opening a query.
+ ***********************************************************/
+void FrameProfiler::EndScope(int scope)
+{
+	FRAME_RECORD& frame = m_pendingFrames[m_frameIndex % PENDING_FRAMES];
+	if (!m_bFrameOpen || (scope < 0) || (scope >= (int)frame.events.size()))
+	{
+		return;
+	}
+
+	SCOPE_EVENT& event = frame.events[scope];
+	event.cpuEnd = GetCpuTime();
+
+	if (m_bGpuTimingSupported)
+	{
+		event.endQuery = AcquireQuery();
+		glQueryCounter(event.endQuery, GL_TIMESTAMP);
+	}
+
+	m_openDepth--;
+}
+
+/***********************************************************
+ *  GetScopeStats()
+ *
+ *  This method is used for getting the rolling statistics of
+ *  the CPU or GPU times of the named scope, added up per
+ *  frame when the scope is timed more than once in a frame.
+ ***********************************************************/
+bool FrameProfiler::GetScopeStats(const char* name, bool bGpuTime, PROFILE_STATS& stats) const
+{
+	for (const SCOPE_HISTORY& scope : m_scopes)
+	{
+		if (strcmp(scope.name, name) == 0)
+		{
+			ComputeStats(bGpuTime ? scope.gpuSamples : scope.cpuSamples, stats);
+			return(stats.sampleCount > 0);
+		}
+	}
+
+	stats = PROFILE_STATS();
+	return(false);
+}
+
+/***********************************************************
+ *  UpdateOverlay()
+ *
+ *  This method is used for showing the frame timings and the
+ *  draw counters of the last frame after the passed in title
+ *  of the window. The title is only set twice a second, so
+ *  the numbers can be read and the window system is not
+ *  asked to redraw the title every frame.
+ ***********************************************************/
+void FrameProfiler::UpdateOverlay(GLFWwindow* window, const char* windowTitle)
+{
+	double currentTime = glfwGetTime();
+	if ((currentTime - m_lastOverlayTime) < OVERLAY_INTERVAL)
+	{
+		return;
+	}
+	m_lastOverlayTime = currentTime;
+
+	PROFILE_STATS cpuStats;
+	PROFILE_STATS gpuStats;
+	GetScopeStats(FRAME_SCOPE_NAME, false, cpuStats);
+	GetScopeStats(FRAME_SCOPE_NAME, true, gpuStats);
+
+	std::ostringstream title;
+	title << std::fixed << std::setprecision(2) << windowTitle
+		<< " | CPU " << cpuStats.average << " ms (p95 " << cpuStats.p95 << ", p99 " << cpuStats.p99 << ")";
+	if (m_bGpuTimingSupported)
+	{
+		title << " | GPU " << gpuStats.average << " ms (p95 " << gpuStats.p95 << ")";
+	}
+	title << " | " << m_lastRenderStats.drawCalls << " draws, "
+		<< m_lastRenderStats.stateChanges << " state changes ("
+		<< m_lastRenderStats.stateChangesSkipped << " skipped), "
+		<< m_lastRenderStats.trianglesDrawn << " triangles";
+
+	glfwSetWindowTitle(window, title.str().c_str());
+}
+
+/***********************************************************
+ *  Flush()
+ *
+ *  This method is used for reading back the frames that are
+ *  still waiting on their queries, oldest first. The GPU is
+ *  made to finish every command first, so all of the results
+ *  are available. Meant for the end of a run, since it
+ *  stalls the pipeline.
+ ***********************************************************/
+void FrameProfiler::Flush()
+{
+	if (m_bFrameOpen)
+	{
+		return;
+	}
+
+	glFinish();
+
+	for (int frameIndex = m_frameIndex - PENDING_FRAMES; frameIndex < m_frameIndex; frameIndex++)
+	{
+		if (frameIndex < 0)
+		{
+			continue;
+		}
+
+		FRAME_RECORD& frame = m_pendingFrames[frameIndex % PENDING_FRAMES];
+		if (frame.frameIndex == frameIndex)
+		{
+			ResolveFrame(frame);
+			frame.frameIndex = -1;
+			frame.events.clear();
+		}
+	}
+}
+
+/***********************************************************
+ *  GetScopeCount()
+ *
+ *  This method is used for getting the number of scopes that
+ *  have been timed so far.
+ ***********************************************************/
+int FrameProfiler::GetScopeCount() const
+{
+	return((int)m_scopes.size());
+}
+
+/***********************************************************
+ *  GetScopeName()
+ *
+ *  This method is used for getting the name of a timed scope,
+ *  in the order they were first timed.
+ ***********************************************************/
+const char* FrameProfiler::GetScopeName(int scope) const
+{
+	if ((scope < 0) || (scope >= (int)m_scopes.size()))
+	{
+		return("");
+	}
+	return(m_scopes[scope].name);
+}
+
+/***********************************************************
+ *  SetRecording()
+ *
+ *  This method is used for turning the recording of frames
+ *  for the dumps on or off. Recording stops by itself once
+ *  MAX_RECORDED_FRAMES frames are kept.
+ ***********************************************************/
+void FrameProfiler::SetRecording(bool bRecording)
+{
+	m_bRecording = bRecording;
+}
+
+/***********************************************************
+ *  ClearRecording()
+ *
+ *  This method is used for forgetting the recorded frames,
+ *  such as the warm up frames of a measured run.
+ ***********************************************************/
+void FrameProfiler::ClearRecording()
+{
+	m_recordedFrames.clear();
+}
+
+/***********************************************************
+ *  GetRecordedStats()
+ *
+ *  This method is used for getting the statistics of the
+ *  CPU or GPU times of the named scope over every recorded
+ *  frame, rather than the rolling history. Frames whose GPU
+ *  times could not be read are left out of the GPU times.
+ ***********************************************************/
+bool FrameProfiler::GetRecordedStats(const char* name, bool bGpuTime, PROFILE_STATS& stats) const
+{
+	int scopeIndex = -1;
+	for (int i = 0; i < (int)m_scopes.size(); i++)
+	{
+		if (strcmp(m_scopes[i].name, name) == 0)
+		{
+			scopeIndex = i;
+			break;
+		}
+	}
+
+	std::vector<float> samples;
+	if (scopeIndex >= 0)
+	{
+		samples.reserve(m_recordedFrames.size());
+		for (const FRAME_RECORD& frame : m_recordedFrames)
+		{
+			double total = 0.0;
+			bool bTimed = false;
+			for (const SCOPE_EVENT& event : frame.events)
+			{
+				if (event.scopeIndex != scopeIndex)
+				{
+					continue;
+				}
+				if (bGpuTime && !event.bGpuValid)
+				{
+					continue;
+				}
+				total += bGpuTime ? (event.gpuEnd - event.gpuStart) : (event.cpuEnd - event.cpuStart);
+				bTimed = true;
+			}
+			if (bTimed)
+			{
+				samples.push_back((float)total);
+			}
+		}
+	}
+
+	ComputeStats(samples, stats);
+	return(stats.sampleCount > 0);
+}
+
+/***********************************************************
+ *  WriteCSV()
+ *
+ *  This method is used for writing every recorded frame to
+ *  the passed in file, one row per timed scope, with the draw
+ *  counters of the frame on each row.
+ ***********************************************************/
+bool FrameProfiler::WriteCSV(const std::string& filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		return(false);
+	}
+
+	file << "frame,scope,depth,cpu_start_ms,cpu_ms,gpu_ms,draw_calls,indirect_commands,prepass_draw_calls,state_changes,state_changes_skipped,objects_drawn,triangles\n";
+	file << std::fixed << std::setprecision(4);
+
+	for (const FRAME_RECORD& frame : m_recordedFrames)
+	{
+		for (const SCOPE_EVENT& event : frame.events)
+		{
+			file << frame.frameIndex << ","
+				<< m_scopes[event.scopeIndex].name << ","
+				<< event.depth << ","
+				<< event.cpuStart << ","
+				<< (event.cpuEnd - event.cpuStart) << ",";
+			if (event.bGpuValid)
+			{
+				file << (event.gpuEnd - event.gpuStart);
+			}
+			file << "," << frame.renderStats.drawCalls
+				<< "," << frame.renderStats.indirectCommands
+				<< "," << frame.renderStats.prePassDrawCalls
+				<< "," << frame.renderStats.stateChanges
+				<< "," << frame.renderStats.stateChangesSkipped
+				<< "," << frame.renderStats.objectsDrawn
+				<< "," << frame.renderStats.trianglesDrawn << "\n";
+		}
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used for writing every recorded frame to
+ *  the passed in file in the trace event format read by
+ *  chrome://tracing and Perfetto. The CPU and GPU times are
+ *  shown as two threads on the same timeline.
+ ***********************************************************/
+bool FrameProfiler::WriteChromeTrace(const std::string& filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		return(false);
+	}
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+	for (const FRAME_RECORD& frame : m_recordedFrames)
+	{
+		for (const SCOPE_EVENT& event : frame.events)
+		{
+			const char* name = m_scopes[event.scopeIndex].name;
+
+			// the trace times are in microseconds
+			file << ",\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+				<< ",\"ts\":" << event.cpuStart * 1000.0
+				<< ",\"dur\":" << (event.cpuEnd - event.cpuStart) * 1000.0
+				<< ",\"args\":{\"frame\":" << frame.frameIndex << "}}";
+
+			if (event.bGpuValid)
+			{
+				file << ",\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":2"
+					<< ",\"ts\":" << event.gpuStart * 1000.0
+					<< ",\"dur\":" << (event.gpuEnd - event.gpuStart) * 1000.0
+					<< ",\"args\":{\"frame\":" << frame.frameIndex << "}}";
+			}
+		}
+	}
+
+	file << "\n]}\n";
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  GetCpuTime()
+ *
+ *  This method is used for getting the time since the
+ *  profiler was created, in milliseconds.
+ ***********************************************************/
+double FrameProfiler::GetCpuTime() const
+{
+	return(std::chrono::duration<double, std::milli>(ProfileClock::now() - m_startTime).count());
+}
+
+/***********************************************************
+ *  FindScope()
+ *
+ *  This method is used for finding the history of the named
+ *  scope, adding one the first time the name is timed. The
+ *  pointer is checked before the string, since most names
+ *  are the same string literal every frame.
+ ***********************************************************/
+int FrameProfiler::FindScope(const char* name)
+{
+	for (int i = 0; i < (int)m_scopes.size(); i++)
+	{
+		if ((m_scopes[i].name == name) || (strcmp(m_scopes[i].name, name) == 0))
+		{
+			return(i);
+		}
+	}
+
+	SCOPE_HISTORY scope;
+	scope.name = name;
+	scope.nextCpuSample = 0;
+	scope.nextGpuSample = 0;
+	m_scopes.push_back(scope);
+
+	return((int)m_scopes.size() - 1);
+}
+
+/***********************************************************
+ *  AcquireQuery()
+ *
+ *  This method is used for getting a query name from the
+ *  pool, creating a new one when the pool is empty.
+ ***********************************************************/
+GLuint FrameProfiler::AcquireQuery()
+{
+	GLuint query = 0;
+	if (!m_freeQueries.empty())
+	{
+		query = m_freeQueries.back();
+		m_freeQueries.pop_back();
+	}
+	else
+	{
+		glGenQueries(1, &query);
+	}
+	return(query);
+}
+
+/***********************************************************
+ *  ResolveFrame()
+ *
+ *  This method is used for reading back the timestamps of a
+ *  finished frame and adding its times to the statistics.
+ *  The last timestamp of the frame is checked first, if the
+ *  GPU has not reached it yet the GPU times of the frame are
+ *  dropped rather than waited for. The queries go back into
+ *  the pool either way.
+ ***********************************************************/
+void FrameProfiler::ResolveFrame(FRAME_RECORD& frame)
+{
+	bool bAvailable = false;
+	if (m_bGpuTimingSupported && !frame.events.empty() && (frame.events[0].endQuery != 0))
+	{
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(frame.events[0].endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+		bAvailable = (available == GL_TRUE);
+	}
+
+	// the times of a scope timed more than once are added up
+	std::vector<float> cpuTimes(m_scopes.size(), 0.0f);
+	std::vector<float> gpuTimes(m_scopes.size(), 0.0f);
+	std::vector<bool> bTimed(m_scopes.size(), false);
+
+	for (SCOPE_EVENT& event : frame.events)
+	{
+		if (bAvailable && (event.startQuery != 0) && (event.endQuery != 0))
+		{
+			GLuint64 startTime = 0;
+			GLuint64 endTime = 0;
+			glGetQueryObjectui64v(event.startQuery, GL_QUERY_RESULT, &startTime);
+			glGetQueryObjectui64v(event.endQuery, GL_QUERY_RESULT, &endTime);
+			event.gpuStart = startTime / 1000000.0 - m_gpuTimeOffset;
+			event.gpuEnd = endTime / 1000000.0 - m_gpuTimeOffset;
+			event.bGpuValid = true;
+		}
+
+		if (event.startQuery != 0)
+		{
+			m_freeQueries.push_back(event.startQuery);
+			event.startQuery = 0;
+		}
+		if (event.endQuery != 0)
+		{
+			m_freeQueries.push_back(event.endQuery);
+			event.endQuery = 0;
+		}
+
+		cpuTimes[event.scopeIndex] += (float)(event.cpuEnd - event.cpuStart);
+		gpuTimes[event.scopeIndex] += (float)(event.gpuEnd - event.gpuStart);
+		bTimed[event.scopeIndex] = true;
+	}
+
+	for (int i = 0; i < (int)m_scopes.size(); i++)
+	{
+		if (bTimed[i])
+		{
+			AddSample(m_scopes[i].cpuSamples, m_scopes[i].nextCpuSample, cpuTimes[i]);
+			if (bAvailable)
+			{
+				AddSample(m_scopes[i].gpuSamples, m_scopes[i].nextGpuSample, gpuTimes[i]);
+			}
+		}
+	}
+
+	if (m_bRecording && (m_recordedFrames.size() < MAX_RECORDED_FRAMES))
+	{
+		m_recordedFrames.push_back(frame);
+	}
+}
+
+/***********************************************************
+ *  AddSample()
+ *
+ *  This method is used for adding a sample to a history of
+ *  HISTORY_FRAMES samples, replacing the oldest sample once
+ *  the history is full.
+ ***********************************************************/
+void FrameProfiler::AddSample(std::vector<float>& samples, int& nextSample, float value)
+{
+	if (samples.size() < HISTORY_FRAMES)
+	{
+		samples.push_back(value);
+	}
+	else
+	{
+		samples[nextSample] = value;
+	}
+	nextSample = (nextSample + 1) % HISTORY_FRAMES;
+}
+
+/***********************************************************
+ *  ComputeStats()
+ *
+ *  This method is used for working out the average, the
+ *  percentiles and the maximum of the passed in samples.
+ ***********************************************************/
+void FrameProfiler::ComputeStats(const std::vector<float>& samples, PROFILE_STATS& stats)
+{
+	stats = PROFILE_STATS();
+	stats.sampleCount = (int)samples.size();
+	if (samples.empty())
+	{
+		return;
+	}
+
+	std::vector<float> sorted = samples;
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0.0;
+	for (float sample : sorted)
+	{
+		total += sample;
+	}
+
+	int last = (int)sorted.size() - 1;
+	stats.average = total / sorted.size();
+	stats.p50 = sorted[(last * 50) / 100];
+	stats.p95 = sorted[(last * 95) / 100];
+	stats.p99 = sorted[(last * 99) / 100];
+	stats.maximum = sorted[last];
+}
+
+/***********************************************************
+ *  ProfileScope()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ProfileScope::ProfileScope(FrameProfiler* pProfiler, const char* name)
+{
+	m_pProfiler = pProfiler;
+	m_scope = -1;
+	if (NULL != m_pProfiler)
+	{
+		m_scope = m_pProfiler->BeginScope(name);
+	}
+}
+
+/***********************************************************
+ *  ~ProfileScope()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ProfileScope::~ProfileScope()
+{
+	if (NULL != m_pProfiler)
+	{
+		m_pProfiler->EndScope(m_scope);
+	}
+}
@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.h
+// ============
+// time the phases of every frame on the CPU and the GPU
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderQueue.h"
+
+#include <GL/glew.h>
+#include "GLFW/glfw3.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// rolling statistics of a timed scope over the recent frames, in ms
+struct PROFILE_STATS
+{
+	int sampleCount;
+	double average;
+	double p50;
+	double p95;
+	double p99;
+	double maximum;
+};
+
+/***********************************************************
+ *  FrameProfiler
+ *
+ *  This class times named scopes of each frame, on the CPU
+ *  with a steady clock and on the GPU with a pair of
+ *  timestamp queries around the commands issued inside the
+ *  scope. The queries are read back a few frames later, once
+ *  the GPU has reached them, so timing never stalls the
+ *  frame. Rolling averages and percentiles of every scope
+ *  are kept along with the draw counters of the scene, and
+ *  can be shown in the window title or dumped to CSV and
+ *  Chrome trace files.
+ ***********************************************************/
+class FrameProfiler
+{
+public:
+	// frames kept for the rolling statistics
+	static const int HISTORY_FRAMES = 240;
+	// frames kept for the CSV and trace dumps
+	static const int MAX_RECORDED_FRAMES = 3600;
+
+	// constructor
+	FrameProfiler();
+	// destructor
+	~FrameProfiler();
+
+	// start timing a frame, the GL context must be current
+	void BeginFrame();
+	// finish timing a frame, with the draw counters of its scene
+	void EndFrame(const RENDER_STATS& renderStats);
+
+	// start timing a named scope, the name must outlive the profiler,
+	// returns the scope to end or -1 when no frame is being timed
+	int BeginScope(const char* name);
+	// finish timing a scope started with BeginScope()
+	void EndScope(int scope);
+
+	// get the rolling statistics of a scope, the frame itself is
+	// the scope named "Frame", false if it has no samples yet
+	bool GetScopeStats(const char* name, bool bGpuTime, PROFILE_STATS& stats) const;
+	// show the frame timings and counters in the window title, at
+	// most twice a second
+	void UpdateOverlay(GLFWwindow* window, const char* windowTitle);
+
+	// read back every frame still waiting on its queries, waiting
+	// for the GPU to finish them
+	void Flush();
+
+	// get the number of scopes timed so far and their names
+	int GetScopeCount() const;
+	const char* GetScopeName(int scope) const;
+
+	// keep every frame timed from now on for the dumps
+	void SetRecording(bool bRecording);
+	// forget the recorded frames
+	void ClearRecording();
+	// get the statistics of a scope over every recorded frame,
+	// false if it has no samples
+	bool GetRecordedStats(const char* name, bool bGpuTime, PROFILE_STATS& stats) const;
+	// write the recorded frames as one CSV row per scope
+	bool WriteCSV(const std::string& filename);
+	// write the recorded frames as a trace for chrome://tracing
+	bool WriteChromeTrace(const std::string& filename);
+
+private:
+	typedef std::chrono::steady_clock ProfileClock;
+
+	// a single timing of a scope within a frame
+	struct SCOPE_EVENT
+	{
+		int scopeIndex;
+		int depth;
+		double cpuStart;
+		double cpuEnd;
+		GLuint startQuery;
+		GLuint endQuery;
+		double gpuStart;
+		double gpuEnd;
+		bool bGpuValid;
+	};
+
+	// the scopes timed in a frame and the counters of its scene
+	struct FRAME_RECORD
+	{
+		int frameIndex;
+		std::vector<SCOPE_EVENT> events;
+		RENDER_STATS renderStats;
+	};
+
+	// the recent samples of a named scope
+	struct SCOPE_HISTORY
+	{
+		const char* name;
+		std::vector<float> cpuSamples;
+		std::vector<float> gpuSamples;
+		int nextCpuSample;
+		int nextGpuSample;
+	};
+
+	// frames waiting on their queries, one slot per frame in flight
+	static const int PENDING_FRAMES = 4;
+
+	bool m_bGpuTimingSupported;
+	ProfileClock::time_point m_startTime;
+	// GPU timestamp taken at the start time, lines the GPU times up
+	// with the CPU ones
+	double m_gpuTimeOffset;
+
+	int m_frameIndex;
+	bool m_bFrameOpen;
+	int m_openDepth;
+	FRAME_RECORD m_pendingFrames[PENDING_FRAMES];
+	// query names ready for reuse
+	std::vector<GLuint> m_freeQueries;
+
+	std::vector<SCOPE_HISTORY> m_scopes;
+	RENDER_STATS m_lastRenderStats;
+
+	bool m_bRecording;
+	std::vector<FRAME_RECORD> m_recordedFrames;
+	double m_lastOverlayTime;
+
+	// get the time since the profiler was created, in ms
+	double GetCpuTime() const;
+	// find the history of a scope by name, adding it when needed
+	int FindScope(const char* name);
+	// get a query name from the pool
+	GLuint AcquireQuery();
+	// read the query results of a finished frame into the
+	// statistics, and keep it if frames are being recorded
+	void ResolveFrame(FRAME_RECORD& frame);
+	// add a sample to a history, replacing the oldest once it is full
+	static void AddSample(std::vector<float>& samples, int& nextSample, float value);
+	// work out the statistics of a set of samples
+	static void ComputeStats(const std::vector<float>& samples, PROFILE_STATS& stats);
+};
+
+/***********************************************************
+ *  ProfileScope
+ *
+ *  This class times the scope it is declared in, ending the
+ *  timing when it goes out of scope. A NULL profiler makes
+ *  it do nothing.
+ ***********************************************************/
+class ProfileScope
+{
+public:
+	// constructor, starts timing the named scope
+	ProfileScope(FrameProfiler* pProfiler, const char* name);
+	// destructor, ends the timing
+	~ProfileScope();
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	FrameProfiler* m_pProfiler;
+	int m_scope;
+};
@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustum.cpp
+// ============
+// bounding volumes and view frustum tests used for culling the scene
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Frustum.h"
+
+#include <cmath>
+
+/***********************************************************
+ *  Frustum()
+ *
+ *  The constructor for the class. The planes start out
+ *  accepting everything until a view projection is set.
+ ***********************************************************/
+Frustum::Frustum()
+{
+	for (int i = 0; i < 6; i++)
+	{
+		m_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+/***********************************************************
+ *  SetViewProjection()
+ *
+ *  This method is used for extracting the six frustum planes
+ *  from the rows of the combined view and projection matrix.
+ *  The planes are normalized so that the plane distances are
+ *  in world units and can be compared with sphere radii.
+ ***********************************************************/
+void Frustum::SetViewProjection(const glm::mat4& viewProjection)
+{
+	// glm matrices are column major, so a row is gathered
+	// from the same component of every column
+	glm::vec4 rows[4];
+	for (int row = 0; row < 4; row++)
+	{
+		rows[row] = glm::vec4(
+			viewProjection[0][row],
+			viewProjection[1][row],
+			viewProjection[2][row],
+			viewProjection[3][row]);
+	}
+
+	m_planes[0] = rows[3] + rows[0]; // left
+	m_planes[1] = rows[3] - rows[0]; // right
+	m_planes[2] = rows[3] + rows[1]; // bottom
+	m_planes[3] = rows[3] - rows[1]; // top
+	m_planes[4] = rows[3] + rows[2]; // near
+	m_planes[5] = rows[3] - rows[2]; // far
+
+	for (int i = 0; i < 6; i++)
+	{
+		float length = glm::length(glm::vec3(m_planes[i]));
+		if (length > 0.0f)
+		{
+			m_planes[i] /= length;
+		}
+	}
+}
+
+/***********************************************************
+ *  IsVisible()
+ *
+ *  This method is used for checking if the bounding volume
+ *  is at least partly inside the frustum. The enclosing
+ *  sphere is tested first, then the box, and the volume is
+ *  culled as soon as it is fully behind any one plane.
+ ***********************************************************/
+bool Frustum::IsVisible(const BOUNDING_VOLUME& bounds) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		const glm::vec3 normal = glm::vec3(m_planes[i]);
+		float distance = glm::dot(normal, bounds.center) + m_planes[i].w;
+
+		// the sphere is fully behind the plane
+		if (distance < -bounds.radius)
+		{
+			return(false);
+		}
+
+		// the box reaches this far along the plane normal
+		float reach = bounds.extents.x * fabs(normal.x) +
+			bounds.extents.y * fabs(normal.y) +
+			bounds.extents.z * fabs(normal.z);
+		if (distance < -reach)
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Classify()
+ *
+ *  This method is used for checking where the bounding box
+ *  lies relative to the frustum. A box that is fully inside
+ *  lets a whole branch of a bounding volume hierarchy be
+ *  accepted without testing anything below it.
+ ***********************************************************/
+FRUSTUM_RESULT Frustum::Classify(const BOUNDING_VOLUME& bounds) const
+{
+	FRUSTUM_RESULT result = FRUSTUM_INSIDE;
+
+	for (int i = 0; i < 6; i++)
+	{
+		const glm::vec3 normal = glm::vec3(m_planes[i]);
+		float distance = glm::dot(normal, bounds.center) + m_planes[i].w;
+		float reach = bounds.extents.x * fabs(normal.x) +
+			bounds.extents.y * fabs(normal.y) +
+			bounds.extents.z * fabs(normal.z);
+
+		if (distance < -reach)
+		{
+			return(FRUSTUM_OUTSIDE);
+		}
+		if (distance < reach)
+		{
+			result = FRUSTUM_INTERSECTING;
+		}
+	}
+
+	return(result);
+}
+
+/***********************************************************
+ *  MakeBounds()
+ *
+ *  This method is used for building a bounding volume from
+ *  the minimum and maximum corners of a box.
+ ***********************************************************/
+BOUNDING_VOLUME Frustum::MakeBounds(const glm::vec3& minimum, const glm::vec3& maximum)
+{
+	BOUNDING_VOLUME bounds;
+	bounds.center = 0.5f * (minimum + maximum);
+	bounds.extents = 0.5f * (maximum - minimum);
+	bounds.radius = glm::length(bounds.extents);
+
+	return(bounds);
+}
+
+/***********************************************************
+ *  MergeBounds()
+ *
+ *  This method is used for building the bounding volume
+ *  that encloses the boxes of both passed in volumes.
+ ***********************************************************/
+BOUNDING_VOLUME Frustum::MergeBounds(const BOUNDING_VOLUME& first, const BOUNDING_VOLUME& second)
+{
+	return(MakeBounds(
+		glm::min(first.center - first.extents, second.center - second.extents),
+		glm::max(first.center + first.extents, second.center + second.extents)));
+}
+
+/***********************************************************
+ *  TransformBounds()
+ *
+ *  This method is used for moving a bounding volume into the
+ *  space of the passed in matrix, such as a model matrix.
+ *  Each new extent is the sum of the old extents projected
+ *  onto that axis, which encloses the rotated box. The sphere
+ *  is scaled by the largest axis scale instead, so it stays
+ *  around the original box and is often the tighter of the two.
+ ***********************************************************/
+BOUNDING_VOLUME Frustum::TransformBounds(const BOUNDING_VOLUME& bounds, const glm::mat4& matrix)
+{
+	BOUNDING_VOLUME transformed;
+	transformed.center = glm::vec3(matrix * glm::vec4(bounds.center, 1.0f));
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		transformed.extents[axis] =
+			fabs(matrix[0][axis]) * bounds.extents.x +
+			fabs(matrix[1][axis]) * bounds.extents.y +
+			fabs(matrix[2][axis]) * bounds.extents.z;
+	}
+
+	float largestScale = glm::max(
+		glm::length(glm::vec3(matrix[0])),
+		glm::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+	transformed.radius = bounds.radius * largestScale;
+
+	return(transformed);
+}
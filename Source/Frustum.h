@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustum.h
+// ============
+// bounding volumes and view frustum tests used for culling the scene
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+// an axis aligned box stored as a center and half extents, with
+// the radius of a sphere around the same center that encloses
+// the object
+struct BOUNDING_VOLUME
+{
+	glm::vec3 center;
+	glm::vec3 extents;
+	float radius;
+};
+
+// where a bounding volume lies relative to the view frustum
+enum FRUSTUM_RESULT
+{
+	FRUSTUM_OUTSIDE,
+	FRUSTUM_INTERSECTING,
+	FRUSTUM_INSIDE
+};
+
+/***********************************************************
+ *  Frustum
+ *
+ *  This class holds the six planes of the view frustum,
+ *  taken from the combined view and projection matrix, and
+ *  tests bounding volumes against them.
+ ***********************************************************/
+class Frustum
+{
+public:
+	// constructor
+	Frustum();
+
+	// extract the frustum planes from the view projection matrix
+	void SetViewProjection(const glm::mat4& viewProjection);
+	// check if any part of the bounding volume may be visible
+	bool IsVisible(const BOUNDING_VOLUME& bounds) const;
+	// check if the bounding volume is outside, partly inside or
+	// fully inside the frustum
+	FRUSTUM_RESULT Classify(const BOUNDING_VOLUME& bounds) const;
+
+	// build a bounding volume from the passed in corners
+	static BOUNDING_VOLUME MakeBounds(const glm::vec3& minimum, const glm::vec3& maximum);
+	// build the bounding volume that encloses both passed in volumes
+	static BOUNDING_VOLUME MergeBounds(const BOUNDING_VOLUME& first, const BOUNDING_VOLUME& second);
+	// transform a bounding volume into the space of the matrix
+	static BOUNDING_VOLUME TransformBounds(const BOUNDING_VOLUME& bounds, const glm::mat4& matrix);
+
+private:
+	// the left, right, bottom, top, near and far planes, with the
+	// normals pointing into the frustum
+	glm::vec4 m_planes[6];
+};
@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////////////
+// glresources.cpp
+// ============
+// own OpenGL object names and keep a registry of the live GPU resources
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLResources.h"
+
+#include <iostream>
+#include <unordered_map>
+
+// declaration of the registry state
+namespace
+{
+	// the live names of each type and the bytes each one holds
+	std::unordered_map<GLuint, GLsizeiptr> g_liveNames[GL_RESOURCE_TYPE_COUNT];
+	// running total of the bytes held by each type
+	GLsizeiptr g_memorySizes[GL_RESOURCE_TYPE_COUNT] = {};
+
+	// names of the types, as printed in the report
+	const char* const RESOURCE_TYPE_NAMES[GL_RESOURCE_TYPE_COUNT] =
+	{
+		"textures",
+		"buffers",
+		"vertex arrays",
+		"samplers"
+	};
+}
+
+/***********************************************************
+ *  CreateName()
+ *
+ *  This method is used for creating a new OpenGL object name
+ *  of the passed in type and adding it to the live names. It
+ *  holds no memory until its owner reports some.
+ ***********************************************************/
+GLuint GLResourceRegistry::CreateName(GL_RESOURCE_TYPE type)
+{
+	GLuint name = 0;
+
+	switch (type)
+	{
+	case GL_RESOURCE_TEXTURE:
+		glGenTextures(1, &name);
+		break;
+	case GL_RESOURCE_BUFFER:
+		glGenBuffers(1, &name);
+		break;
+	case GL_RESOURCE_VERTEX_ARRAY:
+		glGenVertexArrays(1, &name);
+		break;
+	case GL_RESOURCE_SAMPLER:
+		glGenSamplers(1, &name);
+		break;
+	default:
+		break;
+	}
+
+	if (name != 0)
+	{
+		g_liveNames[type][name] = 0;
+	}
+
+	return(name);
+}
+
+/***********************************************************
+ *  DeleteName()
+ *
+ *  This method is used for deleting an OpenGL object name of
+ *  the passed in type and removing it, and the memory it
+ *  held, from the live names.
+ ***********************************************************/
+void GLResourceRegistry::DeleteName(GL_RESOURCE_TYPE type, GLuint name)
+{
+	if (name == 0)
+	{
+		return;
+	}
+
+	switch (type)
+	{
+	case GL_RESOURCE_TEXTURE:
+		glDeleteTextures(1, &name);
+		break;
+	case GL_RESOURCE_BUFFER:
+		glDeleteBuffers(1, &name);
+		break;
+	case GL_RESOURCE_VERTEX_ARRAY:
+		glDeleteVertexArrays(1, &name);
+		break;
+	case GL_RESOURCE_SAMPLER:
+		glDeleteSamplers(1, &name);
+		break;
+	default:
+		return;
+	}
+
+	std::unordered_map<GLuint, GLsizeiptr>::iterator found = g_liveNames[type].find(name);
+	if (found != g_liveNames[type].end())
+	{
+		g_memorySizes[type] -= found->second;
+		g_liveNames[type].erase(found);
+	}
+}
+
+/***********************************************************
+ *  SetMemorySize()
+ *
+ *  This method is used for setting the bytes of GPU memory
+ *  that a live name holds, replacing what it held before,
+ *  such as when a buffer is reallocated with a new size.
+ ***********************************************************/
+void GLResourceRegistry::SetMemorySize(GL_RESOURCE_TYPE type, GLuint name, GLsizeiptr size)
+{
+	if ((type < 0) || (type >= GL_RESOURCE_TYPE_COUNT))
+	{
+		return;
+	}
+
+	std::unordered_map<GLuint, GLsizeiptr>::iterator found = g_liveNames[type].find(name);
+	if (found != g_liveNames[type].end())
+	{
+		g_memorySizes[type] += size - found->second;
+		found->second = size;
+	}
+}
+
+/***********************************************************
+ *  GetNameMemorySize()
+ *
+ *  This method is used for getting the bytes of GPU memory
+ *  that a live name holds, 0 for a name that is not tracked.
+ ***********************************************************/
+GLsizeiptr GLResourceRegistry::GetNameMemorySize(GL_RESOURCE_TYPE type, GLuint name)
+{
+	if ((type < 0) || (type >= GL_RESOURCE_TYPE_COUNT))
+	{
+		return(0);
+	}
+
+	std::unordered_map<GLuint, GLsizeiptr>::const_iterator found = g_liveNames[type].find(name);
+	if (found == g_liveNames[type].end())
+	{
+		return(0);
+	}
+	return(found->second);
+}
+
+/***********************************************************
+ *  GetLiveCount()
+ *
+ *  This method is used for getting the number of live names
+ *  of the passed in type.
+ ***********************************************************/
+int GLResourceRegistry::GetLiveCount(GL_RESOURCE_TYPE type)
+{
+	if ((type < 0) || (type >= GL_RESOURCE_TYPE_COUNT))
+	{
+		return(0);
+	}
+	return((int)g_liveNames[type].size());
+}
+
+/***********************************************************
+ *  GetMemorySize()
+ *
+ *  This method is used for getting the GPU memory held by
+ *  the live names of the passed in type.
+ ***********************************************************/
+GLsizeiptr GLResourceRegistry::GetMemorySize(GL_RESOURCE_TYPE type)
+{
+	if ((type < 0) || (type >= GL_RESOURCE_TYPE_COUNT))
+	{
+		return(0);
+	}
+	return(g_memorySizes[type]);
+}
+
+/***********************************************************
+ *  GetTotalMemorySize()
+ *
+ *  This method is used for getting the GPU memory held by
+ *  every live name.
+ ***********************************************************/
+GLsizeiptr GLResourceRegistry::GetTotalMemorySize()
+{
+	GLsizeiptr memorySize = 0;
+	for (int i = 0; i < GL_RESOURCE_TYPE_COUNT; i++)
+	{
+		memorySize += g_memorySizes[i];
+	}
+	return(memorySize);
+}
+
+/***********************************************************
+ *  PrintReport()
+ *
+ *  This method is used for printing the number of live names
+ *  of each type and the GPU memory they hold.
+ ***********************************************************/
+void GLResourceRegistry::PrintReport(const char* label)
+{
+	std::cout << "INFO: GPU resources " << label << ": "
+		<< GetTotalMemorySize() / 1024 << " KB" << std::endl;
+
+	for (int i = 0; i < GL_RESOURCE_TYPE_COUNT; i++)
+	{
+		std::cout << "INFO:   " << RESOURCE_TYPE_NAMES[i] << ": "
+			<< g_liveNames[i].size() << " live, "
+			<< g_memorySizes[i] / 1024 << " KB" << std::endl;
+	}
+}
@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////
+// glresources.h
+// ============
+// own OpenGL object names and keep a registry of the live GPU resources
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+// kinds of OpenGL objects tracked by the resource registry
+enum GL_RESOURCE_TYPE
+{
+	GL_RESOURCE_TEXTURE,
+	GL_RESOURCE_BUFFER,
+	GL_RESOURCE_VERTEX_ARRAY,
+	GL_RESOURCE_SAMPLER,
+	GL_RESOURCE_TYPE_COUNT
+};
+
+/***********************************************************
+ *  GLResourceRegistry
+ *
+ *  This class creates and deletes the OpenGL object names
+ *  used by the scene, and keeps count of the ones that are
+ *  alive along with the GPU memory their owners report for
+ *  them. Tearing a scene down should bring the counts back
+ *  to where they were before it was loaded, anything left
+ *  over is a leak. Like every GL call, it is only used from
+ *  the GL thread.
+ ***********************************************************/
+class GLResourceRegistry
+{
+public:
+	// create a new name of the passed in type and start tracking it
+	static GLuint CreateName(GL_RESOURCE_TYPE type);
+	// delete a tracked name and stop tracking it
+	static void DeleteName(GL_RESOURCE_TYPE type, GLuint name);
+	// set the bytes of GPU memory a tracked name holds
+	static void SetMemorySize(GL_RESOURCE_TYPE type, GLuint name, GLsizeiptr size);
+	// get the bytes of GPU memory a tracked name holds
+	static GLsizeiptr GetNameMemorySize(GL_RESOURCE_TYPE type, GLuint name);
+
+	// get the number of live names of the passed in type
+	static int GetLiveCount(GL_RESOURCE_TYPE type);
+	// get the GPU memory held by the live names of the passed in type
+	static GLsizeiptr GetMemorySize(GL_RESOURCE_TYPE type);
+	// get the GPU memory held by every live name
+	static GLsizeiptr GetTotalMemorySize();
+	// print the live counts and memory, under the passed in label
+	static void PrintReport(const char* label);
+};
+
+/***********************************************************
+ *  GLHandle
+ *
+ *  This class owns a single OpenGL object name, deleting it
+ *  when the handle is reset or destroyed. Handles can be
+ *  moved but never copied, so every name has exactly one
+ *  owner, and containers of handles free what they hold.
+ ***********************************************************/
+template <GL_RESOURCE_TYPE TYPE>
+class GLHandle
+{
+public:
+	// constructor, the handle starts out empty
+	GLHandle()
+	{
+		m_name = 0;
+	}
+	// constructor, taking ownership of a name created through
+	// GLResourceRegistry::CreateName()
+	explicit GLHandle(GLuint name)
+	{
+		m_name = name;
+	}
+	// destructor
+	~GLHandle()
+	{
+		Reset();
+	}
+
+	GLHandle(GLHandle&& other) noexcept
+	{
+		m_name = other.m_name;
+		other.m_name = 0;
+	}
+	GLHandle& operator=(GLHandle&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			m_name = other.m_name;
+			other.m_name = 0;
+		}
+		return(*this);
+	}
+	GLHandle(const GLHandle&) = delete;
+	GLHandle& operator=(const GLHandle&) = delete;
+
+	// create a new name, deleting the one held before
+	void Create()
+	{
+		Reset();
+		m_name = GLResourceRegistry::CreateName(TYPE);
+	}
+	// delete the held name, leaving the handle empty
+	void Reset()
+	{
+		if (m_name != 0)
+		{
+			GLResourceRegistry::DeleteName(TYPE, m_name);
+			m_name = 0;
+		}
+	}
+	// set the bytes of GPU memory the held name holds
+	void SetMemorySize(GLsizeiptr size) const
+	{
+		GLResourceRegistry::SetMemorySize(TYPE, m_name, size);
+	}
+	// get the bytes of GPU memory the held name holds
+	GLsizeiptr GetMemorySize() const
+	{
+		return(GLResourceRegistry::GetNameMemorySize(TYPE, m_name));
+	}
+	// get the held name, 0 when the handle is empty
+	GLuint Get() const
+	{
+		return(m_name);
+	}
+
+private:
+	GLuint m_name;
+};
+
+// handles for each of the tracked object types
+typedef GLHandle<GL_RESOURCE_TEXTURE> GLTexture;
+typedef GLHandle<GL_RESOURCE_BUFFER> GLBuffer;
+typedef GLHandle<GL_RESOURCE_VERTEX_ARRAY> GLVertexArray;
+typedef GLHandle<GL_RESOURCE_SAMPLER> GLSampler;
@@ -0,0 +1,259 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.cpp
+// ============
+// split the per-frame scene work across a pool of worker threads
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+/***********************************************************
+ *  JobSystem()
+ *
+ *  The constructor for the class. The workers are started
+ *  right away and sleep until the first loop.
+ ***********************************************************/
+JobSystem::JobSystem(int threadCount)
+{
+	if (threadCount <= 0)
+	{
+		threadCount = (int)std::thread::hardware_concurrency();
+		if (threadCount < 1)
+		{
+			threadCount = 1;
+		}
+	}
+
+	m_bStopping = false;
+	m_loopNumber = 0;
+	m_pJob = NULL;
+	m_rangesLeft = 0;
+
+	for (int thread = 0; thread < threadCount; thread++)
+	{
+		m_queues.push_back(new RANGE_QUEUE());
+	}
+
+	// the calling thread is thread 0, so it needs no worker
+	for (int thread = 1; thread < threadCount; thread++)
+	{
+		m_workers.push_back(std::thread(&JobSystem::WorkerLoop, this, thread));
+	}
+}
+
+/***********************************************************
+ *  ~JobSystem()
+ *
+ *  The destructor for the class. The workers are woken up
+ *  and stopped.
+ ***********************************************************/
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+	}
+	m_loopReady.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+
+	for (RANGE_QUEUE* pQueue : m_queues)
+	{
+		delete pQueue;
+	}
+	m_queues.clear();
+}
+
+/***********************************************************
+ *  GetThreadCount()
+ *
+ *  This method is used for getting the number of threads a
+ *  loop is spread over, the workers and the calling thread.
+ ***********************************************************/
+int JobSystem::GetThreadCount() const
+{
+	return((int)m_queues.size());
+}
+
+/***********************************************************
+ *  GetRangeCount()
+ *
+ *  This method is used for getting the number of ranges a
+ *  loop over the passed in number of items is split into.
+ *  Range r starts at item r * rangeSize, so a job can keep
+ *  its results in order by range.
+ ***********************************************************/
+int JobSystem::GetRangeCount(int count, int rangeSize)
+{
+	if (count <= 0)
+	{
+		return(0);
+	}
+	if (rangeSize < 1)
+	{
+		rangeSize = 1;
+	}
+
+	return((count + rangeSize - 1) / rangeSize);
+}
+
+/***********************************************************
+ *  ParallelFor()
+ *
+ *  This method is used for running the passed in job over
+ *  the items in ranges of the passed in size. Each thread is
+ *  dealt a block of neighbouring ranges, and the calling
+ *  thread works through its own block, and steals from the
+ *  others, before it waits for the ranges still running.
+ *  A loop of a single range, or a pool without workers,
+ *  runs on the calling thread without waking anyone.
+ ***********************************************************/
+void JobSystem::ParallelFor(int count, int rangeSize, const RANGE_JOB& job)
+{
+	int rangeCount = GetRangeCount(count, rangeSize);
+	if (rangeCount == 0)
+	{
+		return;
+	}
+	if (rangeSize < 1)
+	{
+		rangeSize = 1;
+	}
+
+	if (m_workers.empty() || (rangeCount == 1))
+	{
+		for (int first = 0; first < count; first += rangeSize)
+		{
+			job(first, std::min(first + rangeSize, count), 0);
+		}
+		return;
+	}
+
+	// the job is set before any range is queued, and read after a
+	// range is taken under the same queue lock
+	m_pJob = &job;
+	m_rangesLeft = rangeCount;
+
+	int threadCount = GetThreadCount();
+	for (int range = 0; range < rangeCount; range++)
+	{
+		JOB_RANGE jobRange;
+		jobRange.first = range * rangeSize;
+		jobRange.end = std::min(jobRange.first + rangeSize, count);
+
+		RANGE_QUEUE& queue = *m_queues[(int)(((long long)range * threadCount) / rangeCount)];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.ranges.push_back(jobRange);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_loopNumber++;
+	}
+	m_loopReady.notify_all();
+
+	RunRanges(0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_loopDone.wait(lock, [this]()
+		{
+			return(m_rangesLeft == 0);
+		});
+	m_pJob = NULL;
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is run by every worker thread. It sleeps
+ *  until a loop is started, and helps run its ranges.
+ ***********************************************************/
+void JobSystem::WorkerLoop(int thread)
+{
+	unsigned int loopNumber = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_loopReady.wait(lock, [this, loopNumber]()
+				{
+					return(m_bStopping || (m_loopNumber != loopNumber));
+				});
+			if (m_bStopping)
+			{
+				return;
+			}
+			loopNumber = m_loopNumber;
+		}
+
+		RunRanges(thread);
+	}
+}
+
+/***********************************************************
+ *  RunRanges()
+ *
+ *  This method is used for running ranges of the current
+ *  loop until there are none left to take, and waking the
+ *  calling thread once the last one is done.
+ ***********************************************************/
+void JobSystem::RunRanges(int thread)
+{
+	JOB_RANGE range;
+	while (TakeRange(thread, range))
+	{
+		(*m_pJob)(range.first, range.end, thread);
+
+		if (--m_rangesLeft == 0)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_loopDone.notify_all();
+		}
+	}
+}
+
+/***********************************************************
+ *  TakeRange()
+ *
+ *  This method is used for taking the next range to run.
+ *  The thread takes from the back of its own queue, and
+ *  steals from the front of the others, so it takes the
+ *  ranges furthest from the ones their owner is running.
+ ***********************************************************/
+bool JobSystem::TakeRange(int thread, JOB_RANGE& range)
+{
+	int threadCount = GetThreadCount();
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		RANGE_QUEUE& queue = *m_queues[(thread + i) % threadCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.ranges.empty())
+		{
+			continue;
+		}
+
+		if (i == 0)
+		{
+			range = queue.ranges.back();
+			queue.ranges.pop_back();
+		}
+		else
+		{
+			range = queue.ranges.front();
+			queue.ranges.pop_front();
+		}
+		return(true);
+	}
+
+	return(false);
+}
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.h
+// ============
+// split the per-frame scene work across a pool of worker threads
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  JobSystem
+ *
+ *  This class runs a loop over many items on a pool of
+ *  worker threads, with the calling thread helping out. The
+ *  items are split into ranges that are dealt out to a queue
+ *  per thread. Each thread takes ranges from the back of its
+ *  own queue, and once it runs dry steals them from the
+ *  front of the others, so a thread given slow ranges is
+ *  helped by the rest. The calling thread returns once
+ *  every range has run. Jobs must make no OpenGL calls and
+ *  must not start a loop of their own.
+ ***********************************************************/
+class JobSystem
+{
+public:
+	// the job run on each range of items, given the first item,
+	// the item after the last and the index of the running thread
+	typedef std::function<void(int first, int end, int thread)> RANGE_JOB;
+
+	// constructor, 0 threads uses one per hardware thread, counting
+	// the calling thread, and 1 runs every loop on the calling thread
+	JobSystem(int threadCount = 0);
+	// destructor
+	~JobSystem();
+
+	// get the number of threads a loop can run on, counting the
+	// calling thread, for sizing the results kept per thread
+	int GetThreadCount() const;
+	// get the number of ranges a loop over the passed in number of
+	// items is split into, for sizing the results kept per range
+	static int GetRangeCount(int count, int rangeSize);
+
+	// run the job over the items in ranges of the passed in size,
+	// returning once every range has run
+	void ParallelFor(int count, int rangeSize, const RANGE_JOB& job);
+
+private:
+	// a range of items waiting to run
+	struct JOB_RANGE
+	{
+		int first;
+		int end;
+	};
+
+	// the ranges dealt out to a single thread, the calling thread
+	// owns the first queue
+	struct RANGE_QUEUE
+	{
+		std::mutex mutex;
+		std::deque<JOB_RANGE> ranges;
+	};
+
+	// worker threads and the state shared with them
+	std::vector<std::thread> m_workers;
+	std::vector<RANGE_QUEUE*> m_queues;
+	std::mutex m_mutex;
+	std::condition_variable m_loopReady;
+	std::condition_variable m_loopDone;
+	bool m_bStopping;
+	// counts the loops started, so a waking worker can tell a new one
+	unsigned int m_loopNumber;
+	// the job of the running loop and the ranges it has left
+	const RANGE_JOB* m_pJob;
+	std::atomic<int> m_rangesLeft;
+
+	// run the ranges of every loop until the pool is destroyed
+	void WorkerLoop(int thread);
+	// run ranges until none are left to take or steal
+	void RunRanges(int thread);
+	// take a range from the thread's own queue, or steal one from
+	// another, false if every queue is empty
+	bool TakeRange(int thread, JOB_RANGE& range);
+};
@@ -0,0 +1,292 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.cpp
+// ============
+// bin the scene lights into view space clusters with a compute shader
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightClusters.h"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/***********************************************************
+ *  LightClusters()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightClusters::LightClusters()
+{
+	m_programID = 0;
+	m_viewLocation = -1;
+	m_inverseProjectionLocation = -1;
+	m_depthRangeLocation = -1;
+	m_lightCountLocation = -1;
+	m_lightCount = 0;
+}
+
+/***********************************************************
+ *  ~LightClusters()
+ *
+ *  The destructor for the class, the buffer handles delete
+ *  the storage buffers
+ ***********************************************************/
+LightClusters::~LightClusters()
+{
+	if (m_programID != 0)
+	{
+		glDeleteProgram(m_programID);
+		m_programID = 0;
+	}
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking if the culling pass can
+ *  run. Compute shaders and shader storage buffers both need
+ *  OpenGL 4.3.
+ ***********************************************************/
+bool LightClusters::IsSupported()
+{
+	return(GLEW_VERSION_4_3 == GL_TRUE);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for building the culling program from
+ *  the passed in shader file and creating the storage
+ *  buffers at their binding points. The buffers are sized
+ *  for the most lights and the most lights per cluster, so
+ *  they are never reallocated. False is returned when the
+ *  pass can't be used, and the scene is then lit from the
+ *  light block alone.
+ ***********************************************************/
+bool LightClusters::Initialize(const char* computeShaderFilename)
+{
+	if (!IsSupported())
+	{
+		std::cout << "Compute shaders are not supported, lights are not clustered" << std::endl;
+		return(false);
+	}
+
+	if (m_programID == 0)
+	{
+		m_programID = BuildProgram(computeShaderFilename);
+		if (m_programID == 0)
+		{
+			return(false);
+		}
+
+		m_viewLocation = glGetUniformLocation(m_programID, "view");
+		m_inverseProjectionLocation = glGetUniformLocation(m_programID, "inverseProjection");
+		m_depthRangeLocation = glGetUniformLocation(m_programID, "depthRange");
+		m_lightCountLocation = glGetUniformLocation(m_programID, "lightCount");
+	}
+
+	GLsizeiptr lightListSize = (GLsizeiptr)MAX_LIGHTS * sizeof(LIGHT_SOURCE_BLOCK);
+	GLsizeiptr clusterGridSize = (GLsizeiptr)CLUSTER_COUNT * 2 * sizeof(GLuint);
+	GLsizeiptr lightIndexListSize = (GLsizeiptr)(1 + CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER) * sizeof(GLuint);
+
+	m_lightList.Create();
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightList.Get());
+	glBufferData(GL_SHADER_STORAGE_BUFFER, lightListSize, NULL, GL_DYNAMIC_DRAW);
+	m_lightList.SetMemorySize(lightListSize);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_LIST_STORAGE_BINDING, m_lightList.Get());
+
+	m_clusterGrid.Create();
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_clusterGrid.Get());
+	glBufferData(GL_SHADER_STORAGE_BUFFER, clusterGridSize, NULL, GL_DYNAMIC_COPY);
+	m_clusterGrid.SetMemorySize(clusterGridSize);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_GRID_STORAGE_BINDING, m_clusterGrid.Get());
+
+	m_lightIndexList.Create();
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightIndexList.Get());
+	glBufferData(GL_SHADER_STORAGE_BUFFER, lightIndexListSize, NULL, GL_DYNAMIC_COPY);
+	m_lightIndexList.SetMemorySize(lightIndexListSize);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_INDEX_STORAGE_BINDING, m_lightIndexList.Get());
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	m_lightCount = 0;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking if the pass was
+ *  initialized and can be updated.
+ ***********************************************************/
+bool LightClusters::IsReady() const
+{
+	return((m_programID != 0) && (m_lightList.Get() != 0));
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for uploading the passed in scene
+ *  lights into the light list. Lights past the most the
+ *  list holds are dropped.
+ ***********************************************************/
+void LightClusters::SetLights(const std::vector<LIGHT_SOURCE_BLOCK>& lights)
+{
+	if (!IsReady())
+	{
+		return;
+	}
+
+	m_lightCount = (int)lights.size();
+	if (m_lightCount > MAX_LIGHTS)
+	{
+		std::cout << "Too many lights to cluster, only the first " << MAX_LIGHTS
+			<< " of " << m_lightCount << " are used" << std::endl;
+		m_lightCount = MAX_LIGHTS;
+	}
+
+	if (m_lightCount > 0)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightList.Get());
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_lightCount * sizeof(LIGHT_SOURCE_BLOCK), lights.data());
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for listing the lights of every
+ *  cluster of the passed in view. The near and far planes
+ *  are read back out of the projection, so both the
+ *  perspective and orthographic views are split the same
+ *  way. The graphics program in use is restored afterwards,
+ *  and given the scale and bias that turn a fragment's
+ *  window position and view depth into its cluster.
+ ***********************************************************/
+void LightClusters::Update(const glm::mat4& view, const glm::mat4& projection, const UniformCache* pUniformCache)
+{
+	if (!IsReady())
+	{
+		return;
+	}
+
+	glm::mat4 inverseProjection = glm::inverse(projection);
+	glm::vec4 nearPoint = inverseProjection * glm::vec4(0.0f, 0.0f, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseProjection * glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	float nearDepth = -nearPoint.z / nearPoint.w;
+	float farDepth = -farPoint.z / farPoint.w;
+	if ((nearDepth <= 0.0f) || (farDepth <= nearDepth))
+	{
+		return;
+	}
+
+	GLint currentProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+
+	// clear the counter the clusters claim their light indices from
+	const GLuint zero = 0;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightIndexList.Get());
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	// one work group per depth slice, one invocation per tile
+	glUseProgram(m_programID);
+	glUniformMatrix4fv(m_viewLocation, 1, GL_FALSE, &view[0][0]);
+	glUniformMatrix4fv(m_inverseProjectionLocation, 1, GL_FALSE, &inverseProjection[0][0]);
+	glUniform2f(m_depthRangeLocation, nearDepth, farDepth);
+	glUniform1i(m_lightCountLocation, m_lightCount);
+	glDispatchCompute(1, 1, CLUSTER_COUNT_Z);
+
+	// the lists are read by the fragment shaders of the next draws
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	glUseProgram(currentProgram);
+
+	if (NULL != pUniformCache)
+	{
+		GLint viewport[4] = { 0, 0, 1, 1 };
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		// the depth slices are spaced exponentially, so the slice of
+		// a view depth is log(depth) * scale + bias
+		float logDepthRange = std::log(farDepth / nearDepth);
+		float sliceScale = CLUSTER_COUNT_Z / logDepthRange;
+		float sliceBias = -CLUSTER_COUNT_Z * std::log(nearDepth) / logDepthRange;
+
+		pUniformCache->setBoolValue(pUniformCache->m_locations.bUseLightClusters, true);
+		pUniformCache->setVec2Value(pUniformCache->m_locations.clusterTileScale,
+			glm::vec2((float)CLUSTER_COUNT_X / (float)glm::max(viewport[2], 1),
+				(float)CLUSTER_COUNT_Y / (float)glm::max(viewport[3], 1)));
+		pUniformCache->setVec2Value(pUniformCache->m_locations.clusterSliceScaleBias,
+			glm::vec2(sliceScale, sliceBias));
+	}
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method is used for getting the number of lights in
+ *  the light list.
+ ***********************************************************/
+int LightClusters::GetLightCount() const
+{
+	return(m_lightCount);
+}
+
+/***********************************************************
+ *  BuildProgram()
+ *
+ *  This method is used for compiling the compute shader in
+ *  the passed in file and linking it into a program. The
+ *  compile or link log is printed when either one fails.
+ ***********************************************************/
+GLuint LightClusters::BuildProgram(const char* filename)
+{
+	std::ifstream file(filename);
+	if (!file)
+	{
+		std::cout << "ERROR: could not open compute shader " << filename << std::endl;
+		return(0);
+	}
+
+	std::stringstream source;
+	source << file.rdbuf();
+	std::string sourceText = source.str();
+	const GLchar* sourcePointer = sourceText.c_str();
+
+	GLint status = GL_FALSE;
+	GLchar infoLog[1024];
+
+	GLuint shaderID = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shaderID, 1, &sourcePointer, NULL);
+	glCompileShader(shaderID);
+	glGetShaderiv(shaderID, GL_COMPILE_STATUS, &status);
+	if (status != GL_TRUE)
+	{
+		glGetShaderInfoLog(shaderID, sizeof(infoLog), NULL, infoLog);
+		std::cout << "ERROR: compute shader " << filename << " failed to compile\n" << infoLog << std::endl;
+		glDeleteShader(shaderID);
+		return(0);
+	}
+
+	GLuint programID = glCreateProgram();
+	glAttachShader(programID, shaderID);
+	glLinkProgram(programID);
+	glDeleteShader(shaderID);
+	glGetProgramiv(programID, GL_LINK_STATUS, &status);
+	if (status != GL_TRUE)
+	{
+		glGetProgramInfoLog(programID, sizeof(infoLog), NULL, infoLog);
+		std::cout << "ERROR: compute program " << filename << " failed to link\n" << infoLog << std::endl;
+		glDeleteProgram(programID);
+		return(0);
+	}
+
+	return(programID);
+}
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.h
+// ============
+// bin the scene lights into view space clusters with a compute shader
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLResources.h"
+#include "UniformBuffer.h"
+#include "UniformCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  LightClusters
+ *
+ *  This class splits the view frustum into a grid of
+ *  clusters, screen tiles cut into exponential depth slices,
+ *  and runs a compute pass every frame that lists the lights
+ *  whose range reaches each cluster. The scene lights live in
+ *  a storage buffer, so there can be many more of them than
+ *  the light block holds, and each fragment only shades the
+ *  lights listed in its cluster. Lights without a range are
+ *  listed in every cluster.
+ ***********************************************************/
+class LightClusters
+{
+public:
+	// the clusters across, down and deep, these must match the
+	// light culling and fragment shaders
+	static const int CLUSTER_COUNT_X = 16;
+	static const int CLUSTER_COUNT_Y = 9;
+	static const int CLUSTER_COUNT_Z = 24;
+	static const int CLUSTER_COUNT = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+	// the most lights a cluster lists, the rest are dropped
+	static const int MAX_LIGHTS_PER_CLUSTER = 64;
+	// the most lights in the light list
+	static const int MAX_LIGHTS = 1024;
+
+	// constructor
+	LightClusters();
+	// destructor
+	~LightClusters();
+
+	// check if the GL context can run the culling pass, which
+	// needs compute shaders and storage buffers
+	static bool IsSupported();
+
+	// build the culling program from its shader file and create
+	// the buffers, false if the pass can't be used
+	bool Initialize(const char* computeShaderFilename);
+	// check if the pass was initialized
+	bool IsReady() const;
+
+	// upload the scene lights into the light list
+	void SetLights(const std::vector<LIGHT_SOURCE_BLOCK>& lights);
+	// list the lights of every cluster of the passed in view, and
+	// set the values the fragment shader finds its cluster with
+	void Update(const glm::mat4& view, const glm::mat4& projection, const UniformCache* pUniformCache);
+	// get the number of lights in the light list
+	int GetLightCount() const;
+
+private:
+	GLuint m_programID;
+	GLint m_viewLocation;
+	GLint m_inverseProjectionLocation;
+	GLint m_depthRangeLocation;
+	GLint m_lightCountLocation;
+
+	// the scene lights
+	GLBuffer m_lightList;
+	// the offset and count of the lights of each cluster
+	GLBuffer m_clusterGrid;
+	// a counter followed by the light indices of every cluster
+	GLBuffer m_lightIndexList;
+	int m_lightCount;
+
+	// compile and link a compute program, 0 if it fails
+	static GLuint BuildProgram(const char* filename);
+};
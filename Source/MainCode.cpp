@@ -1,5 +1,7 @@
 #include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
+#include <cstdlib>          // EXIT_FAILURE, strtod, strtol
+#include <cstring>          // strcmp
+#include <string>
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -11,8 +13,14 @@
 
 #include "SceneManager.h"
 #include "ViewManager.h"
-#include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "GLResources.h"
+#include "UniformCache.h"
+#include "CullingBenchmark.h"
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+#include "CameraPath.h"
+#include "RenderBenchmark.h"
 
 // Namespace for declaring global variables
 namespace
@@ -27,14 +35,75 @@ namespace
 	SceneManager* g_SceneManager = nullptr;
 	// shader manager object for dynamic interaction with the shader code
 	ShaderManager* g_ShaderManager = nullptr;
+	// cached shader uniform locations used by the managers
+	UniformCache* g_UniformCache = nullptr;
 	// view manager object for managing the 3D view setup and projection to 2D
 	ViewManager* g_ViewManager = nullptr;
+	// frame pacer object for the present mode and frame rate cap
+	FramePacer* g_FramePacer = nullptr;
+	// frame profiler object for the CPU and GPU timings of each frame
+	FrameProfiler* g_FrameProfiler = nullptr;
+
+	// length of a simulation tick, the scene is updated in ticks of
+	// this length however fast or slow frames are being drawn
+	const double FIXED_TIMESTEP = 1.0 / 60.0;
+	// longest frame time simulated at once, so a stall such as a
+	// dragged window is not followed by a burst of catch up ticks
+	const double MAX_FRAME_TIME = 0.25;
+	// how often the scene file is checked for changes, in seconds
+	const double SCENE_RELOAD_INTERVAL = 0.5;
+
+	// the options read from the command line
+	struct COMMAND_LINE_OPTIONS
+	{
+		FRAME_PACING_SETTINGS pacingSettings;
+		int windowWidth = ViewManager::DEFAULT_WINDOW_WIDTH;
+		int windowHeight = ViewManager::DEFAULT_WINDOW_HEIGHT;
+		// text file the scene is loaded from, the default scene if empty
+		std::string sceneFile;
+		// copies of the scene laid out side by side
+		int sceneScale = 1;
+		// texture memory the streamed textures are kept within, in MB
+		int textureBudgetMB = SceneManager::DEFAULT_TEXTURE_BUDGET_MB;
+		// draw the opaque depth before shading it
+		bool bDepthPrePass = true;
+		// show how many times each pixel is shaded, debug builds only
+		bool bShowOverdraw = false;
+		// blend the translucent objects in any order instead of sorting
+		bool bWeightedTransparency = false;
+		// shadow the scene from the light the scene file gives shadows
+		bool bShadows = true;
+		// draw the curved shapes with fewer triangles when small, and
+		// dither the switch between two levels
+		bool bMeshLOD = true;
+		bool bLODDither = false;
+		// write the dynamic objects' matrices into a mapped ring
+		bool bDynamicRing = true;
+		// threads the scene passes are split across, 0 for one per
+		// hardware thread
+		int jobThreads = 0;
+		bool bProfileOverlay = false;
+		// frame timings are written to this prefix when it is set
+		std::string profileDumpPrefix;
+		// the camera path is recorded to this file when it is set
+		std::string recordPathFile;
+		// render the benchmark instead of the interactive loop
+		bool bRunBenchmark = false;
+		RENDER_BENCHMARK_SETTINGS benchmarkSettings;
+		// time the frustum culling instead of opening a window
+		bool bRunCullBenchmark = false;
+	};
 }
 
 // Function declarations - all functions that are called manually
 // need to be pre-declared at the beginning of the source code.
 bool InitializeGLFW();
 bool InitializeGLEW();
+void RunMainLoop(const COMMAND_LINE_OPTIONS& options);
+bool ParseCommandLine(
+	int argc,
+	char* argv[],
+	COMMAND_LINE_OPTIONS& options);
 
 
 /***********************************************************
@@ -45,6 +114,29 @@ bool InitializeGLEW();
  ***********************************************************/
 int main(int argc, char* argv[])
 {
+	// read the present mode, frame pacing, window size, scene,
+	// profiling and benchmark options
+	COMMAND_LINE_OPTIONS options;
+	if (ParseCommandLine(argc, argv, options) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// the culling benchmark runs on the CPU only, without a window
+	if (options.bRunCullBenchmark)
+	{
+		RunCullingBenchmark();
+		return(EXIT_SUCCESS);
+	}
+
+	// the benchmark draws as fast as it can, so the frame times
+	// measure the renderer and not the display refresh
+	if (options.bRunBenchmark)
+	{
+		options.pacingSettings.presentMode = PRESENT_VSYNC_OFF;
+		options.pacingSettings.maxFrameRate = 0.0;
+	}
+
 	// if GLFW fails initialization, then terminate the application
 	if (InitializeGLFW() == false)
 	{
@@ -53,12 +145,21 @@ int main(int argc, char* argv[])
 
 	// try to create a new shader manager object
 	g_ShaderManager = new ShaderManager();
+	// create the uniform location cache, it is filled once the
+	// shader program has been linked
+	g_UniformCache = new UniformCache();
 	// try to create a new view manager object
 	g_ViewManager = new ViewManager(
-		g_ShaderManager);
+		g_ShaderManager,
+		g_UniformCache);
 
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	// try to create the main display window, which the benchmark
+	// keeps hidden
+	if (options.bRunBenchmark)
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	}
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE, options.windowWidth, options.windowHeight);
 
 	// if GLEW fails initialization, then terminate the application
 	if (InitializeGLEW() == false)
@@ -68,58 +169,261 @@ int main(int argc, char* argv[])
 
 	// load the shader code from the external GLSL files
 	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
+		"Shaders/vertexShader.glsl",
+		"Shaders/fragmentShader.glsl");
 	g_ShaderManager->use();
 
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
+	// set the swap interval and frame cap, now that the context is current
+	g_FramePacer = new FramePacer();
+	g_FramePacer->SetSettings(options.pacingSettings);
 
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
+	// look up all of the uniform locations once, now that the
+	// shader program is linked and in use
+	g_UniformCache->CacheLocations();
 
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(g_ShaderManager, g_UniformCache);
+	if (!options.sceneFile.empty())
+	{
+		g_SceneManager->SetSceneFile(options.sceneFile);
+	}
+	g_SceneManager->SetSceneScale(options.sceneScale);
+	g_SceneManager->SetTextureBudget((size_t)options.textureBudgetMB * 1024 * 1024);
+	g_SceneManager->SetDepthPrePass(options.bDepthPrePass);
+	g_SceneManager->SetShowOverdraw(options.bShowOverdraw);
+	g_SceneManager->SetWeightedTransparency(options.bWeightedTransparency);
+	g_SceneManager->SetShadows(options.bShadows);
+	g_SceneManager->SetMeshLOD(options.bMeshLOD, options.bLODDither);
+	g_SceneManager->SetDynamicTransforms(options.bDynamicRing);
+	g_SceneManager->SetJobThreads(options.jobThreads);
+	g_SceneManager->PrepareScene();
 
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
+	// time every frame, recording them all when they are to be dumped
+	g_FrameProfiler = new FrameProfiler();
+	g_FrameProfiler->SetRecording(!options.profileDumpPrefix.empty());
+	g_SceneManager->SetFrameProfiler(g_FrameProfiler);
 
+	// report the GPU memory the prepared scene takes up
+	GLResourceRegistry::PrintReport("after preparing the scene");
 
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
+	bool bSucceeded = true;
+	if (options.bRunBenchmark)
+	{
+		// measure the scene along the camera path, without input
+		bSucceeded = RunRenderBenchmark(
+			g_Window,
+			g_ViewManager,
+			g_SceneManager,
+			g_FramePacer,
+			g_FrameProfiler,
+			options.benchmarkSettings);
+	}
+	else
+	{
+		RunMainLoop(options);
+	}
 
-		// query the latest GLFW events
-		glfwPollEvents();
+	// write out the recorded frames before the context goes away
+	if (!options.profileDumpPrefix.empty())
+	{
+		// read back the GPU times of the last frames, whose queries
+		// are still in flight
+		g_FrameProfiler->Flush();
+		if (g_FrameProfiler->WriteCSV(options.profileDumpPrefix + ".csv") &&
+			g_FrameProfiler->WriteChromeTrace(options.profileDumpPrefix + ".json"))
+		{
+			std::cout << "INFO: Frame profile written to " << options.profileDumpPrefix
+				<< ".csv and " << options.profileDumpPrefix << ".json" << std::endl;
+		}
+		else
+		{
+			std::cerr << "ERROR: Could not write the frame profile to "
+				<< options.profileDumpPrefix << std::endl;
+		}
 	}
 
 	// clear the allocated manager objects from memory
+	if (NULL != g_FrameProfiler)
+	{
+		g_SceneManager->SetFrameProfiler(NULL);
+		delete g_FrameProfiler;
+		g_FrameProfiler = NULL;
+	}
 	if (NULL != g_SceneManager)
 	{
 		delete g_SceneManager;
 		g_SceneManager = NULL;
 	}
+	if (NULL != g_FramePacer)
+	{
+		delete g_FramePacer;
+		g_FramePacer = NULL;
+	}
 	if (NULL != g_ViewManager)
 	{
 		delete g_ViewManager;
 		g_ViewManager = NULL;
 	}
+	if (NULL != g_UniformCache)
+	{
+		delete g_UniformCache;
+		g_UniformCache = NULL;
+	}
 	if (NULL != g_ShaderManager)
 	{
 		delete g_ShaderManager;
 		g_ShaderManager = NULL;
 	}
 
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
+	// every resource should be gone with its manager, anything
+	// still live here was leaked
+	GLResourceRegistry::PrintReport("left after teardown");
+
+	// Terminates the program, failing if the benchmark could not run
+	exit(bSucceeded ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/***********************************************************
+ *	RunMainLoop()
+ *
+ *  This function is used to run the interactive loop, which
+ *  keeps drawing the scene until the window is closed. The
+ *  camera is moved in fixed simulation ticks, and its pose
+ *  after every tick is saved when a path is being recorded.
+ *  The scene file is loaded again whenever it is saved.
+ ***********************************************************/
+void RunMainLoop(const COMMAND_LINE_OPTIONS& options)
+{
+	// simulation time not yet consumed by a tick
+	double previousTime = glfwGetTime();
+	double accumulatedTime = 0.0;
+
+	// the camera pose after every tick, when it is being recorded
+	CameraPath recordedPath;
+	double simulationTime = 0.0;
+
+	// time the scene file was last checked for changes
+	double lastReloadCheck = previousTime;
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while (!glfwWindowShouldClose(g_Window))
+	{
+		// hold the loop for the frame cap and the frames in flight,
+		// then read the input, so the frame starts from fresh input
+		g_FramePacer->WaitForNextFrame();
+		g_FrameProfiler->BeginFrame();
+		glfwPollEvents();
+
+		double currentTime = glfwGetTime();
+		double frameTime = currentTime - previousTime;
+		previousTime = currentTime;
+		if (frameTime > MAX_FRAME_TIME)
+		{
+			frameTime = MAX_FRAME_TIME;
+		}
+		accumulatedTime += frameTime;
+
+		if ((currentTime - lastReloadCheck) >= SCENE_RELOAD_INTERVAL)
+		{
+			g_SceneManager->ReloadSceneIfChanged();
+			lastReloadCheck = currentTime;
+		}
+
+		// advance the simulation in fixed ticks until it has caught
+		// up with the elapsed time
+		{
+			ProfileScope scope(g_FrameProfiler, "Update");
+			while (accumulatedTime >= FIXED_TIMESTEP)
+			{
+				g_ViewManager->UpdateSceneView((float)FIXED_TIMESTEP);
+				g_SceneManager->AnimateSceneObjects((float)FIXED_TIMESTEP);
+
+				// pick the object under a click made since the last tick
+				glm::vec3 pickOrigin;
+				glm::vec3 pickDirection;
+				if (g_ViewManager->TakePickRay(pickOrigin, pickDirection))
+				{
+					g_SceneManager->ReportPickedObject(
+						g_SceneManager->PickSceneObject(pickOrigin, pickDirection));
+				}
+				accumulatedTime -= FIXED_TIMESTEP;
+				simulationTime += FIXED_TIMESTEP;
+
+				if (!options.recordPathFile.empty())
+				{
+					glm::vec3 cameraPosition;
+					glm::vec3 cameraFront;
+					g_ViewManager->GetCameraPose(cameraPosition, cameraFront);
+					recordedPath.AddKey((float)simulationTime, cameraPosition, cameraFront);
+				}
+			}
+
+			// draw the spinning objects between the last two ticks,
+			// at the same point as the camera
+			g_SceneManager->InterpolateSceneObjects((float)(accumulatedTime / FIXED_TIMESTEP));
+		}
+
+		// Enable z-depth
+		glEnable(GL_DEPTH_TEST);
+
+		// Clear the frame and z buffers
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// convert from 3D object space to 2D view, drawn at the point
+		// between the last two ticks that the frame falls on
+		{
+			ProfileScope scope(g_FrameProfiler, "Prepare view");
+			g_ViewManager->PrepareSceneView((float)(accumulatedTime / FIXED_TIMESTEP));
+		}
+
+		// load the parts of the scene near the camera and unload the rest
+		{
+			ProfileScope scope(g_FrameProfiler, "Streaming");
+			glm::vec3 cameraPosition;
+			glm::vec3 cameraFront;
+			g_ViewManager->GetCameraPose(cameraPosition, cameraFront);
+			g_SceneManager->UpdateStreaming(cameraPosition);
+		}
+
+		// cull the scene objects and cluster the lights in the prepared view
+		g_SceneManager->SetViewFrustum(g_ViewManager->GetViewProjection());
+		g_SceneManager->SetViewMatrices(g_ViewManager->GetViewMatrix(), g_ViewManager->GetProjectionMatrix());
+
+		// refresh the 3D scene
+		{
+			ProfileScope scope(g_FrameProfiler, "Render scene");
+			g_SceneManager->RenderScene();
+		}
+
+		// Flips the the back buffer with the front buffer every frame.
+		{
+			ProfileScope scope(g_FrameProfiler, "Swap buffers");
+			glfwSwapBuffers(g_Window);
+		}
+		g_FramePacer->EndFrame();
+		g_FrameProfiler->EndFrame(g_SceneManager->GetRenderStats());
+
+		if (options.bProfileOverlay)
+		{
+			g_FrameProfiler->UpdateOverlay(g_Window, WINDOW_TITLE);
+		}
+	}
+
+	// keep the flown path for replaying in the benchmark
+	if (!options.recordPathFile.empty())
+	{
+		if (recordedPath.Save(options.recordPathFile))
+		{
+			std::cout << "INFO: Camera path written to " << options.recordPathFile << std::endl;
+		}
+		else
+		{
+			std::cerr << "ERROR: Could not write the camera path to "
+				<< options.recordPathFile << std::endl;
+		}
+	}
 }
 
 /***********************************************************
@@ -174,4 +478,216 @@ bool InitializeGLEW()
 	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
 
 	return(true);
-}
\ No newline at end of file
+}
+
+/***********************************************************
+ *	ParseCommandLine()
+ *
+ *  This function is used to read the present mode, frame
+ *  pacing, window size, scene, profiling and benchmark
+ *  options from the command line. The interactive station
+ *  wants the lowest latency, with --vsync off
+ *  --frames-in-flight 1, and the kiosk displays the least
+ *  power, with --vsync on --fps-cap 30.
+ ***********************************************************/
+bool ParseCommandLine(
+	int argc,
+	char* argv[],
+	COMMAND_LINE_OPTIONS& options)
+{
+	FRAME_PACING_SETTINGS& pacingSettings = options.pacingSettings;
+	RENDER_BENCHMARK_SETTINGS& benchmarkSettings = options.benchmarkSettings;
+
+	for (int i = 1; i < argc; i++)
+	{
+		// every option but the flags takes a value
+		const char* value = (i + 1 < argc) ? argv[i + 1] : "";
+		char* valueEnd = NULL;
+		bool bValid = false;
+		bool bHasValue = true;
+
+		if (strcmp(argv[i], "--profile-overlay") == 0)
+		{
+			options.bProfileOverlay = true;
+			bValid = true;
+			bHasValue = false;
+		}
+		else if (strcmp(argv[i], "--benchmark") == 0)
+		{
+			options.bRunBenchmark = true;
+			bValid = true;
+			bHasValue = false;
+		}
+		else if (strcmp(argv[i], "--cull-benchmark") == 0)
+		{
+			options.bRunCullBenchmark = true;
+			bValid = true;
+			bHasValue = false;
+		}
+		else if (strcmp(argv[i], "--profile-dump") == 0)
+		{
+			options.profileDumpPrefix = value;
+			bValid = !options.profileDumpPrefix.empty();
+		}
+		else if (strcmp(argv[i], "--vsync") == 0)
+		{
+			bValid = FramePacer::ParsePresentMode(value, pacingSettings.presentMode);
+		}
+		else if (strcmp(argv[i], "--fps-cap") == 0)
+		{
+			pacingSettings.maxFrameRate = strtod(value, &valueEnd);
+			bValid = (valueEnd != value) && (*valueEnd == '\0') &&
+				(pacingSettings.maxFrameRate >= 0.0);
+		}
+		else if (strcmp(argv[i], "--frames-in-flight") == 0)
+		{
+			pacingSettings.maxFramesInFlight = (int)strtol(value, &valueEnd, 10);
+			bValid = (valueEnd != value) && (*valueEnd == '\0') &&
+				(pacingSettings.maxFramesInFlight >= 0);
+		}
+		else if (strcmp(argv[i], "--window") == 0)
+		{
+			// the size is given as the width and height with an x between
+			options.windowWidth = (int)strtol(value, &valueEnd, 10);
+			if ((valueEnd != value) && (*valueEnd == 'x'))
+			{
+				const char* heightStart = valueEnd + 1;
+				options.windowHeight = (int)strtol(heightStart, &valueEnd, 10);
+				bValid = (valueEnd != heightStart) && (*valueEnd == '\0') &&
+					(options.windowWidth > 0) && (options.windowHeight > 0);
+			}
+		}
+		else if (strcmp(argv[i], "--scene") == 0)
+		{
+			options.sceneFile = value;
+			bValid = !options.sceneFile.empty();
+		}
+		else if (strcmp(argv[i], "--scene-scale") == 0)
+		{
+			options.sceneScale = (int)strtol(value, &valueEnd, 10);
+			bValid = (valueEnd != value) && (*valueEnd == '\0') &&
+				(options.sceneScale >= 1);
+		}
+		else if (strcmp(argv[i], "--texture-budget") == 0)
+		{
+			options.textureBudgetMB = (int)strtol(value, &valueEnd, 10);
+			bValid = (valueEnd != value) && (*valueEnd == '\0') &&
+				(options.textureBudgetMB >= 0);
+		}
+		else if (strcmp(argv[i], "--depth-prepass") == 0)
+		{
+			bValid = (strcmp(value, "on") == 0) || (strcmp(value, "off") == 0);
+			options.bDepthPrePass = (strcmp(value, "on") == 0);
+		}
+		else if (strcmp(argv[i], "--transparency") == 0)
+		{
+			bValid = (strcmp(value, "sorted") == 0) || (strcmp(value, "weighted") == 0);
+			options.bWeightedTransparency = (strcmp(value, "weighted") == 0);
+		}
+		else if (strcmp(argv[i], "--shadows") == 0)
+		{
+			bValid = (strcmp(value, "on") == 0) || (strcmp(value, "off") == 0);
+			options.bShadows = (strcmp(value, "on") == 0);
+		}
+		else if (strcmp(argv[i], "--mesh-lod") == 0)
+		{
+			bValid = (strcmp(value, "off") == 0) || (strcmp(value, "on") == 0) ||
+				(strcmp(value, "dither") == 0);
+			options.bMeshLOD = (strcmp(value, "off") != 0);
+			options.bLODDither = (strcmp(value, "dither") == 0);
+		}
+		else if (strcmp(argv[i], "--dynamic-ring") == 0)
+		{
+			bValid = (strcmp(value, "on") == 0) || (strcmp(value, "off") == 0);
+			options.bDynamicRing = (strcmp(value, "on") == 0);
+		}
+		else if (strcmp(argv[i], "--job-threads") == 0)
+		{
+			options.jobThreads = (int)strtol(value, &valueEnd, 10);
+			bValid = (valueEnd != value) && (*valueEnd == '\0') &&
+				(options.jobThreads >= 0);
+		}
+#ifdef _DEBUG
+		else if (strcmp(argv[i], "--show-overdraw") == 0)
+		{
+			options.bShowOverdraw = true;
+			bValid = true;
+			bHasValue = false;
+		}
+#endif
+		else if (strcmp(argv[i], "--record-path") == 0)
+		{
+			options.recordPathFile = value;
+			bValid = !options.recordPathFile.empty();
+		}
+		else if (strcmp(argv[i], "--benchmark-frames") == 0)
+		{
+			// every measured frame is kept by the profiler
+			benchmarkSettings.frameCount = (int)strtol(value, &valueEnd, 10);
+			bValid = (valueEnd != value) && (*valueEnd == '\0') &&
+				(benchmarkSettings.frameCount >= 1) &&
+				(benchmarkSettings.frameCount <= FrameProfiler::MAX_RECORDED_FRAMES);
+		}
+		else if (strcmp(argv[i], "--benchmark-warmup") == 0)
+		{
+			benchmarkSettings.warmupFrames = (int)strtol(value, &valueEnd, 10);
+			bValid = (valueEnd != value) && (*valueEnd == '\0') &&
+				(benchmarkSettings.warmupFrames >= 0);
+		}
+		else if (strcmp(argv[i], "--benchmark-output") == 0)
+		{
+			benchmarkSettings.outputFile = value;
+			bValid = !benchmarkSettings.outputFile.empty();
+		}
+		else if (strcmp(argv[i], "--camera-path") == 0)
+		{
+			benchmarkSettings.cameraPathFile = value;
+			bValid = !benchmarkSettings.cameraPathFile.empty();
+		}
+
+		if (bValid == false)
+		{
+			std::cerr << "Invalid option: " << argv[i] << " " << value << "\n"
+				<< "Options:\n"
+				<< "  --vsync off|on|adaptive   how frames line up with the display refresh\n"
+				<< "  --fps-cap N               hold the frame rate to N, 0 for no cap\n"
+				<< "  --frames-in-flight N      frames queued ahead of the GPU, 0 for no limit\n"
+				<< "  --window WxH              size of the display window\n"
+				<< "  --scene FILE              load the scene from FILE, reloaded when saved\n"
+				<< "  --scene-scale N           draw N copies of the scene side by side\n"
+				<< "  --texture-budget MB       texture memory kept loaded, 0 for no limit\n"
+				<< "  --depth-prepass on|off    draw the opaque depth before shading it\n"
+				<< "  --transparency sorted|weighted\n"
+				<< "                            sort the translucent objects back to front, or\n"
+				<< "                            blend them in any order with weighted blending\n"
+				<< "  --shadows on|off          shadow the scene from the light that casts them\n"
+				<< "  --mesh-lod off|on|dither  draw the curved shapes with fewer triangles when\n"
+				<< "                            small, dithering the switch between levels\n"
+				<< "  --dynamic-ring on|off     write the moving objects' matrices into a mapped\n"
+				<< "                            ring, or upload them with the other instances\n"
+				<< "  --job-threads N           threads the culling, sorting and command building\n"
+				<< "                            are split across, 0 for one per hardware thread\n"
+#ifdef _DEBUG
+				<< "  --show-overdraw           color each pixel by how many times it is shaded\n"
+#endif
+				<< "  --profile-overlay         show the frame timings in the window title\n"
+				<< "  --profile-dump PREFIX     write the frame timings to PREFIX.csv and PREFIX.json\n"
+				<< "  --record-path FILE        record the camera path flown to FILE\n"
+				<< "  --benchmark               render along a camera path in a hidden window,\n"
+				<< "                            print the timings as JSON and exit\n"
+				<< "  --benchmark-frames N      frames measured by the benchmark, at most "
+				<< FrameProfiler::MAX_RECORDED_FRAMES << "\n"
+				<< "  --benchmark-warmup N      frames drawn before the benchmark measures\n"
+				<< "  --benchmark-output FILE   write the benchmark JSON to FILE\n"
+				<< "  --camera-path FILE        camera path the benchmark flies, an orbit if unset\n"
+				<< "  --cull-benchmark          time the frustum culling and exit" << std::endl;
+			return(false);
+		}
+		if (bHasValue)
+		{
+			i++;
+		}
+	}
+
+	return(true);
+}
@@ -0,0 +1,282 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderbenchmark.cpp
+// ============
+// render a fixed number of frames along a camera path and report the timings
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderBenchmark.h"
+#include "CameraPath.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// declaration of the benchmark settings
+namespace
+{
+	// simulated time between frames, every frame sees the same
+	// camera however long the frames before it took
+	const double BENCHMARK_TIMESTEP = 1.0 / 60.0;
+
+	// the orbit flown when no camera path is given, its radius is
+	// kept inside the far plane of the projection
+	const float ORBIT_DURATION = 20.0f;
+	const int ORBIT_KEYS = 72;
+	const float ORBIT_MAX_RADIUS = 60.0f;
+
+	// the draw counters of the measured frames
+	struct COUNTER_TOTALS
+	{
+		double total = 0.0;
+		int maximum = 0;
+
+		void Add(int value)
+		{
+			total += value;
+			maximum = glm::max(maximum, value);
+		}
+	};
+
+	/***********************************************************
+	 *  WriteString()
+	 *
+	 *  Write the passed in text as a JSON string, escaping the
+	 *  backslashes of Windows paths and any quotes.
+	 ***********************************************************/
+	void WriteString(std::ostream& output, const std::string& text)
+	{
+		output << "\"";
+		for (char character : text)
+		{
+			if ((character == '\\') || (character == '"'))
+			{
+				output << '\\';
+			}
+			output << character;
+		}
+		output << "\"";
+	}
+
+	/***********************************************************
+	 *  WriteStats()
+	 *
+	 *  Write the passed in statistics as a JSON object.
+	 ***********************************************************/
+	void WriteStats(std::ostream& output, const PROFILE_STATS& stats)
+	{
+		output << "{\"samples\": " << stats.sampleCount
+			<< ", \"average\": " << stats.average
+			<< ", \"p50\": " << stats.p50
+			<< ", \"p95\": " << stats.p95
+			<< ", \"p99\": " << stats.p99
+			<< ", \"max\": " << stats.maximum << "}";
+	}
+
+	/***********************************************************
+	 *  WriteCounter()
+	 *
+	 *  Write the average and maximum of a counter as a JSON
+	 *  object.
+	 ***********************************************************/
+	void WriteCounter(std::ostream& output, const COUNTER_TOTALS& counter, int frameCount)
+	{
+		output << "{\"average\": " << counter.total / glm::max(1, frameCount)
+			<< ", \"max\": " << counter.maximum << "}";
+	}
+}
+
+/***********************************************************
+ *  RunRenderBenchmark()
+ *
+ *  This function is used for measuring how fast the prepared
+ *  scene renders. Every texture is loaded first, then the
+ *  camera flies the path one fixed time step per frame, so
+ *  every run draws exactly the same frames. The warm up
+ *  frames are drawn and thrown away, the rest are recorded
+ *  by the frame profiler and summed up as JSON.
+ ***********************************************************/
+bool RunRenderBenchmark(
+	GLFWwindow* window,
+	ViewManager* pViewManager,
+	SceneManager* pSceneManager,
+	FramePacer* pFramePacer,
+	FrameProfiler* pFrameProfiler,
+	const RENDER_BENCHMARK_SETTINGS& settings)
+{
+	CameraPath cameraPath;
+	std::string pathName = "orbit";
+	if (!settings.cameraPathFile.empty())
+	{
+		if (!cameraPath.Load(settings.cameraPathFile))
+		{
+			std::cerr << "ERROR: Could not load the camera path " << settings.cameraPathFile << std::endl;
+			return(false);
+		}
+		pathName = settings.cameraPathFile;
+	}
+	else
+	{
+		// circle the whole scene from a little above it
+		BOUNDING_VOLUME bounds = pSceneManager->GetSceneBounds();
+		float radius = glm::min(bounds.radius * 1.2f, ORBIT_MAX_RADIUS);
+		cameraPath.MakeOrbit(bounds.center, radius, radius * 0.4f, ORBIT_DURATION, ORBIT_KEYS);
+	}
+
+	// stream in the scene around the start of the path, frames
+	// would otherwise draw placeholders until the textures
+	// finish loading in the background
+	glm::vec3 startPosition;
+	glm::vec3 startFront;
+	cameraPath.Sample(0.0f, startPosition, startFront);
+	pSceneManager->UpdateStreaming(startPosition);
+	pSceneManager->FinishTextureLoading();
+
+	COUNTER_TOTALS drawCalls;
+	COUNTER_TOTALS indirectCommands;
+	COUNTER_TOTALS prePassDrawCalls;
+	COUNTER_TOTALS stateChanges;
+	COUNTER_TOTALS stateChangesSkipped;
+	COUNTER_TOTALS objectsDrawn;
+	COUNTER_TOTALS triangles;
+
+	pFrameProfiler->SetRecording(false);
+
+	int totalFrames = settings.warmupFrames + settings.frameCount;
+	for (int frame = 0; frame < totalFrames; frame++)
+	{
+		bool bMeasured = (frame >= settings.warmupFrames);
+		if (frame == settings.warmupFrames)
+		{
+			pFrameProfiler->ClearRecording();
+			pFrameProfiler->SetRecording(true);
+		}
+
+		pFramePacer->WaitForNextFrame();
+		pFrameProfiler->BeginFrame();
+		glfwPollEvents();
+
+		glm::vec3 cameraPosition;
+		glm::vec3 cameraFront;
+		cameraPath.Sample((float)(frame * BENCHMARK_TIMESTEP), cameraPosition, cameraFront);
+		pViewManager->SetCameraPose(cameraPosition, cameraFront);
+		// the spinning objects turn by the same step every run
+		pSceneManager->AnimateSceneObjects((float)BENCHMARK_TIMESTEP);
+
+		// chunks streamed in along the path are loaded right away,
+		// so every run draws the same frames
+		{
+			ProfileScope scope(pFrameProfiler, "Streaming");
+			if (pSceneManager->UpdateStreaming(cameraPosition))
+			{
+				pSceneManager->FinishTextureLoading();
+			}
+		}
+
+		glEnable(GL_DEPTH_TEST);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		{
+			ProfileScope scope(pFrameProfiler, "Prepare view");
+			pViewManager->PrepareSceneView(1.0f);
+		}
+		pSceneManager->SetViewFrustum(pViewManager->GetViewProjection());
+		pSceneManager->SetViewMatrices(pViewManager->GetViewMatrix(), pViewManager->GetProjectionMatrix());
+		{
+			ProfileScope scope(pFrameProfiler, "Render scene");
+			pSceneManager->RenderScene();
+		}
+		{
+			ProfileScope scope(pFrameProfiler, "Swap buffers");
+			glfwSwapBuffers(window);
+		}
+
+		const RENDER_STATS& renderStats = pSceneManager->GetRenderStats();
+		pFramePacer->EndFrame();
+		pFrameProfiler->EndFrame(renderStats);
+
+		if (bMeasured)
+		{
+			drawCalls.Add(renderStats.drawCalls);
+			indirectCommands.Add(renderStats.indirectCommands);
+			prePassDrawCalls.Add(renderStats.prePassDrawCalls);
+			stateChanges.Add(renderStats.stateChanges);
+			stateChangesSkipped.Add(renderStats.stateChangesSkipped);
+			objectsDrawn.Add(renderStats.objectsDrawn);
+			triangles.Add(renderStats.trianglesDrawn);
+		}
+	}
+
+	// read back the GPU times of the last frames
+	pFrameProfiler->Flush();
+	pFrameProfiler->SetRecording(false);
+
+	std::ofstream outputFile;
+	if (!settings.outputFile.empty())
+	{
+		outputFile.open(settings.outputFile);
+		if (!outputFile)
+		{
+			std::cerr << "ERROR: Could not write the benchmark results to " << settings.outputFile << std::endl;
+			return(false);
+		}
+	}
+	std::ostream& output = settings.outputFile.empty() ? std::cout : outputFile;
+
+	int windowWidth = 0;
+	int windowHeight = 0;
+	glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
+
+	PROFILE_STATS stats;
+	output << std::fixed << std::setprecision(4);
+	output << "{\n";
+	output << "  \"frames\": " << settings.frameCount << ",\n";
+	output << "  \"warmup_frames\": " << settings.warmupFrames << ",\n";
+	output << "  \"camera_path\": ";
+	WriteString(output, pathName);
+	output << ",\n";
+	output << "  \"resolution\": [" << windowWidth << ", " << windowHeight << "],\n";
+	output << "  \"scene_objects\": " << pSceneManager->GetSceneObjectCount() << ",\n";
+
+	output << "  \"frame_time_ms\": ";
+	pFrameProfiler->GetRecordedStats("Frame", false, stats);
+	WriteStats(output, stats);
+	output << ",\n  \"gpu_time_ms\": ";
+	pFrameProfiler->GetRecordedStats("Frame", true, stats);
+	WriteStats(output, stats);
+
+	output << ",\n  \"scopes\": {";
+	for (int i = 0; i < pFrameProfiler->GetScopeCount(); i++)
+	{
+		const char* name = pFrameProfiler->GetScopeName(i);
+		output << ((i == 0) ? "\n" : ",\n") << "    \"" << name << "\": {\"cpu_ms\": ";
+		pFrameProfiler->GetRecordedStats(name, false, stats);
+		WriteStats(output, stats);
+		output << ", \"gpu_ms\": ";
+		pFrameProfiler->GetRecordedStats(name, true, stats);
+		WriteStats(output, stats);
+		output << "}";
+	}
+	output << "\n  },\n";
+
+	output << "  \"draw_calls\": ";
+	WriteCounter(output, drawCalls, settings.frameCount);
+	output << ",\n  \"indirect_commands\": ";
+	WriteCounter(output, indirectCommands, settings.frameCount);
+	output << ",\n  \"prepass_draw_calls\": ";
+	WriteCounter(output, prePassDrawCalls, settings.frameCount);
+	output << ",\n  \"state_changes\": ";
+	WriteCounter(output, stateChanges, settings.frameCount);
+	output << ",\n  \"state_changes_skipped\": ";
+	WriteCounter(output, stateChangesSkipped, settings.frameCount);
+	output << ",\n  \"objects_drawn\": ";
+	WriteCounter(output, objectsDrawn, settings.frameCount);
+	output << ",\n  \"triangles\": ";
+	WriteCounter(output, triangles, settings.frameCount);
+	output << "\n}" << std::endl;
+
+	return(output.good());
+}
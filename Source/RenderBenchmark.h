@@ -0,0 +1,41 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderbenchmark.h
+// ============
+// render a fixed number of frames along a camera path and report the timings
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+
+#include <string>
+
+// the benchmark run chosen on the command line
+struct RENDER_BENCHMARK_SETTINGS
+{
+	// frames measured, after the warm up frames
+	int frameCount = 1000;
+	// frames drawn before measuring, while caches and drivers settle
+	int warmupFrames = 60;
+	// camera path file to fly, an orbit around the scene when empty
+	std::string cameraPathFile;
+	// file the JSON results are written to, standard output when empty
+	std::string outputFile;
+};
+
+// render the prepared scene along the camera path with a fixed time
+// step per frame and write the frame times, GPU times and draw
+// counters as JSON, false if the path or output could not be used
+bool RunRenderBenchmark(
+	GLFWwindow* window,
+	ViewManager* pViewManager,
+	SceneManager* pSceneManager,
+	FramePacer* pFramePacer,
+	FrameProfiler* pFrameProfiler,
+	const RENDER_BENCHMARK_SETTINGS& settings);
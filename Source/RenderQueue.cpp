@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ============
+// sort the scene draws by render state before they are submitted
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 14th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+// declaration of the sort key layout, from the most significant
+// bits to the least significant bits
+namespace
+{
+	const int TRANSLUCENT_SHIFT = 63;
+	const int SHADER_SHIFT = 56;
+	const int TEXTURE_SHIFT = 40;
+	const int MESH_SHIFT = 32;
+	const int MATERIAL_SHIFT = 24;
+
+	const uint64_t SHADER_MASK = 0x7F;
+	// the texture groups run past the array pages by one for every
+	// texture of its own, so they get 16 bits
+	const uint64_t TEXTURE_MASK = 0xFFFF;
+	const uint64_t FIELD_MASK = 0xFF;
+	// room for 16 million scene objects
+	const uint64_t INDEX_MASK = 0xFFFFFF;
+}
+
+// declaration of the sort settings
+namespace
+{
+	// queues shorter than this are sorted on the calling thread,
+	// since waking the workers would cost more than it saves
+	const int PARALLEL_SORT_SIZE = 4096;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the queued draws.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_items.clear();
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for queuing a draw of the scene
+ *  object at the passed in index with its sort key.
+ ***********************************************************/
+void RenderQueue::Add(uint64_t sortKey, int objectIndex)
+{
+	RENDER_ITEM item;
+	item.sortKey = sortKey;
+	item.objectIndex = objectIndex;
+	m_items.push_back(item);
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for sorting the queued draws by their
+ *  sort keys. The object index in the low bits keeps draws
+ *  with the same state in their scene order. With a job
+ *  system, a block of the queue is sorted on each thread
+ *  and the sorted blocks are merged in pairs, in rounds
+ *  that each halve the number of blocks.
+ ***********************************************************/
+void RenderQueue::Sort(JobSystem* pJobSystem)
+{
+	auto compare = [](const RENDER_ITEM& a, const RENDER_ITEM& b)
+		{
+			return(a.sortKey < b.sortKey);
+		};
+
+	int count = (int)m_items.size();
+	if ((NULL == pJobSystem) || (pJobSystem->GetThreadCount() == 1) ||
+		(count < PARALLEL_SORT_SIZE))
+	{
+		std::sort(m_items.begin(), m_items.end(), compare);
+		return;
+	}
+
+	int blockSize = JobSystem::GetRangeCount(count, pJobSystem->GetThreadCount());
+	pJobSystem->ParallelFor(count, blockSize, [this, &compare](int first, int end, int /*thread*/)
+		{
+			std::sort(m_items.begin() + first, m_items.begin() + end, compare);
+		});
+
+	for (int width = blockSize; width < count; width *= 2)
+	{
+		int pairCount = JobSystem::GetRangeCount(count, width * 2);
+		pJobSystem->ParallelFor(pairCount, 1, [this, &compare, count, width](int first, int end, int /*thread*/)
+			{
+				for (int pair = first; pair < end; pair++)
+				{
+					int begin = pair * width * 2;
+					int middle = std::min(begin + width, count);
+					int last = std::min(begin + width * 2, count);
+					if (middle < last)
+					{
+						std::inplace_merge(m_items.begin() + begin, m_items.begin() + middle,
+							m_items.begin() + last, compare);
+					}
+				}
+			});
+	}
+}
+
+/***********************************************************
+ *  GetItems()
+ *
+ *  This method is used for getting the queued draws.
+ ***********************************************************/
+const std::vector<RENDER_ITEM>& RenderQueue::GetItems() const
+{
+	return(m_items);
+}
+
+/***********************************************************
+ *  MakeOpaqueKey()
+ *
+ *  This method is used for building the sort key of an
+ *  opaque draw from its render state. The mesh is sorted
+ *  before the material so that objects sharing a texture and
+ *  mesh end up next to each other and can be drawn instanced.
+ *  Handles of -1 (no texture or no material) sort before all
+ *  valid handles. Texture groups too large for their field
+ *  all sort last, together, rather than wrapping around onto
+ *  the groups of other textures.
+ ***********************************************************/
+uint64_t RenderQueue::MakeOpaqueKey(
+	int shader,
+	int textureHandle,
+	int materialHandle,
+	int mesh,
+	int objectIndex)
+{
+	uint64_t sortKey = 0;
+
+	sortKey |= ((uint64_t)shader & SHADER_MASK) << SHADER_SHIFT;
+	sortKey |= std::min((uint64_t)(textureHandle + 1), TEXTURE_MASK) << TEXTURE_SHIFT;
+	sortKey |= ((uint64_t)(materialHandle + 1) & FIELD_MASK) << MATERIAL_SHIFT;
+	sortKey |= ((uint64_t)mesh & FIELD_MASK) << MESH_SHIFT;
+	sortKey |= ((uint64_t)objectIndex & INDEX_MASK);
+
+	return(sortKey);
+}
+
+/***********************************************************
+ *  MakeTranslucentKey()
+ *
+ *  This method is used for building the sort key of a
+ *  translucent draw. Translucent draws are sorted after all
+ *  of the opaque draws and keep their scene order, since
+ *  blending depends on the order they are drawn in.
+ ***********************************************************/
+uint64_t RenderQueue::MakeTranslucentKey(int objectIndex)
+{
+	uint64_t sortKey = (uint64_t)1 << TRANSLUCENT_SHIFT;
+	sortKey |= ((uint64_t)objectIndex & INDEX_MASK);
+
+	return(sortKey);
+}
@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// sort the scene draws by render state before they are submitted
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 14th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "JobSystem.h"
+
+#include <cstdint>
+#include <vector>
+
+// per-frame counters for the draws submitted by the scene
+struct RENDER_STATS
+{
+	int drawCalls;
+	// draws submitted inside multi-draw indirect calls
+	int indirectCommands;
+	// draw calls of the depth pre-pass, kept out of the other draw
+	// counters so they read the same with the pre-pass on or off
+	int prePassDrawCalls;
+	int stateChanges;
+	int stateChangesSkipped;
+	int objectsDrawn;
+	// scene objects tested against the view frustum
+	int objectsVisible;
+	int objectsCulled;
+	// triangles submitted by every draw call
+	int trianglesDrawn;
+};
+
+// a single draw in the render queue
+struct RENDER_ITEM
+{
+	uint64_t sortKey;
+	int objectIndex;
+};
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class holds the draws of the scene ordered by a sort
+ *  key, so that draws sharing the same shader, texture,
+ *  mesh and material are submitted next to each other.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// remove all of the queued draws
+	void Clear();
+	// queue a draw of the scene object at the passed in index
+	void Add(uint64_t sortKey, int objectIndex);
+	// sort the queued draws by their sort keys, across the threads
+	// of the job system when one is passed in
+	void Sort(JobSystem* pJobSystem = NULL);
+	// get the queued draws in submission order
+	const std::vector<RENDER_ITEM>& GetItems() const;
+
+	// build the sort key of an opaque draw, the handles may be -1
+	static uint64_t MakeOpaqueKey(
+		int shader,
+		int textureHandle,
+		int materialHandle,
+		int mesh,
+		int objectIndex);
+	// build the sort key of a translucent draw, these are drawn
+	// after every opaque draw and keep their scene order
+	static uint64_t MakeTranslucentKey(int objectIndex);
+
+private:
+	// queued draws
+	std::vector<RENDER_ITEM> m_items;
+};
@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+// resourcecache.cpp
+// ============
+// keep the streamed resources within a memory budget, freeing the least used
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ResourceCache.h"
+
+/***********************************************************
+ *  ResourceCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ResourceCache::ResourceCache()
+{
+	m_budget = 0;
+	m_totalSize = 0;
+	m_frame = 0;
+}
+
+/***********************************************************
+ *  SetBudget()
+ *
+ *  This method is used for setting the bytes of memory that
+ *  the resident resources may take, 0 for no limit.
+ ***********************************************************/
+void ResourceCache::SetBudget(size_t budget)
+{
+	m_budget = budget;
+}
+
+/***********************************************************
+ *  GetBudget()
+ *
+ *  This method is used for getting the memory budget.
+ ***********************************************************/
+size_t ResourceCache::GetBudget() const
+{
+	return(m_budget);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a new frame. Resources
+ *  used before it can be picked to be freed again.
+ ***********************************************************/
+void ResourceCache::BeginFrame()
+{
+	m_frame++;
+}
+
+/***********************************************************
+ *  Use()
+ *
+ *  This method is used for marking a resource as used this
+ *  frame, moving it to the front of the list. A resource that
+ *  is not resident yet is added with the passed in size.
+ ***********************************************************/
+void ResourceCache::Use(int id, size_t size)
+{
+	std::unordered_map<int, std::list<CACHE_ENTRY>::iterator>::iterator found = m_lookup.find(id);
+	if (found != m_lookup.end())
+	{
+		// splicing keeps every iterator into the list valid
+		m_entries.splice(m_entries.begin(), m_entries, found->second);
+		m_entries.front().lastUsedFrame = m_frame;
+		SetSize(id, size);
+		return;
+	}
+
+	CACHE_ENTRY entry;
+	entry.id = id;
+	entry.size = size;
+	entry.lastUsedFrame = m_frame;
+	entry.bPinned = false;
+	m_entries.push_front(entry);
+	m_lookup[id] = m_entries.begin();
+	m_totalSize += size;
+}
+
+/***********************************************************
+ *  SetSize()
+ *
+ *  This method is used for updating the memory taken by a
+ *  resident resource, such as once its data has loaded.
+ ***********************************************************/
+void ResourceCache::SetSize(int id, size_t size)
+{
+	std::unordered_map<int, std::list<CACHE_ENTRY>::iterator>::iterator found = m_lookup.find(id);
+	if (found == m_lookup.end())
+	{
+		return;
+	}
+
+	m_totalSize += size - found->second->size;
+	found->second->size = size;
+}
+
+/***********************************************************
+ *  SetPinned()
+ *
+ *  This method is used for keeping a resident resource from
+ *  being picked to be freed, or letting it be picked again.
+ ***********************************************************/
+void ResourceCache::SetPinned(int id, bool bPinned)
+{
+	std::unordered_map<int, std::list<CACHE_ENTRY>::iterator>::iterator found = m_lookup.find(id);
+	if (found != m_lookup.end())
+	{
+		found->second->bPinned = bPinned;
+	}
+}
+
+/***********************************************************
+ *  Remove()
+ *
+ *  This method is used for forgetting a resident resource,
+ *  such as when its owner freed it.
+ ***********************************************************/
+void ResourceCache::Remove(int id)
+{
+	std::unordered_map<int, std::list<CACHE_ENTRY>::iterator>::iterator found = m_lookup.find(id);
+	if (found == m_lookup.end())
+	{
+		return;
+	}
+
+	m_totalSize -= found->second->size;
+	m_entries.erase(found->second);
+	m_lookup.erase(found);
+}
+
+/***********************************************************
+ *  Contains()
+ *
+ *  This method is used for checking if a resource is resident.
+ ***********************************************************/
+bool ResourceCache::Contains(int id) const
+{
+	return(m_lookup.find(id) != m_lookup.end());
+}
+
+/***********************************************************
+ *  CollectEvictions()
+ *
+ *  This method is used for picking resources to free, from
+ *  the least recently used up, until the rest fit in the
+ *  budget. The walk stops at the first resource used this
+ *  frame, since every one in front of it was used this frame
+ *  too. Pinned resources are stepped over.
+ ***********************************************************/
+void ResourceCache::CollectEvictions(std::vector<int>& evictions)
+{
+	if (m_budget == 0)
+	{
+		return;
+	}
+
+	std::list<CACHE_ENTRY>::iterator entry = m_entries.end();
+	while ((m_totalSize > m_budget) && (entry != m_entries.begin()))
+	{
+		--entry;
+		if (entry->lastUsedFrame == m_frame)
+		{
+			break;
+		}
+		if (entry->bPinned)
+		{
+			continue;
+		}
+
+		evictions.push_back(entry->id);
+		m_totalSize -= entry->size;
+		m_lookup.erase(entry->id);
+		entry = m_entries.erase(entry);
+	}
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of resident
+ *  resources.
+ ***********************************************************/
+int ResourceCache::GetCount() const
+{
+	return((int)m_entries.size());
+}
+
+/***********************************************************
+ *  GetTotalSize()
+ *
+ *  This method is used for getting the memory taken by the
+ *  resident resources.
+ ***********************************************************/
+size_t ResourceCache::GetTotalSize() const
+{
+	return(m_totalSize);
+}
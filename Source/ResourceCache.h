@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// resourcecache.h
+// ============
+// keep the streamed resources within a memory budget, freeing the least used
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  ResourceCache
+ *
+ *  This class keeps the resident resources in the order they
+ *  were last used, along with the memory each one takes. Once
+ *  they take more than the budget, the least recently used
+ *  ones are picked to be freed. Resources used this frame and
+ *  pinned ones, such as those still loading, are never picked,
+ *  so the budget can be overrun while everything in view is
+ *  needed. The cache only does the bookkeeping, its owner
+ *  frees what is picked.
+ ***********************************************************/
+class ResourceCache
+{
+public:
+	// constructor
+	ResourceCache();
+
+	// set the bytes the resources may take, 0 for no limit
+	void SetBudget(size_t budget);
+	size_t GetBudget() const;
+
+	// start a new frame, resources used from now on are kept
+	void BeginFrame();
+
+	// add a resource as the most recently used, or mark it used
+	// again and update its size when it is already resident
+	void Use(int id, size_t size);
+	// update the size of a resident resource
+	void SetSize(int id, size_t size);
+	// keep a resident resource from being picked while pinned
+	void SetPinned(int id, bool bPinned);
+	// forget a resident resource
+	void Remove(int id);
+	// check if a resource is resident
+	bool Contains(int id) const;
+
+	// pick the least recently used resources to free until the rest
+	// fit in the budget, they are removed from the cache
+	void CollectEvictions(std::vector<int>& evictions);
+
+	// get the number of resident resources and the bytes they take
+	int GetCount() const;
+	size_t GetTotalSize() const;
+
+private:
+	// a resident resource, the list runs from most to least
+	// recently used
+	struct CACHE_ENTRY
+	{
+		int id;
+		size_t size;
+		unsigned int lastUsedFrame;
+		bool bPinned;
+	};
+
+	std::list<CACHE_ENTRY> m_entries;
+	std::unordered_map<int, std::list<CACHE_ENTRY>::iterator> m_lookup;
+	size_t m_budget;
+	size_t m_totalSize;
+	unsigned int m_frame;
+};
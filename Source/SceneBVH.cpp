@@ -0,0 +1,392 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebvh.cpp
+// ============
+// bounding volume hierarchy over the scene objects for culling and picking
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBVH.h"
+
+#include <algorithm>
+#include <limits>
+
+// declaration of the traversal limits
+namespace
+{
+	// the tree is split at the median, so its depth stays close
+	// to log2 of the item count and the stack never gets deep
+	const int MAX_TRAVERSAL_DEPTH = 64;
+}
+
+/***********************************************************
+ *  SceneBVH()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneBVH::SceneBVH()
+{
+	// the tree is empty until it is built
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the tree over the passed
+ *  in bounding volumes. Any previous tree is thrown away.
+ ***********************************************************/
+void SceneBVH::Build(const std::vector<BOUNDING_VOLUME>& itemBounds)
+{
+	m_nodes.clear();
+	m_itemLeaves.assign(itemBounds.size(), -1);
+
+	if (itemBounds.empty())
+	{
+		return;
+	}
+
+	std::vector<int> items(itemBounds.size());
+	for (int i = 0; i < (int)items.size(); i++)
+	{
+		items[i] = i;
+	}
+
+	// a tree with one item per leaf has 2n-1 nodes
+	m_nodes.reserve(items.size() * 2 - 1);
+	BuildNode(items, 0, (int)items.size(), -1, itemBounds);
+}
+
+/***********************************************************
+ *  Refit()
+ *
+ *  This method is used for moving a single item to its new
+ *  bounds, then growing or shrinking every branch above it
+ *  to fit its two children again. Only the path to the root
+ *  is touched, the shape of the tree stays the same.
+ ***********************************************************/
+void SceneBVH::Refit(int item, const BOUNDING_VOLUME& bounds)
+{
+	if ((item < 0) || (item >= (int)m_itemLeaves.size()))
+	{
+		return;
+	}
+
+	int node = m_itemLeaves[item];
+	m_nodes[node].bounds = bounds;
+	node = m_nodes[node].parent;
+
+	while (node != -1)
+	{
+		BVH_NODE& branch = m_nodes[node];
+		branch.bounds = Frustum::MergeBounds(
+			m_nodes[branch.left].bounds,
+			m_nodes[branch.right].bounds);
+		node = branch.parent;
+	}
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for adding every item that may be
+ *  visible in the frustum to the passed in list. Branches
+ *  outside the frustum are skipped, and branches fully
+ *  inside it are added without testing their items.
+ ***********************************************************/
+void SceneBVH::Cull(const Frustum& frustum, std::vector<int>& visibleItems) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	CullBranch(frustum, 0, visibleItems);
+}
+
+/***********************************************************
+ *  SplitCull()
+ *
+ *  This method is used for opening the top of the tree one
+ *  level at a time, until at least the passed in number of
+ *  branches are left to cull. Branches outside the frustum
+ *  are dropped on the way, and branches fully inside it or
+ *  leaves are listed without opening them. Every listed
+ *  branch is then culled with CullBranch(), so each can be
+ *  handed to a different thread.
+ ***********************************************************/
+void SceneBVH::SplitCull(const Frustum& frustum, int branchCount, std::vector<int>& branches) const
+{
+	branches.clear();
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	std::vector<int> openBranches(1, 0);
+	std::vector<int> nextBranches;
+	while (!openBranches.empty() && ((int)(openBranches.size() + branches.size()) < branchCount))
+	{
+		nextBranches.clear();
+		for (int branch : openBranches)
+		{
+			const BVH_NODE& node = m_nodes[branch];
+			if (node.item >= 0)
+			{
+				branches.push_back(branch);
+				continue;
+			}
+
+			FRUSTUM_RESULT result = frustum.Classify(node.bounds);
+			if (result == FRUSTUM_INSIDE)
+			{
+				branches.push_back(branch);
+			}
+			else if (result == FRUSTUM_INTERSECTING)
+			{
+				nextBranches.push_back(node.left);
+				nextBranches.push_back(node.right);
+			}
+		}
+		openBranches.swap(nextBranches);
+	}
+
+	branches.insert(branches.end(), openBranches.begin(), openBranches.end());
+}
+
+/***********************************************************
+ *  CullBranch()
+ *
+ *  This method is used for adding every item below the
+ *  passed in branch that may be visible in the frustum to
+ *  the passed in list, the same way Cull() does for the
+ *  whole tree.
+ ***********************************************************/
+void SceneBVH::CullBranch(const Frustum& frustum, int branch, std::vector<int>& visibleItems) const
+{
+	int stack[MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	stack[stackSize++] = branch;
+
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = m_nodes[stack[--stackSize]];
+
+		// leaves are tested like the linear culling would test them
+		if (node.item >= 0)
+		{
+			if (frustum.IsVisible(node.bounds))
+			{
+				visibleItems.push_back(node.item);
+			}
+			continue;
+		}
+
+		FRUSTUM_RESULT result = frustum.Classify(node.bounds);
+		if (result == FRUSTUM_INSIDE)
+		{
+			GatherItems(node.left, visibleItems);
+			GatherItems(node.right, visibleItems);
+		}
+		else if (result == FRUSTUM_INTERSECTING)
+		{
+			stack[stackSize++] = node.right;
+			stack[stackSize++] = node.left;
+		}
+	}
+}
+
+/***********************************************************
+ *  Raycast()
+ *
+ *  This method is used for finding the item with the nearest
+ *  box along the ray. Branches that the ray misses, or only
+ *  enters beyond the nearest hit so far, are skipped.
+ ***********************************************************/
+int SceneBVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float& hitDistance) const
+{
+	int hitItem = -1;
+	hitDistance = std::numeric_limits<float>::max();
+
+	if (m_nodes.empty())
+	{
+		return(hitItem);
+	}
+
+	// a zero direction component divides to infinity, which the
+	// slab test handles as a ray parallel to that slab
+	const glm::vec3 inverseDirection = 1.0f / direction;
+
+	int stack[MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = m_nodes[stack[--stackSize]];
+
+		float entryDistance = 0.0f;
+		if (!IntersectRay(node.bounds, origin, inverseDirection, hitDistance, entryDistance))
+		{
+			continue;
+		}
+
+		if (node.item >= 0)
+		{
+			hitItem = node.item;
+			hitDistance = entryDistance;
+		}
+		else
+		{
+			stack[stackSize++] = node.right;
+			stack[stackSize++] = node.left;
+		}
+	}
+
+	return(hitItem);
+}
+
+/***********************************************************
+ *  GetItemCount()
+ *
+ *  This method is used for getting the number of items the
+ *  tree was built over.
+ ***********************************************************/
+int SceneBVH::GetItemCount() const
+{
+	return((int)m_itemLeaves.size());
+}
+
+/***********************************************************
+ *  BuildNode()
+ *
+ *  This method is used for building the branch over count
+ *  items of the item list starting at first. The items are
+ *  split in half along the axis their centers spread the
+ *  most on, which keeps the tree balanced.
+ ***********************************************************/
+int SceneBVH::BuildNode(
+	std::vector<int>& items,
+	int first,
+	int count,
+	int parent,
+	const std::vector<BOUNDING_VOLUME>& itemBounds)
+{
+	int nodeIndex = (int)m_nodes.size();
+
+	BVH_NODE node;
+	node.bounds = itemBounds[items[first]];
+	node.left = -1;
+	node.right = -1;
+	node.parent = parent;
+	node.item = -1;
+
+	if (count == 1)
+	{
+		node.item = items[first];
+		m_nodes.push_back(node);
+		m_itemLeaves[node.item] = nodeIndex;
+		return(nodeIndex);
+	}
+
+	glm::vec3 centerMinimum = itemBounds[items[first]].center;
+	glm::vec3 centerMaximum = centerMinimum;
+	for (int i = first + 1; i < first + count; i++)
+	{
+		const BOUNDING_VOLUME& bounds = itemBounds[items[i]];
+		node.bounds = Frustum::MergeBounds(node.bounds, bounds);
+		centerMinimum = glm::min(centerMinimum, bounds.center);
+		centerMaximum = glm::max(centerMaximum, bounds.center);
+	}
+
+	glm::vec3 spread = centerMaximum - centerMinimum;
+	int axis = 0;
+	if (spread.y > spread[axis])
+	{
+		axis = 1;
+	}
+	if (spread.z > spread[axis])
+	{
+		axis = 2;
+	}
+
+	int half = count / 2;
+	std::nth_element(
+		items.begin() + first,
+		items.begin() + first + half,
+		items.begin() + first + count,
+		[&itemBounds, axis](int a, int b)
+		{
+			return(itemBounds[a].center[axis] < itemBounds[b].center[axis]);
+		});
+
+	// the node is added before its children, so they are
+	// linked to it by index as the vector grows
+	m_nodes.push_back(node);
+	int left = BuildNode(items, first, half, nodeIndex, itemBounds);
+	int right = BuildNode(items, first + half, count - half, nodeIndex, itemBounds);
+	m_nodes[nodeIndex].left = left;
+	m_nodes[nodeIndex].right = right;
+
+	return(nodeIndex);
+}
+
+/***********************************************************
+ *  GatherItems()
+ *
+ *  This method is used for adding every item in the branch
+ *  below the passed in node to the list.
+ ***********************************************************/
+void SceneBVH::GatherItems(int node, std::vector<int>& items) const
+{
+	int stack[MAX_TRAVERSAL_DEPTH];
+	int stackSize = 0;
+	stack[stackSize++] = node;
+
+	while (stackSize > 0)
+	{
+		const BVH_NODE& current = m_nodes[stack[--stackSize]];
+		if (current.item >= 0)
+		{
+			items.push_back(current.item);
+		}
+		else
+		{
+			stack[stackSize++] = current.right;
+			stack[stackSize++] = current.left;
+		}
+	}
+}
+
+/***********************************************************
+ *  IntersectRay()
+ *
+ *  This method is used for checking if the ray hits the box
+ *  before maxDistance, with the slab test. The distance the
+ *  ray enters the box at is returned, or 0 if it starts
+ *  inside the box.
+ ***********************************************************/
+bool SceneBVH::IntersectRay(
+	const BOUNDING_VOLUME& bounds,
+	const glm::vec3& origin,
+	const glm::vec3& inverseDirection,
+	float maxDistance,
+	float& entryDistance)
+{
+	glm::vec3 toMinimum = (bounds.center - bounds.extents - origin) * inverseDirection;
+	glm::vec3 toMaximum = (bounds.center + bounds.extents - origin) * inverseDirection;
+
+	glm::vec3 nearest = glm::min(toMinimum, toMaximum);
+	glm::vec3 farthest = glm::max(toMinimum, toMaximum);
+
+	float entry = glm::max(glm::max(nearest.x, nearest.y), glm::max(nearest.z, 0.0f));
+	float exit = glm::min(glm::min(farthest.x, farthest.y), farthest.z);
+
+	if ((entry > exit) || (entry >= maxDistance))
+	{
+		return(false);
+	}
+
+	entryDistance = entry;
+	return(true);
+}
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebvh.h
+// ============
+// bounding volume hierarchy over the scene objects for culling and picking
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Frustum.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  SceneBVH
+ *
+ *  This class builds a binary tree of bounding volumes over
+ *  a list of items, with one item in every leaf. Whole
+ *  branches can then be skipped or accepted when culling
+ *  against the view frustum or casting a picking ray. Items
+ *  that move are refit in place without rebuilding the tree.
+ ***********************************************************/
+class SceneBVH
+{
+public:
+	// constructor
+	SceneBVH();
+
+	// build the tree over the passed in bounds, the item of each
+	// bounding volume is its index in the list
+	void Build(const std::vector<BOUNDING_VOLUME>& itemBounds);
+	// move a single item and refit the branches above it
+	void Refit(int item, const BOUNDING_VOLUME& bounds);
+	// add every item that may be visible in the frustum
+	void Cull(const Frustum& frustum, std::vector<int>& visibleItems) const;
+	// list at least the passed in number of branches that together
+	// hold every item that may be visible, when the tree has them,
+	// so they can be culled on separate threads
+	void SplitCull(const Frustum& frustum, int branchCount, std::vector<int>& branches) const;
+	// add every item below a branch that may be visible in the frustum
+	void CullBranch(const Frustum& frustum, int branch, std::vector<int>& visibleItems) const;
+	// find the nearest item whose box is hit by the ray, or -1
+	int Raycast(const glm::vec3& origin, const glm::vec3& direction, float& hitDistance) const;
+	// get the number of items in the tree
+	int GetItemCount() const;
+
+private:
+	// a branch or leaf of the tree, leaves have no children
+	struct BVH_NODE
+	{
+		BOUNDING_VOLUME bounds;
+		int left;
+		int right;
+		int parent;
+		int item;
+	};
+
+	// nodes of the tree, the root is the first node
+	std::vector<BVH_NODE> m_nodes;
+	// the leaf node that holds each item
+	std::vector<int> m_itemLeaves;
+
+	// build the branch over a range of the item list
+	int BuildNode(
+		std::vector<int>& items,
+		int first,
+		int count,
+		int parent,
+		const std::vector<BOUNDING_VOLUME>& itemBounds);
+	// add every item below the passed in node
+	void GatherItems(int node, std::vector<int>& items) const;
+	// check where the ray enters the box, if it hits it at all
+	static bool IntersectRay(
+		const BOUNDING_VOLUME& bounds,
+		const glm::vec3& origin,
+		const glm::vec3& inverseDirection,
+		float maxDistance,
+		float& entryDistance);
+};
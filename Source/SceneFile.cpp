@@ -0,0 +1,1041 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// load scene descriptions from text files through a memory mapped binary cache
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+#include "SceneMeshes.h"
+#include "TextureSamplers.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// declaration of the cache file layout
+namespace
+{
+	// "SCNB" in the first four bytes of every cache file
+	const uint32_t CACHE_MAGIC = 0x424E4353;
+
+	// raise this whenever a record or the text format changes, so
+	// the scenes cached by older builds are compiled again
+	const uint32_t CACHE_VERSION = 5;
+
+	// the fixed part at the start of every cache file, followed by
+	// the texture, material, light, chunk and object records and
+	// then the string table
+	struct CACHE_HEADER
+	{
+		uint32_t magic;
+		uint32_t version;
+		// stamp of the text file the cache was compiled from
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		uint32_t textureCount;
+		uint32_t materialCount;
+		uint32_t lightCount;
+		uint32_t chunkCount;
+		uint32_t objectCount;
+		uint32_t stringTableSize;
+	};
+
+	// names of the mesh shapes, in MESH_SHAPE order
+	const char* const SHAPE_NAMES[MESH_SHAPE_COUNT] =
+	{
+		"box",
+		"cone",
+		"cylinder",
+		"plane",
+		"sphere",
+		"half_sphere",
+		"torus",
+		"half_torus",
+		"tapered_cylinder"
+	};
+
+	// names of the texture filters, in TEXTURE_FILTER order
+	const char* const FILTER_NAMES[3] =
+	{
+		"bilinear",
+		"trilinear",
+		"anisotropic"
+	};
+
+	/***********************************************************
+	 *  FindName()
+	 *
+	 *  Find the passed in name in a list of names, or -1.
+	 ***********************************************************/
+	int FindName(const std::string& name, const char* const* names, int nameCount)
+	{
+		for (int i = 0; i < nameCount; i++)
+		{
+			if (name == names[i])
+			{
+				return(i);
+			}
+		}
+		return(-1);
+	}
+
+	/***********************************************************
+	 *  AppendBytes()
+	 *
+	 *  Append the bytes of the passed in records to the data.
+	 ***********************************************************/
+	template <typename RECORD>
+	void AppendBytes(std::vector<unsigned char>& data, const RECORD* records, size_t count)
+	{
+		const unsigned char* bytes = (const unsigned char*)records;
+		data.insert(data.end(), bytes, bytes + sizeof(RECORD) * count);
+	}
+
+	// builds the string table, storing every distinct string once
+	class StringTable
+	{
+	public:
+		StringTable()
+		{
+			// offset 0 is the empty string
+			m_table.push_back('\0');
+		}
+
+		uint32_t Add(const std::string& text)
+		{
+			if (text.empty())
+			{
+				return(0);
+			}
+
+			std::unordered_map<std::string, uint32_t>::iterator found = m_offsets.find(text);
+			if (found != m_offsets.end())
+			{
+				return(found->second);
+			}
+
+			uint32_t offset = (uint32_t)m_table.size();
+			m_table.insert(m_table.end(), text.begin(), text.end());
+			m_table.push_back('\0');
+			m_offsets[text] = offset;
+			return(offset);
+		}
+
+		const std::vector<char>& GetTable() const
+		{
+			return(m_table);
+		}
+
+	private:
+		std::vector<char> m_table;
+		std::unordered_map<std::string, uint32_t> m_offsets;
+	};
+}
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_pMappedView = NULL;
+	m_mappedSize = 0;
+	m_bFromCache = false;
+	m_pTextures = NULL;
+	m_pMaterials = NULL;
+	m_pLights = NULL;
+	m_pChunks = NULL;
+	m_pObjects = NULL;
+	m_pStrings = NULL;
+	m_textureCount = 0;
+	m_materialCount = 0;
+	m_lightCount = 0;
+	m_chunkCount = 0;
+	m_objectCount = 0;
+	m_stringTableSize = 0;
+}
+
+/***********************************************************
+ *  ~SceneFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneFile::~SceneFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for loading the scene of the passed in
+ *  text file. Its cache file is mapped and used as is when it
+ *  was compiled from the text file as it is now. Otherwise
+ *  the text is compiled and the cache written for next time.
+ *  When only the cache file is there, it is used without the
+ *  check, so a scene can be shipped compiled.
+ ***********************************************************/
+bool SceneFile::Load(const std::string& filename)
+{
+	Close();
+
+	std::string cachePath = GetCachePath(filename);
+	SCENE_FILE_STAMP stamp;
+	bool bHasSource = GetFileStamp(filename, stamp);
+
+	if (MapCacheFile(cachePath))
+	{
+		if (UseData((const unsigned char*)m_pMappedView, m_mappedSize, bHasSource ? &stamp : NULL))
+		{
+			m_bFromCache = true;
+			return(true);
+		}
+		UnmapCacheFile();
+	}
+
+	if (!bHasSource)
+	{
+		std::cerr << "ERROR: Could not open the scene file " << filename << std::endl;
+		return(false);
+	}
+
+	if (!Compile(filename, stamp, m_compiledData) ||
+		!UseData(m_compiledData.data(), m_compiledData.size(), &stamp))
+	{
+		Close();
+		return(false);
+	}
+
+	if (!WriteCacheFile(cachePath, m_compiledData))
+	{
+		std::cout << "Could not write the scene cache " << cachePath << std::endl;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for releasing the loaded scene.
+ ***********************************************************/
+void SceneFile::Close()
+{
+	UnmapCacheFile();
+	m_compiledData.clear();
+	m_compiledData.shrink_to_fit();
+	m_bFromCache = false;
+	m_pTextures = NULL;
+	m_pMaterials = NULL;
+	m_pLights = NULL;
+	m_pChunks = NULL;
+	m_pObjects = NULL;
+	m_pStrings = NULL;
+	m_textureCount = 0;
+	m_materialCount = 0;
+	m_lightCount = 0;
+	m_chunkCount = 0;
+	m_objectCount = 0;
+	m_stringTableSize = 0;
+}
+
+/***********************************************************
+ *  IsFromCache()
+ *
+ *  This method is used for checking whether the loaded scene
+ *  was read from the binary cache instead of compiled.
+ ***********************************************************/
+bool SceneFile::IsFromCache() const
+{
+	return(m_bFromCache);
+}
+
+/***********************************************************
+ *  GetTextureCount()
+ *
+ *  This method is used for getting the number of textures.
+ ***********************************************************/
+int SceneFile::GetTextureCount() const
+{
+	return(m_textureCount);
+}
+
+/***********************************************************
+ *  GetTextureRecord()
+ *
+ *  This method is used for getting a texture record.
+ ***********************************************************/
+const SCENE_TEXTURE_RECORD& SceneFile::GetTextureRecord(int index) const
+{
+	return(m_pTextures[index]);
+}
+
+/***********************************************************
+ *  GetMaterialCount()
+ *
+ *  This method is used for getting the number of materials.
+ ***********************************************************/
+int SceneFile::GetMaterialCount() const
+{
+	return(m_materialCount);
+}
+
+/***********************************************************
+ *  GetMaterialRecord()
+ *
+ *  This method is used for getting a material record.
+ ***********************************************************/
+const SCENE_MATERIAL_RECORD& SceneFile::GetMaterialRecord(int index) const
+{
+	return(m_pMaterials[index]);
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method is used for getting the number of lights.
+ ***********************************************************/
+int SceneFile::GetLightCount() const
+{
+	return(m_lightCount);
+}
+
+/***********************************************************
+ *  GetLightRecord()
+ *
+ *  This method is used for getting a light record.
+ ***********************************************************/
+const SCENE_LIGHT_RECORD& SceneFile::GetLightRecord(int index) const
+{
+	return(m_pLights[index]);
+}
+
+/***********************************************************
+ *  GetChunkCount()
+ *
+ *  This method is used for getting the number of chunks.
+ ***********************************************************/
+int SceneFile::GetChunkCount() const
+{
+	return(m_chunkCount);
+}
+
+/***********************************************************
+ *  GetChunkRecord()
+ *
+ *  This method is used for getting a chunk record.
+ ***********************************************************/
+const SCENE_CHUNK_RECORD& SceneFile::GetChunkRecord(int index) const
+{
+	return(m_pChunks[index]);
+}
+
+/***********************************************************
+ *  GetObjectCount()
+ *
+ *  This method is used for getting the number of objects.
+ ***********************************************************/
+int SceneFile::GetObjectCount() const
+{
+	return(m_objectCount);
+}
+
+/***********************************************************
+ *  GetObjectRecord()
+ *
+ *  This method is used for getting an object record.
+ ***********************************************************/
+const SCENE_OBJECT_RECORD& SceneFile::GetObjectRecord(int index) const
+{
+	return(m_pObjects[index]);
+}
+
+/***********************************************************
+ *  GetString()
+ *
+ *  This method is used for getting a string of the scene by
+ *  its offset in the string table. Every offset was checked
+ *  when the scene was loaded.
+ ***********************************************************/
+const char* SceneFile::GetString(uint32_t offset) const
+{
+	if ((NULL == m_pStrings) || (offset >= m_stringTableSize))
+	{
+		return("");
+	}
+	return(m_pStrings + offset);
+}
+
+/***********************************************************
+ *  GetFileStamp()
+ *
+ *  This method is used for getting the size and last write
+ *  time of the passed in file.
+ ***********************************************************/
+bool SceneFile::GetFileStamp(const std::string& filename, SCENE_FILE_STAMP& stamp)
+{
+#ifdef _WIN32
+	struct _stat64 fileStatus;
+	if (_stat64(filename.c_str(), &fileStatus) != 0)
+	{
+		return(false);
+	}
+#else
+	struct stat fileStatus;
+	if (stat(filename.c_str(), &fileStatus) != 0)
+	{
+		return(false);
+	}
+#endif
+
+	stamp.size = (uint64_t)fileStatus.st_size;
+	stamp.writeTime = (int64_t)fileStatus.st_mtime;
+	return(true);
+}
+
+/***********************************************************
+ *  GetShapeName()
+ *
+ *  This method is used for getting the name the passed in
+ *  mesh shape is written with in a scene file.
+ ***********************************************************/
+const char* SceneFile::GetShapeName(int shape)
+{
+	if ((shape < 0) || (shape >= MESH_SHAPE_COUNT))
+	{
+		return("unknown");
+	}
+
+	return(SHAPE_NAMES[shape]);
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method is used for getting the name of the cache
+ *  file of a scene file, which sits next to it.
+ ***********************************************************/
+std::string SceneFile::GetCachePath(const std::string& filename)
+{
+	return(filename + ".bin");
+}
+
+/***********************************************************
+ *  Compile()
+ *
+ *  This method is used for parsing the passed in text file
+ *  into the layout of a cache file. Each line starts with
+ *  the kind of entry, followed by its values:
+ *
+ *    texture <tag> <image file>
+ *    material <tag> ambient r g b strength s diffuse r g b
+ *        specular r g b shininess s filter <filter> anisotropy n
+ *    light <index> position x y z ambient r g b diffuse r g b
+ *        specular r g b focal f intensity i range r
+ *        shadow on|off
+ *    chunk <name> distance d
+ *    object <shape> position x y z rotation x y z scale x y z
+ *        color r g b a uv u v texture <tag> material <tag>
+ *        spin x y z
+ *
+ *  Every value after the first is optional and can come in
+ *  any order, and # starts a comment. Objects belong to the
+ *  last chunk above them, and are always loaded when there
+ *  is none. Any error fails the
+ *  whole file, so a half saved file never replaces a scene.
+ ***********************************************************/
+bool SceneFile::Compile(
+	const std::string& filename,
+	const SCENE_FILE_STAMP& stamp,
+	std::vector<unsigned char>& data)
+{
+	std::ifstream file(filename);
+	if (!file)
+	{
+		std::cerr << "ERROR: Could not open the scene file " << filename << std::endl;
+		return(false);
+	}
+
+	std::vector<SCENE_TEXTURE_RECORD> textures;
+	std::vector<SCENE_MATERIAL_RECORD> materials;
+	std::vector<SCENE_LIGHT_RECORD> lights;
+	std::vector<SCENE_CHUNK_RECORD> chunks;
+	std::vector<SCENE_OBJECT_RECORD> objects;
+	StringTable strings;
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+
+		size_t commentStart = line.find('#');
+		if (commentStart != std::string::npos)
+		{
+			line.erase(commentStart);
+		}
+
+		std::istringstream values(line);
+		std::string kind;
+		if (!(values >> kind))
+		{
+			continue;
+		}
+
+		std::string error;
+		std::string name;
+		std::string key;
+
+		if (kind == "texture")
+		{
+			SCENE_TEXTURE_RECORD texture;
+			std::string imageFile;
+			if (values >> name >> imageFile)
+			{
+				texture.tag = strings.Add(name);
+				texture.filename = strings.Add(imageFile);
+				textures.push_back(texture);
+			}
+			else
+			{
+				error = "a texture needs a tag and an image file";
+			}
+		}
+		else if (kind == "material")
+		{
+			SCENE_MATERIAL_RECORD material;
+			material.ambientStrength = 0.0f;
+			material.ambientColor = glm::vec3(0.0f);
+			material.diffuseColor = glm::vec3(0.0f);
+			material.specularColor = glm::vec3(0.0f);
+			material.shininess = 0.0f;
+			material.textureFilter = FILTER_ANISOTROPIC;
+			material.maxAnisotropy = 8.0f;
+
+			if (!(values >> name))
+			{
+				error = "a material needs a tag";
+			}
+			material.tag = strings.Add(name);
+
+			while (error.empty() && (values >> key))
+			{
+				bool bRead = false;
+				if (key == "ambient")
+				{
+					bRead = (bool)(values >> material.ambientColor.r >> material.ambientColor.g >> material.ambientColor.b);
+				}
+				else if (key == "strength")
+				{
+					bRead = (bool)(values >> material.ambientStrength);
+				}
+				else if (key == "diffuse")
+				{
+					bRead = (bool)(values >> material.diffuseColor.r >> material.diffuseColor.g >> material.diffuseColor.b);
+				}
+				else if (key == "specular")
+				{
+					bRead = (bool)(values >> material.specularColor.r >> material.specularColor.g >> material.specularColor.b);
+				}
+				else if (key == "shininess")
+				{
+					bRead = (bool)(values >> material.shininess);
+				}
+				else if (key == "anisotropy")
+				{
+					bRead = (bool)(values >> material.maxAnisotropy);
+				}
+				else if (key == "filter")
+				{
+					std::string filterName;
+					if (values >> filterName)
+					{
+						material.textureFilter = FindName(filterName, FILTER_NAMES, 3);
+						bRead = (material.textureFilter >= 0);
+					}
+				}
+
+				if (!bRead)
+				{
+					error = "bad material value " + key;
+				}
+			}
+
+			if (error.empty())
+			{
+				materials.push_back(material);
+			}
+		}
+		else if (kind == "light")
+		{
+			SCENE_LIGHT_RECORD light;
+			light.index = -1;
+			light.position = glm::vec3(0.0f);
+			light.ambientColor = glm::vec3(0.0f);
+			light.diffuseColor = glm::vec3(0.0f);
+			light.specularColor = glm::vec3(0.0f);
+			light.focalStrength = 0.0f;
+			light.specularIntensity = 0.0f;
+			light.range = 0.0f;
+			light.castsShadow = 0;
+
+			if (!(values >> light.index) || (light.index < 0))
+			{
+				error = "a light needs an index";
+			}
+
+			while (error.empty() && (values >> key))
+			{
+				bool bRead = false;
+				if (key == "position")
+				{
+					bRead = (bool)(values >> light.position.x >> light.position.y >> light.position.z);
+				}
+				else if (key == "ambient")
+				{
+					bRead = (bool)(values >> light.ambientColor.r >> light.ambientColor.g >> light.ambientColor.b);
+				}
+				else if (key == "diffuse")
+				{
+					bRead = (bool)(values >> light.diffuseColor.r >> light.diffuseColor.g >> light.diffuseColor.b);
+				}
+				else if (key == "specular")
+				{
+					bRead = (bool)(values >> light.specularColor.r >> light.specularColor.g >> light.specularColor.b);
+				}
+				else if (key == "focal")
+				{
+					bRead = (bool)(values >> light.focalStrength);
+				}
+				else if (key == "intensity")
+				{
+					bRead = (bool)(values >> light.specularIntensity);
+				}
+				else if (key == "range")
+				{
+					bRead = (bool)(values >> light.range) && (light.range >= 0.0f);
+				}
+				else if (key == "shadow")
+				{
+					std::string shadow;
+					bRead = (bool)(values >> shadow) && ((shadow == "on") || (shadow == "off"));
+					light.castsShadow = (shadow == "on") ? 1 : 0;
+				}
+
+				if (!bRead)
+				{
+					error = "bad light value " + key;
+				}
+			}
+
+			if (error.empty())
+			{
+				lights.push_back(light);
+			}
+		}
+		else if (kind == "chunk")
+		{
+			SCENE_CHUNK_RECORD chunk;
+			chunk.loadDistance = 0.0f;
+
+			if (!(values >> name))
+			{
+				error = "a chunk needs a name";
+			}
+			chunk.name = strings.Add(name);
+
+			while (error.empty() && (values >> key))
+			{
+				bool bRead = false;
+				if (key == "distance")
+				{
+					bRead = (bool)(values >> chunk.loadDistance) && (chunk.loadDistance >= 0.0f);
+				}
+
+				if (!bRead)
+				{
+					error = "bad chunk value " + key;
+				}
+			}
+
+			if (error.empty())
+			{
+				chunks.push_back(chunk);
+			}
+		}
+		else if (kind == "object")
+		{
+			SCENE_OBJECT_RECORD sceneObject;
+			sceneObject.shape = -1;
+			sceneObject.position = glm::vec3(0.0f);
+			sceneObject.rotations = glm::vec3(0.0f);
+			sceneObject.scale = glm::vec3(1.0f);
+			sceneObject.color = glm::vec4(1.0f);
+			sceneObject.uvScale = glm::vec2(1.0f);
+			sceneObject.texture = 0;
+			sceneObject.material = 0;
+			sceneObject.spin = glm::vec3(0.0f);
+			sceneObject.chunk = (int32_t)chunks.size() - 1;
+
+			if (values >> name)
+			{
+				sceneObject.shape = FindName(name, SHAPE_NAMES, MESH_SHAPE_COUNT);
+			}
+			if (sceneObject.shape < 0)
+			{
+				error = "an object needs a shape";
+			}
+
+			while (error.empty() && (values >> key))
+			{
+				bool bRead = false;
+				if (key == "position")
+				{
+					bRead = (bool)(values >> sceneObject.position.x >> sceneObject.position.y >> sceneObject.position.z);
+				}
+				else if (key == "rotation")
+				{
+					bRead = (bool)(values >> sceneObject.rotations.x >> sceneObject.rotations.y >> sceneObject.rotations.z);
+				}
+				else if (key == "scale")
+				{
+					bRead = (bool)(values >> sceneObject.scale.x >> sceneObject.scale.y >> sceneObject.scale.z);
+				}
+				else if (key == "color")
+				{
+					bRead = (bool)(values >> sceneObject.color.r >> sceneObject.color.g >> sceneObject.color.b >> sceneObject.color.a);
+				}
+				else if (key == "uv")
+				{
+					bRead = (bool)(values >> sceneObject.uvScale.x >> sceneObject.uvScale.y);
+				}
+				else if (key == "texture")
+				{
+					bRead = (bool)(values >> name);
+					sceneObject.texture = strings.Add(name);
+				}
+				else if (key == "material")
+				{
+					bRead = (bool)(values >> name);
+					sceneObject.material = strings.Add(name);
+				}
+				else if (key == "spin")
+				{
+					bRead = (bool)(values >> sceneObject.spin.x >> sceneObject.spin.y >> sceneObject.spin.z);
+				}
+
+				if (!bRead)
+				{
+					error = "bad object value " + key;
+				}
+			}
+
+			if (error.empty())
+			{
+				objects.push_back(sceneObject);
+			}
+		}
+		else
+		{
+			error = "unknown entry " + kind;
+		}
+
+		if (!error.empty())
+		{
+			std::cerr << "ERROR: " << filename << "(" << lineNumber << "): " << error << std::endl;
+			return(false);
+		}
+	}
+
+	CACHE_HEADER header;
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.sourceSize = stamp.size;
+	header.sourceWriteTime = stamp.writeTime;
+	header.textureCount = (uint32_t)textures.size();
+	header.materialCount = (uint32_t)materials.size();
+	header.lightCount = (uint32_t)lights.size();
+	header.chunkCount = (uint32_t)chunks.size();
+	header.objectCount = (uint32_t)objects.size();
+	header.stringTableSize = (uint32_t)strings.GetTable().size();
+
+	data.clear();
+	AppendBytes(data, &header, 1);
+	AppendBytes(data, textures.data(), textures.size());
+	AppendBytes(data, materials.data(), materials.size());
+	AppendBytes(data, lights.data(), lights.size());
+	AppendBytes(data, chunks.data(), chunks.size());
+	AppendBytes(data, objects.data(), objects.size());
+	AppendBytes(data, strings.GetTable().data(), strings.GetTable().size());
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteCacheFile()
+ *
+ *  This method is used for writing compiled scene data to
+ *  the cache file, through a temporary file so that a partly
+ *  written cache is never mapped.
+ ***********************************************************/
+bool SceneFile::WriteCacheFile(const std::string& path, const std::vector<unsigned char>& data)
+{
+	std::string temporaryPath = path + ".tmp";
+
+	{
+		std::ofstream cacheFile(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!cacheFile)
+		{
+			return(false);
+		}
+
+		cacheFile.write((const char*)data.data(), data.size());
+		if (!cacheFile)
+		{
+			cacheFile.close();
+			std::remove(temporaryPath.c_str());
+			return(false);
+		}
+	}
+
+	// rename does not replace an existing file on every platform
+	std::remove(path.c_str());
+	if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+	{
+		std::remove(temporaryPath.c_str());
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  MapCacheFile()
+ *
+ *  This method is used for mapping the whole cache file into
+ *  memory, read only. The pages are only read from disk as
+ *  the records in them are used.
+ ***********************************************************/
+bool SceneFile::MapCacheFile(const std::string& path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return(false);
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart <= 0))
+	{
+		CloseHandle(file);
+		return(false);
+	}
+
+	// the view stays valid after both handles are closed
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	void* view = NULL;
+	if (mapping != NULL)
+	{
+		view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+	}
+	CloseHandle(file);
+
+	if (view == NULL)
+	{
+		return(false);
+	}
+
+	m_pMappedView = view;
+	m_mappedSize = (size_t)fileSize.QuadPart;
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return(false);
+	}
+
+	struct stat fileStatus;
+	if ((fstat(file, &fileStatus) != 0) || (fileStatus.st_size <= 0))
+	{
+		close(file);
+		return(false);
+	}
+
+	// the mapping stays valid after the file is closed
+	void* view = mmap(NULL, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (view == MAP_FAILED)
+	{
+		return(false);
+	}
+
+	m_pMappedView = view;
+	m_mappedSize = (size_t)fileStatus.st_size;
+#endif
+
+	return(true);
+}
+
+/***********************************************************
+ *  UnmapCacheFile()
+ *
+ *  This method is used for releasing the mapped cache file.
+ ***********************************************************/
+void SceneFile::UnmapCacheFile()
+{
+	if (NULL == m_pMappedView)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_pMappedView);
+#else
+	munmap(m_pMappedView, m_mappedSize);
+#endif
+
+	m_pMappedView = NULL;
+	m_mappedSize = 0;
+}
+
+/***********************************************************
+ *  UseData()
+ *
+ *  This method is used for checking compiled scene data and
+ *  pointing the record sections into it. The header has to
+ *  match the cache version and, when a stamp is passed in,
+ *  the text file. The sections have to fill the data exactly
+ *  and every string offset has to lie in the string table,
+ *  so a damaged cache is compiled again instead of read.
+ ***********************************************************/
+bool SceneFile::UseData(const unsigned char* data, size_t size, const SCENE_FILE_STAMP* pStamp)
+{
+	if (size < sizeof(CACHE_HEADER))
+	{
+		return(false);
+	}
+
+	const CACHE_HEADER* header = (const CACHE_HEADER*)data;
+	if ((header->magic != CACHE_MAGIC) || (header->version != CACHE_VERSION))
+	{
+		return(false);
+	}
+	if ((NULL != pStamp) &&
+		((header->sourceSize != pStamp->size) || (header->sourceWriteTime != pStamp->writeTime)))
+	{
+		return(false);
+	}
+
+	uint64_t expectedSize = sizeof(CACHE_HEADER) +
+		(uint64_t)header->textureCount * sizeof(SCENE_TEXTURE_RECORD) +
+		(uint64_t)header->materialCount * sizeof(SCENE_MATERIAL_RECORD) +
+		(uint64_t)header->lightCount * sizeof(SCENE_LIGHT_RECORD) +
+		(uint64_t)header->chunkCount * sizeof(SCENE_CHUNK_RECORD) +
+		(uint64_t)header->objectCount * sizeof(SCENE_OBJECT_RECORD) +
+		header->stringTableSize;
+	if ((expectedSize != size) || (header->stringTableSize == 0))
+	{
+		return(false);
+	}
+
+	const unsigned char* section = data + sizeof(CACHE_HEADER);
+	const SCENE_TEXTURE_RECORD* textures = (const SCENE_TEXTURE_RECORD*)section;
+	section += header->textureCount * sizeof(SCENE_TEXTURE_RECORD);
+	const SCENE_MATERIAL_RECORD* materials = (const SCENE_MATERIAL_RECORD*)section;
+	section += header->materialCount * sizeof(SCENE_MATERIAL_RECORD);
+	const SCENE_LIGHT_RECORD* lights = (const SCENE_LIGHT_RECORD*)section;
+	section += header->lightCount * sizeof(SCENE_LIGHT_RECORD);
+	const SCENE_CHUNK_RECORD* chunks = (const SCENE_CHUNK_RECORD*)section;
+	section += header->chunkCount * sizeof(SCENE_CHUNK_RECORD);
+	const SCENE_OBJECT_RECORD* objects = (const SCENE_OBJECT_RECORD*)section;
+	section += header->objectCount * sizeof(SCENE_OBJECT_RECORD);
+	const char* strings = (const char*)section;
+
+	// every string in the table ends inside it
+	uint32_t stringTableSize = header->stringTableSize;
+	if (strings[stringTableSize - 1] != '\0')
+	{
+		return(false);
+	}
+
+	for (uint32_t i = 0; i < header->textureCount; i++)
+	{
+		if ((textures[i].tag >= stringTableSize) || (textures[i].filename >= stringTableSize))
+		{
+			return(false);
+		}
+	}
+	for (uint32_t i = 0; i < header->materialCount; i++)
+	{
+		if ((materials[i].tag >= stringTableSize) ||
+			(materials[i].textureFilter < FILTER_BILINEAR) ||
+			(materials[i].textureFilter > FILTER_ANISOTROPIC))
+		{
+			return(false);
+		}
+	}
+	for (uint32_t i = 0; i < header->chunkCount; i++)
+	{
+		if (chunks[i].name >= stringTableSize)
+		{
+			return(false);
+		}
+	}
+	for (uint32_t i = 0; i < header->objectCount; i++)
+	{
+		if ((objects[i].texture >= stringTableSize) ||
+			(objects[i].material >= stringTableSize) ||
+			(objects[i].chunk < -1) ||
+			(objects[i].chunk >= (int32_t)header->chunkCount) ||
+			(objects[i].shape < 0) ||
+			(objects[i].shape >= MESH_SHAPE_COUNT))
+		{
+			return(false);
+		}
+	}
+
+	m_pTextures = textures;
+	m_pMaterials = materials;
+	m_pLights = lights;
+	m_pChunks = chunks;
+	m_pObjects = objects;
+	m_pStrings = strings;
+	m_textureCount = (int)header->textureCount;
+	m_materialCount = (int)header->materialCount;
+	m_lightCount = (int)header->lightCount;
+	m_chunkCount = (int)header->chunkCount;
+	m_objectCount = (int)header->objectCount;
+	m_stringTableSize = stringTableSize;
+
+	return(true);
+}
@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// load scene descriptions from text files through a memory mapped binary cache
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// the records below are stored in the binary cache exactly as they
+// are laid out here, so a mapped cache file is read in place, every
+// string is an offset into the string table, 0 for an empty string
+
+// a texture image file and the tag objects use it by
+struct SCENE_TEXTURE_RECORD
+{
+	uint32_t tag;
+	uint32_t filename;
+};
+
+// the lighting values and texture filtering of a material
+struct SCENE_MATERIAL_RECORD
+{
+	uint32_t tag;
+	float ambientStrength;
+	glm::vec3 ambientColor;
+	glm::vec3 diffuseColor;
+	glm::vec3 specularColor;
+	float shininess;
+	// a TEXTURE_FILTER value
+	int32_t textureFilter;
+	float maxAnisotropy;
+};
+
+// the values of one of the light sources
+struct SCENE_LIGHT_RECORD
+{
+	int32_t index;
+	glm::vec3 position;
+	glm::vec3 ambientColor;
+	glm::vec3 diffuseColor;
+	glm::vec3 specularColor;
+	float focalStrength;
+	float specularIntensity;
+	// distance the light fades out at, 0 to light the whole scene
+	float range;
+	// 1 when the light casts shadows, as if from far away
+	int32_t castsShadow;
+};
+
+// a part of the scene that is loaded and unloaded as a whole,
+// such as a room, by the distance of the camera from it
+struct SCENE_CHUNK_RECORD
+{
+	uint32_t name;
+	// the chunk is loaded once the camera comes this close to its
+	// bounds, 0 keeps it loaded all the time
+	float loadDistance;
+};
+
+// a scene object placed in the scene graph
+struct SCENE_OBJECT_RECORD
+{
+	// a MESH_SHAPE value
+	int32_t shape;
+	glm::vec3 position;
+	glm::vec3 rotations;
+	glm::vec3 scale;
+	glm::vec4 color;
+	glm::vec2 uvScale;
+	uint32_t texture;
+	uint32_t material;
+	// degrees per second the object turns about each axis, an object
+	// that turns is drawn as a dynamic object
+	glm::vec3 spin;
+	// the chunk the object is loaded with, -1 when it is always loaded
+	int32_t chunk;
+};
+
+// the size and last write time of a file, a change to either
+// means the file was saved again
+struct SCENE_FILE_STAMP
+{
+	uint64_t size;
+	int64_t writeTime;
+};
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class loads a scene described in a text file, with
+ *  one texture, material, light, chunk or object per line,
+ *  where the objects belong to the chunk above them. The text
+ *  is compiled into flat records and a string table, which
+ *  are written to a binary cache file next to it. Later loads
+ *  map the cache file into memory and use the records where
+ *  they lie, so only the header is checked and nothing is
+ *  parsed, until the text file is saved again.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// constructor
+	SceneFile();
+	// destructor
+	~SceneFile();
+
+	SceneFile(const SceneFile&) = delete;
+	SceneFile& operator=(const SceneFile&) = delete;
+
+	// load the scene of the passed in text file, from its cache
+	// when the cache is up to date, false if neither can be read
+	bool Load(const std::string& filename);
+	// release the loaded scene
+	void Close();
+	// whether the loaded scene came from the binary cache
+	bool IsFromCache() const;
+
+	// get the records of the loaded scene
+	int GetTextureCount() const;
+	const SCENE_TEXTURE_RECORD& GetTextureRecord(int index) const;
+	int GetMaterialCount() const;
+	const SCENE_MATERIAL_RECORD& GetMaterialRecord(int index) const;
+	int GetLightCount() const;
+	const SCENE_LIGHT_RECORD& GetLightRecord(int index) const;
+	int GetChunkCount() const;
+	const SCENE_CHUNK_RECORD& GetChunkRecord(int index) const;
+	int GetObjectCount() const;
+	const SCENE_OBJECT_RECORD& GetObjectRecord(int index) const;
+	// get a string of the loaded scene by its offset
+	const char* GetString(uint32_t offset) const;
+
+	// get the size and write time of a file, false if it is missing
+	static bool GetFileStamp(const std::string& filename, SCENE_FILE_STAMP& stamp);
+	// get the name of the cache file of a scene file
+	static std::string GetCachePath(const std::string& filename);
+	// get the name a MESH_SHAPE value is written with in a scene file
+	static const char* GetShapeName(int shape);
+
+private:
+	// the compiled scene, owned when it was compiled from the text
+	// and mapped when it was read from the cache
+	std::vector<unsigned char> m_compiledData;
+	void* m_pMappedView;
+	size_t m_mappedSize;
+	bool m_bFromCache;
+
+	// the sections of the loaded scene
+	const SCENE_TEXTURE_RECORD* m_pTextures;
+	const SCENE_MATERIAL_RECORD* m_pMaterials;
+	const SCENE_LIGHT_RECORD* m_pLights;
+	const SCENE_CHUNK_RECORD* m_pChunks;
+	const SCENE_OBJECT_RECORD* m_pObjects;
+	const char* m_pStrings;
+	int m_textureCount;
+	int m_materialCount;
+	int m_lightCount;
+	int m_chunkCount;
+	int m_objectCount;
+	uint32_t m_stringTableSize;
+
+	// parse the text file into the layout of a cache file
+	static bool Compile(
+		const std::string& filename,
+		const SCENE_FILE_STAMP& stamp,
+		std::vector<unsigned char>& data);
+	// write compiled data to the cache file, through a temporary file
+	static bool WriteCacheFile(const std::string& path, const std::vector<unsigned char>& data);
+	// map the cache file into memory, false if it is missing
+	bool MapCacheFile(const std::string& path);
+	// release the mapped cache file
+	void UnmapCacheFile();
+	// check the header and sections of compiled data and point the
+	// sections into it, false if it is from another source file,
+	// an older version or does not hold together
+	bool UseData(const unsigned char* data, size_t size, const SCENE_FILE_STAMP* pStamp);
+};
@@ -8,7 +8,6 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SceneManager.h"
-#include <functional>
 
 #ifndef STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -18,14 +17,30 @@
 #include <glm/gtx/transform.hpp>
 #include "object.h"
 
-// declaration of global variables
+#include <algorithm>
+
+// declaration of the streaming settings
+namespace
+{
+	// a loaded chunk is only unloaded once the camera is this much
+	// further away than its load distance, so a camera hovering
+	// at the edge does not load and unload it every frame
+	const float CHUNK_UNLOAD_FACTOR = 1.25f;
+}
+
+// declaration of the job settings
 namespace
 {
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
+	// number of items in each range the scene passes are split
+	// into, a scene with fewer runs each pass on the GL thread
+	const int ANIMATE_RANGE_SIZE = 1024;
+	const int CULL_RANGE_SIZE = 2048;
+	const int COMMAND_RANGE_SIZE = 4096;
+
+	// the hierarchy is split into this many branches per thread, so
+	// a thread given the branches with the most visible items is
+	// helped by the others
+	const int CULL_BRANCHES_PER_THREAD = 4;
 }
 
 /***********************************************************
@@ -33,18 +48,95 @@ namespace
  *
  *  The constructor for the class
  ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
+SceneManager::SceneManager(ShaderManager *pShaderManager, UniformCache *pUniformCache)
 {
 	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-
-	// initialize the texture collection
-	for (int i = 0; i < 16; i++)
-	{
-		m_textureIDs[i].tag = "/0";
-		m_textureIDs[i].ID = -1;
-	}
+	m_pUniformCache = pUniformCache;
+	m_sceneMeshes = new SceneMeshes();
+	// texture images are decoded on worker threads
+	m_pTextureLoader = new TextureLoader();
+	// objects sharing a mesh and texture are drawn instanced
+	m_bUseInstancing = true;
+	// the instanced batches are submitted with multi-draw indirect
+	// calls when OpenGL 4.3 is available
+	m_bUseMultiDrawIndirect = true;
+	m_bDrawCommandsDirty = true;
+	// the curved shapes lose triangles as they shrink on screen, the
+	// switch between levels is only dithered when asked for
+	m_bUseMeshLOD = true;
+	m_bUseLODDither = false;
+	m_bInstanceFadesDirty = false;
+	// the shadow maps are created in PrepareScene(), for the light
+	// the scene file gives shadows
+	m_pShadowMaps = new ShadowMaps();
+	m_bUseShadows = true;
+	m_shadowLightIndex = -1;
+	m_staticShadowCommandCount = 0;
+	m_shadowFirstCommand = 0;
+	// the matrices of the dynamic objects go through a ring that is
+	// made when the batches first have dynamic instances
+	m_pDynamicTransforms = new DynamicTransforms();
+	m_bUseDynamicTransforms = true;
+	// the scene passes are split across one thread per hardware
+	// thread unless fewer are asked for
+	m_pJobSystem = new JobSystem();
+	// objects outside the view are not submitted, once a view
+	// frustum has been set
+	m_bUseFrustumCulling = true;
+	m_bFrustumValid = false;
+	// culling walks the scene hierarchy instead of every object
+	m_bUseSceneBVH = true;
+	m_bInstancesDirty = false;
+	// the opaque objects are drawn into the depth buffer before
+	// they are shaded, since the big overlapping walls, floors and
+	// sky would otherwise be lit many times per pixel
+	m_bUseDepthPrePass = true;
+	m_bShowOverdraw = false;
+	// the translucent objects are sorted back to front unless
+	// weighted blending is asked for
+	m_pWeightedBlend = new WeightedBlendOIT();
+	m_bUseWeightedBlend = false;
+	// the render phases are only timed once a profiler is set
+	m_pFrameProfiler = NULL;
+	// the scene is built once unless more copies are asked for
+	m_sceneScale = 1;
+	// the scene is loaded from its file in PrepareScene()
+	m_sceneFilename = "Scenes/desk.scene";
+	m_sceneFileStamp = SCENE_FILE_STAMP();
+
+	// initialize the texture collection, the loaded textures are
+	// packed into array pages when OpenGL 4.3 is available
 	m_loadedTextures = 0;
+	m_pTextureArrays = new TextureArrays();
+	m_bUseTextureArrays = true;
+	// the samplers are created with the materials in PrepareScene()
+	m_pTextureSamplers = new TextureSamplers();
+	m_defaultSampler = INVALID_HANDLE;
+	// the textures are loaded as the chunks using them are streamed
+	// in, and freed least recently used first over the budget
+	m_pResidentTextures = new ResourceCache();
+	m_pResidentTextures->SetBudget((size_t)DEFAULT_TEXTURE_BUDGET_MB * 1024 * 1024);
+	m_streamingPosition = glm::vec3(0.0f);
+	m_bStreamingPositionSet = false;
+
+	// the render queue is built on the first frame
+	m_bRenderQueueDirty = true;
+	ResetRenderState();
+
+	// the light uniform buffer is uploaded on the first frame
+	m_lightBlock = LIGHT_BLOCK();
+	m_pLightBuffer = new UniformBuffer(LIGHT_BLOCK_BINDING);
+	m_bLightsDirty = true;
+	// the light culling pass is built in PrepareScene(), and runs
+	// once a view has been set
+	m_pLightClusters = new LightClusters();
+	m_bUseLightClusters = true;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_bViewMatricesValid = false;
+
+	// the material uniform buffer is uploaded in PrepareScene()
+	m_pMaterialBuffer = new UniformBuffer(MATERIAL_BLOCK_BINDING);
 }
 
 /***********************************************************
@@ -56,8 +148,32 @@ SceneManager::~SceneManager()
 {
 	// clear the allocated memory
 	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
+	m_pUniformCache = NULL;
+	m_pFrameProfiler = NULL;
+	delete m_sceneMeshes;
+	m_sceneMeshes = NULL;
+	delete m_pLightBuffer;
+	m_pLightBuffer = NULL;
+	delete m_pLightClusters;
+	m_pLightClusters = NULL;
+	delete m_pWeightedBlend;
+	m_pWeightedBlend = NULL;
+	delete m_pShadowMaps;
+	m_pShadowMaps = NULL;
+	delete m_pDynamicTransforms;
+	m_pDynamicTransforms = NULL;
+	delete m_pJobSystem;
+	m_pJobSystem = NULL;
+	delete m_pMaterialBuffer;
+	m_pMaterialBuffer = NULL;
+	delete m_pTextureLoader;
+	m_pTextureLoader = NULL;
+	delete m_pTextureArrays;
+	m_pTextureArrays = NULL;
+	delete m_pTextureSamplers;
+	m_pTextureSamplers = NULL;
+	delete m_pResidentTextures;
+	m_pResidentTextures = NULL;
 
 	// destroy the created OpenGL textures
 	DestroyGLTextures();
@@ -69,18 +185,48 @@ SceneManager::~SceneManager()
  *  This method is used for loading textures from image files,
  *  configuring the texture mapping parameters in OpenGL,
  *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
+ *  the next available texture slot in memory. Images in the
+ *  texture cache are loaded already compressed and mipmapped.
  ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
+bool SceneManager::CreateGLTexture(const char* filename, const std::string& tag)
 {
 	int width = 0;
 	int height = 0;
 	int colorChannels = 0;
-	GLuint textureID = 0;
+	// the texture is deleted on the way out unless it is registered
+	GLTexture texture;
 
 	// indicate to always flip images vertically when loaded
 	stbi_set_flip_vertically_on_load(true);
 
+	// the compressed image skips the decode and the GPU mipmaps
+	COMPRESSED_IMAGE compressed;
+	if (TextureCache::IsSupported() && TextureCache::LoadImage(filename, compressed))
+	{
+		std::cout << "Successfully loaded image:" << filename << ", width:" << compressed.width << ", height:" << compressed.height << ", channels:" << compressed.channels << ", compressed" << std::endl;
+
+		texture.Create();
+		glBindTexture(GL_TEXTURE_2D, texture.Get());
+
+		// set the texture wrapping parameters
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		// set texture filtering parameters, minified textures read the mipmaps
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		TextureCache::UploadImage(compressed, compressed.data.data());
+		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+		texture.SetMemorySize(compressed.data.size());
+
+		// register the loaded texture and associate it with the special tag string,
+		// then move it into its texture array page
+		PackGLTexture(RegisterGLTexture(std::move(texture), tag, filename));
+
+		return true;
+	}
+
 	// try to parse the image data from the specified image file
 	unsigned char* image = stbi_load(
 		filename,
@@ -94,15 +240,15 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 	{
 		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
 
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
+		texture.Create();
+		glBindTexture(GL_TEXTURE_2D, texture.Get());
 
 		// set the texture wrapping parameters
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		// set texture filtering parameters, minified textures read the mipmaps
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 		// if the loaded image is in RGB format
@@ -116,6 +262,8 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 		else
 		{
 			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+			stbi_image_free(image);
+			glBindTexture(GL_TEXTURE_2D, 0);
 			return false;
 		}
 
@@ -126,10 +274,13 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 		stbi_image_free(image);
 		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
 
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
+		// drivers pad RGB8 out to 4 bytes a texel, and the mip chain
+		// adds a third on top of the full size level
+		texture.SetMemorySize((GLsizeiptr)width * height * 4 * 4 / 3);
+
+		// register the loaded texture and associate it with the special tag string,
+		// then move it into its texture array page
+		PackGLTexture(RegisterGLTexture(std::move(texture), tag, filename));
 
 		return true;
 	}
@@ -140,34 +291,231 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 	return false;
 }
 
+/***********************************************************
+ *  QueueGLTexture()
+ *
+ *  This method is used for registering a texture in the next
+ *  available texture slot right away, while its image file is
+ *  decoded on a worker thread. Objects can be given the tag
+ *  and drawn with a placeholder until the image is uploaded.
+ ***********************************************************/
+bool SceneManager::QueueGLTexture(const char* filename, const std::string& tag)
+{
+	// register an empty texture and associate it with the special tag string,
+	// then queue its image, it is packed into its texture array page once
+	// its image is uploaded
+	StreamInGLTexture(RegisterGLTexture(GLTexture(), tag, filename));
+
+	return true;
+}
+
+/***********************************************************
+ *  RegisterGLTexture()
+ *
+ *  This method is used for adding a created texture to the
+ *  loaded textures under the passed in tag. The loaded
+ *  textures own it from then on. Its slot is returned, which
+ *  is also its texture handle. An empty texture reserves the
+ *  slot, and its image file is loaded once it is needed.
+ ***********************************************************/
+int SceneManager::RegisterGLTexture(GLTexture texture, const std::string& tag, const std::string& filename)
+{
+	TEXTURE_INFO info;
+	info.tag = tag;
+	info.filename = filename;
+	info.ID = std::move(texture);
+	info.location.page = -1;
+	info.location.layer = 0;
+	info.bLoading = false;
+	info.packedSize = 0;
+
+	m_textureIDs.push_back(std::move(info));
+	m_loadedTextures++;
+
+	return(m_loadedTextures - 1);
+}
+
+/***********************************************************
+ *  PackGLTexture()
+ *
+ *  This method is used for copying a loaded texture into the
+ *  texture array page for its size and format, then freeing
+ *  the texture of its own. Objects using textures in the same
+ *  page can then be drawn together. The texture is left as
+ *  it is when arrays are off or no page can take it.
+ ***********************************************************/
+bool SceneManager::PackGLTexture(int textureSlot)
+{
+	if (!m_bUseTextureArrays || !TextureArrays::IsSupported())
+	{
+		return(false);
+	}
+
+	TEXTURE_INFO& texture = m_textureIDs[textureSlot];
+	if (!m_pTextureArrays->AddTexture(texture.ID.Get(), texture.location))
+	{
+		return(false);
+	}
+
+	texture.packedSize = m_pTextureArrays->GetLayerSize(texture.location.page);
+	texture.ID.Reset();
+
+	// the page may be new or moved to a bigger array, and the objects
+	// using the texture now sort and batch with the rest of its page
+	BindGLTextures();
+	m_bRenderQueueDirty = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  PackUploadedTextures()
+ *
+ *  This method is used for packing the textures that the
+ *  texture loader uploaded an image into this frame. Until
+ *  then they hold a placeholder and are drawn on their own.
+ *  Their full size then counts against the texture budget,
+ *  and they can be freed again.
+ ***********************************************************/
+void SceneManager::PackUploadedTextures()
+{
+	for (GLuint textureID : m_uploadedTextures)
+	{
+		for (int i = 0; i < m_loadedTextures; i++)
+		{
+			if (m_textureIDs[i].ID.Get() == textureID)
+			{
+				m_textureIDs[i].bLoading = false;
+				PackGLTexture(i);
+				m_pResidentTextures->SetSize(i, (size_t)GetTextureMemorySize(i));
+				m_pResidentTextures->SetPinned(i, false);
+				break;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  StreamInGLTexture()
+ *
+ *  This method is used for making sure the texture of the
+ *  passed in handle is in memory, queueing its image file
+ *  again when it was freed, and marking it as used this
+ *  frame so it is the last to be freed. A texture stays
+ *  pinned until its image is uploaded, since the loader
+ *  still writes into it.
+ ***********************************************************/
+void SceneManager::StreamInGLTexture(TextureHandle textureHandle)
+{
+	if ((textureHandle < 0) || (textureHandle >= m_loadedTextures))
+	{
+		return;
+	}
+
+	TEXTURE_INFO& texture = m_textureIDs[textureHandle];
+	if ((texture.ID.Get() == 0) && (texture.location.page < 0))
+	{
+		texture.ID = GLTexture(m_pTextureLoader->Queue(texture.filename));
+		texture.bLoading = true;
+		// objects using it sort by its group, which changed
+		m_bRenderQueueDirty = true;
+	}
+
+	m_pResidentTextures->Use(textureHandle, (size_t)GetTextureMemorySize(textureHandle));
+	if (texture.bLoading)
+	{
+		m_pResidentTextures->SetPinned(textureHandle, true);
+	}
+}
+
+/***********************************************************
+ *  EvictGLTexture()
+ *
+ *  This method is used for freeing the texture of the passed
+ *  in handle. The slot and its tag are kept, so the objects
+ *  holding the handle can still be drawn once the texture is
+ *  streamed in again. A packed texture frees its layer of
+ *  the array page for the next texture of that size.
+ ***********************************************************/
+void SceneManager::EvictGLTexture(TextureHandle textureHandle)
+{
+	if ((textureHandle < 0) || (textureHandle >= m_loadedTextures))
+	{
+		return;
+	}
+
+	TEXTURE_INFO& texture = m_textureIDs[textureHandle];
+	if (texture.location.page >= 0)
+	{
+		m_pTextureArrays->RemoveTexture(texture.location);
+		texture.location.page = -1;
+		texture.location.layer = 0;
+	}
+	texture.ID.Reset();
+	texture.packedSize = 0;
+	m_pResidentTextures->Remove(textureHandle);
+}
+
+/***********************************************************
+ *  GetTextureMemorySize()
+ *
+ *  This method is used for getting the GPU memory that the
+ *  texture of the passed in handle takes, its layer of the
+ *  array page once it is packed.
+ ***********************************************************/
+GLsizeiptr SceneManager::GetTextureMemorySize(TextureHandle textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_loadedTextures))
+	{
+		return(0);
+	}
+
+	const TEXTURE_INFO& texture = m_textureIDs[textureHandle];
+	if (texture.location.page >= 0)
+	{
+		return(texture.packedSize);
+	}
+	return(texture.ID.GetMemorySize());
+}
+
 /***********************************************************
  *  BindGLTextures()
  *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
+ *  This method is used for binding the texture array pages
+ *  to their texture units and pointing the shader samplers
+ *  at them. Textures that are not packed are bound to unit 0
+ *  as they are drawn, so the number of textures has no limit.
  ***********************************************************/
 void SceneManager::BindGLTextures()
 {
-	for (int i = 0; i < m_loadedTextures; i++)
+	m_pTextureArrays->BindPages(TEXTURE_ARRAY_FIRST_UNIT);
+
+	if (NULL != m_pUniformCache)
 	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+		// samplers of different types must never share a unit
+		m_pUniformCache->setSampler2DValue(m_pUniformCache->m_locations.objectTexture, 0);
+		m_pUniformCache->setSampler2DValue(m_pUniformCache->m_locations.objectTextureArray, TEXTURE_ARRAY_FIRST_UNIT);
+		m_pUniformCache->setSampler2DValue(m_pUniformCache->m_locations.shadowMap, SHADOW_MAP_UNIT);
 	}
+
+	// the tracked texture state no longer matches
+	m_renderState.textureSlot = -2;
+	m_renderState.textureArrayPage = -2;
+	m_renderState.boundTexture = 0;
+	m_renderState.sampler = -2;
 }
 
 /***********************************************************
  *  DestroyGLTextures()
  *
  *  This method is used for freeing the memory in all the
- *  used texture memory slots.
+ *  used texture memory slots. Each slot owns its texture,
+ *  so clearing the slots deletes them.
  ***********************************************************/
 void SceneManager::DestroyGLTextures()
 {
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
+	m_textureIDs.clear();
+	m_loadedTextures = 0;
 }
 
 /***********************************************************
@@ -175,8 +523,9 @@ void SceneManager::DestroyGLTextures()
  *
  *  This method is used for getting an ID for the previously
  *  loaded texture bitmap associated with the passed in tag.
+ *  Textures packed into an array page no longer have one.
  ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
+int SceneManager::FindTextureID(const std::string& tag)
 {
 	int textureID = -1;
 	int index = 0;
@@ -186,7 +535,7 @@ int SceneManager::FindTextureID(std::string tag)
 	{
 		if (m_textureIDs[index].tag.compare(tag) == 0)
 		{
-			textureID = m_textureIDs[index].ID;
+			textureID = m_textureIDs[index].ID.Get();
 			bFound = true;
 		}
 		else
@@ -202,7 +551,7 @@ int SceneManager::FindTextureID(std::string tag)
  *  This method is used for getting a slot index for the previously
  *  loaded texture bitmap associated with the passed in tag.
  ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
+int SceneManager::FindTextureSlot(const std::string& tag)
 {
 	int textureSlot = -1;
 	int index = 0;
@@ -222,48 +571,125 @@ int SceneManager::FindTextureSlot(std::string tag)
 	return(textureSlot);
 }
 
+/***********************************************************
+ *  FindTextureHandle()
+ *
+ *  This method is used for resolving the passed in texture
+ *  tag to a handle once, so that drawing with the texture
+ *  does not need to search for the tag again.
+ ***********************************************************/
+SceneManager::TextureHandle SceneManager::FindTextureHandle(const std::string& tag)
+{
+	// the texture slot is used directly as the handle
+	return(FindTextureSlot(tag));
+}
+
+/***********************************************************
+ *  GetTextureGroup()
+ *
+ *  This method is used for getting the group the texture of
+ *  the passed in handle is drawn in. Every texture packed
+ *  into the same array page is in the page's group, so its
+ *  objects can be sorted together and drawn in one call.
+ *  Textures of their own each get a group after the pages.
+ ***********************************************************/
+int SceneManager::GetTextureGroup(TextureHandle textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_loadedTextures))
+	{
+		return(INVALID_HANDLE);
+	}
+
+	const TEXTURE_LAYER& location = m_textureIDs[textureHandle].location;
+	if (location.page >= 0)
+	{
+		return(location.page);
+	}
+
+	return(TextureArrays::MAX_PAGES + textureHandle);
+}
+
+/***********************************************************
+ *  GetTextureLayer()
+ *
+ *  This method is used for getting the layer of the array
+ *  page that the texture of the passed in handle is in.
+ ***********************************************************/
+int SceneManager::GetTextureLayer(TextureHandle textureHandle) const
+{
+	if ((textureHandle < 0) || (textureHandle >= m_loadedTextures) ||
+		(m_textureIDs[textureHandle].location.page < 0))
+	{
+		return(0);
+	}
+
+	return(m_textureIDs[textureHandle].location.layer);
+}
+
 /***********************************************************
  *  FindMaterial()
  *
  *  This method is used for getting a material from the previously
  *  defined materials list that is associated with the passed in tag.
  ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+bool SceneManager::FindMaterial(const std::string& tag, OBJECT_MATERIAL& material)
 {
-	if (m_objectMaterials.size() == 0)
+	MaterialHandle materialHandle = FindMaterialHandle(tag);
+	if (materialHandle == INVALID_HANDLE)
 	{
 		return(false);
 	}
 
+	material = m_objectMaterials[materialHandle];
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindMaterialHandle()
+ *
+ *  This method is used for resolving the passed in material
+ *  tag to a handle, which is the index of the material in
+ *  the defined materials list.
+ ***********************************************************/
+SceneManager::MaterialHandle SceneManager::FindMaterialHandle(const std::string& tag)
+{
 	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
+	while (index < (int)m_objectMaterials.size())
 	{
 		if (m_objectMaterials[index].tag.compare(tag) == 0)
 		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
+			return(index);
 		}
+		index++;
 	}
 
-	return(true);
+	return(INVALID_HANDLE);
 }
 
 /***********************************************************
- *  SetTransformations()
+ *  GetMaterialSampler()
  *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
+ *  This method is used for getting the sampler that textures
+ *  drawn with the passed in material are filtered with.
  ***********************************************************/
-void SceneManager::SetTransformations(
+SceneManager::SamplerHandle SceneManager::GetMaterialSampler(MaterialHandle materialHandle) const
+{
+	if ((materialHandle < 0) || (materialHandle >= (int)m_materialSamplers.size()))
+	{
+		return(m_defaultSampler);
+	}
+
+	return(m_materialSamplers[materialHandle]);
+}
+
+/***********************************************************
+ *  BuildModelMatrix()
+ *
+ *  This method is used for building a model matrix from
+ *  the passed in transformation values.
+ ***********************************************************/
+glm::mat4 SceneManager::BuildModelMatrix(
 	glm::vec3 scaleXYZ,
 	float XrotationDegrees,
 	float YrotationDegrees,
@@ -271,7 +697,6 @@ void SceneManager::SetTransformations(
 	glm::vec3 positionXYZ)
 {
 	// variables for this method
-	glm::mat4 modelView;
 	glm::mat4 scale;
 	glm::mat4 rotationX;
 	glm::mat4 rotationY;
@@ -287,11 +712,43 @@ void SceneManager::SetTransformations(
 	// set the translation value in the transform buffer
 	translation = glm::translate(positionXYZ);
 
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
+	return(translation * rotationX * rotationY * rotationZ * scale);
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	SetTransformations(BuildModelMatrix(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ));
+}
 
-	if (NULL != m_pShaderManager)
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using an already built model matrix, such as the one
+ *  cached by a scene object.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	const glm::mat4& modelMatrix)
+{
+	if (NULL != m_pUniformCache)
 	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
+		m_pUniformCache->setMat4Value(m_pUniformCache->m_locations.model, modelMatrix);
 	}
 }
 
@@ -315,10 +772,54 @@ void SceneManager::SetShaderColor(
 	currentColor.b = blueColorValue;
 	currentColor.a = alphaValue;
 
-	if (NULL != m_pShaderManager)
+	SetShaderUseTexture(false);
+	SetShaderObjectColor(currentColor);
+}
+
+/***********************************************************
+ *  SetShaderObjectColor()
+ *
+ *  This method is used for setting the passed in color into
+ *  the shader, skipping the write if it is already set.
+ ***********************************************************/
+void SceneManager::SetShaderObjectColor(
+	const glm::vec4& objectColor)
+{
+	if (m_renderState.bObjectColorValid && (m_renderState.objectColor == objectColor))
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setVec4Value(m_pUniformCache->m_locations.objectColor, objectColor);
+		m_renderState.objectColor = objectColor;
+		m_renderState.bObjectColorValid = true;
+		m_renderStats.stateChanges++;
+	}
+}
+
+/***********************************************************
+ *  SetShaderUseTexture()
+ *
+ *  This method is used for setting whether the shader samples
+ *  the object texture, skipping the write if it is already set.
+ ***********************************************************/
+void SceneManager::SetShaderUseTexture(
+	bool bUseTexture)
+{
+	if (m_renderState.useTexture == (int)bUseTexture)
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	if (NULL != m_pUniformCache)
 	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseTexture, bUseTexture);
+		m_renderState.useTexture = (int)bUseTexture;
+		m_renderStats.stateChanges++;
 	}
 }
 
@@ -326,19 +827,110 @@ void SceneManager::SetShaderColor(
  *  SetShaderTexture()
  *
  *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
+ *  associated with the passed in tag into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	const std::string& textureTag)
+{
+	SetShaderTexture(FindTextureHandle(textureTag));
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in handle into the shader. A
+ *  packed texture points the array sampler at its page and
+ *  sets its layer, which instanced draws take per instance
+ *  instead. Any other texture is bound to unit 0.
  ***********************************************************/
 void SceneManager::SetShaderTexture(
-	std::string textureTag)
+	TextureHandle textureHandle)
+{
+	if ((textureHandle < 0) || (textureHandle >= m_loadedTextures))
+	{
+		SetShaderUseTexture(false);
+		return;
+	}
+
+	SetShaderUseTexture(true);
+
+	if (m_renderState.textureSlot == textureHandle)
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	if (NULL == m_pUniformCache)
+	{
+		return;
+	}
+
+	const TEXTURE_INFO& texture = m_textureIDs[textureHandle];
+	int useTextureArray = (texture.location.page >= 0) ? 1 : 0;
+
+	if (m_renderState.useTextureArray != useTextureArray)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseTextureArray, useTextureArray == 1);
+		m_renderState.useTextureArray = useTextureArray;
+		m_renderStats.stateChanges++;
+	}
+
+	if (useTextureArray == 1)
+	{
+		// every page stays bound, only the sampler unit changes
+		if (m_renderState.textureArrayPage != texture.location.page)
+		{
+			m_pUniformCache->setSampler2DValue(
+				m_pUniformCache->m_locations.objectTextureArray,
+				TEXTURE_ARRAY_FIRST_UNIT + texture.location.page);
+			m_renderState.textureArrayPage = texture.location.page;
+			m_renderStats.stateChanges++;
+		}
+		if (m_renderState.textureLayer != texture.location.layer)
+		{
+			m_pUniformCache->setIntValue(m_pUniformCache->m_locations.textureLayer, texture.location.layer);
+			m_renderState.textureLayer = texture.location.layer;
+			m_renderStats.stateChanges++;
+		}
+	}
+	else if (m_renderState.boundTexture != texture.ID.Get())
+	{
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, texture.ID.Get());
+		m_renderState.boundTexture = texture.ID.Get();
+		m_renderStats.stateChanges++;
+	}
+
+	m_renderState.textureSlot = textureHandle;
+}
+
+/***********************************************************
+ *  SetShaderSampler()
+ *
+ *  This method is used for binding the sampler of the passed
+ *  in handle to the texture unit the last set texture is
+ *  sampled from, skipping the bind if it is already there.
+ ***********************************************************/
+void SceneManager::SetShaderSampler(
+	SamplerHandle samplerHandle)
 {
-	if (NULL != m_pShaderManager)
+	int samplerUnit = 0;
+	if (m_renderState.useTextureArray == 1)
 	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
+		samplerUnit = TEXTURE_ARRAY_FIRST_UNIT + m_renderState.textureArrayPage;
+	}
 
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
+	if ((m_renderState.sampler == samplerHandle) && (m_renderState.samplerUnit == samplerUnit))
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
 	}
+
+	m_pTextureSamplers->BindSampler(samplerHandle, samplerUnit);
+	m_renderState.sampler = samplerHandle;
+	m_renderState.samplerUnit = samplerUnit;
+	m_renderStats.stateChanges++;
 }
 
 /***********************************************************
@@ -349,9 +941,19 @@ void SceneManager::SetShaderTexture(
  ***********************************************************/
 void SceneManager::SetTextureUVScale(float u, float v)
 {
-	if (NULL != m_pShaderManager)
+	glm::vec2 UVscale = glm::vec2(u, v);
+	if (m_renderState.bUVScaleValid && (m_renderState.UVscale == UVscale))
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	if (NULL != m_pUniformCache)
 	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
+		m_pUniformCache->setVec2Value(m_pUniformCache->m_locations.UVscale, UVscale);
+		m_renderState.UVscale = UVscale;
+		m_renderState.bUVScaleValid = true;
+		m_renderStats.stateChanges++;
 	}
 }
 
@@ -359,234 +961,406 @@ void SceneManager::SetTextureUVScale(float u, float v)
  *  DefineObjectMaterials()
  *
  *  This method is used for configuring the various material
- *  settings for all of the objects within the 3D scene.
- ***********************************************************/
-void SceneManager::DefineObjectMaterials()
-{
-	/*** STUDENTS - add the code BELOW for defining object materials. ***/
-	/*** There is no limit to the number of object materials that can ***/
-	/*** be defined. Refer to the code in the OpenGL Sample for help  ***/
-
-	OBJECT_MATERIAL goldMaterial;
-	goldMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	goldMaterial.ambientStrength = 0.3f;
-	goldMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	goldMaterial.specularColor = glm::vec3(0.5f, 0.5f, 0.5f);
-	goldMaterial.shininess = 22.0;
-	goldMaterial.tag = "metal";
-
-	m_objectMaterials.push_back(goldMaterial);
-
-	OBJECT_MATERIAL woodMaterial;
-	woodMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	woodMaterial.ambientStrength = 0.2f;
-	woodMaterial.diffuseColor = glm::vec3(0.23f, 0.23f, 0.23f);
-	woodMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	woodMaterial.shininess = 0.3;
-	woodMaterial.tag = "wood";
-
-	m_objectMaterials.push_back(woodMaterial);
-
-	OBJECT_MATERIAL glassMaterial;
-	glassMaterial.ambientColor = glm::vec3(0.4f, 0.4f, 0.4f);
-	glassMaterial.ambientStrength = 0.3f;
-	glassMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	glassMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
-	glassMaterial.shininess = 85.0;
-	glassMaterial.tag = "glass";
-
-	m_objectMaterials.push_back(glassMaterial);
-
-	OBJECT_MATERIAL softMaterial;
-	softMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	softMaterial.ambientStrength = 0.4f;
-	softMaterial.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	softMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	softMaterial.shininess = 0.05;
-	softMaterial.tag = "soft";
-
-	m_objectMaterials.push_back(softMaterial);
-
-	OBJECT_MATERIAL wallMaterial;
-	wallMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	wallMaterial.ambientStrength = 0.3f;
-	wallMaterial.diffuseColor = glm::vec3(0.5f, 0.5f, 0.5f);
-	wallMaterial.specularColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	wallMaterial.shininess = 0.5;
-	wallMaterial.tag = "wall";
-
-	m_objectMaterials.push_back(wallMaterial);
-
-	OBJECT_MATERIAL matteMaterial;
-	matteMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	matteMaterial.ambientStrength = 0.2f;
-	matteMaterial.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	matteMaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
-	matteMaterial.shininess = 0.0;
-	matteMaterial.tag = "matte";
-
-	m_objectMaterials.push_back(matteMaterial);
-
-	OBJECT_MATERIAL screenMaterial;
-	glassMaterial.ambientColor = glm::vec3(0.298f, 0.694f, 0.929f);
-	glassMaterial.ambientStrength = 0.2f;
-	glassMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	glassMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
-	glassMaterial.shininess = 10.0;
-	glassMaterial.tag = "screen";
-
-	OBJECT_MATERIAL hedgeMaterial;
-	hedgeMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	hedgeMaterial.ambientStrength = 0.1f;
-	hedgeMaterial.diffuseColor = glm::vec3(0.3f, 0.2f, 0.3f);
-	hedgeMaterial.specularColor = glm::vec3(0.4f, 0.2f, 0.2f);
-	hedgeMaterial.shininess = 0.5;
-	hedgeMaterial.tag = "hedge";
-
-	m_objectMaterials.push_back(hedgeMaterial);
+ *  settings for all of the objects within the 3D scene, from
+ *  the materials of the passed in scene file. Any materials
+ *  defined before are replaced.
+ ***********************************************************/
+void SceneManager::DefineObjectMaterials(const SceneFile& sceneFile)
+{
+	m_objectMaterials.clear();
+
+	for (int i = 0; i < sceneFile.GetMaterialCount(); i++)
+	{
+		const SCENE_MATERIAL_RECORD& record = sceneFile.GetMaterialRecord(i);
 
+		OBJECT_MATERIAL material;
+		material.ambientColor = record.ambientColor;
+		material.ambientStrength = record.ambientStrength;
+		material.diffuseColor = record.diffuseColor;
+		material.specularColor = record.specularColor;
+		material.shininess = record.shininess;
+		material.tag = sceneFile.GetString(record.tag);
+		material.textureFilter = (TEXTURE_FILTER)record.textureFilter;
+		material.maxAnisotropy = record.maxAnisotropy;
+
+		m_objectMaterials.push_back(material);
+	}
 }
 
 /***********************************************************
  *  SetupSceneLights()
  *
  *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
+ *  sources for the 3D scene from the passed in scene file.
+ *  Any set before are cleared. The light sources are uploaded
+ *  by UploadSceneLights() only when they change. The first
+ *  light with shadows on is the one that casts them.
  ***********************************************************/
-void SceneManager::SetupSceneLights()
+void SceneManager::SetupSceneLights(const SceneFile& sceneFile)
 {
 	// this line of code is NEEDED for telling the shaders to render 
 	// the 3D scene with custom lighting, if no light sources have
 	// been added then the display window will be black - to use the 
 	// default OpenGL lighting then comment out the following line
-	m_pShaderManager->setBoolValue(g_UseLightingName, true);
-
-	// Room backlight
-	m_pShaderManager->setVec3Value("lightSources[0].position", -3.0f, 10.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 0.5f, 0.5f, 0.5f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 32.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 0.2f);
-
-	// Room light
-	m_pShaderManager->setVec3Value("lightSources[1].position", 0.0f, 71.0f, 0.0f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.05f, 0.05f, 0.05f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.3f, 0.3f, 0.3f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 20.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.1f);
-
-	// Outside light
-	m_pShaderManager->setVec3Value("lightSources[2].position", 5.0f, 70.0f, -79.0f);
-	m_pShaderManager->setVec3Value("lightSources[2].ambientColor", 0.3f, 0.3f, 0.3f);
-	m_pShaderManager->setVec3Value("lightSources[2].diffuseColor", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("lightSources[2].specularColor", 0.0f, 0.0f, 0.0f);
-	m_pShaderManager->setFloatValue("lightSources[2].focalStrength", 12.0f);
-	m_pShaderManager->setFloatValue("lightSources[2].specularIntensity", 0.2f);
-
-	// Monitor light
-	m_pShaderManager->setVec3Value("lightSources[3].position", -1.0f, 7.4f, -2.992f);
-	m_pShaderManager->setVec3Value("lightSources[3].ambientColor", 0.00f, 0.00f, 0.2f); // Blue light
-	m_pShaderManager->setVec3Value("lightSources[3].diffuseColor", 0.0f, 0.0f, 0.8f); // Blue light
-	m_pShaderManager->setVec3Value("lightSources[3].specularColor", 0.0f, 0.0f, 0.5f); // Blue light
-	m_pShaderManager->setFloatValue("lightSources[3].focalStrength", 50.0f);
-	m_pShaderManager->setFloatValue("lightSources[3].specularIntensity", 0.05f);
+	m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseLighting, true);
 
-}
+	m_sceneLights.clear();
+	m_lightBlock = LIGHT_BLOCK();
+	m_bLightsDirty = true;
+	m_shadowLightIndex = -1;
 
-/***********************************************************
+	for (int i = 0; i < sceneFile.GetLightCount(); i++)
+	{
+		const SCENE_LIGHT_RECORD& record = sceneFile.GetLightRecord(i);
+		SetLightSource(record.index,
+			record.position,
+			record.ambientColor,
+			record.diffuseColor,
+			record.specularColor,
+			record.focalStrength,
+			record.specularIntensity,
+			record.range);
+
+		if ((record.castsShadow != 0) && (m_shadowLightIndex < 0))
+		{
+			m_shadowLightIndex = record.index;
+		}
+	}
+}
+
+/***********************************************************
+ *  SetLightSource()
+ *
+ *  This method is used for setting the values of a single
+ *  light source and flagging the lights for upload. A light
+ *  with a range fades out at it and is only shaded by the
+ *  clusters it reaches, a range of 0 lights the whole scene.
+ *  Only the first 4 light sources are shaded when the lights
+ *  are not clustered.
+ ***********************************************************/
+void SceneManager::SetLightSource(
+	int index,
+	glm::vec3 position,
+	glm::vec3 ambientColor,
+	glm::vec3 diffuseColor,
+	glm::vec3 specularColor,
+	float focalStrength,
+	float specularIntensity,
+	float range)
+{
+	if ((index < 0) || (index >= LightClusters::MAX_LIGHTS))
+	{
+		std::cout << "Light source index out of range:" << index << std::endl;
+		return;
+	}
+
+	// the light count covers every light source that has been set
+	if (index >= (int)m_sceneLights.size())
+	{
+		m_sceneLights.resize(index + 1, LIGHT_SOURCE_BLOCK());
+	}
+
+	LIGHT_SOURCE_BLOCK& light = m_sceneLights[index];
+	light.position = glm::vec4(position, 1.0f);
+	light.ambientColor = glm::vec4(ambientColor, 0.0f);
+	light.diffuseColor = glm::vec4(diffuseColor, 0.0f);
+	light.specularColor = glm::vec4(specularColor, 0.0f);
+	light.focalStrength = focalStrength;
+	light.specularIntensity = specularIntensity;
+	light.range = glm::max(range, 0.0f);
+
+	if (index < MAX_LIGHT_SOURCES)
+	{
+		m_lightBlock.lightSources[index] = light;
+	}
+	m_lightBlock.lightCount = glm::min((int)m_sceneLights.size(), MAX_LIGHT_SOURCES);
+
+	m_bLightsDirty = true;
+}
+
+/***********************************************************
+ *  UploadSceneLights()
+ *
+ *  This method is used for uploading the light sources into
+ *  the shared light uniform buffer and the light list of the
+ *  clusters, only when they changed.
+ ***********************************************************/
+void SceneManager::UploadSceneLights()
+{
+	if ((m_bLightsDirty == false) || (NULL == m_pLightBuffer))
+	{
+		return;
+	}
+
+	m_pLightBuffer->Update(&m_lightBlock, sizeof(m_lightBlock));
+	if (NULL != m_pLightClusters)
+	{
+		m_pLightClusters->SetLights(m_sceneLights);
+	}
+	m_bLightsDirty = false;
+}
+
+/***********************************************************
+ *  UpdateLightClusters()
+ *
+ *  This method is used for running the light culling pass
+ *  over the view set for the frame, so each fragment only
+ *  shades the lights that reach its cluster. Until a view is
+ *  set, or when the pass is not available, the fragments are
+ *  shaded by the light uniform buffer instead.
+ ***********************************************************/
+void SceneManager::UpdateLightClusters()
+{
+	if (NULL == m_pUniformCache)
+	{
+		return;
+	}
+
+	if (m_bUseLightClusters && m_bViewMatricesValid &&
+		(NULL != m_pLightClusters) && m_pLightClusters->IsReady())
+	{
+		m_pLightClusters->Update(m_viewMatrix, m_projectionMatrix, m_pUniformCache);
+	}
+	else
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseLightClusters, false);
+	}
+}
+
+/***********************************************************
+ *  UpdateShadowMaps()
+ *
+ *  This method is used for drawing the shadow casters into
+ *  the cascaded shadow maps of the light that casts them.
+ *  The light is far enough away to be treated as shining
+ *  from the center of the scene towards it. The static
+ *  objects are only drawn into the cascades whose cache was
+ *  dropped, the dynamic objects into a copy of every cascade
+ *  each frame. Until a view is set, or without a light that
+ *  casts shadows, the scene is drawn without them.
+ ***********************************************************/
+void SceneManager::UpdateShadowMaps()
+{
+	if (NULL == m_pUniformCache)
+	{
+		return;
+	}
+
+	if (!m_bUseShadows || !m_bViewMatricesValid || !m_pShadowMaps->IsReady() ||
+		(m_shadowLightIndex < 0) || (m_shadowLightIndex >= (int)m_sceneLights.size()))
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseShadows, false);
+		return;
+	}
+
+	BOUNDING_VOLUME casterBounds = GetSceneBounds();
+	glm::vec3 toLight = glm::vec3(m_sceneLights[m_shadowLightIndex].position) - casterBounds.center;
+	if (glm::length(toLight) <= 0.0f)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseShadows, false);
+		return;
+	}
+
+	m_pShadowMaps->SetLight(glm::normalize(toLight), casterBounds);
+	m_pShadowMaps->Update(m_viewMatrix, m_projectionMatrix);
+
+	bool bStale = false;
+	for (int cascade = 0; cascade < ShadowMaps::CASCADE_COUNT; cascade++)
+	{
+		bStale = bStale || m_pShadowMaps->IsCascadeStale(cascade);
+	}
+	bool bDynamicCasters = (m_shadowCommands.size() > (size_t)m_staticShadowCommandCount);
+
+	if (bStale || bDynamicCasters)
+	{
+		m_pShadowMaps->BeginPass();
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bShadowPass, true);
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bDepthOnly, true);
+
+		for (int cascade = 0; cascade < ShadowMaps::CASCADE_COUNT; cascade++)
+		{
+			if (m_pShadowMaps->IsCascadeStale(cascade))
+			{
+				m_pUniformCache->setMat4Value(m_pUniformCache->m_locations.shadowViewProjection,
+					m_pShadowMaps->GetCascadeMatrix(cascade));
+				m_pShadowMaps->BeginStaticCascade(cascade);
+				RenderShadowCasters(false);
+				m_pShadowMaps->EndStaticCascade(cascade);
+			}
+		}
+
+		for (int cascade = 0; bDynamicCasters && (cascade < ShadowMaps::CASCADE_COUNT); cascade++)
+		{
+			bDynamicCasters = m_pShadowMaps->BeginDynamicCascade(cascade);
+			if (bDynamicCasters)
+			{
+				m_pUniformCache->setMat4Value(m_pUniformCache->m_locations.shadowViewProjection,
+					m_pShadowMaps->GetCascadeMatrix(cascade));
+				RenderShadowCasters(true);
+			}
+		}
+
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bDepthOnly, false);
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bShadowPass, false);
+		m_pShadowMaps->EndPass();
+	}
+
+	m_pShadowMaps->Bind(SHADOW_MAP_UNIT, bDynamicCasters, m_pUniformCache);
+	m_pUniformCache->setIntValue(m_pUniformCache->m_locations.shadowLightIndex, m_shadowLightIndex);
+}
+
+/***********************************************************
+ *  UpdateDynamicTransforms()
+ *
+ *  This method is used for writing the model matrix of every
+ *  dynamic instance into the next region of the ring and
+ *  pointing the vertex shader at it. Every slot is written
+ *  each frame, since the region last held the matrices of
+ *  three frames ago. Without dynamic instances in the ring
+ *  the vertex shader uses the instance buffer alone.
+ ***********************************************************/
+void SceneManager::UpdateDynamicTransforms()
+{
+	if (NULL == m_pUniformCache)
+	{
+		return;
+	}
+
+	bool bUseRing = !m_dynamicInstances.empty() && m_pDynamicTransforms->IsReady();
+	m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseDynamicModels, bUseRing);
+	if (!bUseRing)
+	{
+		return;
+	}
+
+	// the slots are written straight into the mapped ring, which the
+	// worker threads can do without any OpenGL calls. Building a
+	// matrix caches it in the object, which is only safe because
+	// every object is queued once, so no two slots share an object
+	m_pDynamicTransforms->BeginFrame();
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	m_pJobSystem->ParallelFor((int)m_dynamicInstances.size(), ANIMATE_RANGE_SIZE,
+		[this, &items](int first, int end, int /*thread*/)
+		{
+			for (int slot = first; slot < end; slot++)
+			{
+				object& sceneObject = m_sceneObjects[items[m_dynamicInstances[slot]].objectIndex];
+				m_pDynamicTransforms->SetModelMatrix(slot, sceneObject.getModelMatrix());
+			}
+		});
+	m_pDynamicTransforms->Bind(DYNAMIC_TRANSFORMS_UNIT, m_pUniformCache);
+}
+
+/***********************************************************
+ *  RenderShadowCasters()
+ *
+ *  This method is used for drawing the depth of the opaque
+ *  static or dynamic objects into the shadow map being
+ *  drawn, whether they are in the view or not. With
+ *  multi-draw indirect they all take a single call.
+ ***********************************************************/
+void SceneManager::RenderShadowCasters(bool bDynamic)
+{
+	if (m_bUseInstancing && m_bUseMultiDrawIndirect &&
+		m_sceneMeshes->IsMultiDrawIndirectSupported())
+	{
+		GLuint firstCommand = m_shadowFirstCommand;
+		GLsizei commandCount = m_staticShadowCommandCount;
+		if (bDynamic)
+		{
+			firstCommand += m_staticShadowCommandCount;
+			commandCount = (GLsizei)m_shadowCommands.size() - m_staticShadowCommandCount;
+		}
+		if (commandCount <= 0)
+		{
+			return;
+		}
+
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseInstancing, true);
+		m_sceneMeshes->DrawMultiIndirect(firstCommand, commandCount);
+		m_renderStats.drawCalls++;
+		m_renderStats.indirectCommands += commandCount;
+		for (GLuint i = firstCommand; i < firstCommand + commandCount; i++)
+		{
+			const DRAW_ELEMENTS_COMMAND& command = m_drawCommands[i];
+			m_renderStats.trianglesDrawn += (int)(command.count / 3 * command.instanceCount);
+		}
+		return;
+	}
+
+	m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseInstancing, m_bUseInstancing);
+
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	for (const INSTANCE_BATCH& batch : m_instanceBatches)
+	{
+		if (batch.bTranslucent)
+		{
+			continue;
+		}
+
+		GLuint endInstance = batch.firstInstance + batch.instanceCount;
+		GLuint instance = batch.firstInstance;
+
+		while (instance < endInstance)
+		{
+			if (m_instanceDynamic[instance] != bDynamic)
+			{
+				instance++;
+				continue;
+			}
+
+			GLuint firstInstance = instance;
+			while ((instance < endInstance) && (m_instanceDynamic[instance] == bDynamic))
+			{
+				instance++;
+			}
+
+			if (m_bUseInstancing)
+			{
+				GLsizei count = (GLsizei)(instance - firstInstance);
+				m_sceneMeshes->DrawMeshInstanced(batch.shape, count, firstInstance);
+				m_renderStats.drawCalls++;
+				m_renderStats.trianglesDrawn += count * (int)m_sceneMeshes->GetTriangleCount(batch.shape);
+				continue;
+			}
+
+			// only the transform matters for the depth
+			for (GLuint i = firstInstance; i < instance; i++)
+			{
+				object& sceneObject = m_sceneObjects[items[i].objectIndex];
+				SetTransformations(sceneObject.getModelMatrix());
+				DrawMesh(sceneObject.getShape());
+			}
+		}
+	}
+}
+
+/***********************************************************
   *  LoadSceneTextures()
   *
-  *  This method is used for preparing the 3D scene by loading
-  *  the shapes, textures in memory to support the 3D scene
-  *  rendering
+  *  This method is used for preparing the 3D scene by adding
+  *  the textures of the passed in scene file to support the
+  *  3D scene rendering. The image files are only loaded once
+  *  a chunk drawn with them is streamed in, then decoded in
+  *  the background and uploaded by RenderScene() as they
+  *  finish. Textures already added under the same tag are
+  *  kept, so reloading the scene only adds the new ones.
   ***********************************************************/
-void SceneManager::LoadSceneTextures()
-{
-	/*** STUDENTS - add the code BELOW for loading the textures that ***/
-	/*** will be used for mapping to objects in the 3D scene. Up to  ***/
-	/*** 16 textures can be loaded per scene. Refer to the code in   ***/
-	/*** the OpenGL Sample for help.                                 ***/
-	bool bReturn = false;
-
-	// CB: A lot of these textures aren't used but I loaded them so I can apply them to different
-	// shapes to see how they look and stretch.
-
-	// Load dark_ceramic
-	bReturn = CreateGLTexture(
-		"Textures/dark_ceramic.jpg",
-		"dark_ceramic");
-
-	// Load cement
-	bReturn = CreateGLTexture(
-		"Textures/cement.jpeg",
-		"cement");
-
-	// Load clouds
-	bReturn = CreateGLTexture(
-		"Textures/clouds.png",
-		"clouds");
-
-	// Load grass
-	bReturn = CreateGLTexture(
-		"Textures/grass.jpg",
-		"grass");
-
-	// Load drywall
-	bReturn = CreateGLTexture(
-		"Textures/drywall.jpg",
-		"drywall");
-
-	// Load dark_carpet
-	bReturn = CreateGLTexture(
-		"Textures/dark_carpet.jpg",
-		"dark_carpet");
-
-	// Load wood
-	bReturn = CreateGLTexture(
-		"Textures/wood.jpg",
-		"wood");
-
-	// Load green vegetation
-	bReturn = CreateGLTexture(
-		"Textures/green_vegetation.jpg",
-		"green_vegetation");
-
-	// Load marble brick
-	bReturn = CreateGLTexture(
-		"Textures/keys.jpg",
-		"keys");
-
-	// Load cobblestone
-	bReturn = CreateGLTexture(
-		"Textures/water.jpg",
-		"water");
-
-	// Load orange_brick
-	bReturn = CreateGLTexture(
-		"Textures/orange_brick.jpg",
-		"orange_brick");
-
-	// Load paper
-	bReturn = CreateGLTexture(
-		"Textures/paper.jpg",
-		"paper");
-
-	// Load pencil
-	bReturn = CreateGLTexture(
-		"Textures/pencil.jpg",
-		"pencil");
-
-	// Load homer
-	bReturn = CreateGLTexture(
-		"Textures/homer.gif",
-		"homer");
-
-
-	// after the texture image data is loaded into memory, the
-	// loaded textures need to be bound to texture slots - there
-	// are a total of 16 available slots for scene textures
+void SceneManager::LoadSceneTextures(const SceneFile& sceneFile)
+{
+	for (int i = 0; i < sceneFile.GetTextureCount(); i++)
+	{
+		const SCENE_TEXTURE_RECORD& record = sceneFile.GetTextureRecord(i);
+		std::string tag = sceneFile.GetString(record.tag);
+
+		if (FindTextureSlot(tag) < 0)
+		{
+			RegisterGLTexture(GLTexture(), tag, sceneFile.GetString(record.filename));
+		}
+	}
+
+	// point the shader samplers at their texture units, the array
+	// pages are bound again as the uploaded textures are packed
 	BindGLTextures();
 }
 
@@ -594,25 +1368,100 @@ void SceneManager::LoadSceneTextures()
  *  SetShaderMaterial()
  *
  *  This method is used for passing the material values
- *  into the shader.
+ *  associated with the passed in tag into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	const std::string& materialTag)
+{
+	SetShaderMaterial(FindMaterialHandle(materialTag));
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for selecting the material associated
+ *  with the passed in handle in the shader. The material values
+ *  are already in the material uniform buffer, so only the
+ *  material index is passed in.
  ***********************************************************/
 void SceneManager::SetShaderMaterial(
-	std::string materialTag)
+	MaterialHandle materialHandle)
 {
-	if (m_objectMaterials.size() > 0)
+	if ((NULL == m_pUniformCache) ||
+		(materialHandle < 0) || (materialHandle >= (int)m_objectMaterials.size()))
 	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
+		return;
+	}
 
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
+	if (m_renderState.materialIndex == materialHandle)
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	m_pUniformCache->setIntValue(m_pUniformCache->m_locations.materialIndex, materialHandle);
+	m_renderState.materialIndex = materialHandle;
+	m_renderStats.stateChanges++;
+}
+
+/***********************************************************
+ *  UploadObjectMaterials()
+ *
+ *  This method is used for uploading all of the defined
+ *  object materials into the material uniform buffer once,
+ *  so that drawing an object only selects a material index.
+ ***********************************************************/
+void SceneManager::UploadObjectMaterials()
+{
+	if (NULL == m_pMaterialBuffer)
+	{
+		return;
+	}
+
+	if (m_objectMaterials.size() > MAX_OBJECT_MATERIALS)
+	{
+		std::cout << "Only the first " << MAX_OBJECT_MATERIALS << " of "
+			<< m_objectMaterials.size() << " materials can be used" << std::endl;
+	}
+
+	MATERIAL_BLOCK materialBlock = MATERIAL_BLOCK();
+	for (int i = 0; (i < (int)m_objectMaterials.size()) && (i < MAX_OBJECT_MATERIALS); i++)
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[i];
+		MATERIAL_SOURCE_BLOCK& block = materialBlock.materials[i];
+
+		block.ambientColor = glm::vec4(material.ambientColor, 0.0f);
+		block.diffuseColor = glm::vec4(material.diffuseColor, 0.0f);
+		block.specularColor = glm::vec4(material.specularColor, 0.0f);
+		block.ambientStrength = material.ambientStrength;
+		block.shininess = material.shininess;
+	}
+
+	m_pMaterialBuffer->Update(&materialBlock, sizeof(materialBlock));
+}
+
+/***********************************************************
+ *  CreateMaterialSamplers()
+ *
+ *  This method is used for creating the sampler of every
+ *  defined material, shared between the materials with the
+ *  same filtering, and the default sampler for objects that
+ *  have no material.
+ ***********************************************************/
+void SceneManager::CreateMaterialSamplers()
+{
+	SAMPLER_SETTINGS settings;
+	settings.filter = FILTER_ANISOTROPIC;
+	settings.maxAnisotropy = 8.0f;
+	settings.wrapMode = GL_REPEAT;
+	m_defaultSampler = m_pTextureSamplers->FindSampler(settings);
+
+	m_materialSamplers.clear();
+	for (const OBJECT_MATERIAL& material : m_objectMaterials)
+	{
+		settings.filter = material.textureFilter;
+		settings.maxAnisotropy = material.maxAnisotropy;
+		m_materialSamplers.push_back(m_pTextureSamplers->FindSampler(settings));
 	}
 }
 
@@ -625,557 +1474,1938 @@ void SceneManager::SetShaderMaterial(
  ***********************************************************/
 void SceneManager::PrepareScene()
 {
-	// define the materials for objects in the scene
-	DefineObjectMaterials();
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene, all of them are packed into
+	// the shared buffers
+	m_sceneMeshes->LoadMeshes();
+
+	// build the light culling pass, without it the scene is lit
+	// by the first light sources in the light uniform buffer
+	if (m_bUseLightClusters)
+	{
+		m_bUseLightClusters = m_pLightClusters->Initialize("Shaders/lightClusterShader.glsl");
+	}
+
+	// build the weighted blending composite, without it the
+	// translucent objects are sorted
+	if (m_bUseWeightedBlend)
+	{
+		m_bUseWeightedBlend = m_pWeightedBlend->Initialize(
+			"Shaders/transparencyVertexShader.glsl",
+			"Shaders/transparencyFragmentShader.glsl");
+	}
+
+	// create the cache of the shadow maps, without it the scene is
+	// drawn without shadows
+	if (m_bUseShadows)
+	{
+		m_bUseShadows = m_pShadowMaps->Initialize();
+	}
+
+	// define the materials, lights, textures and retained scene
+	// graph from the scene file, the scene graph is drawn every
+	// frame by RenderScene() without being rebuilt
+	LoadSceneFile();
+
+	// sort and batch the static scene and build its indirect
+	// commands now, so the first frame does not have to
+	BuildRenderQueue();
+	BuildInstanceBatches();
+	BuildSceneBVH();
+	BuildIndirectCommands();
+}
+
+/***********************************************************
+ *  SetSceneFile()
+ *
+ *  This method is used for setting the text file that the
+ *  scene is loaded from. It must be set before the scene is
+ *  prepared.
+ ***********************************************************/
+void SceneManager::SetSceneFile(const std::string& filename)
+{
+	m_sceneFilename = filename;
+}
+
+/***********************************************************
+ *  LoadSceneFile()
+ *
+ *  This method is used for loading the scene file and
+ *  defining the materials, lights, textures and objects of
+ *  the scene from it, replacing the ones defined before. The
+ *  materials are uploaded and the objects sorted again on
+ *  the next frame. When the file cannot be loaded the scene
+ *  is left as it was.
+ ***********************************************************/
+bool SceneManager::LoadSceneFile()
+{
+	SceneFile sceneFile;
+	if (!sceneFile.Load(m_sceneFilename))
+	{
+		std::cout << "Could not load the scene " << m_sceneFilename << std::endl;
+		return(false);
+	}
+
+	if (!SceneFile::GetFileStamp(m_sceneFilename, m_sceneFileStamp))
+	{
+		m_sceneFileStamp = SCENE_FILE_STAMP();
+	}
+
+	// define the materials for objects in the scene and upload
+	// them once into the material uniform buffer
+	DefineObjectMaterials(sceneFile);
+	UploadObjectMaterials();
+	CreateMaterialSamplers();
 
 	// add and define the light sources for the scene
-	SetupSceneLights();
+	SetupSceneLights(sceneFile);
 
 	// Load the textures for the 3D scenes
-	LoadSceneTextures();
+	LoadSceneTextures(sceneFile);
+
+	// the objects resolve their texture and material tags as they
+	// are built, so they come after both, then the chunks near the
+	// camera are loaded into the scene graph
+	DefineSceneObjects(sceneFile);
+	ReplicateSceneObjects(m_sceneScale);
+	if (m_bStreamingPositionSet)
+	{
+		UpdateStreaming(m_streamingPosition);
+	}
+	else
+	{
+		RebuildResidentObjects();
+	}
 
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
+	std::cout << "Loaded the scene " << m_sceneFilename
+		<< (sceneFile.IsFromCache() ? " from its cache" : "") << std::endl;
 
-	m_basicMeshes->LoadTaperedCylinderMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadConeMesh();
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadBoxMesh();
+	return(true);
 }
 
 /***********************************************************
- *  RenderScene()
+ *  ReloadSceneIfChanged()
  *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for loading the scene file again when
+ *  its size or last write time changed since it was loaded,
+ *  so edits show up as soon as the file is saved. A file
+ *  that fails to load is not tried again until it changes.
  ***********************************************************/
-void SceneManager::RenderScene()
+bool SceneManager::ReloadSceneIfChanged()
+{
+	SCENE_FILE_STAMP stamp;
+	if (!SceneFile::GetFileStamp(m_sceneFilename, stamp))
+	{
+		return(false);
+	}
+
+	if ((stamp.size == m_sceneFileStamp.size) &&
+		(stamp.writeTime == m_sceneFileStamp.writeTime))
+	{
+		return(false);
+	}
+
+	m_sceneFileStamp = stamp;
+	return(LoadSceneFile());
+}
+
+/***********************************************************
+ *  DefineSceneObjects()
+ *
+ *  This method is used for building the chunks of scene
+ *  objects from the chunks and objects of the passed in scene
+ *  file. The first chunk holds the objects outside of any
+ *  chunk and is always loaded. The objects of the loaded
+ *  chunks are copied into the retained list drawn every frame
+ *  by RenderScene().
+ ***********************************************************/
+void SceneManager::DefineSceneObjects(const SceneFile& sceneFile)
+{
+	// throw away any previously defined scene objects
+	m_sceneObjects.clear();
+	m_sceneChunks.clear();
+	m_sceneChunks.resize(sceneFile.GetChunkCount() + 1);
+
+	m_sceneChunks[0].loadDistance = 0.0f;
+	for (int i = 0; i < sceneFile.GetChunkCount(); i++)
+	{
+		const SCENE_CHUNK_RECORD& record = sceneFile.GetChunkRecord(i);
+		m_sceneChunks[i + 1].name = sceneFile.GetString(record.name);
+		m_sceneChunks[i + 1].loadDistance = record.loadDistance;
+	}
+
+	// each object is built up from the defaults and a copy of it
+	// is stored in its chunk
+	object sceneObject(this);
+
+	for (int i = 0; i < sceneFile.GetObjectCount(); i++)
+	{
+		const SCENE_OBJECT_RECORD& record = sceneFile.GetObjectRecord(i);
+
+		sceneObject.resetAll();
+		sceneObject.setShape((MESH_SHAPE)record.shape);
+		sceneObject.setPosition(record.position);
+		sceneObject.setRotations(record.rotations);
+		sceneObject.setScale(record.scale);
+		sceneObject.setRGBA(record.color);
+		sceneObject.set_uvScale(record.uvScale);
+		sceneObject.setTexture(sceneFile.GetString(record.texture));
+		sceneObject.setObjectShaderMaterial(sceneFile.GetString(record.material));
+		sceneObject.setSpin(record.spin);
+		m_sceneChunks[record.chunk + 1].objects.push_back(sceneObject);
+	}
+
+	for (SCENE_CHUNK& chunk : m_sceneChunks)
+	{
+		FinishSceneChunk(chunk);
+	}
+}
+
+/***********************************************************
+ *  AddSceneObject()
+ *
+ *  This method is used for adding a copy of the passed in
+ *  object to the retained scene graph.
+ ***********************************************************/
+void SceneManager::AddSceneObject(const object& sceneObject)
+{
+	m_sceneObjects.push_back(sceneObject);
+	m_bRenderQueueDirty = true;
+	m_pShadowMaps->Invalidate();
+}
+
+/***********************************************************
+ *  SetSceneScale()
+ *
+ *  This method is used for setting the number of copies of
+ *  the scene that PrepareScene() builds, for loading the
+ *  renderer with larger scenes. It must be set before the
+ *  scene is prepared.
+ ***********************************************************/
+void SceneManager::SetSceneScale(int sceneScale)
+{
+	m_sceneScale = glm::max(1, sceneScale);
+}
+
+/***********************************************************
+ *  ReplicateSceneObjects()
+ *
+ *  This method is used for adding copies of the defined
+ *  scene chunks until there are the passed in number of
+ *  scenes. The copies are laid out in a square grid that
+ *  starts at the original scene and grows to the right and
+ *  away from the default camera, a little more than the
+ *  size of the scene apart. Each copy of a chunk is streamed
+ *  in and out on its own.
+ ***********************************************************/
+void SceneManager::ReplicateSceneObjects(int copies)
 {
-	// Lambda calls to functions. I couldn't figure out how to pass just the
-	// function or point to it so I used lambda instead.
-	auto cone = [this]() {m_basicMeshes->DrawConeMesh();};
-	auto cylinder = [this]() {m_basicMeshes->DrawCylinderMesh();};
-	auto plane = [this]() {m_basicMeshes->DrawPlaneMesh();};
-	auto box = [this]() {m_basicMeshes->DrawBoxMesh();};
-	auto sphere = [this]() {m_basicMeshes->DrawSphereMesh();};
-	auto half_sphere = [this]() {m_basicMeshes->DrawHalfSphereMesh();};
-	auto torus = [this]() {m_basicMeshes->DrawTorusMesh();};
-	auto half_torus = [this]() {m_basicMeshes->DrawHalfTorusMesh();};
-	auto taper_cylinder = [this]() {m_basicMeshes->DrawTorusMesh();};
-
-	// This is the general object that will be used. It will retain
-	// values from previous assignments which makes working with repeat values
-	// such as building multiple pencils easy.
-	object* Object = new object(this);
-
-
-	/******************************************************************/
-	/*** Pencil cup                                                 ***/
-	/******************************************************************/
-
-	// Outer Cup White
-	Object->setRotations(glm::vec3(3.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(2.0f, 4.0f, 2.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(13.0f, 1.0f, -3.0f)); // set position xyz
-	Object->setShape(cylinder); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture("dark_ceramic"); // Setting texture
-	Object->set_uvScale(glm::vec2(1.0f, 1.0f)); // uvscale of texture
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Inner Cup black
-	Object->setScale(glm::vec3(1.7f, 4.01f, 1.7f)); // scale XYZ
-	Object->setRGBA(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture to nothing
-	Object->render(); // Create the object.
-
-	/******************************************************************/
-	/*** Pencils                                                    ***/
-	/******************************************************************/
-
-	// Pencil Body 1
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(0.20f, 8.0f, 0.20f)); // scale XYZ
-	Object->setPosition(glm::vec3(13.6f, 1.0f, -3.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.949f, 0.839f, 0.471f, 1)); // Shader RGBA
-	Object->setObjectShaderMaterial("wood");
-	Object->render(); // Create the object.
-
-	// Pencil Body 2
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 15.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(0.20f, 7.0f, 0.20f)); // scale XYZ
-	Object->setPosition(glm::vec3(12.7f, 1.0f, -2.80f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil Body 3
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 10.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(12.9f, 1.0f, -3.40f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil Body 4
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(0.20f, 6.4f, 0.20f)); // scale XYZ
-	Object->setPosition(glm::vec3(13.3f, 1.0f, -2.6f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil Body 5
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 10.0f)); // rotations as XYZ
-	Object->render(); // Create the object.
-
-	// Pencil Body 6
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 5.0f)); // rotations as XYZ
-	Object->render(); // Create the object.
-
-	// Pencil Cone 1
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(0.20f, 1.0f, 0.20f)); // scale XYZ
-	Object->setPosition(glm::vec3(13.6f, 9.0f, -3.0f)); // set position xyz
-	Object->setShape(cone); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(0.969f, 0.949f, 0.878f, 1)); // Shader RGBA
-	Object->setTexture("wood"); // Setting texture
-	Object->set_uvScale(glm::vec2(0.5f, 0.5f)); // uvscale of texture
-	Object->render(); // Create the object.
-
-	// Pencil Cone 2
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 10.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(11.68f, 7.9f, -3.4f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil Cone 3
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 14.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(10.89f, 7.76f, -2.8f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil Cone 4
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(13.3f, 7.32f, -1.49f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil Cone 5
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 5.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(12.74f, 7.28f, -1.49f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil Cone 6
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 8.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(12.19f, 7.20f, -1.50f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil graphite 1
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(0.15f, 1.1f, 0.15f)); // scale XYZ
-	Object->setPosition(glm::vec3(13.6f, 9.0f, -3.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0, 0, 0, 1)); // Shader RGBA to black
-	Object->setTexture(""); // Setting texture to nothing
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Pencil graphite 2
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 10.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(11.68f, 7.9f, -3.40f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil graphite 3
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 14.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(10.89f, 7.76f, -2.8f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil graphite 4
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(13.3f, 7.32f, -1.49f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil graphite 5
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 5.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(12.74f, 7.28f, -1.49f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Pencil graphite 6
-	Object->setRotations(glm::vec3(10.0f, 0.0f, 8.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(12.19f, 7.20f, -1.5f)); // set position xyz
-	Object->render(); // Create the object.
-
-	/******************************************************************/
-	/*** Computer                                                   ***/
-	/******************************************************************/
-
-	//base
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(6.0f, 0.5f, 5.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-1.0f, 1.0f, -3.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->set_uvScale(glm::vec2(1.0f, 1.0f)); // uvscale of texture
-	Object->setShape(box);
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	//back base
-	Object->setPosition(glm::vec3(-1.0f, 3.5f, -5.3f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.970f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setRotations(glm::vec3(100.0f, 0.0f, 0.0f)); // rotate to put up right
-	Object->render();
-
-	// attached back base
-	Object->setScale(glm::vec3(6.0f, 0.5f, 2.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-1.0f, 5.7f, -3.8f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.970f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotate to put up right
-	Object->render();
-
-	//Monitor main
-	Object->setRotations(glm::vec3(90.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(15.0f, 0.5f, 8.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-1.0f, 7.0f, -3.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->render(); // Create the object.
-
-	//Monitor black edges
-	Object->setRotations(glm::vec3(90.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(14.9f, 0.49f, 7.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-1.0f, 7.4f, -2.992f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)); // Shader RGBA
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	//Monitor viewing area
-	Object->setRotations(glm::vec3(90.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(14.2f, 0.49f, 6.4f)); // scale XYZ
-	Object->setPosition(glm::vec3(-1.0f, 7.4f, -2.991f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.3f, 0.5f, 0.2f, 1.0f)); // Shader RGBA
-	Object->setTexture("homer");
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Keyboard
-	Object->setRotations(glm::vec3(7.0f, 5.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(10.0f, 1.0f, 3.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-2.0f, 1.0f, 3.0f)); // set position xyz
-	Object->setShape(box); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->set_uvScale(glm::vec2(1.0f, 1.0f)); // uvscale of texture
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	// Keyboard keys
-	Object->setRotations(glm::vec3(7.0f, 5.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(9.9f, 1.01f, 2.9f)); // scale XYZ
-	Object->setPosition(glm::vec3(-2.0f, 1.0f, 3.0f)); // set position xyz
-	Object->setShape(box); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture("keys"); // Setting texture
-	Object->set_uvScale(glm::vec2(1.0f, 1.0f)); // uvscale of texture
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	// mouse
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(1.5f, 1.0f, 2.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(6.0f, 1.0f, 3.0f)); // set position xyz
-	Object->setShape(half_sphere); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->set_uvScale(glm::vec2(1.0f, 1.0f)); // uvscale of texture
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	// mouse button
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(1.15f, 0.805f, 0.4f)); // scale XYZ
-	Object->setPosition(glm::vec3(6.0f, 1.0f, 2.25f)); // set position xyz
-	Object->setShape(half_torus); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->set_uvScale(glm::vec2(1.0f, 1.0f)); // uvscale of texture
-	Object->setObjectShaderMaterial("matte");
-	Object->render(); // Create the object.
-
-	/******************************************************************/
-	/*** Draw box for the surface our objects will sit on.          ***/
-	/******************************************************************/
-
-	// Cup on Desk
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(1.2f, 2.5f, 1.2f)); // scale XYZ
-	Object->setPosition(glm::vec3(-10.0f, 1.0f, 0.0f)); // set position xyz
-	Object->setShape(cylinder); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	// Cup handle
-	Object->setRotations(glm::vec3(90.0f, 90.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(0.7f, 0.9f, 0.7f)); // scale XYZ
-	Object->setPosition(glm::vec3(-10.0f, 2.3f, 1.0f)); // set position xyz
-	Object->setShape(half_torus); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	// water in cup
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(1.0f, 2.51f, 1.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-10.0f, 1.0f, 0.0f)); // set position xyz
-	Object->setShape(cylinder); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)); // Shader RGBA
-	Object->setTexture("water"); // Setting texture
-	Object->set_uvScale(glm::vec2(1.0f, 1.0f)); // uvscale of texture
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Book 1 on Desk
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(5.0f, 1.0f, 6.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-16.0f, 1.0f, -4.0f)); // set position xyz
-	Object->setShape(box); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(0.44f, 0.23f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	// Book 1 paper
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(4.81f, 0.4f, 6.1f)); // scale XYZ
-	Object->setPosition(glm::vec3(-15.9f, 1.27f, -4.0f)); // set position xyz
-	Object->setShape(box); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Book 2 on Desk
-	Object->setRotations(glm::vec3(0.0f, 15.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(5.0f, 0.45f, 6.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-16.0f, 1.75f, -4.0f)); // set position xyz
-	Object->setShape(box); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 0.7f, 0.22f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->setObjectShaderMaterial("wood");
-	Object->render(); // Create the object.
-
-	// Book 2 paper
-	Object->setRotations(glm::vec3(0.0f, 15.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(4.81f, 0.4f, 6.1f)); // scale XYZ
-	Object->setPosition(glm::vec3(-15.9f, 1.75f, -4.0f)); // set position xyz
-	Object->setShape(box); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Book 1 on Desk
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(5.0f, 0.45f, 6.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-16.0f, 2.20f, -4.0f)); // set position xyz
-	Object->setShape(box); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(0.44f, 0.23f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture("drywall"); // Setting texture
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	// Book 1 paper
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(4.81f, 0.4f, 6.1f)); // scale XYZ
-	Object->setPosition(glm::vec3(-15.9f, 2.20f, -4.0f)); // set position xyz
-	Object->setShape(box); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Desktop
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(40.0f, 2.0f, 20.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, 0.0f, 0.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.773f, 0.78f, 0.702f, 1)); // Shader RGBA to black
-	Object->setShape(box);
-	Object->setTexture("wood"); // Setting texture to wood
-	Object->set_uvScale(glm::vec2(3.0f, 3.0f)); // uvscale of texture
-	Object->setObjectShaderMaterial("wood");
-	Object->render(); // Create the object.
-
-	// FR Desk Leg
-	Object->setRotations(glm::vec3(180.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(1.0f, 18.0f, 1.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(18.0f, 0.0f, 8.0f)); // set position xyz
-	Object->setShape(cylinder); // Set Lambda draw mesh function
-	Object->setRGBA(glm::vec4(0.369f, 0.369f, 0.369f, 1)); // Shader RGBA
-	Object->setTexture(""); // Setting texture
-	Object->setObjectShaderMaterial("metal");
-	Object->render(); // Create the object.
-
-	// FL Desk Leg
-	Object->setPosition(glm::vec3(-18.0f, 0.0f, 8.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// RL Desk Leg
-	Object->setPosition(glm::vec3(-18.0f, 0.0f, -8.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// RR Desk Leg
-	Object->setPosition(glm::vec3(18.0f, 0.0f, -8.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	/******************************************************************/
-	/*** Room                                                       ***/
-	/******************************************************************/
-
-	// North Wall 1
-	Object->setRotations(glm::vec3(90.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(20.0f, 1.0f, 25.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(60.0f, 26.0f, -50.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.612f, 0.612f, 0.612f, 1)); // Shader RGBA
-	Object->setShape(plane);
-	Object->setTexture("drywall"); // Setting texture to drywall
-	Object->set_uvScale(glm::vec2(3.0f, 3.0f)); // uvscale of texture
-	Object->setObjectShaderMaterial("wall");
-	Object->render(); // Create the object.
-
-	// South Wall
-	Object->setScale(glm::vec3(80.0f, 1.0f, 44.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, 26.0f, 80.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// North Wall 2
-	Object->setScale(glm::vec3(20.0f, 1.0f, 25.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(-60.0f, 26.0f, -50.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// North Wall 3
-	Object->setScale(glm::vec3(80.0f, 1.0f, 10.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, -8.0f, -50.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// North Wall 4
-	Object->setPosition(glm::vec3(0.0f, 60.0f, -50.0f)); // set position xyz
-	Object->set_uvScale(glm::vec2(5.0f, 1.3f)); // uvscale of texture
-	Object->render(); // Create the object.
-
-	// East Wall
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 90.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(44.0f, 1.0f, 65.0f)); // scale XYZ
-	Object->set_uvScale(glm::vec2(3.0f, 3.0f)); // uvscale of texture
-	Object->setPosition(glm::vec3(80.0f, 26.0f, 15.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// West Wall
-	Object->setPosition(glm::vec3(-80.0f, 26.0f, 15.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Ceiling
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(80.0f, 1.0f, 65.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, 70.0f, 15.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.467f, 0.467f, 0.58f, 1)); // Shader RGBA
-	Object->setTexture(""); // Setting texture to nothing
-	Object->render(); // Create the object.
-
-	// Ceiling Light
-	Object->setShape(sphere);
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(5.0f, 5.0f, 5.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, 71.0f, 0.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(1.0f, 1.0f, 1.0f, 1)); // Shader RGBA
-	Object->setTexture(""); // Setting texture to nothing
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Ceiling Light torus
-	Object->setShape(torus);
-	Object->setRotations(glm::vec3(90.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(0.0f, 70.0f, 0.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.0f, 0.0f, 0.0f, 1)); // Shader RGBA
-	Object->setObjectShaderMaterial("matte");
-	Object->render(); // Create the object.
-
-	// Floor
-	Object->setShape(plane);
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(80.0f, 1.0f, 65.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, -18.0f, 15.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.467f, 0.467f, 0.58f, 1)); // Shader RGBA
-	Object->setTexture("dark_carpet"); // Setting texture to nothing
-	Object->set_uvScale(glm::vec2(7.0f, 7.0f));
-	Object->setObjectShaderMaterial("matte");
-	Object->render(); // Create the object.
-
-	/******************************************************************/
-	/*** Outside                                                    ***/
-	/******************************************************************/
-
-	// Sky 1
-	Object->setRotations(glm::vec3(90.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(100.0f, 1.0f, 100.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, 0.0f, -80.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.725f, 0.859f, 0.988f, 1)); // Shader RGBA
-	Object->setTexture("clouds"); // Setting texture to nothing
-	Object->set_uvScale(glm::vec2(3.0f, 3.0f));
-	Object->setObjectShaderMaterial("glass");
-	Object->render(); // Create the object.
-
-	// Sky 2
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(0.0f, 71.0f, -80.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Sky 3
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 90.0f)); // rotations as XYZ
-	Object->setPosition(glm::vec3(-81.0f, 0.0f, -80.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Sky 4
-	Object->setPosition(glm::vec3(81.0f, 0.0f, -80.0f)); // set position xyz
-	Object->render(); // Create the object.
-
-	// Brick wall
-	Object->setRotations(glm::vec3(90.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(100.0f, 1.0f, 18.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, 0.0f, -79.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.961f, 0.329f, 0.329f, 1)); // Shader RGBA
-	Object->setTexture("orange_brick"); // Setting texture to nothing
-	Object->setObjectShaderMaterial("wall");
-	Object->render(); // Create the object.
-
-	// Hedge
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(200.0f, 15.0f, 5.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, -10.0f, -79.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.318f, 0.961f, 0.094f, 0.5)); // Shader RGBA
-	Object->setTexture("green_vegetation"); // Setting texture to nothing
-	Object->set_uvScale(glm::vec2(5.0f, 1.0f));
-	Object->setShape(box);
-	Object->setObjectShaderMaterial("hedge");
-	Object->render(); // Create the object.
-
-	// Brick wall topper
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(200.0f, 5.0f, 5.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, 19.0f, -79.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(1, 1, 1, 1)); // Shader RGBA
-	Object->setTexture("cement"); // Setting texture to nothing
-	Object->set_uvScale(glm::vec2(3.0f, 3.0f));
-	Object->setObjectShaderMaterial("soft");
-	Object->render(); // Create the object.
-
-	// Outside Ground
-	Object->setRotations(glm::vec3(0.0f, 0.0f, 0.0f)); // rotations as XYZ
-	Object->setScale(glm::vec3(100.0f, 1.0f, 100.0f)); // scale XYZ
-	Object->setPosition(glm::vec3(0.0f, -19.0f, -80.0f)); // set position xyz
-	Object->setRGBA(glm::vec4(0.318f, 0.961f, 0.094f, 1)); // Shader RGBA
-	Object->setTexture("green_vegetation"); // Setting texture to nothing
-	Object->setShape(plane);
-	Object->set_uvScale(glm::vec2(30.0f, 30.0f));
-	Object->setObjectShaderMaterial("matte");
-	Object->render(); // Create the object.
-
-	// Free up memory.
-	delete Object;
-	/****************************************************************/
+	if ((copies <= 1) || m_sceneChunks.empty())
+	{
+		return;
+	}
+
+	BOUNDING_VOLUME bounds = GetSceneBounds();
+	glm::vec3 spacing = bounds.extents * 2.2f;
+	int gridWidth = (int)ceil(sqrt((float)copies));
+
+	int chunkCount = (int)m_sceneChunks.size();
+	m_sceneChunks.reserve(chunkCount * copies);
+
+	for (int copy = 1; copy < copies; copy++)
+	{
+		glm::vec3 offset = glm::vec3(
+			(copy % gridWidth) * spacing.x,
+			0.0f,
+			-(copy / gridWidth) * spacing.z);
+
+		for (int i = 0; i < chunkCount; i++)
+		{
+			SCENE_CHUNK chunk;
+			chunk.name = m_sceneChunks[i].name;
+			chunk.loadDistance = m_sceneChunks[i].loadDistance;
+			chunk.objects = m_sceneChunks[i].objects;
+			for (object& sceneObject : chunk.objects)
+			{
+				sceneObject.setPosition(sceneObject.getPosition() + offset);
+			}
+			FinishSceneChunk(chunk);
+			m_sceneChunks.push_back(std::move(chunk));
+		}
+	}
+}
+
+/***********************************************************
+ *  FinishSceneChunk()
+ *
+ *  This method is used for working out the bounds around the
+ *  objects of the passed in chunk, and the textures they are
+ *  drawn with, which are loaded along with the chunk. The
+ *  chunk starts out unloaded.
+ ***********************************************************/
+void SceneManager::FinishSceneChunk(SCENE_CHUNK& chunk)
+{
+	chunk.bounds = BOUNDING_VOLUME();
+	chunk.textures.clear();
+	chunk.bResident = false;
+
+	for (int i = 0; i < (int)chunk.objects.size(); i++)
+	{
+		object& sceneObject = chunk.objects[i];
+		if (i == 0)
+		{
+			chunk.bounds = sceneObject.getWorldBounds();
+		}
+		else
+		{
+			chunk.bounds = Frustum::MergeBounds(chunk.bounds, sceneObject.getWorldBounds());
+		}
+
+		TextureHandle textureHandle = sceneObject.getTexture();
+		if ((textureHandle != INVALID_HANDLE) &&
+			(std::find(chunk.textures.begin(), chunk.textures.end(), textureHandle) == chunk.textures.end()))
+		{
+			chunk.textures.push_back(textureHandle);
+		}
+	}
+}
+
+/***********************************************************
+ *  RebuildResidentObjects()
+ *
+ *  This method is used for filling the retained scene graph
+ *  with copies of the objects of every loaded chunk, in
+ *  chunk order, and sorting it again on the next frame. The
+ *  copies in the scene graph may have been animated since
+ *  they were made, so they are copied back into their chunks
+ *  first, and a spinning object carries on from where it was
+ *  rather than snapping back to its authored rotation.
+ ***********************************************************/
+void SceneManager::RebuildResidentObjects()
+{
+	for (SCENE_CHUNK& chunk : m_sceneChunks)
+	{
+		int objectCount = (int)chunk.objects.size();
+		if ((chunk.firstSceneObject >= 0) &&
+			(chunk.firstSceneObject + objectCount <= (int)m_sceneObjects.size()))
+		{
+			std::copy(
+				m_sceneObjects.begin() + chunk.firstSceneObject,
+				m_sceneObjects.begin() + chunk.firstSceneObject + objectCount,
+				chunk.objects.begin());
+		}
+		chunk.firstSceneObject = -1;
+	}
+
+	m_sceneObjects.clear();
+	for (SCENE_CHUNK& chunk : m_sceneChunks)
+	{
+		if (chunk.bResident || (chunk.loadDistance <= 0.0f))
+		{
+			chunk.firstSceneObject = (int)m_sceneObjects.size();
+			m_sceneObjects.insert(m_sceneObjects.end(), chunk.objects.begin(), chunk.objects.end());
+		}
+	}
+	m_bRenderQueueDirty = true;
+	m_pShadowMaps->Invalidate();
+}
+
+/***********************************************************
+ *  UpdateStreaming()
+ *
+ *  This method is used for loading the chunks that the camera
+ *  has come within the load distance of, and unloading the
+ *  ones it has moved well past it, by the distance from the
+ *  camera to their bounds. The textures of every loaded chunk
+ *  are streamed in and marked used, then the least recently
+ *  used textures of unloaded chunks are freed until the rest
+ *  fit in the texture budget. The meshes are the shared
+ *  shapes, which stay loaded.
+ ***********************************************************/
+bool SceneManager::UpdateStreaming(const glm::vec3& viewPosition)
+{
+	m_streamingPosition = viewPosition;
+	m_bStreamingPositionSet = true;
+	m_pResidentTextures->BeginFrame();
+
+	bool bChanged = false;
+	for (SCENE_CHUNK& chunk : m_sceneChunks)
+	{
+		bool bResident = true;
+		if (chunk.loadDistance > 0.0f)
+		{
+			// distance from the camera to the nearest point of the bounds
+			glm::vec3 outside = glm::max(glm::abs(viewPosition - chunk.bounds.center) - chunk.bounds.extents, glm::vec3(0.0f));
+			float distance = glm::length(outside);
+			float limit = chunk.bResident ? chunk.loadDistance * CHUNK_UNLOAD_FACTOR : chunk.loadDistance;
+			bResident = (distance <= limit);
+		}
+
+		if (bResident != chunk.bResident)
+		{
+			chunk.bResident = bResident;
+			bChanged = true;
+		}
+
+		if (bResident)
+		{
+			for (TextureHandle textureHandle : chunk.textures)
+			{
+				StreamInGLTexture(textureHandle);
+			}
+		}
+	}
+
+	if (bChanged)
+	{
+		RebuildResidentObjects();
+	}
+
+	std::vector<int> evictions;
+	m_pResidentTextures->CollectEvictions(evictions);
+	for (int textureHandle : evictions)
+	{
+		EvictGLTexture(textureHandle);
+	}
+
+	return(bChanged);
+}
+
+/***********************************************************
+ *  SetTextureBudget()
+ *
+ *  This method is used for setting the bytes of texture
+ *  memory that the streamed textures are kept within, as
+ *  long as the textures of the loaded chunks fit.
+ ***********************************************************/
+void SceneManager::SetTextureBudget(size_t budget)
+{
+	m_pResidentTextures->SetBudget(budget);
+}
+
+/***********************************************************
+ *  SetDepthPrePass()
+ *
+ *  This method is used for turning the depth pre-pass on or
+ *  off. With it on, the opaque objects are drawn twice, once
+ *  into the depth buffer alone and once more shading only the
+ *  fragments whose depth matches, so the lighting runs once
+ *  per pixel however many surfaces overlap it.
+ ***********************************************************/
+void SceneManager::SetDepthPrePass(bool bEnabled)
+{
+	m_bUseDepthPrePass = bEnabled;
+}
+
+/***********************************************************
+ *  SetShowOverdraw()
+ *
+ *  This method is used for turning the overdraw view on or
+ *  off. Every shaded fragment adds a little color instead of
+ *  its lighting, so the brighter a pixel the more times it
+ *  was shaded.
+ ***********************************************************/
+void SceneManager::SetShowOverdraw(bool bShow)
+{
+	m_bShowOverdraw = bShow;
+}
+
+/***********************************************************
+ *  SetWeightedTransparency()
+ *
+ *  This method is used for choosing how the translucent
+ *  objects are blended. By default they are sorted back to
+ *  front every frame, which is exact for objects that do not
+ *  cross. Weighted blending needs no sorting and copes with
+ *  crossing and heavily layered objects, at the cost of an
+ *  approximate result and a full screen pass. It must be set
+ *  before the scene is prepared.
+ ***********************************************************/
+void SceneManager::SetWeightedTransparency(bool bEnabled)
+{
+	m_bUseWeightedBlend = bEnabled;
+}
+
+/***********************************************************
+ *  SetShadows()
+ *
+ *  This method is used for turning the shadows of the light
+ *  that casts them on or off. It must be set before the
+ *  scene is prepared.
+ ***********************************************************/
+void SceneManager::SetShadows(bool bEnabled)
+{
+	m_bUseShadows = bEnabled;
+}
+
+/***********************************************************
+ *  SetMeshLOD()
+ *
+ *  This method is used for turning the levels of detail of
+ *  the curved shapes on or off, and whether the switch from
+ *  one level to the next is dithered over a few frames of
+ *  movement rather than popping. The dither draws the fading
+ *  objects twice, so it is off unless asked for.
+ ***********************************************************/
+void SceneManager::SetMeshLOD(bool bEnabled, bool bDither)
+{
+	m_bUseMeshLOD = bEnabled;
+	m_bUseLODDither = bEnabled && bDither;
+	m_bInstanceFadesDirty = true;
+}
+
+/***********************************************************
+ *  SetDynamicTransforms()
+ *
+ *  This method is used for choosing how the model matrices
+ *  of the dynamic objects reach the GPU, either written into
+ *  a ring every frame or uploaded with the other instances
+ *  whenever one of them moved. It must be set before the
+ *  scene is prepared.
+ ***********************************************************/
+void SceneManager::SetDynamicTransforms(bool bEnabled)
+{
+	m_bUseDynamicTransforms = bEnabled;
+}
+
+/***********************************************************
+ *  AnimateSceneObjects()
+ *
+ *  This method is used for turning every spinning scene
+ *  object by its spin over the passed in number of seconds.
+ *  The objects are turned and their matrices and bounds
+ *  rebuilt across the threads of the job system, then the
+ *  hierarchy and instances are updated on this thread.
+ ***********************************************************/
+void SceneManager::AnimateSceneObjects(float seconds)
+{
+	m_objectsMoved.assign(m_sceneObjects.size(), 0);
+
+	// each range owns its own objects, so the transforms and bounds
+	// they cache are never built by two threads at once
+	m_pJobSystem->ParallelFor((int)m_sceneObjects.size(), ANIMATE_RANGE_SIZE,
+		[this, seconds](int first, int end, int /*thread*/)
+		{
+			for (int i = first; i < end; i++)
+			{
+				if (m_sceneObjects[i].spin(seconds))
+				{
+					m_sceneObjects[i].getWorldBounds();
+					m_objectsMoved[i] = 1;
+				}
+			}
+		});
+
+	UpdateMovedObjects();
+}
+
+/***********************************************************
+ *  InterpolateSceneObjects()
+ *
+ *  This method is used for drawing every spinning scene
+ *  object at the passed in fraction of the way through its
+ *  last turn, the same fraction the camera is drawn at, so
+ *  the objects turn smoothly between the simulation ticks.
+ ***********************************************************/
+void SceneManager::InterpolateSceneObjects(float interpolation)
+{
+	m_objectsMoved.assign(m_sceneObjects.size(), 0);
+
+	m_pJobSystem->ParallelFor((int)m_sceneObjects.size(), ANIMATE_RANGE_SIZE,
+		[this, interpolation](int first, int end, int /*thread*/)
+		{
+			for (int i = first; i < end; i++)
+			{
+				if (m_sceneObjects[i].interpolateSpin(interpolation))
+				{
+					m_sceneObjects[i].getWorldBounds();
+					m_objectsMoved[i] = 1;
+				}
+			}
+		});
+
+	UpdateMovedObjects();
+}
+
+/***********************************************************
+ *  UpdateMovedObjects()
+ *
+ *  This method is used for picking up the transforms of the
+ *  scene objects flagged as moved. Until the render queue is
+ *  rebuilt nothing is done, since the rebuild picks up their
+ *  transforms.
+ ***********************************************************/
+void SceneManager::UpdateMovedObjects()
+{
+	if (m_bRenderQueueDirty)
+	{
+		return;
+	}
+
+	for (int i = 0; i < (int)m_objectsMoved.size(); i++)
+	{
+		if (m_objectsMoved[i])
+		{
+			UpdateSceneObject(i);
+		}
+	}
+}
+
+/***********************************************************
+ *  SetJobThreads()
+ *
+ *  This method is used for setting the number of threads
+ *  the scene passes are split across, counting the GL
+ *  thread. A single thread runs them all on the GL thread.
+ ***********************************************************/
+void SceneManager::SetJobThreads(int threadCount)
+{
+	delete m_pJobSystem;
+	m_pJobSystem = new JobSystem(threadCount);
+}
+
+/***********************************************************
+ *  GetSceneObjectCount()
+ *
+ *  This method is used for getting the number of objects in
+ *  the retained scene graph.
+ ***********************************************************/
+int SceneManager::GetSceneObjectCount() const
+{
+	return((int)m_sceneObjects.size());
+}
+
+/***********************************************************
+ *  GetSceneBounds()
+ *
+ *  This method is used for getting the bounding volume that
+ *  encloses the world bounds of every scene object, whether
+ *  its chunk is loaded or not.
+ ***********************************************************/
+BOUNDING_VOLUME SceneManager::GetSceneBounds()
+{
+	BOUNDING_VOLUME bounds = BOUNDING_VOLUME();
+	bool bFirst = true;
+
+	for (const SCENE_CHUNK& chunk : m_sceneChunks)
+	{
+		if (chunk.objects.empty())
+		{
+			continue;
+		}
+
+		if (bFirst)
+		{
+			bounds = chunk.bounds;
+			bFirst = false;
+		}
+		else
+		{
+			bounds = Frustum::MergeBounds(bounds, chunk.bounds);
+		}
+	}
+
+	return(bounds);
+}
+
+/***********************************************************
+ *  FinishTextureLoading()
+ *
+ *  This method is used for blocking until every queued
+ *  texture has been decoded, uploaded and packed into its
+ *  array page, so that frames drawn afterwards all draw the
+ *  same textures, such as when rendering is measured.
+ ***********************************************************/
+void SceneManager::FinishTextureLoading()
+{
+	m_uploadedTextures.clear();
+	m_pTextureLoader->Finish(&m_uploadedTextures);
+	PackUploadedTextures();
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing the passed in level of
+ *  detail of a basic mesh shape with the currently set
+ *  shader values. The shape is drawn from the shared buffers
+ *  as a single instance, whose per-instance values the
+ *  shader ignores while instancing is turned off.
+ ***********************************************************/
+void SceneManager::DrawMesh(MESH_SHAPE shape, int lod)
+{
+	if ((shape < 0) || (shape >= MESH_SHAPE_COUNT))
+	{
+		return;
+	}
+
+	m_renderStats.drawCalls++;
+	m_renderStats.trianglesDrawn += m_sceneMeshes->GetTriangleCount(shape, lod);
+	m_sceneMeshes->DrawMeshInstanced(shape, 1, 0, lod);
+}
+
+/***********************************************************
+ *  BuildRenderQueue()
+ *
+ *  This method is used for sorting the scene objects into
+ *  the render queue. Opaque objects are ordered by texture
+ *  group, mesh and material so that consecutive draws share
+ *  as much state as possible, translucent objects are drawn
+ *  last.
+ ***********************************************************/
+void SceneManager::BuildRenderQueue()
+{
+	m_renderQueue.Clear();
+
+	for (int i = 0; i < (int)m_sceneObjects.size(); i++)
+	{
+		const object& sceneObject = m_sceneObjects[i];
+
+		if (sceneObject.isTranslucent())
+		{
+			m_renderQueue.Add(RenderQueue::MakeTranslucentKey(i), i);
+		}
+		else
+		{
+			// there is a single scene shader program for now
+			m_renderQueue.Add(RenderQueue::MakeOpaqueKey(
+				0,
+				GetTextureGroup(sceneObject.getTexture()),
+				sceneObject.getMaterial(),
+				sceneObject.getShape(),
+				i), i);
+		}
+	}
+
+	m_renderQueue.Sort(m_pJobSystem);
+
+	// the translucent draws are sorted after every opaque one
+	m_translucentItems.clear();
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	for (int i = 0; i < (int)items.size(); i++)
+	{
+		if (m_sceneObjects[items[i].objectIndex].isTranslucent())
+		{
+			m_translucentItems.push_back(i);
+		}
+	}
+	m_bRenderQueueDirty = false;
+}
+
+/***********************************************************
+ *  BuildInstanceBatches()
+ *
+ *  This method is used for grouping the sorted render queue
+ *  into instanced draw batches. Consecutive opaque objects
+ *  that share a mesh and texture group become one batch,
+ *  since the color, UV scale, material and texture layer are
+ *  per-instance values.
+ *  Translucent objects are each drawn on their own so they
+ *  keep their blending order.
+ ***********************************************************/
+void SceneManager::BuildInstanceBatches()
+{
+	m_instanceData.clear();
+	m_instanceBatches.clear();
+	m_instanceDynamic.clear();
+
+	for (const RENDER_ITEM& item : m_renderQueue.GetItems())
+	{
+		object& sceneObject = m_sceneObjects[item.objectIndex];
+
+		INSTANCE_DATA instance;
+		sceneObject.getInstanceData(instance);
+		m_instanceData.push_back(instance);
+		m_instanceDynamic.push_back(sceneObject.isDynamic());
+
+		int textureGroup = GetTextureGroup(sceneObject.getTexture());
+
+		// the sampler only splits batches of textured objects
+		SamplerHandle sampler = INVALID_HANDLE;
+		if (textureGroup != INVALID_HANDLE)
+		{
+			sampler = GetMaterialSampler(sceneObject.getMaterial());
+		}
+
+		bool bNewBatch = true;
+		if (!m_instanceBatches.empty() && !sceneObject.isTranslucent())
+		{
+			const INSTANCE_BATCH& lastBatch = m_instanceBatches.back();
+			bNewBatch = lastBatch.bTranslucent ||
+				(lastBatch.shape != sceneObject.getShape()) ||
+				(lastBatch.textureGroup != textureGroup) ||
+				(lastBatch.sampler != sampler);
+		}
+
+		if (bNewBatch)
+		{
+			INSTANCE_BATCH batch;
+			batch.shape = sceneObject.getShape();
+			batch.texture = sceneObject.getTexture();
+			batch.textureGroup = textureGroup;
+			batch.sampler = sampler;
+			batch.bTranslucent = sceneObject.isTranslucent();
+			batch.firstInstance = (GLuint)m_instanceData.size() - 1;
+			batch.instanceCount = 0;
+			m_instanceBatches.push_back(batch);
+		}
+		m_instanceBatches.back().instanceCount++;
+	}
+
+	// the dynamic instances read their model matrix from the ring,
+	// so moving them never uploads the instance buffer again
+	m_dynamicInstances.clear();
+	if (m_bUseDynamicTransforms)
+	{
+		for (int i = 0; i < (int)m_instanceData.size(); i++)
+		{
+			if (m_instanceDynamic[i])
+			{
+				m_instanceData[i].dynamicSlot = (int)m_dynamicInstances.size();
+				m_dynamicInstances.push_back(i);
+			}
+		}
+
+		if (!m_dynamicInstances.empty() &&
+			!m_pDynamicTransforms->Reserve((int)m_dynamicInstances.size()))
+		{
+			for (int item : m_dynamicInstances)
+			{
+				m_instanceData[item].dynamicSlot = -1;
+			}
+			m_dynamicInstances.clear();
+		}
+	}
+
+	// every instance is drawn, at its finest level, until the first
+	// culling pass
+	m_instanceVisible.assign(m_instanceData.size(), true);
+	m_instanceLODs.assign(m_instanceData.size(), 0);
+	m_instanceFades.assign(m_instanceData.size(), 0.0f);
+	m_bInstanceFadesDirty = true;
+	m_lodTransitions.clear();
+	BuildShadowCommands();
+	m_bDrawCommandsDirty = true;
+
+	// the scene graph is retained, so the instances are only
+	// uploaded again when the scene objects change
+	m_sceneMeshes->UploadInstances(m_instanceData);
+}
+
+/***********************************************************
+ *  BuildIndirectCommands()
+ *
+ *  This method is used for turning the visible instances of
+ *  every batch into indirect commands, one for each range of
+ *  consecutive visible instances at the same level of
+ *  detail, and grouping consecutive
+ *  commands that share a texture group into runs. The commands of a
+ *  run are drawn in order, so translucent batches keep their
+ *  blending order. Opaque and translucent batches never share
+ *  a run, so the opaque runs can be drawn on their own. The
+ *  commands of the shadow casters follow the ones of the view.
+ *  Each range of the instances gets its own command list,
+ *  built across the threads of the job system, and the lists
+ *  are replayed in order into the commands that are uploaded.
+ ***********************************************************/
+void SceneManager::BuildIndirectCommands()
+{
+	int instanceCount = (int)m_instanceData.size();
+	m_commandLists.resize(JobSystem::GetRangeCount(instanceCount, COMMAND_RANGE_SIZE));
+
+	m_pJobSystem->ParallelFor(instanceCount, COMMAND_RANGE_SIZE,
+		[this](int first, int end, int /*thread*/)
+		{
+			BuildCommandList((GLuint)first, (GLuint)end, m_commandLists[first / COMMAND_RANGE_SIZE]);
+		});
+
+	m_drawCommands.clear();
+	m_indirectRuns.clear();
+	for (const COMMAND_LIST& commandList : m_commandLists)
+	{
+		for (const INDIRECT_RUN& run : commandList.runs)
+		{
+			for (GLsizei i = 0; i < run.commandCount; i++)
+			{
+				AppendIndirectCommand(run, commandList.commands[run.firstCommand + i],
+					m_drawCommands, m_indirectRuns);
+			}
+		}
+	}
+
+	// the shadow casters are not culled by the view, so their
+	// commands are only rebuilt along with the batches
+	m_shadowFirstCommand = (GLuint)m_drawCommands.size();
+	m_drawCommands.insert(m_drawCommands.end(), m_shadowCommands.begin(), m_shadowCommands.end());
+
+	// the commands only change when the scene objects or the
+	// set of visible objects change
+	m_sceneMeshes->UploadDrawCommands(m_drawCommands);
+	m_bDrawCommandsDirty = false;
+}
+
+/***********************************************************
+ *  BuildCommandList()
+ *
+ *  This method is used for building the commands and runs
+ *  of the visible instances in the passed in range, the way
+ *  BuildIndirectCommands() describes. The range may start
+ *  and end part way through a batch. Only the scene's own
+ *  lists are read, so ranges can be built on any thread.
+ ***********************************************************/
+void SceneManager::BuildCommandList(GLuint firstInstance, GLuint endInstance, COMMAND_LIST& commandList) const
+{
+	commandList.commands.clear();
+	commandList.runs.clear();
+
+	// find the batch holding the first instance of the range
+	std::vector<INSTANCE_BATCH>::const_iterator batchIt = std::upper_bound(
+		m_instanceBatches.begin(), m_instanceBatches.end(), firstInstance,
+		[](GLuint instance, const INSTANCE_BATCH& batch)
+		{
+			return(instance < batch.firstInstance);
+		});
+	if (batchIt == m_instanceBatches.begin())
+	{
+		return;
+	}
+
+	for (batchIt--; (batchIt != m_instanceBatches.end()) && (batchIt->firstInstance < endInstance); batchIt++)
+	{
+		const INSTANCE_BATCH& batch = *batchIt;
+		GLuint batchEnd = std::min(batch.firstInstance + (GLuint)batch.instanceCount, endInstance);
+		GLuint instance = std::max(batch.firstInstance, firstInstance);
+
+		INDIRECT_RUN run;
+		run.texture = batch.texture;
+		run.textureGroup = batch.textureGroup;
+		run.sampler = batch.sampler;
+		run.bTranslucent = batch.bTranslucent;
+
+		while (instance < batchEnd)
+		{
+			// skip to the start of the next visible range
+			if (!m_instanceVisible[instance])
+			{
+				instance++;
+				continue;
+			}
+
+			GLuint firstVisible = instance;
+			int lod = m_instanceLODs[instance];
+			while ((instance < batchEnd) && m_instanceVisible[instance] &&
+				(m_instanceLODs[instance] == lod))
+			{
+				instance++;
+			}
+
+			DRAW_ELEMENTS_COMMAND command;
+			m_sceneMeshes->MakeDrawCommand(batch.shape, (GLsizei)(instance - firstVisible), firstVisible, lod, command);
+			AppendIndirectCommand(run, command, commandList.commands, commandList.runs);
+		}
+	}
+}
+
+/***********************************************************
+ *  AppendIndirectCommand()
+ *
+ *  This method is used for adding a command to the passed
+ *  in lists, starting a new run when its texture group,
+ *  sampler or translucency differs from the last run's. A
+ *  visible range that two command lists split between them
+ *  is joined back into one command, so the replayed lists
+ *  match the ones a single thread would build. Translucent
+ *  commands are never joined, since each is its own batch.
+ ***********************************************************/
+void SceneManager::AppendIndirectCommand(
+	const INDIRECT_RUN& run,
+	const DRAW_ELEMENTS_COMMAND& command,
+	std::vector<DRAW_ELEMENTS_COMMAND>& commands,
+	std::vector<INDIRECT_RUN>& runs)
+{
+	bool bSameRun = !runs.empty() &&
+		(runs.back().textureGroup == run.textureGroup) &&
+		(runs.back().sampler == run.sampler) &&
+		(runs.back().bTranslucent == run.bTranslucent);
+	int triangleCount = (int)(command.count / 3 * command.instanceCount);
+
+	if (bSameRun && !run.bTranslucent)
+	{
+		DRAW_ELEMENTS_COMMAND& lastCommand = commands.back();
+		if ((lastCommand.count == command.count) &&
+			(lastCommand.firstIndex == command.firstIndex) &&
+			(lastCommand.baseVertex == command.baseVertex) &&
+			(lastCommand.baseInstance + lastCommand.instanceCount == command.baseInstance))
+		{
+			lastCommand.instanceCount += command.instanceCount;
+			runs.back().instanceCount += (GLsizei)command.instanceCount;
+			runs.back().triangleCount += triangleCount;
+			return;
+		}
+	}
+
+	commands.push_back(command);
+
+	if (!bSameRun)
+	{
+		INDIRECT_RUN newRun = run;
+		newRun.firstCommand = (GLuint)commands.size() - 1;
+		newRun.commandCount = 0;
+		newRun.instanceCount = 0;
+		newRun.triangleCount = 0;
+		runs.push_back(newRun);
+	}
+	runs.back().commandCount++;
+	runs.back().instanceCount += (GLsizei)command.instanceCount;
+	runs.back().triangleCount += triangleCount;
+}
+
+/***********************************************************
+ *  BuildShadowCommands()
+ *
+ *  This method is used for building the indirect commands
+ *  the shadow casters are drawn with, one for each range of
+ *  consecutive opaque instances in a batch, first for the
+ *  static objects and then for the dynamic ones. Only the
+ *  depth is drawn, so the commands of every texture can be
+ *  submitted together. Translucent objects cast no shadows.
+ *  The casters are drawn at their finest level, since the
+ *  cached maps would otherwise change with the view.
+ ***********************************************************/
+void SceneManager::BuildShadowCommands()
+{
+	m_shadowCommands.clear();
+	m_staticShadowCommandCount = 0;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		bool bDynamic = (pass == 1);
+
+		for (const INSTANCE_BATCH& batch : m_instanceBatches)
+		{
+			if (batch.bTranslucent)
+			{
+				continue;
+			}
+
+			GLuint endInstance = batch.firstInstance + batch.instanceCount;
+			GLuint instance = batch.firstInstance;
+
+			while (instance < endInstance)
+			{
+				// skip to the start of the next range of this pass
+				if (m_instanceDynamic[instance] != bDynamic)
+				{
+					instance++;
+					continue;
+				}
+
+				GLuint firstInstance = instance;
+				while ((instance < endInstance) && (m_instanceDynamic[instance] == bDynamic))
+				{
+					instance++;
+				}
+
+				DRAW_ELEMENTS_COMMAND command;
+				m_sceneMeshes->MakeDrawCommand(batch.shape, (GLsizei)(instance - firstInstance), firstInstance, 0, command);
+				m_shadowCommands.push_back(command);
+			}
+		}
+
+		if (!bDynamic)
+		{
+			m_staticShadowCommandCount = (GLsizei)m_shadowCommands.size();
+		}
+	}
+}
+
+/***********************************************************
+ *  SetFrameProfiler()
+ *
+ *  This method is used for setting the profiler that the
+ *  phases of RenderScene() are timed with. A NULL profiler
+ *  turns the timing off.
+ ***********************************************************/
+void SceneManager::SetFrameProfiler(FrameProfiler* pFrameProfiler)
+{
+	m_pFrameProfiler = pFrameProfiler;
+}
+
+/***********************************************************
+ *  SetViewFrustum()
+ *
+ *  This method is used for setting the view projection of
+ *  the frame about to be rendered, which the scene objects
+ *  are culled against.
+ ***********************************************************/
+void SceneManager::SetViewFrustum(const glm::mat4& viewProjection)
+{
+	m_frustum.SetViewProjection(viewProjection);
+	m_bFrustumValid = true;
+}
+
+/***********************************************************
+ *  SetViewMatrices()
+ *
+ *  This method is used for setting the view and projection
+ *  of the frame about to be rendered, which the lights are
+ *  binned into clusters of and the translucent objects are
+ *  sorted by.
+ ***********************************************************/
+void SceneManager::SetViewMatrices(const glm::mat4& view, const glm::mat4& projection)
+{
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+	m_bViewMatricesValid = true;
+}
+
+/***********************************************************
+ *  CullSceneObjects()
+ *
+ *  This method is used for testing the world space bounds of
+ *  every object in the render queue against the view frustum,
+ *  either through the scene hierarchy or one at a time. The
+ *  hierarchy is split into branches and the objects into
+ *  ranges, which are culled across the threads of the job
+ *  system. The indirect commands are flagged for rebuilding
+ *  only when an object became visible or was culled since
+ *  last frame.
+ ***********************************************************/
+void SceneManager::CullSceneObjects()
+{
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	bool bCull = m_bUseFrustumCulling && m_bFrustumValid;
+
+	ResetThreadResults();
+
+	if (bCull && m_bUseSceneBVH)
+	{
+		// the hierarchy items are render queue positions, and every
+		// item is below a single branch, so the threads never mark
+		// the same one
+		m_cullResults.assign(items.size(), 0);
+		m_sceneBVH.SplitCull(m_frustum, m_pJobSystem->GetThreadCount() * CULL_BRANCHES_PER_THREAD, m_cullBranches);
+
+		m_pJobSystem->ParallelFor((int)m_cullBranches.size(), 1,
+			[this](int first, int end, int thread)
+			{
+				THREAD_RESULTS& results = m_threadResults[thread];
+				for (int branch = first; branch < end; branch++)
+				{
+					results.visibleItems.clear();
+					m_sceneBVH.CullBranch(m_frustum, m_cullBranches[branch], results.visibleItems);
+					for (int item : results.visibleItems)
+					{
+						m_cullResults[item] = 1;
+					}
+					results.objectsVisible += (int)results.visibleItems.size();
+				}
+			});
+	}
+	else
+	{
+		m_cullResults.resize(items.size());
+
+		// the bounds are cached in the object the first time they are
+		// asked for, which threads can do side by side only because
+		// the render queue holds each object once
+		m_pJobSystem->ParallelFor((int)items.size(), CULL_RANGE_SIZE,
+			[this, &items, bCull](int first, int end, int thread)
+			{
+				THREAD_RESULTS& results = m_threadResults[thread];
+				for (int i = first; i < end; i++)
+				{
+					bool bVisible = true;
+					if (bCull)
+					{
+						bVisible = m_frustum.IsVisible(m_sceneObjects[items[i].objectIndex].getWorldBounds());
+					}
+
+					m_cullResults[i] = bVisible ? 1 : 0;
+					if (bVisible)
+					{
+						results.objectsVisible++;
+					}
+				}
+			});
+	}
+
+	int objectsVisible = 0;
+	for (const THREAD_RESULTS& results : m_threadResults)
+	{
+		objectsVisible += results.objectsVisible;
+	}
+	m_renderStats.objectsVisible += objectsVisible;
+	m_renderStats.objectsCulled += (int)items.size() - objectsVisible;
+
+	if (m_cullResults != m_instanceVisible)
+	{
+		m_instanceVisible.swap(m_cullResults);
+		m_bDrawCommandsDirty = true;
+	}
+}
+
+/***********************************************************
+ *  ResetThreadResults()
+ *
+ *  This method is used for clearing the counters and flags
+ *  each thread of the job system keeps, before a scene pass
+ *  is split across them.
+ ***********************************************************/
+void SceneManager::ResetThreadResults()
+{
+	m_threadResults.resize(m_pJobSystem->GetThreadCount());
+	for (THREAD_RESULTS& results : m_threadResults)
+	{
+		results.objectsVisible = 0;
+		results.bLODsChanged = false;
+		results.bFadesChanged = false;
+		results.visibleItems.clear();
+	}
+}
+
+/***********************************************************
+ *  SelectMeshLODs()
+ *
+ *  This method is used for picking the level of detail of
+ *  every visible instance by how many pixels its bounding
+ *  sphere spans on screen. A view from inside the sphere
+ *  keeps the finest level. The indirect commands are flagged
+ *  for rebuilding when any level changed, and the fades of
+ *  the dithered switch are uploaded when any of them moved.
+ *  Only opaque instances drawn instanced fade, the others
+ *  switch at once. The instances are split into ranges
+ *  across the threads of the job system.
+ ***********************************************************/
+void SceneManager::SelectMeshLODs()
+{
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	bool bSelect = m_bUseMeshLOD && m_bViewMatricesValid;
+	bool bDither = bSelect && m_bUseLODDither && m_bUseInstancing;
+
+	GLint viewport[4] = { 0, 0, 1, 1 };
+	if (bSelect)
+	{
+		glGetIntegerv(GL_VIEWPORT, viewport);
+	}
+
+	// a sphere of radius r at clip w spans r * P[1][1] / w of half
+	// the view height, which is viewport height / 2 pixels
+	glm::mat4 viewProjection = m_projectionMatrix * m_viewMatrix;
+	float pixelScale = m_projectionMatrix[1][1] * (float)viewport[3];
+	bool bPerspective = (m_projectionMatrix[2][3] != 0.0f);
+
+	// as in the culling, the objects' cached bounds may be built on
+	// any thread since no object is queued twice
+	ResetThreadResults();
+	m_pJobSystem->ParallelFor((int)items.size(), CULL_RANGE_SIZE,
+		[this, &items, &viewProjection, bSelect, bDither, pixelScale, bPerspective](int first, int end, int thread)
+		{
+			THREAD_RESULTS& results = m_threadResults[thread];
+			for (int i = first; i < end; i++)
+			{
+				int lod = 0;
+				float fade = 0.0f;
+				if (bSelect && m_instanceVisible[i])
+				{
+					object& sceneObject = m_sceneObjects[items[i].objectIndex];
+					const BOUNDING_VOLUME& bounds = sceneObject.getWorldBounds();
+					float w = (viewProjection * glm::vec4(bounds.center, 1.0f)).w;
+					if (!bPerspective || (w > bounds.radius))
+					{
+						float screenSize = bounds.radius * pixelScale / w;
+						bool bFade = bDither && !sceneObject.isTranslucent();
+						lod = m_sceneMeshes->SelectLOD(sceneObject.getShape(), screenSize, bFade ? &fade : NULL);
+					}
+				}
+
+				if (m_instanceLODs[i] != lod)
+				{
+					m_instanceLODs[i] = lod;
+					results.bLODsChanged = true;
+				}
+				if (m_instanceFades[i] != fade)
+				{
+					m_instanceFades[i] = fade;
+					results.bFadesChanged = true;
+				}
+			}
+		});
+
+	for (const THREAD_RESULTS& results : m_threadResults)
+	{
+		m_bDrawCommandsDirty = m_bDrawCommandsDirty || results.bLODsChanged;
+		m_bInstanceFadesDirty = m_bInstanceFadesDirty || results.bFadesChanged;
+	}
+
+	m_lodTransitions.clear();
+	for (int i = 0; i < (int)m_instanceFades.size(); i++)
+	{
+		if (m_instanceFades[i] > 0.0f)
+		{
+			m_lodTransitions.push_back(i);
+		}
+	}
+
+	if (m_bInstanceFadesDirty)
+	{
+		// without the dither the fade attribute is turned off
+		if (m_bUseLODDither)
+		{
+			m_sceneMeshes->UploadInstanceFades(m_instanceFades);
+		}
+		else
+		{
+			m_sceneMeshes->UploadInstanceFades(std::vector<float>());
+		}
+		m_bInstanceFadesDirty = false;
+	}
+}
+
+/***********************************************************
+ *  BuildSceneBVH()
+ *
+ *  This method is used for building the bounding volume
+ *  hierarchy over the world bounds of the objects in the
+ *  render queue, and for recording where each object sits in
+ *  the queue so it can be refit when it moves.
+ ***********************************************************/
+void SceneManager::BuildSceneBVH()
+{
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+
+	std::vector<BOUNDING_VOLUME> itemBounds(items.size());
+	m_queuePositions.assign(m_sceneObjects.size(), -1);
+	for (int i = 0; i < (int)items.size(); i++)
+	{
+		itemBounds[i] = m_sceneObjects[items[i].objectIndex].getWorldBounds();
+		m_queuePositions[items[i].objectIndex] = i;
+	}
+
+	m_sceneBVH.Build(itemBounds);
+}
+
+/***********************************************************
+ *  UpdateSceneObject()
+ *
+ *  This method is used for picking up a change to the
+ *  transform, color or UV scale of the scene object at the
+ *  passed in index. Its branch of the scene hierarchy is
+ *  refit and its instance values are uploaded next frame.
+ *  A static object also drops the cached shadow maps, a
+ *  dynamic one is drawn into them every frame anyway.
+ *  Changing its mesh, texture or material needs the render
+ *  queue to be rebuilt instead.
+ ***********************************************************/
+void SceneManager::UpdateSceneObject(int objectIndex)
+{
+	if ((objectIndex < 0) || (objectIndex >= (int)m_queuePositions.size()) ||
+		(m_queuePositions[objectIndex] < 0))
+	{
+		return;
+	}
+
+	int queuePosition = m_queuePositions[objectIndex];
+	object& sceneObject = m_sceneObjects[objectIndex];
+
+	m_sceneBVH.Refit(queuePosition, sceneObject.getWorldBounds());
+
+	// the matrix of an instance in the ring is written every frame
+	int dynamicSlot = m_instanceData[queuePosition].dynamicSlot;
+	sceneObject.getInstanceData(m_instanceData[queuePosition]);
+	m_instanceData[queuePosition].dynamicSlot = dynamicSlot;
+	if (dynamicSlot < 0)
+	{
+		m_bInstancesDirty = true;
+	}
+
+	if (!sceneObject.isDynamic())
+	{
+		m_pShadowMaps->Invalidate();
+	}
+}
+
+/***********************************************************
+ *  PickSceneObject()
+ *
+ *  This method is used for finding the scene object whose
+ *  bounds the passed in world space ray hits first, such as
+ *  the ray under the mouse cursor. -1 is returned when the
+ *  ray hits nothing.
+ ***********************************************************/
+int SceneManager::PickSceneObject(const glm::vec3& origin, const glm::vec3& direction)
+{
+	float hitDistance = 0.0f;
+	int item = m_sceneBVH.Raycast(origin, direction, hitDistance);
+	if (item < 0)
+	{
+		return(-1);
+	}
+
+	return(m_renderQueue.GetItems()[item].objectIndex);
+}
+
+/***********************************************************
+ *  ReportPickedObject()
+ *
+ *  This method is used for printing which scene object was
+ *  picked, by its index in the scene graph, its shape and
+ *  its position, or that nothing was under the cursor.
+ ***********************************************************/
+void SceneManager::ReportPickedObject(int objectIndex) const
+{
+	if ((objectIndex < 0) || (objectIndex >= (int)m_sceneObjects.size()))
+	{
+		std::cout << "Picked nothing" << std::endl;
+		return;
+	}
+
+	const object& sceneObject = m_sceneObjects[objectIndex];
+	const glm::vec3& position = sceneObject.getPosition();
+	std::cout << "Picked scene object " << objectIndex << ", a "
+		<< SceneFile::GetShapeName(sceneObject.getShape()) << " at ("
+		<< position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
+}
+
+/***********************************************************
+ *  ResetRenderState()
+ *
+ *  This method is used for forgetting the tracked shader
+ *  state, so the next write of every value goes through, and
+ *  for clearing the per-frame draw counters.
+ ***********************************************************/
+void SceneManager::ResetRenderState()
+{
+	m_renderState.useTexture = -1;
+	m_renderState.textureSlot = -2;
+	m_renderState.useTextureArray = -1;
+	m_renderState.textureArrayPage = -2;
+	m_renderState.textureLayer = -1;
+	m_renderState.boundTexture = 0;
+	m_renderState.sampler = -2;
+	m_renderState.samplerUnit = -1;
+	m_renderState.materialIndex = -2;
+	m_renderState.bObjectColorValid = false;
+	m_renderState.bUVScaleValid = false;
+
+	m_renderStats.drawCalls = 0;
+	m_renderStats.indirectCommands = 0;
+	m_renderStats.prePassDrawCalls = 0;
+	m_renderStats.stateChanges = 0;
+	m_renderStats.stateChangesSkipped = 0;
+	m_renderStats.objectsDrawn = 0;
+	m_renderStats.objectsVisible = 0;
+	m_renderStats.objectsCulled = 0;
+	m_renderStats.trianglesDrawn = 0;
+}
+
+/***********************************************************
+ *  GetRenderStats()
+ *
+ *  This method is used for getting the draw counters of the
+ *  last rendered frame.
+ ***********************************************************/
+const RENDER_STATS& SceneManager::GetRenderStats() const
+{
+	return(m_renderStats);
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by 
+ *  walking the render queue and drawing each object
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	// upload the texture images decoded since the last frame, and
+	// pack them into their array pages before the queue is built
+	{
+		ProfileScope scope(m_pFrameProfiler, "Texture uploads");
+		m_uploadedTextures.clear();
+		m_pTextureLoader->Update(&m_uploadedTextures);
+		PackUploadedTextures();
+	}
+
+	// re-sort and re-batch the scene objects if they changed
+	{
+		ProfileScope scope(m_pFrameProfiler, "Build queue");
+		if (m_bRenderQueueDirty)
+		{
+			BuildRenderQueue();
+			BuildInstanceBatches();
+			BuildSceneBVH();
+		}
+
+		// upload the instances of objects moved since the last frame
+		if (m_bInstancesDirty)
+		{
+			m_sceneMeshes->UploadInstances(m_instanceData);
+			m_bInstancesDirty = false;
+		}
+	}
+
+	// write the matrices of the dynamic objects for this frame
+	{
+		ProfileScope scope(m_pFrameProfiler, "Dynamic transforms");
+		UpdateDynamicTransforms();
+	}
+
+	// the tracked state is rebuilt every frame, since the
+	// shader values may have been changed outside the scene
+	ResetRenderState();
+
+	// cull the objects outside the view and pick the level of detail
+	// of the rest, the indirect commands are only rebuilt when the
+	// set of visible objects or their levels changed
+	{
+		ProfileScope scope(m_pFrameProfiler, "Cull");
+		CullSceneObjects();
+		SelectMeshLODs();
+		if (m_bDrawCommandsDirty)
+		{
+			BuildIndirectCommands();
+		}
+	}
+
+	// upload the light sources if they changed, and list the ones
+	// reaching each cluster of the view
+	{
+		ProfileScope scope(m_pFrameProfiler, "Light culling");
+		UploadSceneLights();
+		UpdateLightClusters();
+	}
+
+	// draw the shadow casters into the maps that need them
+	{
+		ProfileScope scope(m_pFrameProfiler, "Shadow maps");
+		UpdateShadowMaps();
+	}
+
+	// the depth-only draws are told apart by a shader value
+	bool bDepthPrePass = m_bUseDepthPrePass && (NULL != m_pUniformCache);
+
+	// every shaded fragment adds to the color in the overdraw view
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bShowOverdraw, m_bShowOverdraw);
+	}
+	if (m_bShowOverdraw)
+	{
+		glBlendFunc(GL_ONE, GL_ONE);
+	}
+
+	if (bDepthPrePass)
+	{
+		// lay down the depth of the opaque objects without shading them
+		{
+			ProfileScope scope(m_pFrameProfiler, "Depth pre-pass");
+			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bDepthOnly, true);
+			RENDER_STATS shadedStats = m_renderStats;
+			DrawSceneObjects(DRAW_OPAQUE_OBJECTS);
+			m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bDepthOnly, false);
+
+			// the opaque objects are counted once, by the shaded pass
+			m_renderStats.prePassDrawCalls += m_renderStats.drawCalls - shadedStats.drawCalls;
+			m_renderStats.drawCalls = shadedStats.drawCalls;
+			m_renderStats.indirectCommands = shadedStats.indirectCommands;
+			m_renderStats.objectsDrawn = shadedStats.objectsDrawn;
+			m_renderStats.trianglesDrawn = shadedStats.trianglesDrawn;
+			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		}
+
+		// shade only the fragments that ended up in front, then blend
+		// the translucent objects over them as before
+		ProfileScope scope(m_pFrameProfiler, "Draw");
+		glDepthFunc(GL_EQUAL);
+		glDepthMask(GL_FALSE);
+		DrawSceneObjects(DRAW_OPAQUE_OBJECTS);
+		glDepthFunc(GL_LESS);
+		glDepthMask(GL_TRUE);
+		DrawSceneObjects(DRAW_TRANSLUCENT_OBJECTS);
+	}
+	else
+	{
+		ProfileScope scope(m_pFrameProfiler, "Draw");
+		DrawSceneObjects(DRAW_ALL_OBJECTS);
+	}
+
+	if (m_bShowOverdraw)
+	{
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+
+	// the ring region of this frame is free again once its draws finish
+	m_pDynamicTransforms->EndFrame();
+}
+
+/***********************************************************
+ *  DrawSceneObjects()
+ *
+ *  This method is used for drawing the scene objects that
+ *  pass the filter with multi-draw indirect calls, instanced
+ *  batches or one draw call per object, whichever is in use.
+ ***********************************************************/
+void SceneManager::DrawSceneObjects(DRAW_FILTER filter)
+{
+	if (filter != DRAW_TRANSLUCENT_OBJECTS)
+	{
+		if (m_bUseInstancing && m_bUseMultiDrawIndirect &&
+			m_sceneMeshes->IsMultiDrawIndirectSupported())
+		{
+			RenderIndirectRuns(DRAW_OPAQUE_OBJECTS);
+		}
+		else if (m_bUseInstancing)
+		{
+			RenderInstanceBatches(DRAW_OPAQUE_OBJECTS);
+		}
+		else
+		{
+			RenderSceneObjects(DRAW_OPAQUE_OBJECTS);
+		}
+		RenderLODTransitions();
+	}
+
+	// the translucent objects always go last, in their own pass
+	if (filter != DRAW_OPAQUE_OBJECTS)
+	{
+		RenderTranslucentObjects();
+	}
+}
+
+/***********************************************************
+ *  RenderLODTransitions()
+ *
+ *  This method is used for drawing every opaque instance
+ *  that is fading to its next level of detail a second time,
+ *  at that level. The shader keeps the fragments of each
+ *  draw by a dither pattern, the first draw the ones the
+ *  fade has not reached and this one the rest, so together
+ *  they cover the object once and the same pixels pass the
+ *  depth test in the pre-pass and the shading pass.
+ ***********************************************************/
+void SceneManager::RenderLODTransitions()
+{
+	if (m_lodTransitions.empty() || !m_bUseInstancing || (NULL == m_pUniformCache))
+	{
+		return;
+	}
+
+	m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseInstancing, true);
+	m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bLODFadeOut, true);
+
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	for (int item : m_lodTransitions)
+	{
+		object& sceneObject = m_sceneObjects[items[item].objectIndex];
+		int lod = m_instanceLODs[item] + 1;
+
+		SetObjectTexture(sceneObject);
+		m_sceneMeshes->DrawMeshInstanced(sceneObject.getShape(), 1, (GLuint)item, lod);
+		m_renderStats.drawCalls++;
+		m_renderStats.trianglesDrawn += (int)m_sceneMeshes->GetTriangleCount(sceneObject.getShape(), lod);
+	}
+
+	m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bLODFadeOut, false);
+}
+
+/***********************************************************
+ *  RenderTranslucentObjects()
+ *
+ *  This method is used for drawing the visible translucent
+ *  objects, one draw call each, after all of the opaque
+ *  objects. They are either sorted from the farthest to the
+ *  nearest and blended over the frame in that order, or
+ *  accumulated in any order with weighted blending. They are
+ *  depth tested against the opaque objects but never write
+ *  depth, so they do not hide each other.
+ ***********************************************************/
+void SceneManager::RenderTranslucentObjects()
+{
+	int visibleCount = 0;
+	for (int item : m_translucentItems)
+	{
+		if (m_instanceVisible[item])
+		{
+			visibleCount++;
+		}
+	}
+	if (visibleCount == 0)
+	{
+		return;
+	}
+
+	// the overdraw view needs the plain blending, so it always sorts
+	bool bWeightedBlend = m_bUseWeightedBlend && !m_bShowOverdraw &&
+		(NULL != m_pUniformCache) &&
+		m_pWeightedBlend->Begin(TRANSLUCENCY_FIRST_UNIT);
+
+	if (bWeightedBlend)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bWeightedBlend, true);
+	}
+	else
+	{
+		SortTranslucentItems();
+		glDepthMask(GL_FALSE);
+	}
+
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseInstancing, m_bUseInstancing);
+	}
+
+	// the instances are uploaded in render queue order, so the
+	// instance of a translucent object is its queue position
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	for (int item : m_translucentItems)
+	{
+		if (!m_instanceVisible[item])
+		{
+			continue;
+		}
+
+		object& sceneObject = m_sceneObjects[items[item].objectIndex];
+		int lod = m_instanceLODs[item];
+		if (!m_bUseInstancing)
+		{
+			sceneObject.render(lod);
+			m_renderStats.objectsDrawn++;
+			continue;
+		}
+
+		SetObjectTexture(sceneObject);
+		m_sceneMeshes->DrawMeshInstanced(sceneObject.getShape(), 1, (GLuint)item, lod);
+		m_renderStats.drawCalls++;
+		m_renderStats.objectsDrawn++;
+		m_renderStats.trianglesDrawn += (int)m_sceneMeshes->GetTriangleCount(sceneObject.getShape(), lod);
+	}
+
+	if (bWeightedBlend)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bWeightedBlend, false);
+		m_pWeightedBlend->Resolve();
+	}
+	else
+	{
+		glDepthMask(GL_TRUE);
+	}
+}
+
+/***********************************************************
+ *  SetObjectTexture()
+ *
+ *  This method is used for setting the texture and sampler
+ *  of a draw of the passed in object on its own, when the
+ *  draw has no batch to take them from.
+ ***********************************************************/
+void SceneManager::SetObjectTexture(const object& sceneObject)
+{
+	if (sceneObject.getTexture() != INVALID_HANDLE)
+	{
+		SetShaderTexture(sceneObject.getTexture());
+		if (GetTextureGroup(sceneObject.getTexture()) != INVALID_HANDLE)
+		{
+			SetShaderSampler(GetMaterialSampler(sceneObject.getMaterial()));
+		}
+		else
+		{
+			SetShaderSampler(INVALID_HANDLE);
+		}
+	}
+	else
+	{
+		SetShaderUseTexture(false);
+	}
+}
+
+/***********************************************************
+ *  SortTranslucentItems()
+ *
+ *  This method is used for sorting the translucent objects
+ *  by the view depth of their bounds' centers, the farthest
+ *  first, so each one blends over the ones behind it. Objects
+ *  at the same depth keep their scene order. Until a view is
+ *  set they are left in scene order.
+ ***********************************************************/
+void SceneManager::SortTranslucentItems()
+{
+	if (!m_bViewMatricesValid || (m_translucentItems.size() < 2))
+	{
+		return;
+	}
+
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	m_translucentDepths.clear();
+	for (int item : m_translucentItems)
+	{
+		const BOUNDING_VOLUME& bounds = m_sceneObjects[items[item].objectIndex].getWorldBounds();
+		float viewDepth = -(m_viewMatrix * glm::vec4(bounds.center, 1.0f)).z;
+		m_translucentDepths.push_back(std::make_pair(viewDepth, item));
+	}
+
+	std::stable_sort(m_translucentDepths.begin(), m_translucentDepths.end(),
+		[](const std::pair<float, int>& a, const std::pair<float, int>& b)
+		{
+			return(a.first > b.first);
+		});
+
+	for (int i = 0; i < (int)m_translucentDepths.size(); i++)
+	{
+		m_translucentItems[i] = m_translucentDepths[i].second;
+	}
+}
+
+/***********************************************************
+ *  PassesDrawFilter()
+ *
+ *  This method is used for checking if a draw of the passed
+ *  in translucency is drawn by a pass with the filter.
+ ***********************************************************/
+bool SceneManager::PassesDrawFilter(DRAW_FILTER filter, bool bTranslucent)
+{
+	switch (filter)
+	{
+	case DRAW_OPAQUE_OBJECTS:
+		return(!bTranslucent);
+	case DRAW_TRANSLUCENT_OBJECTS:
+		return(bTranslucent);
+	default:
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  RenderSceneObjects()
+ *
+ *  This method is used for drawing every object in the render
+ *  queue that passes the filter with its own draw call and
+ *  uniform values.
+ ***********************************************************/
+void SceneManager::RenderSceneObjects(DRAW_FILTER filter)
+{
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseInstancing, false);
+	}
+
+	const std::vector<RENDER_ITEM>& items = m_renderQueue.GetItems();
+	for (int i = 0; i < (int)items.size(); i++)
+	{
+		if (m_instanceVisible[i] &&
+			PassesDrawFilter(filter, m_sceneObjects[items[i].objectIndex].isTranslucent()))
+		{
+			m_sceneObjects[items[i].objectIndex].render(m_instanceLODs[i]);
+			m_renderStats.objectsDrawn++;
+		}
+	}
+}
+
+/***********************************************************
+ *  RenderInstanceBatches()
+ *
+ *  This method is used for drawing the render queue with one
+ *  instanced draw call per range of visible instances at the
+ *  same level of detail in each batch that passes the
+ *  filter. Only the texture is set per
+ *  batch, every other object value, the layer of a packed
+ *  texture included, comes from the instance buffer.
+ ***********************************************************/
+void SceneManager::RenderInstanceBatches(DRAW_FILTER filter)
+{
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseInstancing, true);
+	}
+
+	for (const INSTANCE_BATCH& batch : m_instanceBatches)
+	{
+		if (!PassesDrawFilter(filter, batch.bTranslucent))
+		{
+			continue;
+		}
+
+		if (batch.texture != INVALID_HANDLE)
+		{
+			SetShaderTexture(batch.texture);
+			SetShaderSampler(batch.sampler);
+		}
+		else
+		{
+			SetShaderUseTexture(false);
+		}
+
+		GLuint endInstance = batch.firstInstance + batch.instanceCount;
+		GLuint instance = batch.firstInstance;
+
+		while (instance < endInstance)
+		{
+			// skip to the start of the next visible range
+			if (!m_instanceVisible[instance])
+			{
+				instance++;
+				continue;
+			}
+
+			GLuint firstVisible = instance;
+			int lod = m_instanceLODs[instance];
+			while ((instance < endInstance) && m_instanceVisible[instance] &&
+				(m_instanceLODs[instance] == lod))
+			{
+				instance++;
+			}
+			GLsizei visibleCount = (GLsizei)(instance - firstVisible);
+
+			m_sceneMeshes->DrawMeshInstanced(batch.shape, visibleCount, firstVisible, lod);
+			m_renderStats.drawCalls++;
+			m_renderStats.objectsDrawn += visibleCount;
+			m_renderStats.trianglesDrawn +=
+				visibleCount * (int)m_sceneMeshes->GetTriangleCount(batch.shape, lod);
+		}
+	}
+}
+
+/***********************************************************
+ *  RenderIndirectRuns()
+ *
+ *  This method is used for drawing the render queue with one
+ *  multi-draw indirect call per texture run. The texture is
+ *  the only value set per run, the mesh and instance range of
+ *  every batch are read from the indirect command buffer. A
+ *  run covers a whole texture array page, so one call draws
+ *  objects with any of the textures packed into it. Only the
+ *  runs passing the filter are drawn.
+ ***********************************************************/
+void SceneManager::RenderIndirectRuns(DRAW_FILTER filter)
+{
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setBoolValue(m_pUniformCache->m_locations.bUseInstancing, true);
+	}
+
+	for (const INDIRECT_RUN& run : m_indirectRuns)
+	{
+		if (!PassesDrawFilter(filter, run.bTranslucent))
+		{
+			continue;
+		}
+
+		if (run.texture != INVALID_HANDLE)
+		{
+			SetShaderTexture(run.texture);
+			SetShaderSampler(run.sampler);
+		}
+		else
+		{
+			SetShaderUseTexture(false);
+		}
+
+		m_sceneMeshes->DrawMultiIndirect(run.firstCommand, run.commandCount);
+		m_renderStats.drawCalls++;
+		m_renderStats.indirectCommands += run.commandCount;
+		m_renderStats.objectsDrawn += run.instanceCount;
+		m_renderStats.trianglesDrawn += run.triangleCount;
+	}
 }
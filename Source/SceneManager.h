@@ -10,11 +10,31 @@
 #pragma once
 
 #include "ShaderManager.h"
-#include "ShapeMeshes.h"
+#include "UniformCache.h"
+#include "UniformBuffer.h"
+#include "RenderQueue.h"
+#include "GLResources.h"
+#include "SceneMeshes.h"
+#include "Frustum.h"
+#include "SceneBVH.h"
+#include "FrameProfiler.h"
+#include "SceneFile.h"
+#include "ResourceCache.h"
+#include "TextureLoader.h"
+#include "TextureCache.h"
+#include "TextureArrays.h"
+#include "TextureSamplers.h"
+#include "LightClusters.h"
+#include "WeightedBlendOIT.h"
+#include "ShadowMaps.h"
+#include "DynamicTransforms.h"
+#include "JobSystem.h"
 
 #include <string>
 #include <vector>
-#include <functional>
+
+// scene objects are stored by value in the scene graph
+class object;
 
 /***********************************************************
  *  SceneManager
@@ -26,14 +46,141 @@ class SceneManager
 {
 public:
 	// constructor
-	SceneManager(ShaderManager *pShaderManager);
+	SceneManager(ShaderManager *pShaderManager, UniformCache *pUniformCache);
 	// destructor
 	~SceneManager();
 
+	// compact handles that textures and materials are resolved
+	// to when the scene is built, so drawing needs no tag lookups
+	typedef int TextureHandle;
+	typedef int MaterialHandle;
+	typedef int SamplerHandle;
+	static const int INVALID_HANDLE = -1;
+
+	// texture units from this one up hold the texture array pages,
+	// textures that are not packed are bound to unit 0 when drawn
+	static const int TEXTURE_ARRAY_FIRST_UNIT = 1;
+	// the two units after the pages hold the weighted blending targets
+	static const int TRANSLUCENCY_FIRST_UNIT = TEXTURE_ARRAY_FIRST_UNIT + TextureArrays::MAX_PAGES;
+	// the unit after them holds the shadow maps
+	static const int SHADOW_MAP_UNIT = TRANSLUCENCY_FIRST_UNIT + 2;
+	// and the one after that the model matrices of the dynamic objects
+	static const int DYNAMIC_TRANSFORMS_UNIT = SHADOW_MAP_UNIT + 1;
+
+	// texture memory the streamed textures are kept within, by default
+	static const int DEFAULT_TEXTURE_BUDGET_MB = 256;
+
 	struct TEXTURE_INFO
 	{
 		std::string tag;
-		uint32_t ID;
+		// the image file, loaded again when a streamed out
+		// texture is needed again
+		std::string filename;
+		// the texture of its own, deleted along with the info
+		GLTexture ID;
+		// the array page and layer the texture was packed into,
+		// the page is -1 while it is still a texture of its own
+		TEXTURE_LAYER location;
+		// whether the image is still being loaded into the texture
+		bool bLoading;
+		// bytes the layer of a packed texture takes
+		GLsizeiptr packedSize;
+	};
+
+	// a part of the scene loaded and unloaded as a whole by the
+	// distance of the camera from its bounds
+	struct SCENE_CHUNK
+	{
+		std::string name;
+		// 0 keeps the chunk loaded all the time
+		float loadDistance;
+		// the objects of the chunk, copied into the scene graph
+		// while it is loaded
+		std::vector<object> objects;
+		BOUNDING_VOLUME bounds;
+		// the textures the objects are drawn with
+		std::vector<TextureHandle> textures;
+		bool bResident;
+		// where the copies of the objects start in the scene graph,
+		// or -1 while they are not in it
+		int firstSceneObject = -1;
+	};
+
+	// the shader values last written by the draw path, used for
+	// skipping uniform writes that would not change anything
+	struct RENDER_STATE
+	{
+		int useTexture;
+		int textureSlot;
+		int useTextureArray;
+		int textureArrayPage;
+		int textureLayer;
+		GLuint boundTexture;
+		int sampler;
+		int samplerUnit;
+		int materialIndex;
+		bool bObjectColorValid;
+		glm::vec4 objectColor;
+		bool bUVScaleValid;
+		glm::vec2 UVscale;
+	};
+
+	// a run of consecutive render queue objects that share a mesh
+	// and texture group, drawn with a single instanced draw call,
+	// the texture set for the batch is the one of its first object
+	struct INSTANCE_BATCH
+	{
+		MESH_SHAPE shape;
+		TextureHandle texture;
+		int textureGroup;
+		SamplerHandle sampler;
+		bool bTranslucent;
+		GLuint firstInstance;
+		GLsizei instanceCount;
+	};
+
+	// a run of consecutive instance batches that share a texture
+	// group and sampler, submitted with a single multi-draw
+	// indirect call
+	struct INDIRECT_RUN
+	{
+		TextureHandle texture;
+		int textureGroup;
+		SamplerHandle sampler;
+		GLuint firstCommand;
+		GLsizei commandCount;
+		GLsizei instanceCount;
+		// triangles drawn by every command of the run
+		int triangleCount;
+		bool bTranslucent;
+	};
+
+	// the indirect commands and texture runs built from one range of
+	// the instances on a worker thread, replayed in range order into
+	// the commands uploaded by the GL thread
+	struct COMMAND_LIST
+	{
+		std::vector<DRAW_ELEMENTS_COMMAND> commands;
+		std::vector<INDIRECT_RUN> runs;
+	};
+
+	// the counters and flags each thread keeps while the scene passes
+	// run in parallel, added up once the pass is done
+	struct THREAD_RESULTS
+	{
+		int objectsVisible;
+		bool bLODsChanged;
+		bool bFadesChanged;
+		// render queue positions found visible by the thread
+		std::vector<int> visibleItems;
+	};
+
+	// which of the scene objects a render pass draws
+	enum DRAW_FILTER
+	{
+		DRAW_ALL_OBJECTS,
+		DRAW_OPAQUE_OBJECTS,
+		DRAW_TRANSLUCENT_OBJECTS
 	};
 
 	struct OBJECT_MATERIAL
@@ -44,30 +191,205 @@ public:
 		glm::vec3 specularColor;
 		float shininess;
 		std::string tag;
+		// how the object textures are filtered when minified
+		TEXTURE_FILTER textureFilter = FILTER_ANISOTROPIC;
+		float maxAnisotropy = 8.0f;
 	};
 
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
+	// pointer to the cached shader uniform locations
+	UniformCache* m_pUniformCache;
+	// pointer to the profiler the render phases are timed with, if any
+	FrameProfiler* m_pFrameProfiler;
+	// number of copies of the scene objects laid out in a grid
+	int m_sceneScale;
+	// text file the scene is loaded from, and its stamp when it
+	// was last loaded so that saving it reloads the scene
+	std::string m_sceneFilename;
+	SCENE_FILE_STAMP m_sceneFileStamp;
+	// pointer to the shared shape buffers every object is drawn from
+	SceneMeshes* m_sceneMeshes;
+	// whether the opaque objects are drawn into the depth buffer
+	// first, so the lighting only runs for the visible fragments
+	bool m_bUseDepthPrePass;
+	// render queue positions of the translucent objects, sorted back
+	// to front every frame unless they are blended in any order
+	std::vector<int> m_translucentItems;
+	std::vector<std::pair<float, int>> m_translucentDepths;
+	WeightedBlendOIT* m_pWeightedBlend;
+	bool m_bUseWeightedBlend;
+	// whether every shaded fragment adds to the color instead, which
+	// shows how many times each pixel was shaded
+	bool m_bShowOverdraw;
+	// whether the scene is drawn with instanced draw calls
+	bool m_bUseInstancing;
+	// per-instance values and batches built from the render queue
+	std::vector<INSTANCE_DATA> m_instanceData;
+	std::vector<INSTANCE_BATCH> m_instanceBatches;
+	// whether the batches are submitted with multi-draw indirect calls
+	bool m_bUseMultiDrawIndirect;
+	// indirect commands and texture runs built from the batches
+	std::vector<DRAW_ELEMENTS_COMMAND> m_drawCommands;
+	std::vector<INDIRECT_RUN> m_indirectRuns;
+	bool m_bDrawCommandsDirty;
+	// whether the curved shapes are drawn with fewer triangles the
+	// smaller they are on screen, and whether the switch between
+	// two levels is dithered instead of popping
+	bool m_bUseMeshLOD;
+	bool m_bUseLODDither;
+	// level of detail and fade to the next level of every instance,
+	// in render queue order
+	std::vector<int> m_instanceLODs;
+	std::vector<float> m_instanceFades;
+	bool m_bInstanceFadesDirty;
+	// render queue positions of the opaque instances that are fading,
+	// drawn a second time at their next level
+	std::vector<int> m_lodTransitions;
+	// cascaded shadow maps of the scene light that casts shadows, or
+	// -1 for none, the static objects are drawn into their cache
+	// only when it is dropped and the dynamic ones every frame
+	ShadowMaps* m_pShadowMaps;
+	bool m_bUseShadows;
+	int m_shadowLightIndex;
+	// whether each instance is of a dynamic object, in render queue order
+	std::vector<bool> m_instanceDynamic;
+	// model matrices of the dynamic objects, written every frame into
+	// a persistently mapped ring when OpenGL 4.4 is available, and
+	// the render queue position of the instance in each slot of it
+	DynamicTransforms* m_pDynamicTransforms;
+	bool m_bUseDynamicTransforms;
+	std::vector<int> m_dynamicInstances;
+	// indirect commands drawing every opaque static instance followed
+	// by every opaque dynamic one, placed after the commands of the
+	// view in the indirect command buffer
+	std::vector<DRAW_ELEMENTS_COMMAND> m_shadowCommands;
+	GLsizei m_staticShadowCommandCount;
+	GLuint m_shadowFirstCommand;
+	// view frustum the scene objects are culled against
+	Frustum m_frustum;
+	bool m_bFrustumValid;
+	bool m_bUseFrustumCulling;
+	// visibility of every instance, in render queue order, kept a
+	// byte each so that threads can set neighbouring instances
+	std::vector<char> m_instanceVisible;
+	// hierarchy over the render queue used for culling and picking
+	SceneBVH m_sceneBVH;
+	bool m_bUseSceneBVH;
+	// render queue position of every scene object
+	std::vector<int> m_queuePositions;
+	// scratch lists reused by the culling every frame, the branches
+	// of the hierarchy handed to the threads and the visibility found
+	std::vector<int> m_cullBranches;
+	std::vector<char> m_cullResults;
+	// the transform updates, culling, level of detail selection,
+	// sorting and indirect command building are split across the
+	// threads of the job system, each keeping its own results
+	JobSystem* m_pJobSystem;
+	std::vector<THREAD_RESULTS> m_threadResults;
+	std::vector<COMMAND_LIST> m_commandLists;
+	// scene objects turned by the last animation step
+	std::vector<char> m_objectsMoved;
+	// whether moved objects need their instances uploaded again
+	bool m_bInstancesDirty;
+	// decodes the texture images in the background
+	TextureLoader* m_pTextureLoader;
 	// total number of loaded textures
 	int m_loadedTextures;
 	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
+	std::vector<TEXTURE_INFO> m_textureIDs;
+	// array pages the loaded textures are packed into
+	TextureArrays* m_pTextureArrays;
+	bool m_bUseTextureArrays;
+	// textures the loader finished uploading this frame
+	std::vector<GLuint> m_uploadedTextures;
+	// the textures in memory, freed least recently used first
+	// when they take more than the texture budget
+	ResourceCache* m_pResidentTextures;
+	// the chunks the scene objects are streamed in with, and the
+	// camera position they were last loaded for
+	std::vector<SCENE_CHUNK> m_sceneChunks;
+	glm::vec3 m_streamingPosition;
+	bool m_bStreamingPositionSet;
+	// sampler objects shared by the materials that filter alike,
+	// the default one is used by objects without a material
+	TextureSamplers* m_pTextureSamplers;
+	std::vector<SamplerHandle> m_materialSamplers;
+	SamplerHandle m_defaultSampler;
 	// defined object materials
 	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// retained scene graph, built once and drawn every frame
+	std::vector<object> m_sceneObjects;
+	// scene objects sorted by render state for submission
+	RenderQueue m_renderQueue;
+	bool m_bRenderQueueDirty;
+	// tracked shader state and the counters of the last frame
+	RENDER_STATE m_renderState;
+	RENDER_STATS m_renderStats;
+	// scene light sources, the first of which are also uploaded to
+	// the light uniform buffer for shading without clusters
+	std::vector<LIGHT_SOURCE_BLOCK> m_sceneLights;
+	LIGHT_BLOCK m_lightBlock;
+	UniformBuffer* m_pLightBuffer;
+	bool m_bLightsDirty;
+	// the lights are binned into view space clusters every frame
+	// when OpenGL 4.3 is available
+	LightClusters* m_pLightClusters;
+	bool m_bUseLightClusters;
+	// view and projection of the frame, the lights are clustered in
+	// it and the translucent objects sorted by their depth in it
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	bool m_bViewMatricesValid;
+	// object materials uploaded to the material uniform buffer
+	UniformBuffer* m_pMaterialBuffer;
 
 	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
+	bool CreateGLTexture(const char* filename, const std::string& tag);
+	// reserve a texture slot and load its image in the background
+	bool QueueGLTexture(const char* filename, const std::string& tag);
+	// add a created OpenGL texture to the loaded textures, which
+	// take ownership of it, an empty texture is loaded when needed
+	int RegisterGLTexture(GLTexture texture, const std::string& tag, const std::string& filename);
+	// load the image of a streamed texture if it is not in memory,
+	// and mark it used this frame
+	void StreamInGLTexture(TextureHandle textureHandle);
+	// free the texture of a slot, keeping the slot for reloading
+	void EvictGLTexture(TextureHandle textureHandle);
+	// get the bytes of GPU memory a loaded texture takes
+	GLsizeiptr GetTextureMemorySize(TextureHandle textureHandle) const;
+	// move a loaded texture into its texture array page
+	bool PackGLTexture(int textureSlot);
+	// pack the textures the loader uploaded this frame
+	void PackUploadedTextures();
 	// bind loaded OpenGL textures to slots in memory
 	void BindGLTextures();
 	// free the loaded OpenGL textures
 	void DestroyGLTextures();
 	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
+	int FindTextureID(const std::string& tag);
+	int FindTextureSlot(const std::string& tag);
+	// resolve a texture tag to a handle
+	TextureHandle FindTextureHandle(const std::string& tag);
+	// get the group a texture is drawn in, textures packed into
+	// the same array page share a group, or -1 for no texture
+	int GetTextureGroup(TextureHandle textureHandle) const;
+	// get the array layer of a packed texture, 0 for any other
+	int GetTextureLayer(TextureHandle textureHandle) const;
 	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+	bool FindMaterial(const std::string& tag, OBJECT_MATERIAL& material);
+	// resolve a material tag to a handle
+	MaterialHandle FindMaterialHandle(const std::string& tag);
+	// get the sampler the textures of a material are filtered with
+	SamplerHandle GetMaterialSampler(MaterialHandle materialHandle) const;
+
+	// build a model matrix from the transformation values
+	static glm::mat4 BuildModelMatrix(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
 
 	// set the transformation values 
 	// into the transform buffer
@@ -78,6 +400,11 @@ public:
 		float ZrotationDegrees,
 		glm::vec3 positionXYZ);
 
+	// set an already built model matrix
+	// into the transform buffer
+	void SetTransformations(
+		const glm::mat4& modelMatrix);
+
 	// set the color values into the shader
 	void SetShaderColor(
 		float redColorValue,
@@ -85,23 +412,189 @@ public:
 		float blueColorValue,
 		float alphaValue);
 
+	// set only the object color into the shader, without
+	// changing whether a texture is used
+	void SetShaderObjectColor(
+		const glm::vec4& objectColor);
+
+	// set whether the shader samples the object texture
+	void SetShaderUseTexture(
+		bool bUseTexture);
+
 	// set the texture data into the shader
 	void SetShaderTexture(
-		std::string textureTag);
+		const std::string& textureTag);
+	void SetShaderTexture(
+		TextureHandle textureHandle);
+
+	// bind the sampler to the unit of the texture last set
+	void SetShaderSampler(
+		SamplerHandle samplerHandle);
 
 	// set the UV scale for the texture mapping
 	void SetTextureUVScale(
 		float u, float v);
 
-	void LoadSceneTextures();
+	// queue the textures of the scene file that are not loaded yet
+	void LoadSceneTextures(const SceneFile& sceneFile);
 
 	// set the object material into the shader
 	void SetShaderMaterial(
-		std::string materialTag);
+		const std::string& materialTag);
+	void SetShaderMaterial(
+		MaterialHandle materialHandle);
+
+	// define the object materials of the scene file
+	void DefineObjectMaterials(const SceneFile& sceneFile);
+
+	// upload the defined object materials into the material buffer
+	void UploadObjectMaterials();
+	// create the sampler objects the defined materials filter with
+	void CreateMaterialSamplers();
+
+	// set the light sources of the scene file
+	void SetupSceneLights(const SceneFile& sceneFile);
 
-	void DefineObjectMaterials();
+	// set the values of a single scene light source
+	void SetLightSource(
+		int index,
+		glm::vec3 position,
+		glm::vec3 ambientColor,
+		glm::vec3 diffuseColor,
+		glm::vec3 specularColor,
+		float focalStrength,
+		float specularIntensity,
+		float range = 0.0f);
+	// upload the light sources if they changed since the last upload
+	void UploadSceneLights();
+	// bin the light sources into the clusters of the view
+	void UpdateLightClusters();
+	// draw the shadow casters into the shadow maps of the view
+	void UpdateShadowMaps();
+	// draw the opaque static or dynamic objects into a shadow map
+	void RenderShadowCasters(bool bDynamic);
+	// write the model matrices of the dynamic objects into the ring
+	void UpdateDynamicTransforms();
 
-	void SetupSceneLights();
+	// build the retained list of objects that make up the scene
+	void DefineSceneObjects(const SceneFile& sceneFile);
+	// add a copy of the passed in object to the scene graph
+	void AddSceneObject(const object& sceneObject);
+	// work out the bounds and textures of a chunk from its objects
+	void FinishSceneChunk(SCENE_CHUNK& chunk);
+	// fill the scene graph with the objects of the loaded chunks
+	void RebuildResidentObjects();
+	// load and unload the chunks by their distance from the camera
+	// and keep the textures within the budget, true if the loaded
+	// chunks changed
+	bool UpdateStreaming(const glm::vec3& viewPosition);
+	// set the bytes of texture memory kept loaded, 0 for no limit
+	void SetTextureBudget(size_t budget);
+	// set the number of copies of the scene built by PrepareScene()
+	void SetSceneScale(int sceneScale);
+	// turn the depth pre-pass of the opaque objects on or off
+	void SetDepthPrePass(bool bEnabled);
+	// turn the overdraw view on or off
+	void SetShowOverdraw(bool bShow);
+	// blend the translucent objects in any order instead of sorting them
+	void SetWeightedTransparency(bool bEnabled);
+	// turn the shadows of the light that casts them on or off
+	void SetShadows(bool bEnabled);
+	// turn the levels of detail of the curved shapes, and the
+	// dithered switch between them, on or off
+	void SetMeshLOD(bool bEnabled, bool bDither);
+	// write the dynamic objects' model matrices into a ring every
+	// frame instead of uploading them with the other instances
+	void SetDynamicTransforms(bool bEnabled);
+	// turn the spinning scene objects by the passed in seconds
+	void AnimateSceneObjects(float seconds);
+	// draw the spinning scene objects at the passed in fraction of
+	// the way through their last turn
+	void InterpolateSceneObjects(float interpolation);
+	// set the number of threads the scene passes are split across,
+	// 0 for one per hardware thread
+	void SetJobThreads(int threadCount);
+	// set the scene file loaded by PrepareScene()
+	void SetSceneFile(const std::string& filename);
+	// load the materials, lights, textures and objects of the scene
+	// file, keeping the current scene if it cannot be loaded
+	bool LoadSceneFile();
+	// load the scene file again if it was saved since it was loaded
+	bool ReloadSceneIfChanged();
+	// add copies of the defined scene objects, side by side
+	void ReplicateSceneObjects(int copies);
+	// get the number of objects in the scene graph
+	int GetSceneObjectCount() const;
+	// get the bounding volume around every scene object
+	BOUNDING_VOLUME GetSceneBounds();
+	// wait for every queued texture to be loaded and packed
+	void FinishTextureLoading();
+	// draw the passed in level of detail of a basic mesh shape
+	void DrawMesh(MESH_SHAPE shape, int lod = 0);
+	// sort the scene objects into the render queue
+	void BuildRenderQueue();
+	// group the render queue into instanced draw batches
+	void BuildInstanceBatches();
+	// build the indirect commands and texture runs from the batches
+	void BuildIndirectCommands();
+	// build the commands and runs of the visible instances in a range
+	void BuildCommandList(GLuint firstInstance, GLuint endInstance, COMMAND_LIST& commandList) const;
+	// add a command to a list, joining it to the last one when it
+	// draws the next instances of the same mesh in the same run
+	static void AppendIndirectCommand(
+		const INDIRECT_RUN& run,
+		const DRAW_ELEMENTS_COMMAND& command,
+		std::vector<DRAW_ELEMENTS_COMMAND>& commands,
+		std::vector<INDIRECT_RUN>& runs);
+	// clear the results kept by each thread of the job system
+	void ResetThreadResults();
+	// build the indirect commands the shadow casters are drawn with
+	void BuildShadowCommands();
+	// set the view projection the scene objects are culled against
+	void SetViewFrustum(const glm::mat4& viewProjection);
+	// set the view and projection the lights are clustered in and
+	// the translucent objects are sorted by
+	void SetViewMatrices(const glm::mat4& view, const glm::mat4& projection);
+	// time the render phases with the passed in profiler, or NULL
+	void SetFrameProfiler(FrameProfiler* pFrameProfiler);
+	// test every scene object against the view frustum
+	void CullSceneObjects();
+	// pick the level of detail of every visible instance by its size
+	// on screen
+	void SelectMeshLODs();
+	// build the bounding volume hierarchy over the render queue
+	void BuildSceneBVH();
+	// pick up the changed transform of a single scene object
+	void UpdateSceneObject(int objectIndex);
+	// pick up the transforms of the objects flagged as moved
+	void UpdateMovedObjects();
+	// find the scene object nearest along a ray, or -1
+	int PickSceneObject(const glm::vec3& origin, const glm::vec3& direction);
+	// print the shape and position of a picked scene object
+	void ReportPickedObject(int objectIndex) const;
+	// draw the scene objects passing the filter with the draw path in use
+	void DrawSceneObjects(DRAW_FILTER filter);
+	// draw the scene objects one draw call at a time
+	void RenderSceneObjects(DRAW_FILTER filter);
+	// draw the scene objects with the instanced draw batches
+	void RenderInstanceBatches(DRAW_FILTER filter);
+	// draw the scene objects with one multi-draw call per texture group
+	void RenderIndirectRuns(DRAW_FILTER filter);
+	// draw the fading instances again at their next level of detail
+	void RenderLODTransitions();
+	// draw the translucent objects after the opaque ones, sorted or
+	// with weighted blending
+	void RenderTranslucentObjects();
+	// set the texture and sampler of a single object's draw
+	void SetObjectTexture(const object& sceneObject);
+	// sort the translucent objects from the farthest to the nearest
+	void SortTranslucentItems();
+	// check if a draw of the passed in translucency passes the filter
+	static bool PassesDrawFilter(DRAW_FILTER filter, bool bTranslucent);
+	// forget the tracked shader state and clear the counters
+	void ResetRenderState();
+	// get the draw counters of the last rendered frame
+	const RENDER_STATS& GetRenderStats() const;
 
 	// The following methods are for the students to 
 	// customize for their own 3D scene
@@ -0,0 +1,907 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenemeshes.cpp
+// ============
+// shared geometry buffers for the basic mesh shapes with instanced drawing
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 14th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneMeshes.h"
+
+#include <cmath>
+#include <cstddef>
+
+// declaration of the tessellation used for the curved shapes
+namespace
+{
+	const float PI = 3.14159265358979f;
+
+	// each level of detail has about half the slices of the last,
+	// the last still keeps the silhouette round at a few pixels
+	const int CYLINDER_SLICES[SceneMeshes::MESH_LOD_COUNT] = { 36, 18, 12, 8 };
+	const int SPHERE_SLICES[SceneMeshes::MESH_LOD_COUNT] = { 36, 18, 12, 8 };
+	const int SPHERE_STACKS[SceneMeshes::MESH_LOD_COUNT] = { 18, 9, 6, 4 };
+	const int TORUS_MAIN_SLICES[SceneMeshes::MESH_LOD_COUNT] = { 36, 18, 12, 8 };
+	const int TORUS_TUBE_SLICES[SceneMeshes::MESH_LOD_COUNT] = { 18, 9, 6, 4 };
+
+	// the projected diameter in pixels below which each level of
+	// detail gives way to the next
+	const float LOD_SCREEN_SIZES[SceneMeshes::MESH_LOD_COUNT - 1] = { 160.0f, 64.0f, 24.0f };
+	// the part of each size, above it, over which the next level
+	// is faded in
+	const float LOD_FADE_BAND = 0.25f;
+
+	const float TORUS_MAIN_RADIUS = 1.0f;
+	const float TORUS_TUBE_RADIUS = 0.2f;
+	const float TAPERED_TOP_RADIUS = 0.5f;
+}
+
+/***********************************************************
+ *  SceneMeshes()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneMeshes::SceneMeshes()
+{
+	m_instanceCapacity = 0;
+	m_fadeCapacity = 0;
+	m_commandCapacity = 0;
+	m_bBaseInstanceSupported = false;
+	m_bMultiDrawIndirectSupported = false;
+
+	for (int i = 0; i < MESH_SHAPE_COUNT; i++)
+	{
+		for (int lod = 0; lod < MESH_LOD_COUNT; lod++)
+		{
+			m_meshRanges[i][lod].firstIndex = 0;
+			m_meshRanges[i][lod].indexCount = 0;
+			m_meshRanges[i][lod].baseVertex = 0;
+		}
+		m_lodCounts[i] = 1;
+		m_meshBounds[i] = Frustum::MakeBounds(glm::vec3(0.0f), glm::vec3(0.0f));
+	}
+}
+
+/***********************************************************
+ *  ~SceneMeshes()
+ *
+ *  The destructor for the class, the buffer handles delete
+ *  the shared buffers and vertex array
+ ***********************************************************/
+SceneMeshes::~SceneMeshes()
+{
+}
+
+/***********************************************************
+ *  LoadMeshes()
+ *
+ *  This method is used for building all of the basic shapes
+ *  into the shared vertex and index buffers and attaching
+ *  the per-instance buffer to the vertex array. Every level
+ *  of detail of the curved shapes is built into the same
+ *  buffers, so switching levels only changes the range that
+ *  is drawn. The box and plane are flat, so their one level
+ *  is shared by all of the levels.
+ ***********************************************************/
+void SceneMeshes::LoadMeshes()
+{
+	m_vertices.clear();
+	m_indices.clear();
+
+	BeginMesh(MESH_BOX, 0);
+	AppendBox();
+	EndMesh(MESH_BOX, 0);
+
+	BeginMesh(MESH_PLANE, 0);
+	AppendPlane();
+	EndMesh(MESH_PLANE, 0);
+
+	for (int lod = 0; lod < MESH_LOD_COUNT; lod++)
+	{
+		BeginMesh(MESH_CYLINDER, lod);
+		AppendCylinder(1.0f, 1.0f, CYLINDER_SLICES[lod]);
+		AppendDisc(0.0f, 1.0f, CYLINDER_SLICES[lod], false);
+		AppendDisc(1.0f, 1.0f, CYLINDER_SLICES[lod], true);
+		EndMesh(MESH_CYLINDER, lod);
+
+		BeginMesh(MESH_TAPERED_CYLINDER, lod);
+		AppendCylinder(1.0f, TAPERED_TOP_RADIUS, CYLINDER_SLICES[lod]);
+		AppendDisc(0.0f, 1.0f, CYLINDER_SLICES[lod], false);
+		AppendDisc(1.0f, TAPERED_TOP_RADIUS, CYLINDER_SLICES[lod], true);
+		EndMesh(MESH_TAPERED_CYLINDER, lod);
+
+		BeginMesh(MESH_CONE, lod);
+		AppendCylinder(1.0f, 0.0f, CYLINDER_SLICES[lod]);
+		AppendDisc(0.0f, 1.0f, CYLINDER_SLICES[lod], false);
+		EndMesh(MESH_CONE, lod);
+
+		BeginMesh(MESH_SPHERE, lod);
+		AppendSphere(false, SPHERE_SLICES[lod], SPHERE_STACKS[lod]);
+		EndMesh(MESH_SPHERE, lod);
+
+		BeginMesh(MESH_HALF_SPHERE, lod);
+		AppendSphere(true, SPHERE_SLICES[lod], SPHERE_STACKS[lod] / 2);
+		AppendDisc(0.0f, 1.0f, SPHERE_SLICES[lod], false);
+		EndMesh(MESH_HALF_SPHERE, lod);
+
+		BeginMesh(MESH_TORUS, lod);
+		AppendTorus(false, TORUS_MAIN_RADIUS, TORUS_TUBE_RADIUS, TORUS_MAIN_SLICES[lod], TORUS_TUBE_SLICES[lod]);
+		EndMesh(MESH_TORUS, lod);
+
+		BeginMesh(MESH_HALF_TORUS, lod);
+		AppendTorus(true, TORUS_MAIN_RADIUS, TORUS_TUBE_RADIUS, TORUS_MAIN_SLICES[lod] / 2, TORUS_TUBE_SLICES[lod]);
+		EndMesh(MESH_HALF_TORUS, lod);
+	}
+
+	for (int i = 0; i < MESH_SHAPE_COUNT; i++)
+	{
+		m_lodCounts[i] = ((i == MESH_BOX) || (i == MESH_PLANE)) ? 1 : MESH_LOD_COUNT;
+		for (int lod = m_lodCounts[i]; lod < MESH_LOD_COUNT; lod++)
+		{
+			m_meshRanges[i][lod] = m_meshRanges[i][0];
+		}
+	}
+
+	// base instance draws offset the instance attributes on the
+	// GPU, without them the attribute pointers are moved instead
+	m_bBaseInstanceSupported = (GLEW_VERSION_4_2 == GL_TRUE);
+	// the indirect commands carry their own base instance, so the
+	// instance attributes never have to be moved between commands
+	m_bMultiDrawIndirectSupported = (GLEW_VERSION_4_3 == GL_TRUE);
+
+	// loading the meshes again replaces the buffers of the last load
+	m_vao.Create();
+	m_vertexBuffer.Create();
+	m_indexBuffer.Create();
+	m_instanceBuffer.Create();
+	m_instanceCapacity = 0;
+	m_fadeBuffer.Create();
+	m_fadeCapacity = 0;
+	m_indirectBuffer.Reset();
+	m_commandCapacity = 0;
+	if (m_bMultiDrawIndirectSupported)
+	{
+		m_indirectBuffer.Create();
+	}
+
+	glBindVertexArray(m_vao.Get());
+
+	// upload the shared vertex data
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer.Get());
+	glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(MESH_VERTEX), m_vertices.data(), GL_STATIC_DRAW);
+	m_vertexBuffer.SetMemorySize(m_vertices.size() * sizeof(MESH_VERTEX));
+
+	glEnableVertexAttribArray(POSITION_ATTRIBUTE);
+	glVertexAttribPointer(POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(MESH_VERTEX),
+		(void*)offsetof(MESH_VERTEX, position));
+	glEnableVertexAttribArray(NORMAL_ATTRIBUTE);
+	glVertexAttribPointer(NORMAL_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(MESH_VERTEX),
+		(void*)offsetof(MESH_VERTEX, normal));
+	glEnableVertexAttribArray(TEXTURE_COORDINATE_ATTRIBUTE);
+	glVertexAttribPointer(TEXTURE_COORDINATE_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, sizeof(MESH_VERTEX),
+		(void*)offsetof(MESH_VERTEX, textureCoordinate));
+
+	// upload the shared index data
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer.Get());
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(GLuint), m_indices.data(), GL_STATIC_DRAW);
+	m_indexBuffer.SetMemorySize(m_indices.size() * sizeof(GLuint));
+
+	// the per-instance attributes advance once per instance
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer.Get());
+	for (int column = 0; column < 4; column++)
+	{
+		glEnableVertexAttribArray(INSTANCE_MODEL_ATTRIBUTE + column);
+		glVertexAttribDivisor(INSTANCE_MODEL_ATTRIBUTE + column, 1);
+	}
+	glEnableVertexAttribArray(INSTANCE_COLOR_ATTRIBUTE);
+	glVertexAttribDivisor(INSTANCE_COLOR_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(INSTANCE_UV_SCALE_ATTRIBUTE);
+	glVertexAttribDivisor(INSTANCE_UV_SCALE_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(INSTANCE_MATERIAL_ATTRIBUTE);
+	glVertexAttribDivisor(INSTANCE_MATERIAL_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(INSTANCE_TEXTURE_LAYER_ATTRIBUTE);
+	glVertexAttribDivisor(INSTANCE_TEXTURE_LAYER_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(INSTANCE_DYNAMIC_SLOT_ATTRIBUTE);
+	glVertexAttribDivisor(INSTANCE_DYNAMIC_SLOT_ATTRIBUTE, 1);
+	// the fade is only read once fades are uploaded, until then the
+	// attribute stays off and every instance reads a fade of 0
+	glVertexAttribDivisor(INSTANCE_LOD_FADE_ATTRIBUTE, 1);
+	glVertexAttrib1f(INSTANCE_LOD_FADE_ATTRIBUTE, 0.0f);
+	SetInstanceAttributes(0);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// the geometry now lives on the GPU
+	m_vertices.clear();
+	m_vertices.shrink_to_fit();
+	m_indices.clear();
+	m_indices.shrink_to_fit();
+}
+
+/***********************************************************
+ *  UploadInstances()
+ *
+ *  This method is used for uploading the per-instance values
+ *  that the instanced draws read. The buffer only grows, so
+ *  uploading the same number of instances again reuses it.
+ ***********************************************************/
+void SceneMeshes::UploadInstances(const std::vector<INSTANCE_DATA>& instances)
+{
+	if ((m_instanceBuffer.Get() == 0) || instances.empty())
+	{
+		return;
+	}
+
+	GLsizei count = (GLsizei)instances.size();
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer.Get());
+	if (count > m_instanceCapacity)
+	{
+		glBufferData(GL_ARRAY_BUFFER, count * sizeof(INSTANCE_DATA), instances.data(), GL_DYNAMIC_DRAW);
+		m_instanceBuffer.SetMemorySize(count * sizeof(INSTANCE_DATA));
+		m_instanceCapacity = count;
+	}
+	else
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(INSTANCE_DATA), instances.data());
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  UploadInstanceFades()
+ *
+ *  This method is used for uploading how far each instance
+ *  has faded to its next level of detail, one value for each
+ *  instance of the instance buffer. The fade attribute is
+ *  only turned on while there are fades, so an empty list
+ *  goes back to every instance being fully drawn.
+ ***********************************************************/
+void SceneMeshes::UploadInstanceFades(const std::vector<float>& fades)
+{
+	if ((m_vao.Get() == 0) || (m_fadeBuffer.Get() == 0))
+	{
+		return;
+	}
+
+	glBindVertexArray(m_vao.Get());
+	if (fades.empty())
+	{
+		glDisableVertexAttribArray(INSTANCE_LOD_FADE_ATTRIBUTE);
+		glBindVertexArray(0);
+		return;
+	}
+
+	GLsizei count = (GLsizei)fades.size();
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_fadeBuffer.Get());
+	if (count > m_fadeCapacity)
+	{
+		glBufferData(GL_ARRAY_BUFFER, count * sizeof(float), fades.data(), GL_DYNAMIC_DRAW);
+		m_fadeBuffer.SetMemorySize(count * sizeof(float));
+		m_fadeCapacity = count;
+	}
+	else
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(float), fades.data());
+	}
+	glEnableVertexAttribArray(INSTANCE_LOD_FADE_ATTRIBUTE);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  DrawMeshInstanced()
+ *
+ *  This method is used for drawing the passed in shape once
+ *  for every instance from baseInstance to baseInstance+count
+ *  in the instance buffer, with a single draw call.
+ ***********************************************************/
+void SceneMeshes::DrawMeshInstanced(MESH_SHAPE shape, GLsizei count, GLuint baseInstance, int lod)
+{
+	if ((m_vao.Get() == 0) || (count <= 0))
+	{
+		return;
+	}
+
+	const MESH_RANGE& range = m_meshRanges[shape][glm::clamp(lod, 0, MESH_LOD_COUNT - 1)];
+
+	glBindVertexArray(m_vao.Get());
+	if (m_bBaseInstanceSupported)
+	{
+		glDrawElementsInstancedBaseVertexBaseInstance(
+			GL_TRIANGLES,
+			range.indexCount,
+			GL_UNSIGNED_INT,
+			(void*)(range.firstIndex * sizeof(GLuint)),
+			count,
+			range.baseVertex,
+			baseInstance);
+	}
+	else
+	{
+		SetInstanceAttributes(baseInstance);
+		glDrawElementsInstancedBaseVertex(
+			GL_TRIANGLES,
+			range.indexCount,
+			GL_UNSIGNED_INT,
+			(void*)(range.firstIndex * sizeof(GLuint)),
+			count,
+			range.baseVertex);
+	}
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  MakeDrawCommand()
+ *
+ *  This method is used for filling in the indirect command
+ *  that draws the passed in level of detail of the passed in
+ *  shape once for every instance from baseInstance to
+ *  baseInstance+count.
+ ***********************************************************/
+void SceneMeshes::MakeDrawCommand(
+	MESH_SHAPE shape,
+	GLsizei count,
+	GLuint baseInstance,
+	int lod,
+	DRAW_ELEMENTS_COMMAND& command) const
+{
+	const MESH_RANGE& range = m_meshRanges[shape][glm::clamp(lod, 0, MESH_LOD_COUNT - 1)];
+
+	command.count = range.indexCount;
+	command.instanceCount = (GLuint)count;
+	command.firstIndex = range.firstIndex;
+	command.baseVertex = range.baseVertex;
+	command.baseInstance = baseInstance;
+}
+
+/***********************************************************
+ *  UploadDrawCommands()
+ *
+ *  This method is used for uploading the commands that the
+ *  multi-draw indirect calls read. Like the instance buffer,
+ *  the command buffer only grows.
+ ***********************************************************/
+void SceneMeshes::UploadDrawCommands(const std::vector<DRAW_ELEMENTS_COMMAND>& commands)
+{
+	if ((m_indirectBuffer.Get() == 0) || commands.empty())
+	{
+		return;
+	}
+
+	GLsizei count = (GLsizei)commands.size();
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer.Get());
+	if (count > m_commandCapacity)
+	{
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, count * sizeof(DRAW_ELEMENTS_COMMAND), commands.data(), GL_STATIC_DRAW);
+		m_indirectBuffer.SetMemorySize(count * sizeof(DRAW_ELEMENTS_COMMAND));
+		m_commandCapacity = count;
+	}
+	else
+	{
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, count * sizeof(DRAW_ELEMENTS_COMMAND), commands.data());
+	}
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+/***********************************************************
+ *  DrawMultiIndirect()
+ *
+ *  This method is used for submitting commandCount of the
+ *  uploaded commands, starting at firstCommand, with a single
+ *  multi-draw indirect call.
+ ***********************************************************/
+void SceneMeshes::DrawMultiIndirect(GLuint firstCommand, GLsizei commandCount)
+{
+	if ((m_vao.Get() == 0) || (m_indirectBuffer.Get() == 0) || (commandCount <= 0))
+	{
+		return;
+	}
+
+	glBindVertexArray(m_vao.Get());
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer.Get());
+	glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		(void*)(firstCommand * sizeof(DRAW_ELEMENTS_COMMAND)),
+		commandCount,
+		0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  IsMultiDrawIndirectSupported()
+ *
+ *  This method is used for checking if the multi-draw
+ *  indirect calls can be used, which needs OpenGL 4.3.
+ ***********************************************************/
+bool SceneMeshes::IsMultiDrawIndirectSupported() const
+{
+	return(m_bMultiDrawIndirectSupported);
+}
+
+/***********************************************************
+ *  Draw*MeshInstanced()
+ *
+ *  These methods are used for drawing a single shape once
+ *  for every instance in the passed in instance range.
+ ***********************************************************/
+void SceneMeshes::DrawBoxMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_BOX, count, baseInstance);
+}
+
+void SceneMeshes::DrawConeMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_CONE, count, baseInstance);
+}
+
+void SceneMeshes::DrawCylinderMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_CYLINDER, count, baseInstance);
+}
+
+void SceneMeshes::DrawPlaneMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_PLANE, count, baseInstance);
+}
+
+void SceneMeshes::DrawSphereMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_SPHERE, count, baseInstance);
+}
+
+void SceneMeshes::DrawHalfSphereMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_HALF_SPHERE, count, baseInstance);
+}
+
+void SceneMeshes::DrawTorusMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_TORUS, count, baseInstance);
+}
+
+void SceneMeshes::DrawHalfTorusMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_HALF_TORUS, count, baseInstance);
+}
+
+void SceneMeshes::DrawTaperedCylinderMeshInstanced(GLsizei count, GLuint baseInstance)
+{
+	DrawMeshInstanced(MESH_TAPERED_CYLINDER, count, baseInstance);
+}
+
+/***********************************************************
+ *  GetTriangleCount()
+ *
+ *  This method is used for getting the number of triangles
+ *  a single draw of the passed in level of detail of the
+ *  passed in shape renders.
+ ***********************************************************/
+GLuint SceneMeshes::GetTriangleCount(MESH_SHAPE shape, int lod) const
+{
+	return(m_meshRanges[shape][glm::clamp(lod, 0, MESH_LOD_COUNT - 1)].indexCount / 3);
+}
+
+/***********************************************************
+ *  SelectLOD()
+ *
+ *  This method is used for picking the level of detail of
+ *  the passed in shape when it is drawn screenSize pixels
+ *  across. Each level is used down to its size, and shapes
+ *  with a single level always get level 0. When pFade is
+ *  passed in, it is set to how far the shape has faded to
+ *  the next level, rising from 0 to 1 over a band just above
+ *  the size it switches at, so the switch can be dithered
+ *  rather than popping.
+ ***********************************************************/
+int SceneMeshes::SelectLOD(MESH_SHAPE shape, float screenSize, float* pFade) const
+{
+	int lod = 0;
+	while ((lod < m_lodCounts[shape] - 1) && (screenSize < LOD_SCREEN_SIZES[lod]))
+	{
+		lod++;
+	}
+
+	if (NULL != pFade)
+	{
+		*pFade = 0.0f;
+		if (lod < m_lodCounts[shape] - 1)
+		{
+			float threshold = LOD_SCREEN_SIZES[lod];
+			float band = threshold * LOD_FADE_BAND;
+			if (screenSize < threshold + band)
+			{
+				*pFade = glm::clamp(1.0f - (screenSize - threshold) / band, 0.0f, 1.0f);
+			}
+		}
+	}
+
+	return(lod);
+}
+
+/***********************************************************
+ *  GetMeshBounds()
+ *
+ *  This method is used for getting the bounding volume of
+ *  the passed in shape in object space, before any model
+ *  matrix is applied.
+ ***********************************************************/
+const BOUNDING_VOLUME& SceneMeshes::GetMeshBounds(MESH_SHAPE shape) const
+{
+	return(m_meshBounds[shape]);
+}
+
+/***********************************************************
+ *  BeginMesh()
+ *
+ *  This method is used for recording where the geometry of
+ *  the passed in level of the passed in shape starts in the
+ *  shared buffers.
+ ***********************************************************/
+void SceneMeshes::BeginMesh(MESH_SHAPE shape, int lod)
+{
+	m_meshRanges[shape][lod].firstIndex = (GLuint)m_indices.size();
+	m_meshRanges[shape][lod].baseVertex = (GLint)m_vertices.size();
+}
+
+/***********************************************************
+ *  EndMesh()
+ *
+ *  This method is used for recording how much geometry the
+ *  passed in level of the passed in shape occupies in the
+ *  shared buffers, and the box that the vertices of level 0
+ *  fit in, which every coarser level fits inside as well. The
+ *  indices of each level are relative to its base vertex.
+ ***********************************************************/
+void SceneMeshes::EndMesh(MESH_SHAPE shape, int lod)
+{
+	MESH_RANGE& range = m_meshRanges[shape][lod];
+	range.indexCount = (GLuint)m_indices.size() - range.firstIndex;
+
+	if ((lod == 0) && (range.baseVertex < (GLint)m_vertices.size()))
+	{
+		glm::vec3 minimum = m_vertices[range.baseVertex].position;
+		glm::vec3 maximum = minimum;
+		for (size_t i = range.baseVertex; i < m_vertices.size(); i++)
+		{
+			minimum = glm::min(minimum, m_vertices[i].position);
+			maximum = glm::max(maximum, m_vertices[i].position);
+		}
+		m_meshBounds[shape] = Frustum::MakeBounds(minimum, maximum);
+	}
+
+	for (GLuint i = range.firstIndex; i < m_indices.size(); i++)
+	{
+		m_indices[i] -= range.baseVertex;
+	}
+}
+
+/***********************************************************
+ *  AppendBox()
+ *
+ *  This method is used for building a unit box centered on
+ *  the origin, with separate vertices for every face so each
+ *  face has its own normal and texture coordinates.
+ ***********************************************************/
+void SceneMeshes::AppendBox()
+{
+	// face normal and the two face axes for every side of the box,
+	// the axes are chosen so that uAxis x vAxis == normal
+	const glm::vec3 faces[6][3] =
+	{
+		{ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f) },
+		{ glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) },
+		{ glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) }
+	};
+	const glm::vec2 corners[4] =
+	{
+		glm::vec2(0.0f, 0.0f),
+		glm::vec2(1.0f, 0.0f),
+		glm::vec2(1.0f, 1.0f),
+		glm::vec2(0.0f, 1.0f)
+	};
+
+	for (int face = 0; face < 6; face++)
+	{
+		GLuint first = (GLuint)m_vertices.size();
+
+		for (int corner = 0; corner < 4; corner++)
+		{
+			MESH_VERTEX vertex;
+			vertex.position = 0.5f * faces[face][0] +
+				(corners[corner].x - 0.5f) * faces[face][1] +
+				(corners[corner].y - 0.5f) * faces[face][2];
+			vertex.normal = faces[face][0];
+			vertex.textureCoordinate = corners[corner];
+			m_vertices.push_back(vertex);
+		}
+
+		m_indices.push_back(first);
+		m_indices.push_back(first + 1);
+		m_indices.push_back(first + 2);
+		m_indices.push_back(first);
+		m_indices.push_back(first + 2);
+		m_indices.push_back(first + 3);
+	}
+}
+
+/***********************************************************
+ *  AppendPlane()
+ *
+ *  This method is used for building a plane facing up the
+ *  Y axis that spans from -1 to 1 on the X and Z axes.
+ ***********************************************************/
+void SceneMeshes::AppendPlane()
+{
+	GLuint first = (GLuint)m_vertices.size();
+
+	const glm::vec2 corners[4] =
+	{
+		glm::vec2(0.0f, 0.0f),
+		glm::vec2(1.0f, 0.0f),
+		glm::vec2(1.0f, 1.0f),
+		glm::vec2(0.0f, 1.0f)
+	};
+
+	for (int corner = 0; corner < 4; corner++)
+	{
+		MESH_VERTEX vertex;
+		vertex.position = glm::vec3(
+			corners[corner].x * 2.0f - 1.0f,
+			0.0f,
+			1.0f - corners[corner].y * 2.0f);
+		vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+		vertex.textureCoordinate = corners[corner];
+		m_vertices.push_back(vertex);
+	}
+
+	m_indices.push_back(first);
+	m_indices.push_back(first + 1);
+	m_indices.push_back(first + 2);
+	m_indices.push_back(first);
+	m_indices.push_back(first + 2);
+	m_indices.push_back(first + 3);
+}
+
+/***********************************************************
+ *  AppendCylinder()
+ *
+ *  This method is used for building the side of a cylinder
+ *  along the Y axis from 0 to 1. Different radii make a
+ *  tapered cylinder, and a top radius of 0 makes a cone.
+ ***********************************************************/
+void SceneMeshes::AppendCylinder(float bottomRadius, float topRadius, int slices)
+{
+	GLuint first = (GLuint)m_vertices.size();
+
+	// the side normal leans towards the narrow end of the cylinder
+	float slope = bottomRadius - topRadius;
+
+	for (int i = 0; i <= slices; i++)
+	{
+		float angle = 2.0f * PI * (float)i / (float)slices;
+		float cosAngle = cos(angle);
+		float sinAngle = sin(angle);
+		glm::vec3 normal = glm::normalize(glm::vec3(cosAngle, slope, sinAngle));
+
+		MESH_VERTEX bottom;
+		bottom.position = glm::vec3(bottomRadius * cosAngle, 0.0f, bottomRadius * sinAngle);
+		bottom.normal = normal;
+		bottom.textureCoordinate = glm::vec2((float)i / (float)slices, 0.0f);
+		m_vertices.push_back(bottom);
+
+		MESH_VERTEX top;
+		top.position = glm::vec3(topRadius * cosAngle, 1.0f, topRadius * sinAngle);
+		top.normal = normal;
+		top.textureCoordinate = glm::vec2((float)i / (float)slices, 1.0f);
+		m_vertices.push_back(top);
+	}
+
+	for (int i = 0; i < slices; i++)
+	{
+		GLuint bottom = first + i * 2;
+		GLuint top = bottom + 1;
+		GLuint nextBottom = bottom + 2;
+		GLuint nextTop = bottom + 3;
+
+		m_indices.push_back(bottom);
+		m_indices.push_back(top);
+		m_indices.push_back(nextBottom);
+
+		// a cone has no second triangle, its top edge is a point
+		if (topRadius > 0.0f)
+		{
+			m_indices.push_back(nextBottom);
+			m_indices.push_back(top);
+			m_indices.push_back(nextTop);
+		}
+	}
+}
+
+/***********************************************************
+ *  AppendDisc()
+ *
+ *  This method is used for building a flat disc at the
+ *  passed in height, used for capping cylinders and cones.
+ ***********************************************************/
+void SceneMeshes::AppendDisc(float y, float radius, int slices, bool bFacingUp)
+{
+	GLuint center = (GLuint)m_vertices.size();
+	glm::vec3 normal = glm::vec3(0.0f, bFacingUp ? 1.0f : -1.0f, 0.0f);
+
+	MESH_VERTEX centerVertex;
+	centerVertex.position = glm::vec3(0.0f, y, 0.0f);
+	centerVertex.normal = normal;
+	centerVertex.textureCoordinate = glm::vec2(0.5f, 0.5f);
+	m_vertices.push_back(centerVertex);
+
+	for (int i = 0; i <= slices; i++)
+	{
+		float angle = 2.0f * PI * (float)i / (float)slices;
+
+		MESH_VERTEX vertex;
+		vertex.position = glm::vec3(radius * cos(angle), y, radius * sin(angle));
+		vertex.normal = normal;
+		vertex.textureCoordinate = glm::vec2(0.5f + 0.5f * cos(angle), 0.5f + 0.5f * sin(angle));
+		m_vertices.push_back(vertex);
+	}
+
+	for (int i = 0; i < slices; i++)
+	{
+		GLuint current = center + 1 + i;
+
+		m_indices.push_back(center);
+		if (bFacingUp)
+		{
+			m_indices.push_back(current + 1);
+			m_indices.push_back(current);
+		}
+		else
+		{
+			m_indices.push_back(current);
+			m_indices.push_back(current + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  AppendSphere()
+ *
+ *  This method is used for building a sphere with a radius
+ *  of 1 centered on the origin. The half sphere only builds
+ *  the stacks above the XZ plane.
+ ***********************************************************/
+void SceneMeshes::AppendSphere(bool bHalfSphere, int slices, int stacks)
+{
+	GLuint first = (GLuint)m_vertices.size();
+	float stackAngle = (bHalfSphere ? 0.5f * PI : PI) / (float)stacks;
+
+	for (int stack = 0; stack <= stacks; stack++)
+	{
+		float polar = stackAngle * (float)stack;
+
+		for (int slice = 0; slice <= slices; slice++)
+		{
+			float azimuth = 2.0f * PI * (float)slice / (float)slices;
+			glm::vec3 position = glm::vec3(
+				sin(polar) * cos(azimuth),
+				cos(polar),
+				sin(polar) * sin(azimuth));
+
+			MESH_VERTEX vertex;
+			vertex.position = position;
+			vertex.normal = position;
+			vertex.textureCoordinate = glm::vec2(
+				(float)slice / (float)slices,
+				1.0f - polar / PI);
+			m_vertices.push_back(vertex);
+		}
+	}
+
+	for (int stack = 0; stack < stacks; stack++)
+	{
+		for (int slice = 0; slice < slices; slice++)
+		{
+			GLuint current = first + stack * (slices + 1) + slice;
+			GLuint below = current + slices + 1;
+
+			m_indices.push_back(current);
+			m_indices.push_back(current + 1);
+			m_indices.push_back(below + 1);
+			m_indices.push_back(current);
+			m_indices.push_back(below + 1);
+			m_indices.push_back(below);
+		}
+	}
+}
+
+/***********************************************************
+ *  AppendTorus()
+ *
+ *  This method is used for building a torus lying in the XY
+ *  plane around the Z axis. The half torus only builds the
+ *  half above the XZ plane.
+ ***********************************************************/
+void SceneMeshes::AppendTorus(bool bHalfTorus, float mainRadius, float tubeRadius, int mainSlices, int tubeSlices)
+{
+	GLuint first = (GLuint)m_vertices.size();
+	float mainSweep = bHalfTorus ? PI : 2.0f * PI;
+
+	for (int mainSlice = 0; mainSlice <= mainSlices; mainSlice++)
+	{
+		float mainAngle = mainSweep * (float)mainSlice / (float)mainSlices;
+		glm::vec3 ringDirection = glm::vec3(cos(mainAngle), sin(mainAngle), 0.0f);
+
+		for (int tubeSlice = 0; tubeSlice <= tubeSlices; tubeSlice++)
+		{
+			float tubeAngle = 2.0f * PI * (float)tubeSlice / (float)tubeSlices;
+			glm::vec3 normal = cos(tubeAngle) * ringDirection + glm::vec3(0.0f, 0.0f, sin(tubeAngle));
+
+			MESH_VERTEX vertex;
+			vertex.position = mainRadius * ringDirection + tubeRadius * normal;
+			vertex.normal = normal;
+			vertex.textureCoordinate = glm::vec2(
+				(float)mainSlice / (float)mainSlices,
+				(float)tubeSlice / (float)tubeSlices);
+			m_vertices.push_back(vertex);
+		}
+	}
+
+	for (int mainSlice = 0; mainSlice < mainSlices; mainSlice++)
+	{
+		for (int tubeSlice = 0; tubeSlice < tubeSlices; tubeSlice++)
+		{
+			GLuint current = first + mainSlice * (tubeSlices + 1) + tubeSlice;
+			GLuint next = current + tubeSlices + 1;
+
+			m_indices.push_back(current);
+			m_indices.push_back(next);
+			m_indices.push_back(next + 1);
+			m_indices.push_back(current);
+			m_indices.push_back(next + 1);
+			m_indices.push_back(current + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  SetInstanceAttributes()
+ *
+ *  This method is used for pointing the per-instance vertex
+ *  attributes at the passed in first instance of the
+ *  instance and fade buffers. The vertex array must be bound.
+ ***********************************************************/
+void SceneMeshes::SetInstanceAttributes(GLuint baseInstance)
+{
+	size_t baseOffset = baseInstance * sizeof(INSTANCE_DATA);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer.Get());
+	for (int column = 0; column < 4; column++)
+	{
+		glVertexAttribPointer(INSTANCE_MODEL_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, sizeof(INSTANCE_DATA),
+			(void*)(baseOffset + offsetof(INSTANCE_DATA, model) + column * sizeof(glm::vec4)));
+	}
+	glVertexAttribPointer(INSTANCE_COLOR_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, sizeof(INSTANCE_DATA),
+		(void*)(baseOffset + offsetof(INSTANCE_DATA, objectColor)));
+	glVertexAttribPointer(INSTANCE_UV_SCALE_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, sizeof(INSTANCE_DATA),
+		(void*)(baseOffset + offsetof(INSTANCE_DATA, UVscale)));
+	glVertexAttribIPointer(INSTANCE_MATERIAL_ATTRIBUTE, 1, GL_INT, sizeof(INSTANCE_DATA),
+		(void*)(baseOffset + offsetof(INSTANCE_DATA, materialIndex)));
+	glVertexAttribIPointer(INSTANCE_TEXTURE_LAYER_ATTRIBUTE, 1, GL_INT, sizeof(INSTANCE_DATA),
+		(void*)(baseOffset + offsetof(INSTANCE_DATA, textureLayer)));
+	glVertexAttribIPointer(INSTANCE_DYNAMIC_SLOT_ATTRIBUTE, 1, GL_INT, sizeof(INSTANCE_DATA),
+		(void*)(baseOffset + offsetof(INSTANCE_DATA, dynamicSlot)));
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_fadeBuffer.Get());
+	glVertexAttribPointer(INSTANCE_LOD_FADE_ATTRIBUTE, 1, GL_FLOAT, GL_FALSE, sizeof(float),
+		(void*)(baseInstance * sizeof(float)));
+}
@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenemeshes.h
+// ============
+// shared geometry buffers for the basic mesh shapes with instanced drawing
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 14th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Frustum.h"
+#include "GLResources.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// basic mesh shapes that a scene object can be drawn with
+enum MESH_SHAPE
+{
+	MESH_BOX,
+	MESH_CONE,
+	MESH_CYLINDER,
+	MESH_PLANE,
+	MESH_SPHERE,
+	MESH_HALF_SPHERE,
+	MESH_TORUS,
+	MESH_HALF_TORUS,
+	MESH_TAPERED_CYLINDER,
+	MESH_SHAPE_COUNT
+};
+
+// per-instance values read by the vertex shader, one entry
+// for every object drawn by an instanced draw call
+struct INSTANCE_DATA
+{
+	glm::mat4 model;
+	glm::vec4 objectColor;
+	glm::vec2 UVscale;
+	int materialIndex;
+	// layer of the texture array page the object texture is in
+	int textureLayer;
+	// slot of a dynamic object in the ring of model matrices written
+	// every frame, -1 when the model above is used
+	int dynamicSlot;
+};
+
+// layout of a single command in the indirect command buffer,
+// as read by glMultiDrawElementsIndirect
+struct DRAW_ELEMENTS_COMMAND
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+/***********************************************************
+ *  SceneMeshes
+ *
+ *  This class builds the same basic shapes as ShapeMeshes,
+ *  but packs all of them into one shared vertex and index
+ *  buffer with a per-instance buffer attached, so the same
+ *  shape can be drawn many times with a single draw call.
+ *  The curved shapes are built at several levels of detail,
+ *  each with fewer slices than the last, picked by how big
+ *  an object is on screen. The buffers are owned by handles
+ *  that delete them along with the meshes.
+ ***********************************************************/
+class SceneMeshes
+{
+public:
+	// constructor
+	SceneMeshes();
+	// destructor
+	~SceneMeshes();
+
+	// the levels of detail of the curved shapes, 0 being the finest,
+	// the box and plane only have the one
+	static const int MESH_LOD_COUNT = 4;
+
+	// vertex attribute locations shared with the vertex shader
+	enum ATTRIBUTE_LOCATION
+	{
+		POSITION_ATTRIBUTE = 0,
+		NORMAL_ATTRIBUTE = 1,
+		TEXTURE_COORDINATE_ATTRIBUTE = 2,
+		INSTANCE_MODEL_ATTRIBUTE = 3, // uses locations 3 to 6
+		INSTANCE_COLOR_ATTRIBUTE = 7,
+		INSTANCE_UV_SCALE_ATTRIBUTE = 8,
+		INSTANCE_MATERIAL_ATTRIBUTE = 9,
+		INSTANCE_TEXTURE_LAYER_ATTRIBUTE = 10,
+		INSTANCE_LOD_FADE_ATTRIBUTE = 11,
+		INSTANCE_DYNAMIC_SLOT_ATTRIBUTE = 12
+	};
+
+	// the part of the shared buffers a single shape occupies
+	struct MESH_RANGE
+	{
+		GLuint firstIndex;
+		GLuint indexCount;
+		GLint baseVertex;
+	};
+
+	// build all of the shapes into the shared buffers
+	void LoadMeshes();
+	// upload the per-instance values used by the instanced draws
+	void UploadInstances(const std::vector<INSTANCE_DATA>& instances);
+	// upload how far each instance has faded to its next level of
+	// detail, read alongside the other per-instance values
+	void UploadInstanceFades(const std::vector<float>& fades);
+
+	// draw the passed in shape once for every instance in the range
+	void DrawMeshInstanced(MESH_SHAPE shape, GLsizei count, GLuint baseInstance = 0, int lod = 0);
+
+	// fill in the indirect command that draws the passed in shape
+	// once for every instance in the range
+	void MakeDrawCommand(
+		MESH_SHAPE shape,
+		GLsizei count,
+		GLuint baseInstance,
+		int lod,
+		DRAW_ELEMENTS_COMMAND& command) const;
+	// upload the commands read by the multi-draw indirect calls
+	void UploadDrawCommands(const std::vector<DRAW_ELEMENTS_COMMAND>& commands);
+	// submit a range of the uploaded commands with a single call
+	void DrawMultiIndirect(GLuint firstCommand, GLsizei commandCount);
+	// whether the multi-draw indirect calls are available
+	bool IsMultiDrawIndirectSupported() const;
+
+	// instanced draw entry points for each of the shapes
+	void DrawBoxMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+	void DrawConeMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+	void DrawCylinderMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+	void DrawPlaneMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+	void DrawSphereMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+	void DrawHalfSphereMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+	void DrawTorusMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+	void DrawHalfTorusMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+	void DrawTaperedCylinderMeshInstanced(GLsizei count, GLuint baseInstance = 0);
+
+	// get the number of triangles in the passed in shape
+	GLuint GetTriangleCount(MESH_SHAPE shape, int lod = 0) const;
+	// pick the level of detail of a shape drawn the passed in
+	// number of pixels across, and how far it has faded to the
+	// next level when the fade is asked for
+	int SelectLOD(MESH_SHAPE shape, float screenSize, float* pFade) const;
+	// get the object space bounding volume of the passed in shape
+	const BOUNDING_VOLUME& GetMeshBounds(MESH_SHAPE shape) const;
+
+private:
+	// a single vertex of the shared vertex buffer
+	struct MESH_VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 textureCoordinate;
+	};
+
+	// OpenGL names of the shared buffers
+	GLVertexArray m_vao;
+	GLBuffer m_vertexBuffer;
+	GLBuffer m_indexBuffer;
+	GLBuffer m_instanceBuffer;
+	GLBuffer m_fadeBuffer;
+	GLBuffer m_indirectBuffer;
+	// number of instances the instance buffer has room for
+	GLsizei m_instanceCapacity;
+	// number of instances the fade buffer has room for
+	GLsizei m_fadeCapacity;
+	// number of commands the indirect buffer has room for
+	GLsizei m_commandCapacity;
+	// whether the base instance draw calls are available
+	bool m_bBaseInstanceSupported;
+	// whether the multi-draw indirect calls are available
+	bool m_bMultiDrawIndirectSupported;
+
+	// where each level of each of the shapes lives in the shared
+	// buffers, and how many levels each shape was built with
+	MESH_RANGE m_meshRanges[MESH_SHAPE_COUNT][MESH_LOD_COUNT];
+	int m_lodCounts[MESH_SHAPE_COUNT];
+	// object space bounding volume of each of the shapes
+	BOUNDING_VOLUME m_meshBounds[MESH_SHAPE_COUNT];
+
+	// geometry being built by LoadMeshes()
+	std::vector<MESH_VERTEX> m_vertices;
+	std::vector<GLuint> m_indices;
+
+	// start and finish recording the range of a level of a shape
+	void BeginMesh(MESH_SHAPE shape, int lod);
+	void EndMesh(MESH_SHAPE shape, int lod);
+
+	// shape generators, these append to the geometry being built
+	void AppendBox();
+	void AppendPlane();
+	void AppendCylinder(float bottomRadius, float topRadius, int slices);
+	void AppendDisc(float y, float radius, int slices, bool bFacingUp);
+	void AppendSphere(bool bHalfSphere, int slices, int stacks);
+	void AppendTorus(bool bHalfTorus, float mainRadius, float tubeRadius, int mainSlices, int tubeSlices);
+
+	// point the instance attributes at the passed in first instance
+	void SetInstanceAttributes(GLuint baseInstance);
+};
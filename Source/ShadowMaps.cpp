@@ -0,0 +1,482 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.cpp
+// ============
+// cascaded shadow maps for the light of the scene that casts shadows
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShadowMaps.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <iostream>
+
+// declaration of the shadow settings
+namespace
+{
+	// shadows are only drawn out to this view depth
+	const float MAX_SHADOW_DISTANCE = 100.0f;
+	// how far the cascade ends lean from even spacing towards
+	// logarithmic spacing, which gives the near cascades more detail
+	const float CASCADE_SPLIT_LAMBDA = 0.75f;
+	// each cascade covers this much more than its slice, so it can
+	// stay put until the slice has moved by up to this much
+	const float CASCADE_MARGIN = 0.25f;
+	// depth offset of the drawn casters, so a lit surface does not
+	// shadow itself
+	const float SHADOW_SLOPE_BIAS = 2.0f;
+	const float SHADOW_CONSTANT_BIAS = 4.0f;
+}
+
+/***********************************************************
+ *  ShadowMaps()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShadowMaps::ShadowMaps()
+{
+	m_staticFramebuffer = 0;
+	m_dynamicFramebuffer = 0;
+	m_toLight = glm::vec3(0.0f, 1.0f, 0.0f);
+	m_casterBounds = BOUNDING_VOLUME();
+	m_lightView = glm::mat4(1.0f);
+	m_bLightSet = false;
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		m_cascadeMatrices[i] = glm::mat4(1.0f);
+		m_cascadeEnds[i] = 0.0f;
+		m_texelSizes[i] = 0.0f;
+		m_cachedMatrices[i] = glm::mat4(1.0f);
+		m_bCascadeCached[i] = false;
+	}
+	m_bCascadesFitted = false;
+	m_previousFramebuffer = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		m_previousViewport[i] = 0;
+	}
+}
+
+/***********************************************************
+ *  ~ShadowMaps()
+ *
+ *  The destructor for the class, the texture handles delete
+ *  the maps
+ ***********************************************************/
+ShadowMaps::~ShadowMaps()
+{
+	if (m_staticFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_staticFramebuffer);
+		m_staticFramebuffer = 0;
+	}
+	if (m_dynamicFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_dynamicFramebuffer);
+		m_dynamicFramebuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the cache of the static
+ *  objects. The copy the dynamic objects are drawn into is
+ *  made the first time there are any. False is returned when
+ *  the maps can't be used, and the scene is then drawn
+ *  without shadows.
+ ***********************************************************/
+bool ShadowMaps::Initialize()
+{
+	if (IsReady())
+	{
+		return(true);
+	}
+
+	if (!CreateMaps(m_staticMaps, m_staticFramebuffer))
+	{
+		m_staticMaps.Reset();
+		return(false);
+	}
+
+	Invalidate();
+	return(true);
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking if the maps were
+ *  initialized.
+ ***********************************************************/
+bool ShadowMaps::IsReady() const
+{
+	return(m_staticFramebuffer != 0);
+}
+
+/***********************************************************
+ *  SetLight()
+ *
+ *  This method is used for setting the direction towards
+ *  the light and the bounds around every object that can
+ *  cast a shadow. The light is treated as far away, so all
+ *  of its shadows are cast the same way. The depth of every
+ *  cascade spans the whole of the bounds, so the objects
+ *  outside the view still shadow the ones in it. The cache
+ *  is only dropped when either one changes.
+ ***********************************************************/
+void ShadowMaps::SetLight(const glm::vec3& toLight, const BOUNDING_VOLUME& casterBounds)
+{
+	if (m_bLightSet && (toLight == m_toLight) &&
+		(casterBounds.center == m_casterBounds.center) &&
+		(casterBounds.radius == m_casterBounds.radius))
+	{
+		return;
+	}
+
+	m_toLight = toLight;
+	m_casterBounds = casterBounds;
+	m_bLightSet = true;
+
+	// any up direction works that is not along the light
+	glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+	if (std::fabs(toLight.y) > 0.99f)
+	{
+		up = glm::vec3(0.0f, 0.0f, 1.0f);
+	}
+	m_lightView = glm::lookAt(glm::vec3(0.0f), -toLight, up);
+
+	Invalidate();
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for dropping the cache of every
+ *  cascade, so the static objects are drawn again.
+ ***********************************************************/
+void ShadowMaps::Invalidate()
+{
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		m_bCascadeCached[i] = false;
+	}
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for fitting the cascades to the
+ *  passed in view. The view is sliced by depth between the
+ *  near plane and the shadow distance, and each cascade is
+ *  an orthographic view from the light around the bounding
+ *  sphere of its slice. A sphere keeps the same size however
+ *  the camera turns, and the cascade is only moved in whole
+ *  steps of its texels, so the cache stays valid and the
+ *  shadow edges do not crawl while the camera moves.
+ ***********************************************************/
+void ShadowMaps::Update(const glm::mat4& view, const glm::mat4& projection)
+{
+	m_bCascadesFitted = false;
+	if (!IsReady() || !m_bLightSet || (m_casterBounds.radius <= 0.0f))
+	{
+		return;
+	}
+
+	glm::mat4 inverseProjection = glm::inverse(projection);
+	glm::mat4 inverseView = glm::inverse(view);
+
+	// the corner edges of the view, from the near to the far plane
+	const glm::vec2 corners[4] =
+	{
+		glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f),
+		glm::vec2(-1.0f, 1.0f), glm::vec2(1.0f, 1.0f)
+	};
+	glm::vec3 edgeNear[4];
+	glm::vec3 edgeFar[4];
+	for (int i = 0; i < 4; i++)
+	{
+		glm::vec4 nearPoint = inverseProjection * glm::vec4(corners[i].x, corners[i].y, -1.0f, 1.0f);
+		glm::vec4 farPoint = inverseProjection * glm::vec4(corners[i].x, corners[i].y, 1.0f, 1.0f);
+		edgeNear[i] = glm::vec3(nearPoint) / nearPoint.w;
+		edgeFar[i] = glm::vec3(farPoint) / farPoint.w;
+	}
+
+	float nearDepth = -edgeNear[0].z;
+	float farDepth = glm::min(-edgeFar[0].z, MAX_SHADOW_DISTANCE);
+	if ((nearDepth <= 0.0f) || (farDepth <= nearDepth))
+	{
+		return;
+	}
+
+	// the depth of every cascade spans all of the casters
+	float casterDepth = -(m_lightView * glm::vec4(m_casterBounds.center, 1.0f)).z;
+
+	float sliceStart = nearDepth;
+	for (int cascade = 0; cascade < CASCADE_COUNT; cascade++)
+	{
+		float ratio = (float)(cascade + 1) / (float)CASCADE_COUNT;
+		float logarithmicEnd = nearDepth * std::pow(farDepth / nearDepth, ratio);
+		float evenEnd = nearDepth + (farDepth - nearDepth) * ratio;
+		float sliceEnd = glm::mix(evenEnd, logarithmicEnd, CASCADE_SPLIT_LAMBDA);
+
+		// the world space corners of the slice
+		glm::vec3 points[8];
+		glm::vec3 center = glm::vec3(0.0f);
+		for (int i = 0; i < 4; i++)
+		{
+			float edgeLength = edgeFar[i].z - edgeNear[i].z;
+			glm::vec3 startPoint = glm::mix(edgeNear[i], edgeFar[i], (-sliceStart - edgeNear[i].z) / edgeLength);
+			glm::vec3 endPoint = glm::mix(edgeNear[i], edgeFar[i], (-sliceEnd - edgeNear[i].z) / edgeLength);
+			points[i * 2] = glm::vec3(inverseView * glm::vec4(startPoint, 1.0f));
+			points[i * 2 + 1] = glm::vec3(inverseView * glm::vec4(endPoint, 1.0f));
+			center += points[i * 2] + points[i * 2 + 1];
+		}
+		center /= 8.0f;
+
+		float radius = 0.0f;
+		for (int i = 0; i < 8; i++)
+		{
+			radius = glm::max(radius, glm::length(points[i] - center));
+		}
+		// round the radius up, so rounding errors as the camera turns
+		// do not change the size of the cascade
+		radius = std::ceil(radius * 16.0f) / 16.0f;
+
+		// the cascade is moved in whole texels, in steps of up to its
+		// margin, which keeps the slice inside it between steps
+		float extent = radius * (1.0f + CASCADE_MARGIN);
+		float texelSize = 2.0f * extent / (float)MAP_SIZE;
+		float step = glm::max(texelSize * std::floor(radius * CASCADE_MARGIN / texelSize), texelSize);
+		glm::vec3 lightCenter = glm::vec3(m_lightView * glm::vec4(center, 1.0f));
+		float centerX = std::floor(lightCenter.x / step + 0.5f) * step;
+		float centerY = std::floor(lightCenter.y / step + 0.5f) * step;
+
+		glm::mat4 lightProjection = glm::ortho(
+			centerX - extent, centerX + extent,
+			centerY - extent, centerY + extent,
+			casterDepth - m_casterBounds.radius - texelSize,
+			casterDepth + m_casterBounds.radius + texelSize);
+
+		m_cascadeMatrices[cascade] = lightProjection * m_lightView;
+		m_cascadeEnds[cascade] = sliceEnd;
+		m_texelSizes[cascade] = texelSize;
+		sliceStart = sliceEnd;
+	}
+
+	m_bCascadesFitted = true;
+}
+
+/***********************************************************
+ *  IsCascadeStale()
+ *
+ *  This method is used for checking if the static objects
+ *  need drawing into the cache of a cascade, because it was
+ *  dropped or the cascade moved since it was drawn.
+ ***********************************************************/
+bool ShadowMaps::IsCascadeStale(int cascade) const
+{
+	if ((cascade < 0) || (cascade >= CASCADE_COUNT) || !m_bCascadesFitted)
+	{
+		return(false);
+	}
+
+	return(!m_bCascadeCached[cascade] || (m_cachedMatrices[cascade] != m_cascadeMatrices[cascade]));
+}
+
+/***********************************************************
+ *  GetCascadeMatrix()
+ *
+ *  This method is used for getting the view projection from
+ *  the light that a cascade is drawn with.
+ ***********************************************************/
+const glm::mat4& ShadowMaps::GetCascadeMatrix(int cascade) const
+{
+	return(m_cascadeMatrices[glm::clamp(cascade, 0, CASCADE_COUNT - 1)]);
+}
+
+/***********************************************************
+ *  BeginPass()
+ *
+ *  This method is used for setting up the drawing into the
+ *  maps. The framebuffer and viewport of the scene are saved
+ *  for EndPass(), and the drawn depth is pushed away from
+ *  the light by the slope of each triangle.
+ ***********************************************************/
+void ShadowMaps::BeginPass()
+{
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, m_previousViewport);
+
+	glViewport(0, 0, MAP_SIZE, MAP_SIZE);
+	glDepthMask(GL_TRUE);
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(SHADOW_SLOPE_BIAS, SHADOW_CONSTANT_BIAS);
+}
+
+/***********************************************************
+ *  BeginStaticCascade()
+ *
+ *  This method is used for clearing the cache of a cascade
+ *  and drawing into it.
+ ***********************************************************/
+void ShadowMaps::BeginStaticCascade(int cascade)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_staticFramebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticMaps.Get(), 0, cascade);
+	glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+/***********************************************************
+ *  EndStaticCascade()
+ *
+ *  This method is used for marking the cache of a cascade as
+ *  drawn for where the cascade is now.
+ ***********************************************************/
+void ShadowMaps::EndStaticCascade(int cascade)
+{
+	m_cachedMatrices[cascade] = m_cascadeMatrices[cascade];
+	m_bCascadeCached[cascade] = true;
+}
+
+/***********************************************************
+ *  BeginDynamicCascade()
+ *
+ *  This method is used for copying the cache of a cascade
+ *  into the map the dynamic objects are drawn over, and
+ *  drawing into it. The maps are made the first time.
+ ***********************************************************/
+bool ShadowMaps::BeginDynamicCascade(int cascade)
+{
+	if ((m_dynamicFramebuffer == 0) && !CreateMaps(m_dynamicMaps, m_dynamicFramebuffer))
+	{
+		m_dynamicMaps.Reset();
+		return(false);
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_staticFramebuffer);
+	glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticMaps.Get(), 0, cascade);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_dynamicFramebuffer);
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_dynamicMaps.Get(), 0, cascade);
+	glBlitFramebuffer(0, 0, MAP_SIZE, MAP_SIZE, 0, 0, MAP_SIZE, MAP_SIZE, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_dynamicFramebuffer);
+
+	return(true);
+}
+
+/***********************************************************
+ *  EndPass()
+ *
+ *  This method is used for putting back the framebuffer and
+ *  viewport saved by BeginPass().
+ ***********************************************************/
+void ShadowMaps::EndPass()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_previousFramebuffer);
+	glViewport(m_previousViewport[0], m_previousViewport[1], m_previousViewport[2], m_previousViewport[3]);
+	glDisable(GL_POLYGON_OFFSET_FILL);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the maps the scene is
+ *  shadowed with to the passed in texture unit, the copy
+ *  with the dynamic objects when there are any, and setting
+ *  the cascade values into the shader. Shadows are turned
+ *  off until the cascades have been fitted to a view.
+ ***********************************************************/
+void ShadowMaps::Bind(int unit, bool bDynamicCasters, const UniformCache* pUniformCache) const
+{
+	if (NULL == pUniformCache)
+	{
+		return;
+	}
+
+	if (!IsReady() || !m_bCascadesFitted)
+	{
+		pUniformCache->setBoolValue(pUniformCache->m_locations.bUseShadows, false);
+		return;
+	}
+
+	GLuint maps = m_staticMaps.Get();
+	if (bDynamicCasters && (m_dynamicFramebuffer != 0))
+	{
+		maps = m_dynamicMaps.Get();
+	}
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, maps);
+	glActiveTexture(GL_TEXTURE0);
+
+	// the cascade ends and texel sizes are passed as a vec4 each
+	glm::vec4 cascadeEnds = glm::vec4(0.0f);
+	glm::vec4 texelSizes = glm::vec4(0.0f);
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		cascadeEnds[i] = m_cascadeEnds[i];
+		texelSizes[i] = m_texelSizes[i];
+	}
+
+	pUniformCache->setBoolValue(pUniformCache->m_locations.bUseShadows, true);
+	pUniformCache->setMat4ArrayValue(pUniformCache->m_locations.shadowMatrices, m_cascadeMatrices, CASCADE_COUNT);
+	pUniformCache->setVec4Value(pUniformCache->m_locations.shadowCascadeEnds, cascadeEnds);
+	pUniformCache->setVec4Value(pUniformCache->m_locations.shadowTexelSizes, texelSizes);
+}
+
+/***********************************************************
+ *  CreateMaps()
+ *
+ *  This method is used for creating a depth texture array
+ *  with a layer for every cascade, and a framebuffer with
+ *  no color that draws into one layer at a time. The maps
+ *  are compared against the depth of a fragment as they are
+ *  sampled, with the four nearest texels blended, and read
+ *  as lit outside of their edges. The array bound to the
+ *  active unit is put back.
+ ***********************************************************/
+bool ShadowMaps::CreateMaps(GLTexture& maps, GLuint& framebuffer)
+{
+	GLint previousMaps = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &previousMaps);
+
+	const GLfloat borderColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+	maps.Create();
+	glBindTexture(GL_TEXTURE_2D_ARRAY, maps.Get());
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, MAP_SIZE, MAP_SIZE, CASCADE_COUNT,
+		0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	maps.SetMemorySize((GLsizeiptr)MAP_SIZE * MAP_SIZE * 4 * CASCADE_COUNT);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, previousMaps);
+
+	GLint previousFramebuffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, maps.Get(), 0, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "ERROR: the shadow maps are not complete: " << status << std::endl;
+		glDeleteFramebuffers(1, &framebuffer);
+		framebuffer = 0;
+		return(false);
+	}
+
+	return(true);
+}
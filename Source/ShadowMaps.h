@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.h
+// ============
+// cascaded shadow maps for the light of the scene that casts shadows
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLResources.h"
+#include "Frustum.h"
+#include "UniformCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  ShadowMaps
+ *
+ *  This class holds the depth maps the scene is shadowed
+ *  with from a far away light, one for each cascade, a
+ *  slice of the view by depth. The nearer cascades cover
+ *  less of the scene, so the shadows near the camera get
+ *  the most detail. The depth of the static objects is kept
+ *  in a cache that is only drawn again when a cascade moves
+ *  to a new spot, the light moves or a static object moves.
+ *  Each cascade is fitted loosely around its slice and only
+ *  moved in steps, so a moving camera rarely needs a new one.
+ *  Dynamic objects are drawn every frame into a copy of the
+ *  cache, which is then sampled instead.
+ ***********************************************************/
+class ShadowMaps
+{
+public:
+	// the slices of the view that get a map of their own, this
+	// must match the fragment shader
+	static const int CASCADE_COUNT = 3;
+	// the width and height of each map in texels
+	static const int MAP_SIZE = 2048;
+
+	// constructor
+	ShadowMaps();
+	// destructor
+	~ShadowMaps();
+
+	// create the static cache, false if the maps can't be used
+	bool Initialize();
+	// check if the maps were initialized
+	bool IsReady() const;
+
+	// set the direction towards the light and the bounds around
+	// every object that can cast a shadow, the cache is dropped
+	// when either changes
+	void SetLight(const glm::vec3& toLight, const BOUNDING_VOLUME& casterBounds);
+	// drop the cache, such as when a static object moved
+	void Invalidate();
+	// fit the cascades to the passed in view
+	void Update(const glm::mat4& view, const glm::mat4& projection);
+	// check if the static objects need drawing into a cascade
+	bool IsCascadeStale(int cascade) const;
+	// get the light view projection of a cascade
+	const glm::mat4& GetCascadeMatrix(int cascade) const;
+
+	// start drawing into the maps, saving the framebuffer and
+	// viewport the scene is drawn with
+	void BeginPass();
+	// start drawing the static objects into the cache of a cascade
+	void BeginStaticCascade(int cascade);
+	// mark the cache of a cascade as drawn
+	void EndStaticCascade(int cascade);
+	// copy the cache of a cascade into its map and start drawing
+	// the dynamic objects over it, false if the copy can't be made
+	bool BeginDynamicCascade(int cascade);
+	// put the saved framebuffer and viewport back
+	void EndPass();
+
+	// bind the maps to the passed in texture unit and set the
+	// values the fragment shader samples them with
+	void Bind(int unit, bool bDynamicCasters, const UniformCache* pUniformCache) const;
+
+private:
+	// depth of the static objects, one layer per cascade
+	GLTexture m_staticMaps;
+	GLuint m_staticFramebuffer;
+	// copy of the cache with the dynamic objects drawn over it,
+	// only made once there are dynamic objects
+	GLTexture m_dynamicMaps;
+	GLuint m_dynamicFramebuffer;
+
+	glm::vec3 m_toLight;
+	BOUNDING_VOLUME m_casterBounds;
+	glm::mat4 m_lightView;
+	bool m_bLightSet;
+
+	glm::mat4 m_cascadeMatrices[CASCADE_COUNT];
+	// the view depth each cascade reaches out to
+	float m_cascadeEnds[CASCADE_COUNT];
+	// world size of a texel of each cascade
+	float m_texelSizes[CASCADE_COUNT];
+	// the matrix the cache of each cascade was drawn with
+	glm::mat4 m_cachedMatrices[CASCADE_COUNT];
+	bool m_bCascadeCached[CASCADE_COUNT];
+	bool m_bCascadesFitted;
+
+	// framebuffer and viewport saved by BeginPass()
+	GLint m_previousFramebuffer;
+	GLint m_previousViewport[4];
+
+	// create a depth texture array with a layer per cascade and
+	// the framebuffer that draws into it, false if incomplete
+	static bool CreateMaps(GLTexture& maps, GLuint& framebuffer);
+};
@@ -0,0 +1,356 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturearrays.cpp
+// ============
+// pack the scene textures into array texture pages grouped by size and format
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureArrays.h"
+
+#include <algorithm>
+#include <utility>
+
+// declaration of the page settings
+namespace
+{
+	// layers a new page starts with, doubled every time it fills
+	const int INITIAL_LAYER_CAPACITY = 4;
+
+	// uncompressed textures are counted at 4 bytes per texel,
+	// since drivers store RGB8 padded out to RGBA8
+	const GLsizeiptr UNCOMPRESSED_TEXEL_SIZE = 4;
+}
+
+/***********************************************************
+ *  TextureArrays()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureArrays::TextureArrays()
+{
+	m_maxLayers = 0;
+	m_maxPages = 0;
+}
+
+/***********************************************************
+ *  ~TextureArrays()
+ *
+ *  The destructor for the class, the texture handles of the
+ *  pages delete the arrays
+ ***********************************************************/
+TextureArrays::~TextureArrays()
+{
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking if textures can be
+ *  packed into pages. The pages use immutable storage and
+ *  are filled with GPU copies, which need OpenGL 4.3.
+ ***********************************************************/
+bool TextureArrays::IsSupported()
+{
+	return(GLEW_VERSION_4_3 == GL_TRUE);
+}
+
+/***********************************************************
+ *  AddTexture()
+ *
+ *  This method is used for copying every mip level of the
+ *  passed in texture into a free layer of the page for its
+ *  size and format. The texture is left as it was, so the
+ *  caller can delete it once it is packed. False is returned
+ *  when the texture is incomplete or no page can take it.
+ ***********************************************************/
+bool TextureArrays::AddTexture(GLuint textureID, TEXTURE_LAYER& location)
+{
+	if (m_maxLayers == 0)
+	{
+		// one texture unit is kept for the textures that are not packed
+		GLint maxUnits = 0;
+		glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &m_maxLayers);
+		glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxUnits);
+		m_maxPages = std::min(MAX_PAGES, (int)maxUnits - 1);
+	}
+
+	GLint boundTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	GLint width = 0;
+	GLint height = 0;
+	GLint internalFormat = 0;
+	GLint compressed = 0;
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &compressed);
+
+	// count the mip levels the texture has, a full chain goes
+	// down to 1x1 but a texture without mipmaps only has one
+	int fullLevelCount = 1;
+	while ((std::max(width, height) >> fullLevelCount) > 0)
+	{
+		fullLevelCount++;
+	}
+
+	int levelCount = 0;
+	GLsizeiptr layerSize = 0;
+	for (int level = 0; level < fullLevelCount; level++)
+	{
+		GLint levelWidth = 0;
+		GLint levelHeight = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &levelWidth);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &levelHeight);
+		if ((levelWidth == 0) || (levelHeight == 0))
+		{
+			break;
+		}
+
+		GLint levelSize = levelWidth * levelHeight * UNCOMPRESSED_TEXEL_SIZE;
+		if (compressed == GL_TRUE)
+		{
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &levelSize);
+		}
+		layerSize += levelSize;
+		levelCount++;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, boundTexture);
+
+	if (levelCount == 0)
+	{
+		return(false);
+	}
+
+	int pageIndex = FindPage(internalFormat, width, height, levelCount, layerSize);
+	if (pageIndex < 0)
+	{
+		return(false);
+	}
+
+	ARRAY_PAGE& page = m_pages[pageIndex];
+	int layer = 0;
+	if (!page.freeLayers.empty())
+	{
+		layer = page.freeLayers.back();
+		page.freeLayers.pop_back();
+	}
+	else
+	{
+		if (page.layerCount == page.layerCapacity)
+		{
+			GrowPage(page);
+		}
+
+		layer = page.layerCount;
+		page.layerCount++;
+	}
+
+	int levelWidth = width;
+	int levelHeight = height;
+	for (int level = 0; level < levelCount; level++)
+	{
+		glCopyImageSubData(
+			textureID, GL_TEXTURE_2D, level, 0, 0, 0,
+			page.array.Get(), GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+			levelWidth, levelHeight, 1);
+
+		levelWidth = std::max(1, levelWidth / 2);
+		levelHeight = std::max(1, levelHeight / 2);
+	}
+
+	location.page = pageIndex;
+	location.layer = layer;
+
+	return(true);
+}
+
+/***********************************************************
+ *  RemoveTexture()
+ *
+ *  This method is used for freeing the layer that a texture
+ *  was packed into. The layer keeps its texels until the next
+ *  texture of the same size and format is copied over them.
+ ***********************************************************/
+void TextureArrays::RemoveTexture(const TEXTURE_LAYER& location)
+{
+	if ((location.page < 0) || (location.page >= (int)m_pages.size()))
+	{
+		return;
+	}
+
+	ARRAY_PAGE& page = m_pages[location.page];
+	if ((location.layer >= 0) && (location.layer < page.layerCount))
+	{
+		page.freeLayers.push_back(location.layer);
+	}
+}
+
+/***********************************************************
+ *  GetLayerSize()
+ *
+ *  This method is used for getting the texture memory that a
+ *  single layer of the passed in page takes.
+ ***********************************************************/
+GLsizeiptr TextureArrays::GetLayerSize(int page) const
+{
+	if ((page < 0) || (page >= (int)m_pages.size()))
+	{
+		return(0);
+	}
+	return(m_pages[page].layerSize);
+}
+
+/***********************************************************
+ *  BindPages()
+ *
+ *  This method is used for binding every page to its own
+ *  texture unit, starting at the passed in unit. Unit 0 is
+ *  left active afterwards.
+ ***********************************************************/
+void TextureArrays::BindPages(int firstUnit) const
+{
+	for (int i = 0; i < (int)m_pages.size(); i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_pages[i].array.Get());
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  GetPageCount()
+ *
+ *  This method is used for getting the number of pages.
+ ***********************************************************/
+int TextureArrays::GetPageCount() const
+{
+	return((int)m_pages.size());
+}
+
+/***********************************************************
+ *  GetMemorySize()
+ *
+ *  This method is used for getting the texture memory taken
+ *  by the pages, counting the free layers they have grown.
+ ***********************************************************/
+GLsizeiptr TextureArrays::GetMemorySize() const
+{
+	GLsizeiptr memorySize = 0;
+	for (const ARRAY_PAGE& page : m_pages)
+	{
+		memorySize += page.layerSize * page.layerCapacity;
+	}
+	return(memorySize);
+}
+
+/***********************************************************
+ *  FindPage()
+ *
+ *  This method is used for finding the page that a texture of
+ *  the passed in size and format can be added to. A page that
+ *  is full can still grow until it reaches the layer limit of
+ *  the GL context, after that a second page is started.
+ ***********************************************************/
+int TextureArrays::FindPage(GLenum internalFormat, int width, int height, int levelCount, GLsizeiptr layerSize)
+{
+	for (int i = 0; i < (int)m_pages.size(); i++)
+	{
+		const ARRAY_PAGE& page = m_pages[i];
+		if ((page.internalFormat == internalFormat) &&
+			(page.width == width) &&
+			(page.height == height) &&
+			(page.levelCount == levelCount) &&
+			(!page.freeLayers.empty() ||
+				(page.layerCount < page.layerCapacity) ||
+				(page.layerCapacity < m_maxLayers)))
+		{
+			return(i);
+		}
+	}
+
+	if ((int)m_pages.size() >= m_maxPages)
+	{
+		return(-1);
+	}
+
+	ARRAY_PAGE page;
+	page.internalFormat = internalFormat;
+	page.width = width;
+	page.height = height;
+	page.levelCount = levelCount;
+	page.layerCount = 0;
+	page.layerCapacity = std::min(INITIAL_LAYER_CAPACITY, m_maxLayers);
+	page.layerSize = layerSize;
+	CreateArray(page);
+	m_pages.push_back(std::move(page));
+
+	return((int)m_pages.size() - 1);
+}
+
+/***********************************************************
+ *  GrowPage()
+ *
+ *  This method is used for moving a full page into a new
+ *  array with twice the layers. Array textures can't be
+ *  resized, so the layers in use are copied across on the
+ *  GPU and the old array is deleted.
+ ***********************************************************/
+void TextureArrays::GrowPage(ARRAY_PAGE& page)
+{
+	// the old array is deleted when its handle goes out of scope
+	GLTexture oldArray = std::move(page.array);
+	page.layerCapacity = std::min(page.layerCapacity * 2, m_maxLayers);
+	CreateArray(page);
+
+	int levelWidth = page.width;
+	int levelHeight = page.height;
+	for (int level = 0; level < page.levelCount; level++)
+	{
+		glCopyImageSubData(
+			oldArray.Get(), GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+			page.array.Get(), GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+			levelWidth, levelHeight, page.layerCount);
+
+		levelWidth = std::max(1, levelWidth / 2);
+		levelHeight = std::max(1, levelHeight / 2);
+	}
+}
+
+/***********************************************************
+ *  CreateArray()
+ *
+ *  This method is used for creating the array texture of the
+ *  passed in page, with its size, format, mip levels and
+ *  layer capacity, sampled the same way as the 2D textures.
+ ***********************************************************/
+void TextureArrays::CreateArray(ARRAY_PAGE& page)
+{
+	GLint boundArray = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &boundArray);
+
+	page.array.Create();
+	page.array.SetMemorySize(page.layerSize * page.layerCapacity);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, page.array.Get());
+	glTexStorage3D(
+		GL_TEXTURE_2D_ARRAY,
+		page.levelCount,
+		page.internalFormat,
+		page.width,
+		page.height,
+		page.layerCapacity);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	// set texture filtering parameters, minified textures read the mipmaps
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, boundArray);
+}
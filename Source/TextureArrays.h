@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturearrays.h
+// ============
+// pack the scene textures into array texture pages grouped by size and format
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLResources.h"
+
+#include <GL/glew.h>
+
+#include <vector>
+
+// where a texture was packed, the page is bound to its own
+// texture unit and the layer is picked per draw or per instance
+struct TEXTURE_LAYER
+{
+	int page;
+	int layer;
+};
+
+/***********************************************************
+ *  TextureArrays
+ *
+ *  This class holds the scene textures in GL_TEXTURE_2D_ARRAY
+ *  pages, one page for every texture size and format in use.
+ *  Textures are copied into a free layer of their page on the
+ *  GPU, with all of their mip levels, and the pages grow as
+ *  layers are added. Removed textures leave their layer free
+ *  for the next texture of the page, since the arrays never
+ *  shrink. Objects whose textures share a page can
+ *  be drawn together, each instance picking its own layer.
+ ***********************************************************/
+class TextureArrays
+{
+public:
+	// the most pages kept, each one takes a texture unit
+	static const int MAX_PAGES = 32;
+
+	// constructor
+	TextureArrays();
+	// destructor
+	~TextureArrays();
+
+	// check if the GL context can create and copy into the pages
+	static bool IsSupported();
+
+	// copy every mip level of a complete 2D texture into a layer
+	// of the page for its size and format, false if it can't be
+	bool AddTexture(GLuint textureID, TEXTURE_LAYER& location);
+	// free the layer of a texture added before, for reuse
+	void RemoveTexture(const TEXTURE_LAYER& location);
+	// get the bytes a layer of the passed in page takes
+	GLsizeiptr GetLayerSize(int page) const;
+	// bind every page to the unit firstUnit plus its page index
+	void BindPages(int firstUnit) const;
+	// get the number of pages in use
+	int GetPageCount() const;
+	// get the bytes of texture memory the pages take up
+	GLsizeiptr GetMemorySize() const;
+
+private:
+	// a single array texture holding textures of one size and format
+	struct ARRAY_PAGE
+	{
+		GLTexture array;
+		GLenum internalFormat;
+		int width;
+		int height;
+		int levelCount;
+		int layerCount;
+		int layerCapacity;
+		GLsizeiptr layerSize;
+		// layers below the layer count whose texture was removed
+		std::vector<int> freeLayers;
+	};
+
+	std::vector<ARRAY_PAGE> m_pages;
+	// limits of the GL context, read on the first texture added
+	int m_maxLayers;
+	int m_maxPages;
+
+	// find a page of the passed in size and format with a free
+	// layer, creating one when there is none, or -1
+	int FindPage(GLenum internalFormat, int width, int height, int levelCount, GLsizeiptr layerSize);
+	// move a page into a new array with twice the layers
+	void GrowPage(ARRAY_PAGE& page);
+	// create the array of the page with the size of the page
+	static void CreateArray(ARRAY_PAGE& page);
+};
@@ -0,0 +1,621 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.cpp
+// ============
+// convert texture images to block compressed mip chains and cache them on disk
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCache.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#define MAKE_DIRECTORY(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define MAKE_DIRECTORY(path) mkdir(path, 0755)
+#endif
+
+// declaration of the cache file layout
+namespace
+{
+	// folder the compressed images are written to, relative to
+	// the working directory the textures are loaded from
+	const char* CACHE_FOLDER = "TextureCache";
+
+	// "BCTX" in the first four bytes of every cache file
+	const uint32_t CACHE_MAGIC = 0x58544342;
+
+	// raise this whenever the encoder or the layout changes, so
+	// the images cached by older builds are converted again
+	const uint32_t CACHE_VERSION = 1;
+
+	// the fixed part at the start of every cache file, followed by
+	// the offset and size of each level, then the level data
+	struct CACHE_HEADER
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sourceHash;
+		uint32_t format;
+		int32_t width;
+		int32_t height;
+		int32_t channels;
+		int32_t levelCount;
+		uint32_t dataSize;
+	};
+
+	/***********************************************************
+	 *  PackColor()
+	 *
+	 *  Pack an 8 bit per channel color into 5:6:5 bits.
+	 ***********************************************************/
+	uint16_t PackColor(const int color[3])
+	{
+		return((uint16_t)(((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3)));
+	}
+
+	/***********************************************************
+	 *  UnpackColor()
+	 *
+	 *  Expand a 5:6:5 color back to 8 bits per channel, the
+	 *  same way the GPU does when it decodes the block.
+	 ***********************************************************/
+	void UnpackColor(uint16_t packed, int color[3])
+	{
+		int red = (packed >> 11) & 31;
+		int green = (packed >> 5) & 63;
+		int blue = packed & 31;
+		color[0] = (red << 3) | (red >> 2);
+		color[1] = (green << 2) | (green >> 4);
+		color[2] = (blue << 3) | (blue >> 2);
+	}
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking if compressed images can
+ *  be uploaded. S3TC is exposed by every desktop driver that
+ *  runs this project, but the check keeps the uncompressed
+ *  path working without it.
+ ***********************************************************/
+bool TextureCache::IsSupported()
+{
+	return(GLEW_EXT_texture_compression_s3tc == GL_TRUE);
+}
+
+/***********************************************************
+ *  LoadImage()
+ *
+ *  This method is used for getting the compressed image of
+ *  the passed in image file. The file is hashed and the cache
+ *  file for that hash is read when it is valid. Otherwise the
+ *  file is decoded, converted and written to the cache, so
+ *  only the first run pays for the conversion. A changed
+ *  image file has a new hash and is converted again.
+ ***********************************************************/
+bool TextureCache::LoadImage(const std::string& filename, COMPRESSED_IMAGE& image)
+{
+	std::ifstream sourceFile(filename, std::ios::binary | std::ios::ate);
+	if (!sourceFile)
+	{
+		return(false);
+	}
+
+	std::vector<unsigned char> sourceBytes((size_t)sourceFile.tellg());
+	sourceFile.seekg(0);
+	if (!sourceFile.read((char*)sourceBytes.data(), sourceBytes.size()))
+	{
+		return(false);
+	}
+
+	uint64_t sourceHash = HashBytes(sourceBytes);
+	std::string cachePath = GetCachePath(sourceHash);
+	if (ReadCacheFile(cachePath, sourceHash, image))
+	{
+		return(true);
+	}
+
+	// the decode always asks for RGBA, the channel count of the
+	// file still picks between the BC1 and BC3 formats
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	unsigned char* pixels = stbi_load_from_memory(
+		sourceBytes.data(),
+		(int)sourceBytes.size(),
+		&width,
+		&height,
+		&channels,
+		4);
+	if (pixels == NULL)
+	{
+		return(false);
+	}
+
+	CompressImage(pixels, width, height, channels, image);
+	stbi_image_free(pixels);
+
+	// a cache that can't be written only means the image is
+	// converted again on the next run
+	MAKE_DIRECTORY(CACHE_FOLDER);
+	WriteCacheFile(cachePath, sourceHash, image);
+
+	return(true);
+}
+
+/***********************************************************
+ *  UploadImage()
+ *
+ *  This method is used for uploading every level of the
+ *  compressed image into the bound texture. The levels are
+ *  already compressed, so the driver copies them as they are
+ *  and no mipmaps are generated on the GPU.
+ ***********************************************************/
+void TextureCache::UploadImage(const COMPRESSED_IMAGE& image, const unsigned char* pixels)
+{
+	int width = image.width;
+	int height = image.height;
+	int levelCount = (int)image.levelSizes.size();
+
+	for (int level = 0; level < levelCount; level++)
+	{
+		glCompressedTexImage2D(
+			GL_TEXTURE_2D,
+			level,
+			image.format,
+			width,
+			height,
+			0,
+			image.levelSizes[level],
+			pixels + image.levelOffsets[level]);
+
+		width = (width > 1) ? width / 2 : 1;
+		height = (height > 1) ? height / 2 : 1;
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+}
+
+/***********************************************************
+ *  HashBytes()
+ *
+ *  This method is used for hashing the contents of an image
+ *  file, which keys its cache file.
+ ***********************************************************/
+uint64_t TextureCache::HashBytes(const std::vector<unsigned char>& bytes)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (unsigned char value : bytes)
+	{
+		hash ^= value;
+		hash *= 1099511628211ULL;
+	}
+	return(hash);
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method is used for getting the cache file name of a
+ *  hash, which is the hash written out in hexadecimal.
+ ***********************************************************/
+std::string TextureCache::GetCachePath(uint64_t sourceHash)
+{
+	std::ostringstream path;
+	path << CACHE_FOLDER << "/" << std::hex;
+	path.width(16);
+	path.fill('0');
+	path << sourceHash << ".bctx";
+	return(path.str());
+}
+
+/***********************************************************
+ *  ReadCacheFile()
+ *
+ *  This method is used for reading a compressed image from
+ *  its cache file. The header has to match the hash and the
+ *  cache version, and every level has to lie inside the data
+ *  that was read, or the file is treated as missing.
+ ***********************************************************/
+bool TextureCache::ReadCacheFile(const std::string& path, uint64_t sourceHash, COMPRESSED_IMAGE& image)
+{
+	std::ifstream cacheFile(path, std::ios::binary);
+	if (!cacheFile)
+	{
+		return(false);
+	}
+
+	CACHE_HEADER header;
+	if (!cacheFile.read((char*)&header, sizeof(header)))
+	{
+		return(false);
+	}
+
+	if ((header.magic != CACHE_MAGIC) ||
+		(header.version != CACHE_VERSION) ||
+		(header.sourceHash != sourceHash) ||
+		(header.levelCount <= 0) ||
+		(header.levelCount > 32))
+	{
+		return(false);
+	}
+
+	image.format = header.format;
+	image.width = header.width;
+	image.height = header.height;
+	image.channels = header.channels;
+	image.levelOffsets.resize(header.levelCount);
+	image.levelSizes.resize(header.levelCount);
+	image.data.resize(header.dataSize);
+
+	for (int level = 0; level < header.levelCount; level++)
+	{
+		cacheFile.read((char*)&image.levelOffsets[level], sizeof(GLsizei));
+		cacheFile.read((char*)&image.levelSizes[level], sizeof(GLsizei));
+		if ((image.levelOffsets[level] < 0) ||
+			(image.levelSizes[level] <= 0) ||
+			((uint32_t)image.levelOffsets[level] + (uint32_t)image.levelSizes[level] > header.dataSize))
+		{
+			return(false);
+		}
+	}
+
+	if (!cacheFile.read((char*)image.data.data(), header.dataSize))
+	{
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteCacheFile()
+ *
+ *  This method is used for writing a compressed image to its
+ *  cache file. Two workers converting the same image write
+ *  the same bytes, so whichever rename lands last is fine.
+ ***********************************************************/
+bool TextureCache::WriteCacheFile(const std::string& path, uint64_t sourceHash, const COMPRESSED_IMAGE& image)
+{
+	CACHE_HEADER header;
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.sourceHash = sourceHash;
+	header.format = image.format;
+	header.width = image.width;
+	header.height = image.height;
+	header.channels = image.channels;
+	header.levelCount = (int32_t)image.levelSizes.size();
+	header.dataSize = (uint32_t)image.data.size();
+
+	// the temporary name is unique to the converting worker
+	std::ostringstream temporaryPath;
+	temporaryPath << path << "." << std::hex << (uintptr_t)&image << ".tmp";
+
+	{
+		std::ofstream cacheFile(temporaryPath.str(), std::ios::binary | std::ios::trunc);
+		if (!cacheFile)
+		{
+			return(false);
+		}
+
+		cacheFile.write((const char*)&header, sizeof(header));
+		for (int level = 0; level < header.levelCount; level++)
+		{
+			cacheFile.write((const char*)&image.levelOffsets[level], sizeof(GLsizei));
+			cacheFile.write((const char*)&image.levelSizes[level], sizeof(GLsizei));
+		}
+		cacheFile.write((const char*)image.data.data(), image.data.size());
+
+		if (!cacheFile)
+		{
+			cacheFile.close();
+			std::remove(temporaryPath.str().c_str());
+			return(false);
+		}
+	}
+
+	// rename does not replace an existing file on every platform
+	std::remove(path.c_str());
+	if (std::rename(temporaryPath.str().c_str(), path.c_str()) != 0)
+	{
+		std::remove(temporaryPath.str().c_str());
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompressImage()
+ *
+ *  This method is used for building the mip chain of the
+ *  decoded RGBA pixels, down to 1x1, and compressing every
+ *  level. Images with alpha are stored as BC3, the others as
+ *  BC1 at half the size.
+ ***********************************************************/
+void TextureCache::CompressImage(const unsigned char* pixels, int width, int height, int channels, COMPRESSED_IMAGE& image)
+{
+	bool bAlpha = (channels == 2) || (channels == 4);
+	int blockSize = bAlpha ? 16 : 8;
+
+	image.format = bAlpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	image.width = width;
+	image.height = height;
+	image.channels = channels;
+	image.data.clear();
+	image.levelOffsets.clear();
+	image.levelSizes.clear();
+
+	std::vector<unsigned char> level(pixels, pixels + (size_t)width * height * 4);
+	std::vector<unsigned char> nextLevel;
+
+	while (true)
+	{
+		int blocksWide = (width + 3) / 4;
+		int blocksHigh = (height + 3) / 4;
+		GLsizei levelSize = blocksWide * blocksHigh * blockSize;
+		GLsizei levelOffset = (GLsizei)image.data.size();
+
+		image.levelOffsets.push_back(levelOffset);
+		image.levelSizes.push_back(levelSize);
+		image.data.resize(levelOffset + levelSize);
+		CompressLevel(level.data(), width, height, bAlpha, image.data.data() + levelOffset);
+
+		if ((width == 1) && (height == 1))
+		{
+			break;
+		}
+
+		DownsampleImage(level, width, height, nextLevel);
+		level.swap(nextLevel);
+		width = (width > 1) ? width / 2 : 1;
+		height = (height > 1) ? height / 2 : 1;
+	}
+}
+
+/***********************************************************
+ *  DownsampleImage()
+ *
+ *  This method is used for halving an RGBA image, averaging
+ *  each 2x2 square of pixels. A side that is already 1 pixel
+ *  or odd reuses its last row or column.
+ ***********************************************************/
+void TextureCache::DownsampleImage(const std::vector<unsigned char>& source, int width, int height, std::vector<unsigned char>& target)
+{
+	int targetWidth = (width > 1) ? width / 2 : 1;
+	int targetHeight = (height > 1) ? height / 2 : 1;
+	target.resize((size_t)targetWidth * targetHeight * 4);
+
+	for (int y = 0; y < targetHeight; y++)
+	{
+		int row0 = std::min(y * 2, height - 1);
+		int row1 = std::min(y * 2 + 1, height - 1);
+		for (int x = 0; x < targetWidth; x++)
+		{
+			int column0 = std::min(x * 2, width - 1);
+			int column1 = std::min(x * 2 + 1, width - 1);
+			for (int channel = 0; channel < 4; channel++)
+			{
+				int sum =
+					source[((size_t)row0 * width + column0) * 4 + channel] +
+					source[((size_t)row0 * width + column1) * 4 + channel] +
+					source[((size_t)row1 * width + column0) * 4 + channel] +
+					source[((size_t)row1 * width + column1) * 4 + channel];
+				target[((size_t)y * targetWidth + x) * 4 + channel] = (unsigned char)((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  CompressLevel()
+ *
+ *  This method is used for compressing one mip level, one
+ *  4x4 block at a time. Blocks hanging over the right or top
+ *  edge repeat the edge pixels.
+ ***********************************************************/
+void TextureCache::CompressLevel(const unsigned char* pixels, int width, int height, bool bAlpha, unsigned char* blocks)
+{
+	unsigned char texels[64];
+
+	for (int blockY = 0; blockY < height; blockY += 4)
+	{
+		for (int blockX = 0; blockX < width; blockX += 4)
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				int x = std::min(blockX + (i % 4), width - 1);
+				int y = std::min(blockY + (i / 4), height - 1);
+				memcpy(&texels[i * 4], &pixels[((size_t)y * width + x) * 4], 4);
+			}
+
+			if (bAlpha)
+			{
+				CompressAlphaBlock(texels, blocks);
+				blocks += 8;
+			}
+			CompressColorBlock(texels, blocks);
+			blocks += 8;
+		}
+	}
+}
+
+/***********************************************************
+ *  CompressColorBlock()
+ *
+ *  This method is used for compressing the colors of a block
+ *  to two 5:6:5 end colors and a 2 bit index per texel. The
+ *  ends are the corners of the box around the colors, on the
+ *  diagonal that follows how red and blue change with green,
+ *  pulled in by a sixteenth so the ends are not wasted on
+ *  outliers. Each texel takes the nearest of the four colors.
+ ***********************************************************/
+void TextureCache::CompressColorBlock(const unsigned char texels[64], unsigned char* block)
+{
+	int minimum[3] = { 255, 255, 255 };
+	int maximum[3] = { 0, 0, 0 };
+	int sum[3] = { 0, 0, 0 };
+
+	for (int i = 0; i < 16; i++)
+	{
+		for (int channel = 0; channel < 3; channel++)
+		{
+			int value = texels[i * 4 + channel];
+			minimum[channel] = std::min(minimum[channel], value);
+			maximum[channel] = std::max(maximum[channel], value);
+			sum[channel] += value;
+		}
+	}
+
+	// flip red or blue when it falls as green rises
+	int covarianceRed = 0;
+	int covarianceBlue = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int green = texels[i * 4 + 1] * 16 - sum[1];
+		covarianceRed += (texels[i * 4 + 0] * 16 - sum[0]) * green;
+		covarianceBlue += (texels[i * 4 + 2] * 16 - sum[2]) * green;
+	}
+	if (covarianceRed < 0)
+	{
+		int swap = minimum[0];
+		minimum[0] = maximum[0];
+		maximum[0] = swap;
+	}
+	if (covarianceBlue < 0)
+	{
+		int swap = minimum[2];
+		minimum[2] = maximum[2];
+		maximum[2] = swap;
+	}
+
+	int end0[3];
+	int end1[3];
+	for (int channel = 0; channel < 3; channel++)
+	{
+		int inset = (maximum[channel] - minimum[channel]) / 16;
+		end0[channel] = maximum[channel] - inset;
+		end1[channel] = minimum[channel] + inset;
+	}
+
+	uint16_t color0 = PackColor(end0);
+	uint16_t color1 = PackColor(end1);
+
+	// the four color mode needs the first end to be the larger
+	if (color0 < color1)
+	{
+		uint16_t swap = color0;
+		color0 = color1;
+		color1 = swap;
+	}
+
+	uint32_t indices = 0;
+	if (color0 != color1)
+	{
+		int palette[4][3];
+		UnpackColor(color0, palette[0]);
+		UnpackColor(color1, palette[1]);
+		for (int channel = 0; channel < 3; channel++)
+		{
+			palette[2][channel] = (palette[0][channel] * 2 + palette[1][channel]) / 3;
+			palette[3][channel] = (palette[0][channel] + palette[1][channel] * 2) / 3;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			int nearest = 0;
+			int nearestDistance = INT_MAX;
+			for (int entry = 0; entry < 4; entry++)
+			{
+				int distance = 0;
+				for (int channel = 0; channel < 3; channel++)
+				{
+					int difference = texels[i * 4 + channel] - palette[entry][channel];
+					distance += difference * difference;
+				}
+				if (distance < nearestDistance)
+				{
+					nearest = entry;
+					nearestDistance = distance;
+				}
+			}
+			indices |= (uint32_t)nearest << (i * 2);
+		}
+	}
+
+	block[0] = (unsigned char)(color0 & 0xFF);
+	block[1] = (unsigned char)(color0 >> 8);
+	block[2] = (unsigned char)(color1 & 0xFF);
+	block[3] = (unsigned char)(color1 >> 8);
+	block[4] = (unsigned char)(indices & 0xFF);
+	block[5] = (unsigned char)((indices >> 8) & 0xFF);
+	block[6] = (unsigned char)((indices >> 16) & 0xFF);
+	block[7] = (unsigned char)(indices >> 24);
+}
+
+/***********************************************************
+ *  CompressAlphaBlock()
+ *
+ *  This method is used for compressing the alpha of a block
+ *  to two end values and a 3 bit index per texel, picking
+ *  the nearest of the eight values between the ends.
+ ***********************************************************/
+void TextureCache::CompressAlphaBlock(const unsigned char texels[64], unsigned char* block)
+{
+	int alpha0 = 0;
+	int alpha1 = 255;
+	for (int i = 0; i < 16; i++)
+	{
+		alpha0 = std::max(alpha0, (int)texels[i * 4 + 3]);
+		alpha1 = std::min(alpha1, (int)texels[i * 4 + 3]);
+	}
+
+	uint64_t indices = 0;
+	if (alpha0 != alpha1)
+	{
+		int palette[8];
+		palette[0] = alpha0;
+		palette[1] = alpha1;
+		for (int entry = 2; entry < 8; entry++)
+		{
+			palette[entry] = ((8 - entry) * alpha0 + (entry - 1) * alpha1) / 7;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			int nearest = 0;
+			int nearestDistance = INT_MAX;
+			for (int entry = 0; entry < 8; entry++)
+			{
+				int distance = abs(texels[i * 4 + 3] - palette[entry]);
+				if (distance < nearestDistance)
+				{
+					nearest = entry;
+					nearestDistance = distance;
+				}
+			}
+			indices |= (uint64_t)nearest << (i * 3);
+		}
+	}
+
+	block[0] = (unsigned char)alpha0;
+	block[1] = (unsigned char)alpha1;
+	for (int i = 0; i < 6; i++)
+	{
+		block[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xFF);
+	}
+}
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.h
+// ============
+// convert texture images to block compressed mip chains and cache them on disk
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// an image compressed to BC1 or BC3 blocks, with every mip level
+// down to 1x1 stored back to back in one buffer
+struct COMPRESSED_IMAGE
+{
+	GLenum format;
+	int width;
+	int height;
+	int channels;
+	std::vector<unsigned char> data;
+	std::vector<GLsizei> levelOffsets;
+	std::vector<GLsizei> levelSizes;
+};
+
+/***********************************************************
+ *  TextureCache
+ *
+ *  This class turns texture image files into block
+ *  compressed images with a full mip chain. The first time
+ *  an image file is loaded it is decoded, mipmapped and
+ *  compressed on the CPU, and the result is written to the
+ *  cache folder under the hash of the file contents. Later
+ *  loads read the compressed levels straight from the cache,
+ *  skipping the decode. Loading makes no OpenGL calls, so it
+ *  can run on the texture loader worker threads.
+ ***********************************************************/
+class TextureCache
+{
+public:
+	// check if the GL context can sample S3TC compressed textures
+	static bool IsSupported();
+	// load the compressed image of the passed in image file from
+	// the cache, converting and caching it first when needed
+	static bool LoadImage(const std::string& filename, COMPRESSED_IMAGE& image);
+	// upload every level of the image into the bound texture, from
+	// the passed in pointer, or offset when an unpack buffer is bound
+	static void UploadImage(const COMPRESSED_IMAGE& image, const unsigned char* pixels);
+
+private:
+	// hash the passed in bytes with 64 bit FNV-1a
+	static uint64_t HashBytes(const std::vector<unsigned char>& bytes);
+	// get the path of the cache file for the passed in hash
+	static std::string GetCachePath(uint64_t sourceHash);
+	// read a cache file, failing if it is missing, from another
+	// source file, or written by an older version of the cache
+	static bool ReadCacheFile(const std::string& path, uint64_t sourceHash, COMPRESSED_IMAGE& image);
+	// write a cache file, through a temporary file so a partly
+	// written cache is never read
+	static bool WriteCacheFile(const std::string& path, uint64_t sourceHash, const COMPRESSED_IMAGE& image);
+	// build the mip chain of decoded RGBA pixels and compress it
+	static void CompressImage(const unsigned char* pixels, int width, int height, int channels, COMPRESSED_IMAGE& image);
+	// halve an RGBA image with a box filter
+	static void DownsampleImage(const std::vector<unsigned char>& source, int width, int height, std::vector<unsigned char>& target);
+	// compress one level of RGBA pixels into 4x4 blocks
+	static void CompressLevel(const unsigned char* pixels, int width, int height, bool bAlpha, unsigned char* blocks);
+	// compress the colors of a 4x4 block into an 8 byte BC1 block
+	static void CompressColorBlock(const unsigned char texels[64], unsigned char* block);
+	// compress the alpha of a 4x4 block into an 8 byte BC3 alpha block
+	static void CompressAlphaBlock(const unsigned char texels[64], unsigned char* block);
+};
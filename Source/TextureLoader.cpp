@@ -0,0 +1,535 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// ============
+// decode texture images on worker threads and upload them on the GL thread
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+#include "stb_image.h"
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+// declaration of the loader settings
+namespace
+{
+	// size of each half of the staging buffer, images larger than
+	// this are uploaded straight from client memory instead
+	const GLsizeiptr STAGING_HALF_SIZE = 16 * 1024 * 1024;
+
+	// staged images start on this alignment inside the buffer
+	const GLsizeiptr STAGING_ALIGNMENT = 256;
+
+	// color of the single texel shown until an image is ready
+	const unsigned char PLACEHOLDER_TEXEL[4] = { 128, 128, 128, 255 };
+}
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader(int workerCount)
+{
+	m_workerCount = workerCount;
+	if (m_workerCount <= 0)
+	{
+		// leave one hardware thread for the GL thread
+		m_workerCount = (int)std::thread::hardware_concurrency() - 1;
+		if (m_workerCount < 1)
+		{
+			m_workerCount = 1;
+		}
+	}
+
+	m_bStopping = false;
+	m_pendingCount = 0;
+	m_bUseTextureCache = false;
+
+	m_pStagingMemory = NULL;
+	m_stagingHalfSize = 0;
+	m_stagingHalf = 0;
+	m_stagingFences[0] = 0;
+	m_stagingFences[1] = 0;
+	m_bStagingChecked = false;
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class. The workers are stopped
+ *  and any image that was never uploaded is freed.
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+		m_jobs.clear();
+	}
+	m_jobReady.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+
+	for (DECODED_IMAGE& image : m_decoded)
+	{
+		stbi_image_free(image.data);
+	}
+	m_decoded.clear();
+
+	for (int half = 0; half < 2; half++)
+	{
+		if (m_stagingFences[half] != 0)
+		{
+			glDeleteSync(m_stagingFences[half]);
+		}
+	}
+	if (m_stagingBuffer.Get() != 0)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer.Get());
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		m_stagingBuffer.Reset();
+	}
+}
+
+/***********************************************************
+ *  Queue()
+ *
+ *  This method is used for creating the texture that the
+ *  passed in image file will be loaded into, and queuing the
+ *  file for the worker threads. Until the image is uploaded
+ *  the texture holds a single grey placeholder texel.
+ ***********************************************************/
+GLuint TextureLoader::Queue(const std::string& filename)
+{
+	GLuint textureID = GLResourceRegistry::CreateName(GL_RESOURCE_TEXTURE);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	// set texture filtering parameters, minified textures read the mipmaps
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// the placeholder has no mipmaps, so its last level is 0 to keep
+	// it complete under the mipmapped filters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, PLACEHOLDER_TEXEL);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	GLResourceRegistry::SetMemorySize(GL_RESOURCE_TEXTURE, textureID, sizeof(PLACEHOLDER_TEXEL));
+
+	StartWorkers();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		LOAD_JOB job;
+		job.textureID = textureID;
+		job.filename = filename;
+		m_jobs.push_back(job);
+		m_pendingCount++;
+	}
+	m_jobReady.notify_one();
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for uploading the images that the
+ *  workers have decoded, and is called once per frame on the
+ *  GL thread. The images are copied into the staging half
+ *  the GPU is not reading from, until that half is full, so
+ *  a burst of finished images is spread over a few frames.
+ ***********************************************************/
+int TextureLoader::Update(std::vector<GLuint>* pUploadedTextures)
+{
+	if (!m_bStagingChecked)
+	{
+		CreateStagingBuffer();
+		m_bStagingChecked = true;
+	}
+
+	int uploadedCount = 0;
+	GLsizeiptr stagingUsed = 0;
+	bool bHalfReady = false;
+
+	while (true)
+	{
+		DECODED_IMAGE image;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_decoded.empty())
+			{
+				break;
+			}
+			image = std::move(m_decoded.front());
+			m_decoded.pop_front();
+		}
+
+		// compressed images are staged with all of their levels
+		const unsigned char* imageData = image.data;
+		GLsizeiptr imageSize = (GLsizeiptr)image.width * image.height * image.channels;
+		if (image.bCompressed)
+		{
+			imageData = image.compressed.data.data();
+			imageSize = (GLsizeiptr)image.compressed.data.size();
+		}
+
+		GLsizeiptr stagingOffset = -1;
+		if ((imageData != NULL) && (m_pStagingMemory != NULL))
+		{
+			if (imageSize <= m_stagingHalfSize)
+			{
+				if (stagingUsed + imageSize > m_stagingHalfSize)
+				{
+					// this half is full, the image waits for the next frame
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_decoded.push_front(std::move(image));
+					break;
+				}
+
+				// the GPU may still be reading this half from two frames ago
+				if (!bHalfReady)
+				{
+					WaitForStagingHalf(m_stagingHalf);
+					bHalfReady = true;
+				}
+
+				stagingOffset = m_stagingHalf * m_stagingHalfSize + stagingUsed;
+				memcpy(m_pStagingMemory + stagingOffset, imageData, imageSize);
+				stagingUsed += (imageSize + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+			}
+		}
+
+		if (UploadImage(image, stagingOffset) && (pUploadedTextures != NULL))
+		{
+			pUploadedTextures->push_back(image.textureID);
+		}
+		stbi_image_free(image.data);
+		uploadedCount++;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pendingCount--;
+		}
+		m_imageReady.notify_all();
+	}
+
+	// fence the half that was just filled and switch to the other
+	if (stagingUsed > 0)
+	{
+		m_stagingFences[m_stagingHalf] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_stagingHalf = 1 - m_stagingHalf;
+	}
+
+	return(uploadedCount);
+}
+
+/***********************************************************
+ *  Finish()
+ *
+ *  This method is used for blocking until every queued image
+ *  has been decoded and uploaded, for callers that need all
+ *  of the textures before they go on.
+ ***********************************************************/
+void TextureLoader::Finish(std::vector<GLuint>* pUploadedTextures)
+{
+	while (true)
+	{
+		Update(pUploadedTextures);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_pendingCount == 0)
+		{
+			break;
+		}
+		m_imageReady.wait(lock, [this]()
+			{
+				return(!m_decoded.empty() || (m_pendingCount == 0));
+			});
+	}
+}
+
+/***********************************************************
+ *  GetPendingCount()
+ *
+ *  This method is used for getting the number of queued
+ *  images that still show the placeholder.
+ ***********************************************************/
+int TextureLoader::GetPendingCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return(m_pendingCount);
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is run by every worker thread. It takes the
+ *  next queued image file, loads its compressed image from
+ *  the texture cache or decodes it, and hands the result to
+ *  the GL thread. Workers make no OpenGL calls.
+ ***********************************************************/
+void TextureLoader::WorkerLoop()
+{
+	while (true)
+	{
+		LOAD_JOB job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobReady.wait(lock, [this]()
+				{
+					return(m_bStopping || !m_jobs.empty());
+				});
+			if (m_bStopping)
+			{
+				return;
+			}
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		DECODED_IMAGE image;
+		image.textureID = job.textureID;
+		image.filename = job.filename;
+		image.width = 0;
+		image.height = 0;
+		image.channels = 0;
+		image.data = NULL;
+		image.bCompressed = false;
+
+		if (m_bUseTextureCache)
+		{
+			image.bCompressed = TextureCache::LoadImage(job.filename, image.compressed);
+		}
+
+		if (image.bCompressed)
+		{
+			image.width = image.compressed.width;
+			image.height = image.compressed.height;
+			image.channels = image.compressed.channels;
+		}
+		else
+		{
+			image.data = stbi_load(
+				job.filename.c_str(),
+				&image.width,
+				&image.height,
+				&image.channels,
+				0);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_decoded.push_back(std::move(image));
+		}
+		m_imageReady.notify_all();
+	}
+}
+
+/***********************************************************
+ *  StartWorkers()
+ *
+ *  This method is used for starting the worker threads the
+ *  first time an image is queued.
+ ***********************************************************/
+void TextureLoader::StartWorkers()
+{
+	if (!m_workers.empty())
+	{
+		return;
+	}
+
+	// the flip setting is shared by all of the workers
+	stbi_set_flip_vertically_on_load(true);
+
+	// the extension check needs the GL thread, so it is made once
+	// here before any worker can read the setting
+	m_bUseTextureCache = TextureCache::IsSupported();
+
+	for (int i = 0; i < m_workerCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureLoader::WorkerLoop, this));
+	}
+}
+
+/***********************************************************
+ *  CreateStagingBuffer()
+ *
+ *  This method is used for creating the staging buffer and
+ *  mapping it once for the life of the loader. Persistent
+ *  mapping needs OpenGL 4.4, without it the images are
+ *  uploaded from client memory.
+ ***********************************************************/
+void TextureLoader::CreateStagingBuffer()
+{
+	if (GLEW_VERSION_4_4 != GL_TRUE)
+	{
+		return;
+	}
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	m_stagingBuffer.Create();
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer.Get());
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, STAGING_HALF_SIZE * 2, NULL, flags);
+	m_pStagingMemory = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, STAGING_HALF_SIZE * 2, flags);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (m_pStagingMemory == NULL)
+	{
+		std::cout << "Could not map the texture staging buffer" << std::endl;
+		m_stagingBuffer.Reset();
+		return;
+	}
+
+	m_stagingBuffer.SetMemorySize(STAGING_HALF_SIZE * 2);
+
+	m_stagingHalfSize = STAGING_HALF_SIZE;
+}
+
+/***********************************************************
+ *  WaitForStagingHalf()
+ *
+ *  This method is used for waiting on the fence placed after
+ *  the last uploads from the passed in half, so its memory
+ *  can be written again.
+ ***********************************************************/
+void TextureLoader::WaitForStagingHalf(int half)
+{
+	if (m_stagingFences[half] == 0)
+	{
+		return;
+	}
+
+	GLenum result = GL_TIMEOUT_EXPIRED;
+	while ((result != GL_ALREADY_SIGNALED) && (result != GL_CONDITION_SATISFIED) && (result != GL_WAIT_FAILED))
+	{
+		result = glClientWaitSync(m_stagingFences[half], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+
+	glDeleteSync(m_stagingFences[half]);
+	m_stagingFences[half] = 0;
+}
+
+/***********************************************************
+ *  UploadImage()
+ *
+ *  This method is used for replacing the placeholder of a
+ *  texture with its loaded image. Compressed images bring
+ *  their own mip chain, decoded images have their mipmaps
+ *  generated. Images that could not be loaded, or that have
+ *  an unsupported channel count, keep the placeholder.
+ ***********************************************************/
+bool TextureLoader::UploadImage(const DECODED_IMAGE& image, GLsizeiptr stagingOffset)
+{
+	if (image.bCompressed)
+	{
+		return(UploadCompressedImage(image, stagingOffset));
+	}
+
+	if (image.data == NULL)
+	{
+		std::cout << "Could not load image:" << image.filename << std::endl;
+		return(false);
+	}
+
+	GLenum internalFormat = GL_RGB8;
+	GLenum format = GL_RGB;
+	if (image.channels == 4)
+	{
+		// the loaded image is in RGBA format - it supports transparency
+		internalFormat = GL_RGBA8;
+		format = GL_RGBA;
+	}
+	else if (image.channels != 3)
+	{
+		std::cout << "Not implemented to handle image with " << image.channels << " channels" << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.channels << std::endl;
+
+	// the pixel source is an offset into the staging buffer when
+	// it is bound, or the decoded image in client memory
+	const void* pixels = image.data;
+	if (stagingOffset >= 0)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer.Get());
+		pixels = (const void*)stagingOffset;
+	}
+
+	// decoded RGB rows are tightly packed
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	// the scene textures are already bound to their texture units,
+	// so the binding of the active unit is put back afterwards
+	GLint boundTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+
+	glBindTexture(GL_TEXTURE_2D, image.textureID);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+
+	// generate the texture mipmaps for mapping textures to lower resolutions,
+	// every level down to 1x1 now that the placeholder is replaced
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, boundTexture);
+
+	// drivers pad RGB8 out to 4 bytes a texel, and the mip chain
+	// adds a third on top of the full size level
+	GLResourceRegistry::SetMemorySize(GL_RESOURCE_TEXTURE, image.textureID, (GLsizeiptr)image.width * image.height * 4 * 4 / 3);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	if (stagingOffset >= 0)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  UploadCompressedImage()
+ *
+ *  This method is used for replacing the placeholder of a
+ *  texture with every level of its compressed image.
+ ***********************************************************/
+bool TextureLoader::UploadCompressedImage(const DECODED_IMAGE& image, GLsizeiptr stagingOffset)
+{
+	std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.channels << ", compressed" << std::endl;
+
+	const unsigned char* pixels = image.compressed.data.data();
+	if (stagingOffset >= 0)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer.Get());
+		pixels = (const unsigned char*)stagingOffset;
+	}
+
+	GLint boundTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+
+	glBindTexture(GL_TEXTURE_2D, image.textureID);
+	TextureCache::UploadImage(image.compressed, pixels);
+	glBindTexture(GL_TEXTURE_2D, boundTexture);
+	GLResourceRegistry::SetMemorySize(GL_RESOURCE_TEXTURE, image.textureID, image.compressed.data.size());
+
+	if (stagingOffset >= 0)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	return(true);
+}
@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture images on worker threads and upload them on the GL thread
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "GLResources.h"
+#include "TextureCache.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class decodes texture image files on a pool of
+ *  worker threads. Each queued texture gets an OpenGL texture
+ *  right away holding a single placeholder texel, so it can
+ *  be bound and drawn with before its image is ready. The
+ *  workers load block compressed images from the texture
+ *  cache when the driver supports them, and decode the files
+ *  otherwise. The images are uploaded on the GL thread by
+ *  Update(), through a persistent mapped pixel buffer when
+ *  available.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// constructor, 0 workers uses one per spare hardware thread
+	TextureLoader(int workerCount = 0);
+	// destructor
+	~TextureLoader();
+
+	// create a placeholder texture and queue its image file for
+	// decoding, the returned texture is filled in by Update() and
+	// is owned by the caller, who deletes it through a GLTexture
+	GLuint Queue(const std::string& filename);
+	// upload the images decoded since the last call, as many as
+	// fit in the staging buffer, and return how many were uploaded,
+	// the textures that got their image are added to the list
+	int Update(std::vector<GLuint>* pUploadedTextures = NULL);
+	// wait for every queued image to be decoded and uploaded, the
+	// textures that got their image are added to the list
+	void Finish(std::vector<GLuint>* pUploadedTextures = NULL);
+	// get the number of queued images that are not uploaded yet
+	int GetPendingCount();
+
+private:
+	// an image file waiting to be decoded
+	struct LOAD_JOB
+	{
+		GLuint textureID;
+		std::string filename;
+	};
+
+	// an image loaded by a worker, waiting to be uploaded, either
+	// decoded pixels or a compressed image from the texture cache
+	struct DECODED_IMAGE
+	{
+		GLuint textureID;
+		std::string filename;
+		int width;
+		int height;
+		int channels;
+		unsigned char* data;
+		bool bCompressed;
+		COMPRESSED_IMAGE compressed;
+	};
+
+	// worker threads and the queues shared with them
+	int m_workerCount;
+	std::vector<std::thread> m_workers;
+	std::deque<LOAD_JOB> m_jobs;
+	std::deque<DECODED_IMAGE> m_decoded;
+	std::mutex m_mutex;
+	std::condition_variable m_jobReady;
+	std::condition_variable m_imageReady;
+	bool m_bStopping;
+	int m_pendingCount;
+	// load compressed images through the texture cache
+	bool m_bUseTextureCache;
+
+	// persistent mapped staging buffer, split into two halves that
+	// are filled on alternate frames while the GPU reads the other
+	GLBuffer m_stagingBuffer;
+	unsigned char* m_pStagingMemory;
+	GLsizeiptr m_stagingHalfSize;
+	int m_stagingHalf;
+	GLsync m_stagingFences[2];
+	bool m_bStagingChecked;
+
+	// load queued image files until the loader is destroyed
+	void WorkerLoop();
+	// start the worker threads on the first queued image
+	void StartWorkers();
+	// create the staging buffer if persistent mapping is available
+	void CreateStagingBuffer();
+	// wait until the GPU has finished reading a staging half
+	void WaitForStagingHalf(int half);
+	// upload a decoded image into its texture, staging it at the
+	// passed in offset of the current half, or from client memory
+	// when the offset is negative, false if it kept the placeholder
+	bool UploadImage(const DECODED_IMAGE& image, GLsizeiptr stagingOffset);
+	// upload a compressed image into its texture, the same way
+	bool UploadCompressedImage(const DECODED_IMAGE& image, GLsizeiptr stagingOffset);
+};
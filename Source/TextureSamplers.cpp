@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturesamplers.cpp
+// ============
+// share OpenGL sampler objects between the materials that filter alike
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureSamplers.h"
+
+#include <algorithm>
+#include <utility>
+
+/***********************************************************
+ *  TextureSamplers()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureSamplers::TextureSamplers()
+{
+	m_maxSupportedAnisotropy = 0.0f;
+}
+
+/***********************************************************
+ *  ~TextureSamplers()
+ *
+ *  The destructor for the class, the sampler handles delete
+ *  the sampler objects
+ ***********************************************************/
+TextureSamplers::~TextureSamplers()
+{
+}
+
+/***********************************************************
+ *  FindSampler()
+ *
+ *  This method is used for getting the handle of the sampler
+ *  with the passed in settings. Materials asking for the same
+ *  settings share a sampler, so they can still be drawn in
+ *  the same batch.
+ ***********************************************************/
+int TextureSamplers::FindSampler(const SAMPLER_SETTINGS& settings)
+{
+	for (int i = 0; i < (int)m_samplers.size(); i++)
+	{
+		const SAMPLER_SETTINGS& existing = m_samplers[i].settings;
+		if ((existing.filter == settings.filter) &&
+			(existing.maxAnisotropy == settings.maxAnisotropy) &&
+			(existing.wrapMode == settings.wrapMode))
+		{
+			return(i);
+		}
+	}
+
+	SAMPLER sampler;
+	sampler.settings = settings;
+	CreateSampler(settings, sampler.sampler);
+	m_samplers.push_back(std::move(sampler));
+
+	return((int)m_samplers.size() - 1);
+}
+
+/***********************************************************
+ *  BindSampler()
+ *
+ *  This method is used for binding the sampler of the passed
+ *  in handle to a texture unit.
+ ***********************************************************/
+void TextureSamplers::BindSampler(int samplerHandle, GLuint unit) const
+{
+	GLuint samplerID = 0;
+	if ((samplerHandle >= 0) && (samplerHandle < (int)m_samplers.size()))
+	{
+		samplerID = m_samplers[samplerHandle].sampler.Get();
+	}
+
+	glBindSampler(unit, samplerID);
+}
+
+/***********************************************************
+ *  GetSamplerCount()
+ *
+ *  This method is used for getting the number of samplers.
+ ***********************************************************/
+int TextureSamplers::GetSamplerCount() const
+{
+	return((int)m_samplers.size());
+}
+
+/***********************************************************
+ *  CreateSampler()
+ *
+ *  This method is used for creating a sampler object. The
+ *  trilinear and anisotropic filters read the mip chain when
+ *  a surface is minified, which keeps distant and heavily
+ *  tiled surfaces from aliasing and reads far fewer texels.
+ *  Anisotropy is clamped to what the GL context supports.
+ ***********************************************************/
+void TextureSamplers::CreateSampler(const SAMPLER_SETTINGS& settings, GLSampler& sampler)
+{
+	if (m_maxSupportedAnisotropy == 0.0f)
+	{
+		m_maxSupportedAnisotropy = 1.0f;
+		if ((GLEW_EXT_texture_filter_anisotropic == GL_TRUE) ||
+			(GLEW_ARB_texture_filter_anisotropic == GL_TRUE))
+		{
+			glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &m_maxSupportedAnisotropy);
+		}
+	}
+
+	sampler.Create();
+	GLuint samplerID = sampler.Get();
+
+	// set the texture wrapping parameters
+	glSamplerParameteri(samplerID, GL_TEXTURE_WRAP_S, settings.wrapMode);
+	glSamplerParameteri(samplerID, GL_TEXTURE_WRAP_T, settings.wrapMode);
+
+	// set texture filtering parameters
+	GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;
+	if (settings.filter == FILTER_BILINEAR)
+	{
+		minFilter = GL_LINEAR;
+	}
+	glSamplerParameteri(samplerID, GL_TEXTURE_MIN_FILTER, minFilter);
+	glSamplerParameteri(samplerID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	if ((settings.filter == FILTER_ANISOTROPIC) && (m_maxSupportedAnisotropy > 1.0f))
+	{
+		float anisotropy = std::min(std::max(settings.maxAnisotropy, 1.0f), m_maxSupportedAnisotropy);
+		glSamplerParameterf(samplerID, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+	}
+}
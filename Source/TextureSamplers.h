@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturesamplers.h
+// ============
+// share OpenGL sampler objects between the materials that filter alike
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLResources.h"
+
+#include <GL/glew.h>
+
+#include <vector>
+
+// how a texture is filtered when it is minified
+enum TEXTURE_FILTER
+{
+	// the full size level only, how the textures were sampled before
+	FILTER_BILINEAR,
+	// blends the two mip levels nearest to the texel size
+	FILTER_TRILINEAR,
+	// trilinear, with extra samples along surfaces seen at an angle
+	FILTER_ANISOTROPIC
+};
+
+// the sampling state of a sampler object
+struct SAMPLER_SETTINGS
+{
+	TEXTURE_FILTER filter;
+	float maxAnisotropy;
+	GLenum wrapMode;
+};
+
+/***********************************************************
+ *  TextureSamplers
+ *
+ *  This class creates the OpenGL sampler objects that the
+ *  materials ask for, one for every distinct setting, and
+ *  binds them to the texture units. A sampler bound to a
+ *  unit overrides the filtering of whichever texture is on
+ *  that unit, so one set of samplers serves every texture.
+ ***********************************************************/
+class TextureSamplers
+{
+public:
+	// constructor
+	TextureSamplers();
+	// destructor
+	~TextureSamplers();
+
+	// get the sampler with the passed in settings, creating it
+	// the first time they are asked for
+	int FindSampler(const SAMPLER_SETTINGS& settings);
+	// bind a sampler to a texture unit, -1 puts back the
+	// filtering of the texture itself
+	void BindSampler(int samplerHandle, GLuint unit) const;
+	// get the number of samplers created
+	int GetSamplerCount() const;
+
+private:
+	struct SAMPLER
+	{
+		SAMPLER_SETTINGS settings;
+		GLSampler sampler;
+	};
+
+	std::vector<SAMPLER> m_samplers;
+	// the anisotropy limit of the GL context, 1 without the
+	// extension, read when the first sampler is created
+	float m_maxSupportedAnisotropy;
+
+	// create a sampler object with the passed in settings
+	void CreateSampler(const SAMPLER_SETTINGS& settings, GLSampler& sampler);
+};
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformbuffer.cpp
+// ============
+// manage the uniform buffer objects shared by all shader programs
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 14th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformBuffer.h"
+
+/***********************************************************
+ *  UniformBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformBuffer::UniformBuffer(GLuint bindingPoint)
+{
+	m_bindingPoint = bindingPoint;
+	m_size = 0;
+}
+
+/***********************************************************
+ *  ~UniformBuffer()
+ *
+ *  The destructor for the class, the buffer handle deletes
+ *  the uniform buffer
+ ***********************************************************/
+UniformBuffer::~UniformBuffer()
+{
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for uploading the passed in block
+ *  data into the uniform buffer. The buffer is created and
+ *  bound to its binding point on the first update, after
+ *  that the existing storage is overwritten in place.
+ ***********************************************************/
+void UniformBuffer::Update(const void* data, GLsizeiptr size)
+{
+	if (m_buffer.Get() == 0)
+	{
+		m_buffer.Create();
+		glBindBufferBase(GL_UNIFORM_BUFFER, m_bindingPoint, m_buffer.Get());
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_buffer.Get());
+	if (size != m_size)
+	{
+		// (re)allocate the storage when the block size changes
+		glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+		m_buffer.SetMemorySize(size);
+		m_size = size;
+	}
+	else
+	{
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformbuffer.h
+// ============
+// manage the uniform buffer objects shared by all shader programs
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 14th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLResources.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// the fixed binding points of the uniform blocks, every shader
+// program binds its blocks to these points so the data is shared
+enum UNIFORM_BLOCK_BINDING
+{
+	CAMERA_BLOCK_BINDING = 0,
+	LIGHT_BLOCK_BINDING = 1,
+	MATERIAL_BLOCK_BINDING = 2
+};
+
+// the fixed binding points of the shader storage blocks filled by
+// the light culling pass and read while shading
+enum STORAGE_BLOCK_BINDING
+{
+	LIGHT_LIST_STORAGE_BINDING = 0,
+	CLUSTER_GRID_STORAGE_BINDING = 1,
+	LIGHT_INDEX_STORAGE_BINDING = 2
+};
+
+// the number of light sources declared in the light block, the
+// clustered shading reads every scene light from the light list
+const int MAX_LIGHT_SOURCES = 4;
+// the number of materials declared in the material block
+const int MAX_OBJECT_MATERIALS = 64;
+
+// std140 layout of the CameraBlock uniform block
+struct CAMERA_BLOCK
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec4 viewPosition;
+};
+
+// std140 layout of a single LightSource in the light block, which
+// is also its std430 layout in the light list
+struct LIGHT_SOURCE_BLOCK
+{
+	glm::vec4 position;
+	glm::vec4 ambientColor;
+	glm::vec4 diffuseColor;
+	glm::vec4 specularColor;
+	float focalStrength;
+	float specularIntensity;
+	// distance the light fades out at, 0 for a light that reaches
+	// the whole scene
+	float range;
+	float padding;
+};
+
+// std140 layout of the LightBlock uniform block
+struct LIGHT_BLOCK
+{
+	LIGHT_SOURCE_BLOCK lightSources[MAX_LIGHT_SOURCES];
+	int lightCount;
+	int padding[3];
+};
+
+// std140 layout of a single Material in the material block
+struct MATERIAL_SOURCE_BLOCK
+{
+	glm::vec4 ambientColor;
+	glm::vec4 diffuseColor;
+	glm::vec4 specularColor;
+	float ambientStrength;
+	float shininess;
+	float padding[2];
+};
+
+// std140 layout of the MaterialBlock uniform block
+struct MATERIAL_BLOCK
+{
+	MATERIAL_SOURCE_BLOCK materials[MAX_OBJECT_MATERIALS];
+};
+
+/***********************************************************
+ *  UniformBuffer
+ *
+ *  This class owns a single uniform buffer object that is
+ *  bound to a fixed uniform block binding point.
+ ***********************************************************/
+class UniformBuffer
+{
+public:
+	// constructor
+	UniformBuffer(GLuint bindingPoint);
+	// destructor
+	~UniformBuffer();
+
+	// upload the passed in block data into the buffer, the
+	// buffer is created on the first update
+	void Update(const void* data, GLsizeiptr size);
+
+private:
+	// OpenGL name of the buffer
+	GLBuffer m_buffer;
+	// uniform block binding point of the buffer
+	GLuint m_bindingPoint;
+	// allocated size of the buffer
+	GLsizeiptr m_size;
+};
@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.cpp
+// ============
+// cache the shader uniform locations so they are only looked up once
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 14th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformCache.h"
+#include "UniformBuffer.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+/***********************************************************
+ *  UniformCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformCache::UniformCache()
+{
+	m_programID = 0;
+
+	// -1 is ignored by OpenGL, so uniforms written before the
+	// locations are cached are silently dropped
+	GLint* pLocation = reinterpret_cast<GLint*>(&m_locations);
+	for (size_t i = 0; i < sizeof(m_locations) / sizeof(GLint); i++)
+	{
+		pLocation[i] = -1;
+	}
+}
+
+/***********************************************************
+ *  CacheLocations()
+ *
+ *  This method is used for looking up the locations of all
+ *  the uniforms used while rendering. It needs to be called
+ *  once after the shader program is linked and put in use.
+ ***********************************************************/
+void UniformCache::CacheLocations()
+{
+	GLint currentProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+	m_programID = currentProgram;
+
+	m_locations.model = FindLocation("model");
+	m_locations.objectColor = FindLocation("objectColor");
+	m_locations.objectTexture = FindLocation("objectTexture");
+	m_locations.objectTextureArray = FindLocation("objectTextureArray");
+	m_locations.bUseTexture = FindLocation("bUseTexture");
+	m_locations.bUseTextureArray = FindLocation("bUseTextureArray");
+	m_locations.textureLayer = FindLocation("textureLayer");
+	m_locations.bUseLighting = FindLocation("bUseLighting");
+	m_locations.UVscale = FindLocation("UVscale");
+	m_locations.materialIndex = FindLocation("materialIndex");
+	m_locations.bUseInstancing = FindLocation("bUseInstancing");
+	m_locations.bUseLightClusters = FindLocation("bUseLightClusters");
+	m_locations.clusterTileScale = FindLocation("clusterTileScale");
+	m_locations.clusterSliceScaleBias = FindLocation("clusterSliceScaleBias");
+	m_locations.bDepthOnly = FindLocation("bDepthOnly");
+	m_locations.bShowOverdraw = FindLocation("bShowOverdraw");
+	m_locations.bWeightedBlend = FindLocation("bWeightedBlend");
+	m_locations.bShadowPass = FindLocation("bShadowPass");
+	m_locations.shadowViewProjection = FindLocation("shadowViewProjection");
+	m_locations.bUseShadows = FindLocation("bUseShadows");
+	m_locations.shadowLightIndex = FindLocation("shadowLightIndex");
+	m_locations.shadowMap = FindLocation("shadowMap");
+	m_locations.shadowMatrices = FindLocation("shadowMatrices");
+	m_locations.shadowCascadeEnds = FindLocation("shadowCascadeEnds");
+	m_locations.shadowTexelSizes = FindLocation("shadowTexelSizes");
+	m_locations.bLODFadeOut = FindLocation("bLODFadeOut");
+	m_locations.bUseDynamicModels = FindLocation("bUseDynamicModels");
+	m_locations.dynamicModels = FindLocation("dynamicModels");
+	m_locations.dynamicModelBase = FindLocation("dynamicModelBase");
+
+	// the camera, light and material data come from shared uniform buffers
+	BindUniformBlock("CameraBlock", CAMERA_BLOCK_BINDING);
+	BindUniformBlock("LightBlock", LIGHT_BLOCK_BINDING);
+	BindUniformBlock("MaterialBlock", MATERIAL_BLOCK_BINDING);
+
+	// the clustered lights come from the storage buffers of the
+	// light culling pass
+	BindStorageBlock("LightList", LIGHT_LIST_STORAGE_BINDING);
+	BindStorageBlock("ClusterGrid", CLUSTER_GRID_STORAGE_BINDING);
+	BindStorageBlock("LightIndexList", LIGHT_INDEX_STORAGE_BINDING);
+}
+
+/***********************************************************
+ *  FindLocation()
+ *
+ *  This method is used for looking up the location of the
+ *  passed in uniform name in the cached shader program.
+ ***********************************************************/
+GLint UniformCache::FindLocation(const char* uniformName) const
+{
+	if (m_programID == 0)
+	{
+		return(-1);
+	}
+
+	return(glGetUniformLocation(m_programID, uniformName));
+}
+
+/***********************************************************
+ *  BindUniformBlock()
+ *
+ *  This method is used for binding the passed in uniform
+ *  block of the cached shader program to a fixed binding
+ *  point. Blocks the program does not declare are skipped.
+ ***********************************************************/
+void UniformCache::BindUniformBlock(const char* blockName, GLuint bindingPoint) const
+{
+	if (m_programID == 0)
+	{
+		return;
+	}
+
+	GLuint blockIndex = glGetUniformBlockIndex(m_programID, blockName);
+	if (blockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(m_programID, blockIndex, bindingPoint);
+	}
+}
+
+/***********************************************************
+ *  BindStorageBlock()
+ *
+ *  This method is used for binding the passed in shader
+ *  storage block of the cached shader program to a fixed
+ *  binding point. Storage blocks need OpenGL 4.3, without it
+ *  or when the program does not declare the block nothing
+ *  is bound.
+ ***********************************************************/
+void UniformCache::BindStorageBlock(const char* blockName, GLuint bindingPoint) const
+{
+	if ((m_programID == 0) || (GLEW_VERSION_4_3 != GL_TRUE))
+	{
+		return;
+	}
+
+	GLuint blockIndex = glGetProgramResourceIndex(m_programID, GL_SHADER_STORAGE_BLOCK, blockName);
+	if (blockIndex != GL_INVALID_INDEX)
+	{
+		glShaderStorageBlockBinding(m_programID, blockIndex, bindingPoint);
+	}
+}
+
+/***********************************************************
+ *  setBoolValue()
+ *
+ *  This method is used for setting a bool uniform value.
+ ***********************************************************/
+void UniformCache::setBoolValue(GLint location, bool value) const
+{
+	glUniform1i(location, (int)value);
+}
+
+/***********************************************************
+ *  setIntValue()
+ *
+ *  This method is used for setting an int uniform value.
+ ***********************************************************/
+void UniformCache::setIntValue(GLint location, int value) const
+{
+	glUniform1i(location, value);
+}
+
+/***********************************************************
+ *  setFloatValue()
+ *
+ *  This method is used for setting a float uniform value.
+ ***********************************************************/
+void UniformCache::setFloatValue(GLint location, float value) const
+{
+	glUniform1f(location, value);
+}
+
+/***********************************************************
+ *  setVec2Value()
+ *
+ *  This method is used for setting a vec2 uniform value.
+ ***********************************************************/
+void UniformCache::setVec2Value(GLint location, const glm::vec2& value) const
+{
+	glUniform2fv(location, 1, glm::value_ptr(value));
+}
+
+/***********************************************************
+ *  setVec3Value()
+ *
+ *  This method is used for setting a vec3 uniform value.
+ ***********************************************************/
+void UniformCache::setVec3Value(GLint location, const glm::vec3& value) const
+{
+	glUniform3fv(location, 1, glm::value_ptr(value));
+}
+
+/***********************************************************
+ *  setVec4Value()
+ *
+ *  This method is used for setting a vec4 uniform value.
+ ***********************************************************/
+void UniformCache::setVec4Value(GLint location, const glm::vec4& value) const
+{
+	glUniform4fv(location, 1, glm::value_ptr(value));
+}
+
+/***********************************************************
+ *  setMat4Value()
+ *
+ *  This method is used for setting a mat4 uniform value.
+ ***********************************************************/
+void UniformCache::setMat4Value(GLint location, const glm::mat4& value) const
+{
+	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+/***********************************************************
+ *  setMat4ArrayValue()
+ *
+ *  This method is used for setting the passed in number of
+ *  mat4 values into a uniform array, starting at the cached
+ *  location of its first element.
+ ***********************************************************/
+void UniformCache::setMat4ArrayValue(GLint location, const glm::mat4* values, int count) const
+{
+	glUniformMatrix4fv(location, count, GL_FALSE, glm::value_ptr(values[0]));
+}
+
+/***********************************************************
+ *  setSampler2DValue()
+ *
+ *  This method is used for setting a sampler2D uniform to
+ *  the passed in texture slot.
+ ***********************************************************/
+void UniformCache::setSampler2DValue(GLint location, int textureSlot) const
+{
+	glUniform1i(location, textureSlot);
+}
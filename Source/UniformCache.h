@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.h
+// ============
+// cache the shader uniform locations so they are only looked up once
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 14th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  UniformCache
+ *
+ *  This class looks up the locations of all the uniforms that
+ *  are written while rendering once, right after the shader
+ *  program is linked, and provides typed setters that take the
+ *  cached locations instead of uniform names. It also binds the
+ *  shared uniform blocks to their fixed binding points.
+ ***********************************************************/
+class UniformCache
+{
+public:
+	// constructor
+	UniformCache();
+
+	struct UNIFORM_LOCATIONS
+	{
+		GLint model;
+		GLint objectColor;
+		GLint objectTexture;
+		GLint objectTextureArray;
+		GLint bUseTexture;
+		GLint bUseTextureArray;
+		GLint textureLayer;
+		GLint bUseLighting;
+		GLint UVscale;
+		GLint materialIndex;
+		GLint bUseInstancing;
+		GLint bUseLightClusters;
+		GLint clusterTileScale;
+		GLint clusterSliceScaleBias;
+		GLint bDepthOnly;
+		GLint bShowOverdraw;
+		GLint bWeightedBlend;
+		GLint bShadowPass;
+		GLint shadowViewProjection;
+		GLint bUseShadows;
+		GLint shadowLightIndex;
+		GLint shadowMap;
+		GLint shadowMatrices;
+		GLint shadowCascadeEnds;
+		GLint shadowTexelSizes;
+		GLint bLODFadeOut;
+		GLint bUseDynamicModels;
+		GLint dynamicModels;
+		GLint dynamicModelBase;
+	};
+
+	// cached uniform locations of the linked shader program
+	UNIFORM_LOCATIONS m_locations;
+
+	// look up and store the uniform locations of the shader
+	// program that is currently in use
+	void CacheLocations();
+	// look up the location of a uniform that is not cached
+	GLint FindLocation(const char* uniformName) const;
+	// bind a uniform block of the program to a fixed binding point
+	void BindUniformBlock(const char* blockName, GLuint bindingPoint) const;
+	// bind a shader storage block of the program to a fixed binding point
+	void BindStorageBlock(const char* blockName, GLuint bindingPoint) const;
+
+	// typed setters that write to a cached uniform location
+	void setBoolValue(GLint location, bool value) const;
+	void setIntValue(GLint location, int value) const;
+	void setFloatValue(GLint location, float value) const;
+	void setVec2Value(GLint location, const glm::vec2& value) const;
+	void setVec3Value(GLint location, const glm::vec3& value) const;
+	void setVec4Value(GLint location, const glm::vec4& value) const;
+	void setMat4Value(GLint location, const glm::mat4& value) const;
+	void setMat4ArrayValue(GLint location, const glm::mat4* values, int count) const;
+	void setSampler2DValue(GLint location, int textureSlot) const;
+
+private:
+	// the shader program the locations were cached from
+	GLuint m_programID;
+};
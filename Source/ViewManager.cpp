@@ -13,31 +13,25 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/type_ptr.hpp>   
-#include <chrono>
-#include <thread>
+#include <vector>
 
 // declaration of the global variables and defines
 namespace
 {
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
 	// camera object used for viewing and interacting with
 	// the 3D scene
 	Camera* g_pCamera = nullptr;
 
 	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
+	float gLastX = ViewManager::DEFAULT_WINDOW_WIDTH / 2.0f;
+	float gLastY = ViewManager::DEFAULT_WINDOW_HEIGHT / 2.0f;
 	bool gFirstMouse = true;
 
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
+	// camera movement speed, in the distance moved per 1/60th
+	// of a second, which is what it was tuned against when the
+	// camera moved once per frame at 60 frames per second
 	float cameraSpeed = 0.2f;
+	const float CAMERA_SPEED_RATE = 60.0f;
 
 	// the following variable is false when orthographic projection
 	// is off and true when it is on
@@ -46,6 +40,14 @@ namespace
 	// Toggle bool for movement speed vs camera speed. If true it will adjust wasdQE speed.
 	// False would be it adjusts the mouse sensitivity.
 	bool toggleScroll = true;
+
+	// keys pressed since the last frame, in the order they were
+	// pressed, filled by Key_Callback() while events are polled
+	std::vector<int> gPressedKeys;
+
+	// set by Mouse_Button_Callback() when the left button is clicked,
+	// and cleared once the object under the click is picked
+	bool gPickRequested = false;
 }
 
 /***********************************************************
@@ -53,11 +55,18 @@ namespace
  *
  *  The constructor for the class
  ***********************************************************/
-ViewManager::ViewManager(ShaderManager *pShaderManager)
+ViewManager::ViewManager(ShaderManager *pShaderManager, UniformCache *pUniformCache)
 {
 	// initialize the member variables
 	m_pShaderManager = pShaderManager;
+	m_pUniformCache = pUniformCache;
 	m_pWindow = NULL;
+	m_windowWidth = DEFAULT_WINDOW_WIDTH;
+	m_windowHeight = DEFAULT_WINDOW_HEIGHT;
+	m_pCameraBuffer = new UniformBuffer(CAMERA_BLOCK_BINDING);
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	m_viewProjection = glm::mat4(1.0f);
 	g_pCamera = new Camera();
 	// default camera view parameters
 	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
@@ -65,6 +74,7 @@ ViewManager::ViewManager(ShaderManager *pShaderManager)
 	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
 	g_pCamera->Zoom = 80;
 	g_pCamera->MouseSensitivity = 0.20;
+	m_previousCameraPosition = g_pCamera->Position;
 }
 
 /***********************************************************
@@ -76,7 +86,13 @@ ViewManager::~ViewManager()
 {
 	// free up allocated memory
 	m_pShaderManager = NULL;
+	m_pUniformCache = NULL;
 	m_pWindow = NULL;
+	if (NULL != m_pCameraBuffer)
+	{
+		delete m_pCameraBuffer;
+		m_pCameraBuffer = NULL;
+	}
 	if (NULL != g_pCamera)
 	{
 		delete g_pCamera;
@@ -87,16 +103,17 @@ ViewManager::~ViewManager()
 /***********************************************************
  *  CreateDisplayWindow()
  *
- *  This method is used to create the main display window.
+ *  This method is used to create the main display window,
+ *  with the passed in size.
  ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle, int windowWidth, int windowHeight)
 {
 	GLFWwindow* window = nullptr;
 
 	// try to create the displayed OpenGL window
 	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
+		windowWidth,
+		windowHeight,
 		windowTitle,
 		NULL, NULL);
 	if (window == NULL)
@@ -116,11 +133,23 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
 	// this callback is used for the scroll wheel of a mouse
 	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Wheel_Callback);
 
+	// this callback is used to receive the key presses of the toggle keys
+	glfwSetKeyCallback(window, &ViewManager::Key_Callback);
+
+	// this callback is used to receive the clicks that pick objects
+	glfwSetMouseButtonCallback(window, &ViewManager::Mouse_Button_Callback);
+
 	// enable blending for supporting tranparent rendering
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	m_pWindow = window;
+	m_windowWidth = windowWidth;
+	m_windowHeight = windowHeight;
+
+	// the mouse starts out in the middle of the window
+	gLastX = windowWidth / 2.0f;
+	gLastY = windowHeight / 2.0f;
 
 	return(window);
 }
@@ -197,13 +226,57 @@ void ViewManager::Mouse_Scroll_Wheel_Callback(GLFWwindow* window, double xoffset
 	}
 }
 
+/***********************************************************
+ *  Key_Callback()
+ *
+ *  This method is automatically called from GLFW whenever a
+ *  key is pressed, repeated or released in the active GLFW
+ *  display window. Only the moment a key goes down is kept,
+ *  so a toggle fires once per press however long the key is
+ *  held, without waiting for the key to come back up.
+ ***********************************************************/
+void ViewManager::Key_Callback(GLFWwindow* /*window*/, int key, int /*scancode*/, int action, int /*mods*/)
+{
+	if (action == GLFW_PRESS)
+	{
+		gPressedKeys.push_back(key);
+	}
+}
+
+/***********************************************************
+ *  Mouse_Button_Callback()
+ *
+ *  This method is automatically called from GLFW whenever a
+ *  mouse button is pressed or released in the active GLFW
+ *  display window. A left click is queued, and the object
+ *  under it is picked on the next tick. The cursor position
+ *  is read again, so the click is picked where it was made
+ *  even if no move was reported before it.
+ ***********************************************************/
+void ViewManager::Mouse_Button_Callback(GLFWwindow* window, int button, int action, int /*mods*/)
+{
+	if ((button == GLFW_MOUSE_BUTTON_LEFT) && (action == GLFW_PRESS))
+	{
+		double xMousePos = 0.0;
+		double yMousePos = 0.0;
+		glfwGetCursorPos(window, &xMousePos, &yMousePos);
+		gLastX = xMousePos;
+		gLastY = yMousePos;
+		gPickRequested = true;
+	}
+}
+
 /***********************************************************
  *  ProcessKeyboardEvents()
  *
  *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
+ *  that may be waiting in the event queue. The movement keys
+ *  are polled, since they act for as long as they are held,
+ *  and the toggle keys are read from the queued key presses.
+ *  The camera moves by its speed times the passed in time
+ *  step, so it covers the same distance at any frame rate.
  ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
+void ViewManager::ProcessKeyboardEvents(float timeStep)
 {
 	// close the window if the escape key has been pressed
 	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -217,59 +290,92 @@ void ViewManager::ProcessKeyboardEvents()
 		return;
 	}
 
+	// distance scale of the movement during this time step
+	float movement = cameraSpeed * CAMERA_SPEED_RATE * timeStep;
+
 	// process camera zooming in and out
 	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
 	{
-		g_pCamera->ProcessKeyboard(FORWARD, (gDeltaTime + cameraSpeed));
+		g_pCamera->ProcessKeyboard(FORWARD, movement);
 	}
 	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
 	{
-		g_pCamera->ProcessKeyboard(BACKWARD, (gDeltaTime + cameraSpeed));
+		g_pCamera->ProcessKeyboard(BACKWARD, movement);
 	}
 
 	// process camera panning left and right
 	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
 	{
-		g_pCamera->ProcessKeyboard(LEFT, (gDeltaTime + cameraSpeed));
+		g_pCamera->ProcessKeyboard(LEFT, movement);
 	}
 	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
 	{
-		g_pCamera->ProcessKeyboard(RIGHT, (gDeltaTime + cameraSpeed));
+		g_pCamera->ProcessKeyboard(RIGHT, movement);
 	}
 
 	// process upward and downward movement
 	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
 	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime + cameraSpeed);
+		g_pCamera->ProcessKeyboard(UP, movement);
 	}
 	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
 	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime + cameraSpeed);
+		g_pCamera->ProcessKeyboard(DOWN, movement);
 	}
 
-	// Toggle Scroll wheel function to adjust mouse speed instead
-	if (glfwGetKey(m_pWindow, GLFW_KEY_R) == GLFW_PRESS)
+	// handle every toggle key pressed since the last frame
+	for (int key : gPressedKeys)
 	{
-		// I've noticed that you may need to hold the keys for a moment before glfwGetKey catches it.
-		// Invert the boolean so when the mouse scroll wheel callback is called it will perform differently.
-		toggleScroll = !toggleScroll;
-		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+		switch (key)
+		{
+		case GLFW_KEY_R:
+			// Toggle Scroll wheel function to adjust mouse speed instead
+			// Invert the boolean so when the mouse scroll wheel callback is called it will perform differently.
+			toggleScroll = !toggleScroll;
+			break;
+		case GLFW_KEY_P:
+			// Perspective 3D
+			std::cout << "Changing to Perspective 3D" << std::endl;
+			bOrthographicProjection = false;
+			break;
+		case GLFW_KEY_O:
+			// Ortho 2D
+			std::cout << "Changing to glOrtho 2D" << std::endl;
+			bOrthographicProjection = true;
+			break;
+		default:
+			break;
+		}
 	}
+	gPressedKeys.clear();
+}
 
-	// Ortho (2D) vs Perspective (3D)
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		// Perspective 3D
-		std::cout << "Changing to Perspective 3D" << std::endl;
-		bOrthographicProjection = false;
-		std::this_thread::sleep_for(std::chrono::milliseconds(250));
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
+/***********************************************************
+ *  UpdateSceneView()
+ *
+ *  This method is used for advancing the camera by one fixed
+ *  simulation tick of the passed in length. The position it
+ *  had before the tick is kept, so frames drawn between two
+ *  ticks can blend the camera between them.
+ ***********************************************************/
+void ViewManager::UpdateSceneView(float timeStep)
+{
+	m_previousCameraPosition = g_pCamera->Position;
+
+	// process any keyboard events that may be waiting in the 
+	// event queue
+	ProcessKeyboardEvents(timeStep);
+
+	// the orthographic view is taken from a fixed camera
+	if (bOrthographicProjection)
 	{
-		// Ortho 2D
-		std::cout << "Changing to glOrtho 2D" << std::endl;
-		bOrthographicProjection = true;
-		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+		// Set camera
+		g_pCamera->Position = glm::vec3(0.0f, 8.0f, 12.0f);
+		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+
+		// the camera jumped, so there is nothing to blend from
+		m_previousCameraPosition = g_pCamera->Position;
 	}
 }
 
@@ -278,73 +384,167 @@ void ViewManager::ProcessKeyboardEvents()
  *
  *  This method is used for preparing the 3D scene by loading
  *  the shapes, textures in memory to support the 3D scene 
- *  rendering
+ *  rendering. The camera is drawn at the passed in fraction
+ *  of the way from its position before the last simulation
+ *  tick to its position after it.
  ***********************************************************/
-void ViewManager::PrepareSceneView()
+void ViewManager::PrepareSceneView(float interpolation)
 {
 	// Constant perspectives
-	const glm::mat4 perspectiveProjection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+	const glm::mat4 perspectiveProjection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)m_windowWidth / (GLfloat)m_windowHeight, 0.1f, 100.0f);
 	const glm::mat4 orthoProjection = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 100.0f);
 
 	glm::mat4 view;
 	glm::mat4 projection = perspectiveProjection;
 
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
 	// set projection
-	if (bOrthographicProjection && (projection != orthoProjection))
+	if (bOrthographicProjection)
 	{
 		// Set to Ortho Projection
 		projection = orthoProjection;
+	}
 
-		// Set camera
-		g_pCamera->Position = glm::vec3(0.0f, 8.0f, 12.0f);
-		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	// get the view matrix from the camera, moved to the blended
+	// position only while the matrix is built
+	glm::vec3 cameraPosition = g_pCamera->Position;
+	g_pCamera->Position = glm::mix(m_previousCameraPosition, cameraPosition, interpolation);
+	view = g_pCamera->GetViewMatrix();
+	glm::vec3 viewPosition = g_pCamera->Position;
+	g_pCamera->Position = cameraPosition;
 
-		// Still working out the kinks to this. It would be nice if I could disable the callbacks
-		// but When renabling the perspective projection the callbacks don't get renabled and I'm
-		// unsure why.
-		// 
-		// Disable mouse callbacks
-		//glfwSetCursorPosCallback(m_pWindow, nullptr);
-		//glfwSetScrollCallback(m_pWindow, nullptr);
+	// upload the camera data once per frame into the shared camera
+	// uniform buffer, every shader program reads it from there
+	if (NULL != m_pCameraBuffer)
+	{
+		CAMERA_BLOCK cameraBlock;
+		cameraBlock.view = view;
+		cameraBlock.projection = projection;
+		cameraBlock.viewPosition = glm::vec4(viewPosition, 1.0f);
+
+		m_pCameraBuffer->Update(&cameraBlock, sizeof(cameraBlock));
 	}
-	
-	if(!bOrthographicProjection && (projection != perspectiveProjection))
+
+	// kept for the scene, which culls its objects against the
+	// combination and clusters its lights in the view
+	m_view = view;
+	m_projection = projection;
+	m_viewProjection = projection * view;
+}
+
+/***********************************************************
+ *  SetCameraPose()
+ *
+ *  This method is used for placing the camera at the passed
+ *  in position, looking along the passed in direction, such
+ *  as when a recorded camera path is replayed. The yaw and
+ *  pitch are matched to the direction, so mouse movement
+ *  carries on from the new pose.
+ ***********************************************************/
+void ViewManager::SetCameraPose(const glm::vec3& position, const glm::vec3& front)
+{
+	if (NULL == g_pCamera)
 	{
-		// Perspective Projection
-		projection = perspectiveProjection;
-		g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
-		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+		return;
+	}
+
+	g_pCamera->Position = position;
+	g_pCamera->Front = glm::normalize(front);
+	g_pCamera->Yaw = glm::degrees(atan2(g_pCamera->Front.z, g_pCamera->Front.x));
+	g_pCamera->Pitch = glm::degrees(asin(g_pCamera->Front.y));
 
-		// Still working out the kinks to this. When renabling the perspective projection the callbacks
-		// don't get renabled and I'm unsure why.
-		// 
-		// Enable mouse callbacks
-		//glfwSetCursorPosCallback(m_pWindow, &ViewManager::Mouse_Position_Callback);
-		//glfwSetScrollCallback(m_pWindow, &ViewManager::Mouse_Scroll_Wheel_Callback);
+	// the camera jumped, so there is nothing to blend from
+	m_previousCameraPosition = position;
+}
+
+/***********************************************************
+ *  GetCameraPose()
+ *
+ *  This method is used for getting the position and viewing
+ *  direction of the camera after the last simulation tick.
+ ***********************************************************/
+void ViewManager::GetCameraPose(glm::vec3& position, glm::vec3& front) const
+{
+	if (NULL == g_pCamera)
+	{
+		return;
 	}
 
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
+	position = g_pCamera->Position;
+	front = g_pCamera->Front;
+}
+
+/***********************************************************
+ *  GetViewProjection()
+ *
+ *  This method is used for getting the combined view and
+ *  projection matrix of the last prepared frame.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetViewProjection() const
+{
+	return(m_viewProjection);
+}
+
+/***********************************************************
+ *  GetViewMatrix()
+ *
+ *  This method is used for getting the view matrix of the
+ *  last prepared frame.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetViewMatrix() const
+{
+	return(m_view);
+}
+
+/***********************************************************
+ *  GetProjectionMatrix()
+ *
+ *  This method is used for getting the projection matrix of
+ *  the last prepared frame.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetProjectionMatrix() const
+{
+	return(m_projection);
+}
+
+/***********************************************************
+ *  GetCursorRay()
+ *
+ *  This method is used for getting the world space ray that
+ *  passes through the last mouse position recorded by
+ *  Mouse_Position_Callback(), for picking scene objects. The
+ *  cursor is moved back from the near to the far plane.
+ ***********************************************************/
+void ViewManager::GetCursorRay(glm::vec3& origin, glm::vec3& direction) const
+{
+	// window coordinates start at the top left corner
+	float x = (2.0f * gLastX) / m_windowWidth - 1.0f;
+	float y = 1.0f - (2.0f * gLastY) / m_windowHeight;
+
+	glm::mat4 inverseViewProjection = glm::inverse(m_viewProjection);
+	glm::vec4 nearPoint = inverseViewProjection * glm::vec4(x, y, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
+
+	origin = glm::vec3(nearPoint) / nearPoint.w;
+	direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+}
+
+/***********************************************************
+ *  TakePickRay()
+ *
+ *  This method is used for checking if the scene was clicked
+ *  since it was last called, and getting the world space ray
+ *  under the click, through the view of the last prepared
+ *  frame, which is the one the click was made on. The click
+ *  is used up, so the next call waits for another one.
+ ***********************************************************/
+bool ViewManager::TakePickRay(glm::vec3& origin, glm::vec3& direction)
+{
+	if (!gPickRequested)
 	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+		return(false);
 	}
-}
\ No newline at end of file
+
+	gPickRequested = false;
+	GetCursorRay(origin, direction);
+	return(true);
+}
@@ -10,6 +10,8 @@
 #pragma once
 
 #include "ShaderManager.h"
+#include "UniformCache.h"
+#include "UniformBuffer.h"
 #include "camera.h"
 
 // GLFW library
@@ -20,7 +22,8 @@ class ViewManager
 public:
 	// constructor
 	ViewManager(
-		ShaderManager* pShaderManager);
+		ShaderManager* pShaderManager,
+		UniformCache* pUniformCache);
 	// destructor
 	~ViewManager();
 
@@ -29,19 +32,64 @@ public:
 
 	static void Mouse_Scroll_Wheel_Callback(GLFWwindow* window, double xoffset, double yoffset);
 
+	// key callback that queues the key presses for the toggle keys
+	static void Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+	// mouse button callback that queues a click for picking
+	static void Mouse_Button_Callback(GLFWwindow* window, int button, int action, int mods);
+
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
+	// pointer to the cached shader uniform locations
+	UniformCache* m_pUniformCache;
+	// active OpenGL display window and its size
 	GLFWwindow* m_pWindow;
+	int m_windowWidth;
+	int m_windowHeight;
+	// per-frame camera data shared with every shader program
+	UniformBuffer* m_pCameraBuffer;
+	// view, projection and their combination of the last prepared frame
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	glm::mat4 m_viewProjection;
+	// camera position before the last simulation tick, blended
+	// with the current one when a frame is drawn between ticks
+	glm::vec3 m_previousCameraPosition;
 
 	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
+	void ProcessKeyboardEvents(float timeStep);
 
 public:
+	// size of the display window when none is asked for
+	static const int DEFAULT_WINDOW_WIDTH = 1000;
+	static const int DEFAULT_WINDOW_HEIGHT = 800;
+
 	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	GLFWwindow* CreateDisplayWindow(
+		const char* windowTitle,
+		int windowWidth = DEFAULT_WINDOW_WIDTH,
+		int windowHeight = DEFAULT_WINDOW_HEIGHT);
 	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+	// advance the camera by one fixed simulation tick
+	void UpdateSceneView(float timeStep);
+	// prepare the conversion from 3D object display to 2D scene display,
+	// blending the camera between the last two ticks
+	void PrepareSceneView(float interpolation);
+
+	// place the camera at a pose, without blending from the last one
+	void SetCameraPose(const glm::vec3& position, const glm::vec3& front);
+	// get the position and viewing direction of the camera
+	void GetCameraPose(glm::vec3& position, glm::vec3& front) const;
+
+	// get the combined view and projection used for culling
+	const glm::mat4& GetViewProjection() const;
+	// get the view and projection of the last prepared frame
+	const glm::mat4& GetViewMatrix() const;
+	const glm::mat4& GetProjectionMatrix() const;
+	// get the world space ray under the last mouse position
+	void GetCursorRay(glm::vec3& origin, glm::vec3& direction) const;
+	// check if the scene was clicked since the last call, and get
+	// the ray under the click, clearing the click
+	bool TakePickRay(glm::vec3& origin, glm::vec3& direction);
 };
\ No newline at end of file
@@ -0,0 +1,303 @@
+///////////////////////////////////////////////////////////////////////////////
+// weightedblendoit.cpp
+// ============
+// blend translucent fragments in any order with weighted blended transparency
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "WeightedBlendOIT.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  WeightedBlendOIT()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+WeightedBlendOIT::WeightedBlendOIT()
+{
+	m_pCompositeShader = NULL;
+	m_accumulationLocation = -1;
+	m_revealageLocation = -1;
+	m_framebuffer = 0;
+	m_depthRenderbuffer = 0;
+	m_width = 0;
+	m_height = 0;
+	m_firstUnit = 0;
+	m_previousFramebuffer = 0;
+}
+
+/***********************************************************
+ *  ~WeightedBlendOIT()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+WeightedBlendOIT::~WeightedBlendOIT()
+{
+	DestroyTargets();
+
+	if (NULL != m_pCompositeShader)
+	{
+		delete m_pCompositeShader;
+		m_pCompositeShader = NULL;
+	}
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking if the pass can run. The
+ *  two targets are blended in different ways, which needs
+ *  the per target blending of OpenGL 4.0.
+ ***********************************************************/
+bool WeightedBlendOIT::IsSupported()
+{
+	return(GLEW_VERSION_4_0 == GL_TRUE);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for building the program that blends
+ *  the accumulated fragments over the frame. The program in
+ *  use before is put back. False is returned when the pass
+ *  can't be used, and the translucent objects are then sorted
+ *  instead.
+ ***********************************************************/
+bool WeightedBlendOIT::Initialize(const char* vertexShaderFilename, const char* fragmentShaderFilename)
+{
+	if (!IsSupported())
+	{
+		std::cout << "Per target blending is not supported, translucent objects are sorted instead" << std::endl;
+		return(false);
+	}
+
+	if (NULL != m_pCompositeShader)
+	{
+		return(true);
+	}
+
+	GLint currentProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+
+	m_pCompositeShader = new ShaderManager();
+	m_pCompositeShader->LoadShaders(vertexShaderFilename, fragmentShaderFilename);
+	if (m_pCompositeShader->m_programID == 0)
+	{
+		std::cout << "ERROR: could not build the transparency composite program" << std::endl;
+		delete m_pCompositeShader;
+		m_pCompositeShader = NULL;
+		glUseProgram(currentProgram);
+		return(false);
+	}
+
+	m_accumulationLocation = glGetUniformLocation(m_pCompositeShader->m_programID, "accumulationTexture");
+	m_revealageLocation = glGetUniformLocation(m_pCompositeShader->m_programID, "revealageTexture");
+	glUseProgram(currentProgram);
+
+	// the full screen triangle is made in the vertex shader, but
+	// a core context still needs a vertex array bound to draw
+	m_emptyVertexArray.Create();
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking if the pass was
+ *  initialized.
+ ***********************************************************/
+bool WeightedBlendOIT::IsReady() const
+{
+	return(NULL != m_pCompositeShader);
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for switching the drawing over to the
+ *  accumulation targets. They are sized to the viewport,
+ *  remade when it changes, and get a copy of the depth drawn
+ *  so far. The accumulation target adds up the fragments
+ *  and the revealage target multiplies in how much of the
+ *  background each one lets through. Depth writes are turned
+ *  off until Resolve(), so the translucent objects never hide
+ *  each other.
+ ***********************************************************/
+bool WeightedBlendOIT::Begin(int firstUnit)
+{
+	if (!IsReady())
+	{
+		return(false);
+	}
+
+	GLint viewport[4] = { 0, 0, 0, 0 };
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	if ((viewport[2] <= 0) || (viewport[3] <= 0))
+	{
+		return(false);
+	}
+
+	m_firstUnit = firstUnit;
+	if ((m_framebuffer == 0) || (viewport[2] != m_width) || (viewport[3] != m_height))
+	{
+		if (!CreateTargets(viewport[2], viewport[3]))
+		{
+			DestroyTargets();
+			return(false);
+		}
+	}
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+
+	// copy the depth of the opaque objects
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_previousFramebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer);
+	glBlitFramebuffer(viewport[0], viewport[1], viewport[0] + viewport[2], viewport[1] + viewport[3],
+		viewport[0], viewport[1], viewport[0] + viewport[2], viewport[1] + viewport[3],
+		GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+
+	const GLfloat clearAccumulation[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const GLfloat clearRevealage[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glClearBufferfv(GL_COLOR, 0, clearAccumulation);
+	glClearBufferfv(GL_COLOR, 1, clearRevealage);
+
+	glDepthMask(GL_FALSE);
+	glEnable(GL_BLEND);
+	glBlendFunci(0, GL_ONE, GL_ONE);
+	glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Resolve()
+ *
+ *  This method is used for blending the average color of the
+ *  accumulated fragments over the framebuffer drawn into
+ *  before Begin(), by how much of it they cover. The depth
+ *  writes, blending and program in use are put back the way
+ *  the scene draws with them.
+ ***********************************************************/
+void WeightedBlendOIT::Resolve()
+{
+	if (!IsReady() || (m_framebuffer == 0))
+	{
+		return;
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_previousFramebuffer);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	GLint currentProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+	m_pCompositeShader->use();
+
+	glActiveTexture(GL_TEXTURE0 + m_firstUnit);
+	glBindTexture(GL_TEXTURE_2D, m_accumulationTexture.Get());
+	glActiveTexture(GL_TEXTURE0 + m_firstUnit + 1);
+	glBindTexture(GL_TEXTURE_2D, m_revealageTexture.Get());
+	glActiveTexture(GL_TEXTURE0);
+	glUniform1i(m_accumulationLocation, m_firstUnit);
+	glUniform1i(m_revealageLocation, m_firstUnit + 1);
+
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(m_emptyVertexArray.Get());
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glEnable(GL_DEPTH_TEST);
+
+	glDepthMask(GL_TRUE);
+	glUseProgram(currentProgram);
+}
+
+/***********************************************************
+ *  CreateTargets()
+ *
+ *  This method is used for creating the accumulation and
+ *  revealage textures and the depth copy at the passed in
+ *  size. The accumulation sums can grow well past 1, so
+ *  they are kept in half floats. The textures are bound on
+ *  the units they are sampled from, leaving the scene's
+ *  bound textures alone.
+ ***********************************************************/
+bool WeightedBlendOIT::CreateTargets(int width, int height)
+{
+	DestroyTargets();
+
+	glActiveTexture(GL_TEXTURE0 + m_firstUnit);
+	m_accumulationTexture.Create();
+	glBindTexture(GL_TEXTURE_2D, m_accumulationTexture.Get());
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	m_accumulationTexture.SetMemorySize((GLsizeiptr)width * height * 8);
+
+	m_revealageTexture.Create();
+	glBindTexture(GL_TEXTURE_2D, m_revealageTexture.Get());
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	m_revealageTexture.SetMemorySize((GLsizeiptr)width * height);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0);
+
+	// the depth format matches the window's, so it can be copied
+	glGenRenderbuffers(1, &m_depthRenderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLint previousFramebuffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_accumulationTexture.Get(), 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_revealageTexture.Get(), 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+
+	const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	glDrawBuffers(2, drawBuffers);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "ERROR: the transparency targets are not complete: " << status << std::endl;
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyTargets()
+ *
+ *  This method is used for deleting the targets, they are
+ *  made again by the next Begin().
+ ***********************************************************/
+void WeightedBlendOIT::DestroyTargets()
+{
+	if (m_framebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (m_depthRenderbuffer != 0)
+	{
+		glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+		m_depthRenderbuffer = 0;
+	}
+	m_accumulationTexture.Reset();
+	m_revealageTexture.Reset();
+	m_width = 0;
+	m_height = 0;
+}
@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+// weightedblendoit.h
+// ============
+// blend translucent fragments in any order with weighted blended transparency
+//
+//  AUTHOR: Cade Bray - SNHU Student / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, October 15th, 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLResources.h"
+#include "ShaderManager.h"
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  WeightedBlendOIT
+ *
+ *  This class holds the offscreen targets that translucent
+ *  fragments are accumulated into, so they can be drawn in
+ *  any order. Each fragment adds its premultiplied color,
+ *  weighted by how near and how opaque it is, to one target
+ *  and multiplies its coverage into another. The average
+ *  color is then blended over the frame in a single full
+ *  screen pass. The result is an approximation, but it never
+ *  needs sorting, which suits scenes with many overlapping
+ *  translucent surfaces. The depth of the opaque objects is
+ *  copied in first, so they still hide what is behind them.
+ ***********************************************************/
+class WeightedBlendOIT
+{
+public:
+	// constructor
+	WeightedBlendOIT();
+	// destructor
+	~WeightedBlendOIT();
+
+	// check if the GL context can blend each target its own way,
+	// which needs OpenGL 4.0
+	static bool IsSupported();
+
+	// build the composite program from its shader files, the
+	// targets are created by the first Begin(), false if the pass
+	// can't be used
+	bool Initialize(const char* vertexShaderFilename, const char* fragmentShaderFilename);
+	// check if the pass was initialized
+	bool IsReady() const;
+
+	// start accumulating translucent fragments, sampling the
+	// targets from the passed in first of two texture units,
+	// false if the targets could not be made
+	bool Begin(int firstUnit);
+	// blend the accumulated fragments over the frame
+	void Resolve();
+
+private:
+	ShaderManager* m_pCompositeShader;
+	GLint m_accumulationLocation;
+	GLint m_revealageLocation;
+
+	GLuint m_framebuffer;
+	// premultiplied weighted color and weighted alpha
+	GLTexture m_accumulationTexture;
+	// product of how much each fragment lets through
+	GLTexture m_revealageTexture;
+	// copy of the depth of the opaque objects
+	GLuint m_depthRenderbuffer;
+	GLVertexArray m_emptyVertexArray;
+	int m_width;
+	int m_height;
+	int m_firstUnit;
+	// framebuffer bound when Begin() was called, drawn back into
+	GLint m_previousFramebuffer;
+
+	// create the targets for the passed in size, false if they
+	// are not complete
+	bool CreateTargets(int width, int height);
+	// delete the targets
+	void DestroyTargets();
+};
@@ -9,6 +9,7 @@
 
 #include "object.h"
 #include "SceneManager.h"
+#include <iostream>
 using namespace glm;
 
 /***********************************************************
@@ -36,63 +37,70 @@ object::~object()
 /***********************************************************
  *  render()
  *
- *  Render the Object
+ *  Render the Object at the passed in level of detail
  ***********************************************************/
-void object::render()
+void object::render(int lod)
 {
-	// Set the transformations
-	scenePtr->SetTransformations(
-		scale,
-		rotations.x,
-		rotations.y,
-		rotations.z,
-		position
-	);
+	// Set the transformations from the cached model matrix
+	scenePtr->SetTransformations(getModelMatrix());
 
 	// Set the Shaders using RGBA
-	scenePtr->SetShaderColor(
-		RGBA.x,
-		RGBA.y,
-		RGBA.z,
-		RGBA.w
-	);
+	scenePtr->SetShaderObjectColor(RGBA);
 
 	// Set the Shader Texture
-	if (texture != "")
+	if (texture != SceneManager::INVALID_HANDLE)
 	{
-		// Texture provided
+		// Texture provided, filtered the way its material asks for
 		scenePtr->SetShaderTexture(texture);
+		scenePtr->SetShaderSampler(scenePtr->GetMaterialSampler(shaderMaterial));
 
 		// Set the UV scale
 		scenePtr->SetTextureUVScale(uvScale.x, uvScale.y);
 	}
+	else
+	{
+		// No texture so the RGBA color is used
+		scenePtr->SetShaderUseTexture(false);
+	}
 
-	// Set the Shader Material
-	if (shaderMaterial != "")
+	// Set the Shader Material, objects without one use the first
+	// material like they do when drawn instanced, rather than the
+	// material the previous draw left selected
+	if (shaderMaterial != SceneManager::INVALID_HANDLE)
 	{
-		// Set the Shader Material if it's not empty.
 		scenePtr->SetShaderMaterial(shaderMaterial);
 	}
+	else
+	{
+		scenePtr->SetShaderMaterial(0);
+	}
 
-	// Draw the shape with lambda function for draw mesh
-	shape();
+	// Draw the basic mesh shape
+	scenePtr->DrawMesh(shape, lod);
 }
 
 /***********************************************************
  *  resetAll()
  *
- *  Reset all vectors and texture. This will not reset lambda
- *  draw mesh function given.
+ *  Reset all vectors and texture. This will not reset the
+ *  mesh shape given.
  ***********************************************************/
 void object::resetAll()
 {
 	uvScale = vec2(0.0f, 0.0f);
 	rotations = vec3(0.0f, 0.0f, 0.0f);
+	previousRotations = rotations;
+	spinSeconds = 0.0f;
+	drawnRotations = rotations;
 	scale = vec3(1.0f, 1.0f, 1.0f);
 	position = vec3(0.0f, 0.0f, 0.0f);
+	bTransformDirty = true;
+	bBoundsDirty = true;
 	RGBA = vec4(0.0f, 0.0f, 0.0f, 1);
-	texture = "";
-	shaderMaterial = "";
+	texture = SceneManager::INVALID_HANDLE;
+	shaderMaterial = SceneManager::INVALID_HANDLE;
+	bDynamic = false;
+	spinRates = vec3(0.0f, 0.0f, 0.0f);
 }
 
 /***********************************************************
@@ -113,6 +121,11 @@ void object::set_uvScale(vec2 given_uvScale)
 void object::setRotations(vec3 givenRotations)
 {
 	rotations = givenRotations;
+	previousRotations = rotations;
+	spinSeconds = 0.0f;
+	drawnRotations = rotations;
+	bTransformDirty = true;
+	bBoundsDirty = true;
 }
 
 /***********************************************************
@@ -123,6 +136,8 @@ void object::setRotations(vec3 givenRotations)
 void object::setScale(vec3 givenScale)
 {
 	scale = givenScale;
+	bTransformDirty = true;
+	bBoundsDirty = true;
 }
 
 /***********************************************************
@@ -133,6 +148,8 @@ void object::setScale(vec3 givenScale)
 void object::setPosition(vec3 givenPosition)
 {
 	position = givenPosition;
+	bTransformDirty = true;
+	bBoundsDirty = true;
 }
 
 /***********************************************************
@@ -148,29 +165,256 @@ void object::setRGBA(vec4 givenRGBA)
 /***********************************************************
  *  setShape()
  *
- *  Function for setting the lamba shape of the object.
+ *  Function for setting the mesh shape of the object.
  ***********************************************************/
-void object::setShape(std::function<void()> givenShape)
+void object::setShape(MESH_SHAPE givenShape)
 {
 	shape = givenShape;
+	bBoundsDirty = true;
 }
 
 /***********************************************************
  *  setTexture()
  *
- *  Function for setting the texture of the object.
+ *  Function for setting the texture of the object. The tag is
+ *  resolved to a handle here so rendering does no lookups. An
+ *  empty tag clears the texture.
  ***********************************************************/
-void object::setTexture(std::string givenTexture)
+void object::setTexture(const std::string& givenTexture)
 {
-	texture = givenTexture;
+	texture = SceneManager::INVALID_HANDLE;
+	if (!givenTexture.empty())
+	{
+		texture = scenePtr->FindTextureHandle(givenTexture);
+		if (texture == SceneManager::INVALID_HANDLE)
+		{
+			std::cout << "Could not find texture:" << givenTexture << std::endl;
+		}
+	}
 }
 
 /***********************************************************
- *  setTexture()
+ *  setObjectShaderMaterial()
+ *
+ *  Function for setting the shader material of the object. The
+ *  tag is resolved to a handle here so rendering does no lookups.
+ *  An empty tag clears the material.
+ ***********************************************************/
+void object::setObjectShaderMaterial(const std::string& givenMaterial)
+{
+	shaderMaterial = SceneManager::INVALID_HANDLE;
+	if (!givenMaterial.empty())
+	{
+		shaderMaterial = scenePtr->FindMaterialHandle(givenMaterial);
+		if (shaderMaterial == SceneManager::INVALID_HANDLE)
+		{
+			std::cout << "Could not find material:" << givenMaterial << std::endl;
+		}
+	}
+}
+
+/***********************************************************
+ *  setDynamic()
+ *
+ *  Function for marking the object as one that moves often.
+ *  The shadow maps of the static objects are cached, so a
+ *  dynamic object is drawn over them every frame instead of
+ *  dropping the cache each time it moves. The render queue
+ *  needs rebuilding for the change to be picked up.
+ ***********************************************************/
+void object::setDynamic(bool givenDynamic)
+{
+	bDynamic = givenDynamic;
+}
+
+/***********************************************************
+ *  setSpin()
+ *
+ *  Function for setting the degrees per second the object
+ *  turns about each axis. A spinning object moves every
+ *  frame, so it is marked dynamic.
+ ***********************************************************/
+void object::setSpin(vec3 givenSpin)
+{
+	spinRates = givenSpin;
+	if (spinRates != vec3(0.0f, 0.0f, 0.0f))
+	{
+		bDynamic = true;
+	}
+}
+
+/***********************************************************
+ *  spin()
+ *
+ *  Function for turning the object by its spin over the
+ *  passed in number of seconds. The rotations are kept
+ *  within a single turn, so they never lose precision. The
+ *  object is drawn at its new rotations until it is moved
+ *  back between the two steps by interpolateSpin().
+ ***********************************************************/
+bool object::spin(float seconds)
+{
+	if (spinRates == vec3(0.0f, 0.0f, 0.0f))
+	{
+		return(false);
+	}
+
+	previousRotations = rotations;
+	spinSeconds = seconds;
+	rotations = mod(rotations + spinRates * seconds, 360.0f);
+	drawnRotations = rotations;
+	bTransformDirty = true;
+	bBoundsDirty = true;
+	return(true);
+}
+
+/***********************************************************
+ *  interpolateSpin()
+ *
+ *  Function for drawing the object at the passed in fraction
+ *  of the way through its last spin step. The rotations are
+ *  turned on from where the step started instead of blended,
+ *  so the object never turns the long way round when the
+ *  step crosses a full turn.
+ ***********************************************************/
+bool object::interpolateSpin(float interpolation)
+{
+	if (spinRates == vec3(0.0f, 0.0f, 0.0f))
+	{
+		return(false);
+	}
+
+	drawnRotations = mod(previousRotations + spinRates * (spinSeconds * interpolation), 360.0f);
+	bTransformDirty = true;
+	bBoundsDirty = true;
+	return(true);
+}
+
+/***********************************************************
+ *  getModelMatrix()
+ *
+ *  Function for getting the model matrix of the object. The
+ *  matrix is only rebuilt when the scale, rotations or
+ *  position changed since it was last built.
+ ***********************************************************/
+const mat4& object::getModelMatrix()
+{
+	if (bTransformDirty)
+	{
+		modelMatrix = SceneManager::BuildModelMatrix(
+			scale,
+			drawnRotations.x,
+			drawnRotations.y,
+			drawnRotations.z,
+			position
+		);
+		bTransformDirty = false;
+	}
+
+	return(modelMatrix);
+}
+
+/***********************************************************
+ *  getWorldBounds()
+ *
+ *  Function for getting the bounding volume of the object in
+ *  world space. The bounds of the mesh shape are moved by the
+ *  cached model matrix, and only again after the transform
+ *  or the shape changed.
+ ***********************************************************/
+const BOUNDING_VOLUME& object::getWorldBounds()
+{
+	if (bBoundsDirty)
+	{
+		worldBounds = Frustum::TransformBounds(
+			scenePtr->m_sceneMeshes->GetMeshBounds(shape),
+			getModelMatrix());
+		bBoundsDirty = false;
+	}
+
+	return(worldBounds);
+}
+
+/***********************************************************
+ *  getPosition()
+ *
+ *  Function for getting the position of the object.
+ ***********************************************************/
+const glm::vec3& object::getPosition() const
+{
+	return(position);
+}
+
+/***********************************************************
+ *  getShape()
+ *
+ *  Function for getting the mesh shape of the object.
+ ***********************************************************/
+MESH_SHAPE object::getShape() const
+{
+	return(shape);
+}
+
+/***********************************************************
+ *  getTexture()
+ *
+ *  Function for getting the texture handle of the object.
+ ***********************************************************/
+SceneManager::TextureHandle object::getTexture() const
+{
+	return(texture);
+}
+
+/***********************************************************
+ *  getMaterial()
+ *
+ *  Function for getting the material handle of the object.
+ ***********************************************************/
+SceneManager::MaterialHandle object::getMaterial() const
+{
+	return(shaderMaterial);
+}
+
+/***********************************************************
+ *  isTranslucent()
+ *
+ *  Function for checking if the object is see-through and
+ *  needs to be blended after the opaque objects.
+ ***********************************************************/
+bool object::isTranslucent() const
+{
+	return(RGBA.w < 1.0f);
+}
+
+/***********************************************************
+ *  isDynamic()
  *
- *  Function for setting the texture of the object.
+ *  Function for checking if the object is marked as one that
+ *  moves often.
  ***********************************************************/
-void object::setObjectShaderMaterial(std::string givenMaterial)
+bool object::isDynamic() const
 {
-	shaderMaterial = givenMaterial;
-}
\ No newline at end of file
+	return(bDynamic);
+}
+
+/***********************************************************
+ *  getInstanceData()
+ *
+ *  Function for filling in the per-instance values of the
+ *  object used when it is drawn with an instanced draw call.
+ *  Objects without a material use the first material. The
+ *  dynamic slot is given out by the scene manager.
+ ***********************************************************/
+void object::getInstanceData(INSTANCE_DATA& instance)
+{
+	instance.model = getModelMatrix();
+	instance.objectColor = RGBA;
+	instance.UVscale = uvScale;
+	instance.materialIndex = 0;
+	if (shaderMaterial != SceneManager::INVALID_HANDLE)
+	{
+		instance.materialIndex = shaderMaterial;
+	}
+	instance.textureLayer = scenePtr->GetTextureLayer(texture);
+	instance.dynamicSlot = -1;
+}
@@ -9,28 +9,57 @@
 
 #pragma once
 #include "SceneManager.h"
-#include <functional>
 #include <string>
 #include <glm/vec4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
+#include <glm/mat4x4.hpp>
 
 class object
 {
 public:
 	object(SceneManager* sceneManager);
 	~object();
-	void render();
+	// draw the object at the passed in level of detail of its shape
+	void render(int lod = 0);
 	void resetAll();
 	void set_uvScale(glm::vec2 given_uvScale);
 	void setRotations(glm::vec3 givenRotations);
 	void setScale(glm::vec3 givenScale);
 	void setPosition(glm::vec3 givenPosition);
 	void setRGBA(glm::vec4 givenRGBA);
-	void setShape(std::function<void()> givenShape);
-	void setTexture(std::string givenTexture);
+	void setShape(MESH_SHAPE givenShape);
+	void setTexture(const std::string& givenTexture);
 
-	void setObjectShaderMaterial(std::string givenMaterial);
+	void setObjectShaderMaterial(const std::string& givenMaterial);
+	// mark the object as one that moves often, so it is drawn into
+	// the shadow maps every frame instead of into their cache
+	void setDynamic(bool givenDynamic);
+	// set the degrees per second the object turns about each axis
+	void setSpin(glm::vec3 givenSpin);
+	// turn the object by its spin, false if it has none
+	bool spin(float seconds);
+	// draw the object at the passed in fraction of its last spin
+	// step, false if it has no spin
+	bool interpolateSpin(float interpolation);
+
+	// get the model matrix, rebuilding it only if a transform changed
+	const glm::mat4& getModelMatrix();
+	// get the world space bounding volume, rebuilt with the model matrix
+	const BOUNDING_VOLUME& getWorldBounds();
+
+	// get the position the object is placed at
+	const glm::vec3& getPosition() const;
+
+	// getters for the render state used when sorting the draws
+	MESH_SHAPE getShape() const;
+	SceneManager::TextureHandle getTexture() const;
+	SceneManager::MaterialHandle getMaterial() const;
+	bool isTranslucent() const;
+	bool isDynamic() const;
+
+	// fill in the per-instance values used by instanced drawing
+	void getInstanceData(INSTANCE_DATA& instance);
 
 private:
 	// Pointer back to the SceneManager instance so we can call
@@ -42,8 +71,22 @@ private:
 	glm::vec3 rotations = glm::vec3(0.0f, 0.0f, 0.0f);
 	glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
 	glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f);
+	// cached model matrix, rebuilt when the dirty flag is set
+	glm::mat4 modelMatrix = glm::mat4(1.0f);
+	bool bTransformDirty = true;
+	// cached world space bounds, rebuilt when the transform or shape changes
+	BOUNDING_VOLUME worldBounds = BOUNDING_VOLUME();
+	bool bBoundsDirty = true;
 	glm::vec4 RGBA = glm::vec4(0.0f, 0.0f, 0.0f, 1);
-	std::function<void()> shape = [this]() {scenePtr->m_basicMeshes->DrawBoxMesh();};
-	std::string texture = "";
-	std::string shaderMaterial = "";
+	MESH_SHAPE shape = MESH_BOX;
+	// texture and material tags resolved to handles when they are set
+	SceneManager::TextureHandle texture = SceneManager::INVALID_HANDLE;
+	SceneManager::MaterialHandle shaderMaterial = SceneManager::INVALID_HANDLE;
+	bool bDynamic = false;
+	glm::vec3 spinRates = glm::vec3(0.0f, 0.0f, 0.0f);
+	// rotations before the last spin step and its length, and the
+	// rotations between the two that the model matrix is built from
+	glm::vec3 previousRotations = glm::vec3(0.0f, 0.0f, 0.0f);
+	float spinSeconds = 0.0f;
+	glm::vec3 drawnRotations = glm::vec3(0.0f, 0.0f, 0.0f);
 };
\ No newline at end of file